@@ -32,6 +32,7 @@
 #include "config.h"
 #include "dgd_opt.h"
 #include "b_time.h"
+#include "b_stat.h"
 
 char cell_name[1024] = "mydesign";
 char target_library_name[1024] = "mylib";
@@ -43,6 +44,7 @@ char out_vhdl_name[1024] = "";
 char out_xnf_name[1024] = "";
 char out_bex_name[1024] = "";
 char out_pla_name[1024] = "";
+char stat_file_name[1024] = "";
 char cell_library_name[1024] = "gatelib";
 char view_name[1024] = "symbol";
 int is_async = 0;
@@ -50,6 +52,8 @@ long log_level = 4;
 long reset_type = GNC_HL_OPT_CLR_LOW;
 long state_encoding = GNC_HL_OPT_ENC_SIMPLE;
 long delay_safety = 10L;
+long enc_search_cnt = 64L;
+long enc_search_ms = 0L;
 
 int t_is_neca = 1;
 int t_is_generic = 1;
@@ -118,6 +122,10 @@ cl_entry_struct cl_list[] =
   { CL_TYP_SET,     "encfi-Use 'fan in' state encoding", &state_encoding, GNC_HL_OPT_ENC_FAN_IN },
   { CL_TYP_SET,     "encica-Use 'all input constrains' state encoding", &state_encoding, GNC_HL_OPT_ENC_IC_ALL },
   { CL_TYP_SET,     "encicp-Use 'input constraints partially' state encoding", &state_encoding, GNC_HL_OPT_ENC_IC_PART },
+  { CL_TYP_SET,     "encsearch-Search the state encoding with the lowest cost (see DGC_THREADS)", &state_encoding, GNC_HL_OPT_ENC_SEARCH },
+  { CL_TYP_SET,     "encsa-Use simulated annealing with the input constraints for the state encoding", &state_encoding, GNC_HL_OPT_ENC_ANNEAL },
+  { CL_TYP_LONG,    "enccnt-Number of state encodings for 'encsearch'", &enc_search_cnt, 0 },
+  { CL_TYP_LONG,    "encms-Time limit (ms) for 'encsearch', 0: no limit", &enc_search_ms, 0 },
 
   { CL_TYP_GROUP,   "Export netlist", NULL, 0 },
   { CL_TYP_PATH,    "oe-Generate EDIF netlist", out_edif_name, 1022 },
@@ -142,6 +150,7 @@ cl_entry_struct cl_list[] =
   
   { CL_TYP_LONG,    "ll-Log level, 0: all messages, 7: no messages", &log_level, 0 },
   { CL_TYP_ON,      "cap-Calculate charge/dischage capacitance (see log output)", &t_is_cap_report, 0 },
+  { CL_TYP_PATH,    "stat-Append solver statistics (JSON lines) to file (default: $DGC_STAT)", stat_file_name, 1022 },
   CL_ENTRY_LAST
 };
 
@@ -157,6 +166,8 @@ int do_all(gnc nc)
   nc->log_level = log_level;
   nc->syparam.delay_safety = 1.0 + ((double)delay_safety)/100.0;
   gnc_Log(nc, 4, "Using delay safety factor %.2lf", nc->syparam.delay_safety);
+  nc->syparam.enc_search_cnt = (int)enc_search_cnt;
+  nc->syparam.enc_search_ms = enc_search_ms;
 
   gnc_DisableStrListBBB(nc, disable_cells);
   
@@ -391,6 +402,12 @@ int main(int argc, char **argv)
     exit(1);
   }
   
+  if ( b_stat_Open(stat_file_name) == 0 )
+  {
+    printf("Can not open statistics file '%s'.\n", stat_file_name);
+    exit(1);
+  }
+  
   nc = gnc_Open();
   if ( nc != NULL )
   {
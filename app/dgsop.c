@@ -28,17 +28,20 @@
 #include "dcube.h"
 #include "cmdline.h"
 #include "b_ff.h"
+#include "b_stat.h"
 #include "config.h"
 
 char pla_file_name[1024] = "";
 char bex_file_name[1024] = "";
 char fn_cube_str[1024] = "";
+char stat_file_name[1024] = "";
 long log_level = 4;
 long command = 0;
 int is_quiet = 0, greedy = 0;
 int is_bcp = 0;
 int is_pos = 0;
 int is_literal = 0;
+int is_implicit = 0;
 
 cl_entry_struct cl_list[] =
 {
@@ -60,9 +63,11 @@ cl_entry_struct cl_list[] =
   { CL_TYP_GROUP,   "Additional options", NULL, 0 },
   { CL_TYP_ON,      "greedy-use heuristic cover algorithm", &greedy,  0 },
   { CL_TYP_ON,      "literal-weight function is 'number of literals'", &is_literal,  0 },
+  { CL_TYP_ON,      "implicit-use decision diagrams for primes and essential primes", &is_implicit,  0 },
   { CL_TYP_ON,      "bcp-use binate cover algorithm for minimize command", &is_bcp,  0 },
   { CL_TYP_ON,      "pos-assume 'product of sums' for the 1st input file", &is_pos, 0 },
   { CL_TYP_ON,      "b-Batch operation, be quiet", &is_quiet, 0 },
+  { CL_TYP_STRING,  "stat-append solver statistics (JSON lines) to file (default: $DGC_STAT)", stat_file_name, 1024 },
   CL_ENTRY_LAST
 };
 
@@ -138,7 +143,7 @@ int doall(void)
     case 0:
       if ( is_bcp == 0 )
       {
-        if ( dclMinimizeDC(&pi, cl_on, cl_dc, greedy, is_literal) == 0 )
+        if ( dclMinimizeDC(&pi, cl_on, cl_dc, greedy | (is_implicit != 0 ? DCL_MIN_IMPLICIT : 0), is_literal) == 0 )
         {
           puts("error: minimize");
           return dclDestroyVA(4, cl_on, cl_dc, cl2_on, cl2_dc), pinfoDestroy(&pi), 0;
@@ -366,6 +371,12 @@ int main(int argc, char **argv)
     exit(4);
   }  
   
+  if ( b_stat_Open(stat_file_name) == 0 )
+  {
+    printf("can not open statistics file\n");
+    exit(3);
+  }
+  
   if ( doall() == 0 )
   {
     exit(3);
@@ -26,9 +26,11 @@
 #include "dgd_opt.h"
 #include "fsmtest.h"
 #include "fsmenc.h"
+#include "fsmsim.h"
 #include "cmdline.h"
 #include <stdio.h>
 #include <string.h>
+#include <time.h>
 
 char out_vhdl_name[1024] = "";
 char out_vhdltb_name[1024] = "";
@@ -37,6 +39,8 @@ char vhdltb_entity_name[1024] = "testbench";
 char vhdl_arch_name[1024] = "rtl";
 char vhdl_clock_name[1024] = "clk";
 char vhdl_reset_name[1024] = "clr";
+char sim_stim_name[1024] = "";
+char sim_out_name[1024] = "";
 /*
  * int is_state_port = 0;
  * int is_state_dub = 0;
@@ -46,6 +50,7 @@ long encoding = 0;
 long ns = 20;
 long reset_type = 1;
 int t_is_min_state = 0;
+int is_tour = 0;
 
 cl_entry_struct cl_list[] =
 {
@@ -66,6 +71,7 @@ cl_entry_struct cl_list[] =
 */
   { CL_TYP_STRING,  "ovtb-generate VHDL testbench", out_vhdltb_name, 1022 },
   { CL_TYP_STRING,  "ov-generate VHDL model", out_vhdl_name, 1022 }, 
+  { CL_TYP_ON,      "tour-testbench with a closed tour over all transitions (chinese postman)", &is_tour, 0 },
   { CL_TYP_STRING,  "tbe-entity name for the VHDL testbench", vhdltb_entity_name, 1022 },
   { CL_TYP_STRING,  "e-entity name for the VHDL model", vhdl_entity_name, 1022 },
   { CL_TYP_STRING,  "a-architecture name for the VHDL model", vhdl_arch_name, 1022 },
@@ -74,6 +80,8 @@ cl_entry_struct cl_list[] =
   { CL_TYP_LONG,    "p-length of clock period in nanoseconds", &ns, 0 },
   { CL_TYP_SET,     "rsl-Generate low aktive reset", &reset_type, 1 },
   { CL_TYP_SET,     "rsh-Generate high aktive reset", &reset_type, 0 },
+  { CL_TYP_STRING,  "simout-output file of the compiled simulation", sim_out_name, 1022 },
+  { CL_TYP_STRING,  "sim-stimulus file for the compiled simulation (one input vector per line)", sim_stim_name, 1022 },
   CL_ENTRY_LAST
 };
 
@@ -134,6 +142,33 @@ int do_all(fsm_type fsm)
     return 0;
   }
   
+  if ( sim_stim_name[0] != '\0' )
+  {
+    fsmsim_type fs;
+    long cnt;
+    clock_t start = clock();
+    if ( encoding != 0 )
+    {
+      puts("Compiled simulation requires a clocked machine.");
+      return 0;
+    }
+    fs = fsmsim_Open(fsm);
+    if ( fs == NULL )
+    {
+      puts("Memory error (fsmsim_Open).");
+      return 0;
+    }
+    cnt = fsmsim_DoFile(fs, sim_stim_name, sim_out_name[0] != '\0' ? sim_out_name : NULL);
+    fsmsim_Close(fs);
+    if ( cnt < 0 )
+    {
+      printf("Simulation of '%s' failed.\n", sim_stim_name);
+      return 0;
+    }
+    printf("Simulated %ld vectors in %.2lf seconds.\n", cnt, 
+      (double)(clock()-start)/(double)CLOCKS_PER_SEC);
+  }
+
   if ( out_vhdl_name[0] != '\0' )
   {
     if ( fsm_WriteVHDL(fsm, out_vhdl_name, vhdl_entity_name, vhdl_arch_name, vhdl_clock_name, vhdl_reset_name, vhdl_opt) == 0 )
@@ -148,7 +183,10 @@ int do_all(fsm_type fsm)
     tl = fsmtl_Open(fsm);
     if ( tl != NULL )
     {
-      fsmtl_AddAllEdgeSequence(tl);
+      if ( is_tour != 0 )
+        fsmtl_AddEdgeTour(tl);
+      else
+        fsmtl_AddAllEdgeSequence(tl);
       if ( out_vhdltb_name[0] != '\0' )
       {
         fsm_WriteVHDLTB(fsm, out_vhdltb_name, tl, vhdltb_entity_name, 
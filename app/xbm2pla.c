@@ -32,6 +32,7 @@
 int is_fbo = 0;
 int is_mis = 0;
 int is_sync = 0;
+int is_split = 0;
 int log_level = 4;
 int is_show_walk = 0;
 long tb_reset_type = XBM_RESET_LOW;
@@ -48,6 +49,7 @@ int is_auto_ddc_mix = 0;
 char tb_vhdl_file_name[1024] = "";
 char tb_dut_name[1024] = "mydesign";
 long tb_wait_time_ns = 100;
+long tb_parts = 1;
 char normal_partitions_file_name[1024] = "";
 char prime_partitions_file_name[1024] = "";
 char minimized_partitions_file_name[1024] = "";
@@ -72,6 +74,8 @@ cl_entry_struct cl_list[] =
   { CL_TYP_OFF,     "nomis-disable state minimization", &is_mis,  0 },
   { CL_TYP_ON,      "sync-synchronous machines", &is_sync,  0 },
   { CL_TYP_OFF,     "async-asynchronous machines", &is_sync,  0 },
+  { CL_TYP_ON,      "split-minimize each output separately (DGC_THREADS threads)", &is_split,  0 },
+  { CL_TYP_OFF,     "nosplit-minimize all outputs together", &is_split,  0 },
   { CL_TYP_GROUP,   "Advanced options", NULL, 0 },
   { CL_TYP_ON,      "ddclevel-apply 'directed don't care' to all level variables", &is_auto_ddc_level,  0 },
   { CL_TYP_OFF,     "noddclevel-do not apply 'directed don't care' to all level variables", &is_auto_ddc_level,  0 },
@@ -85,6 +89,7 @@ cl_entry_struct cl_list[] =
   { CL_TYP_SET,     "tbrsl-Generate low aktive reset", &tb_reset_type, XBM_RESET_LOW },
   { CL_TYP_SET,     "tbrsh-Generate high aktive reset", &tb_reset_type,  XBM_RESET_HIGH},
   { CL_TYP_LONG,    "tbwait-Argument (nanoseconds) for the 'wait' statement.", &tb_wait_time_ns,  0},
+  { CL_TYP_LONG,    "tbparts-Split the testbench into n files (DGC_THREADS threads)", &tb_parts,  0},
   { CL_TYP_GROUP,   "Debug", NULL, 0 },
   { CL_TYP_STRING,  "donp-write partitions", normal_partitions_file_name, 1024 },
   { CL_TYP_STRING,  "dopp-write prime partitions", prime_partitions_file_name, 1024 },
@@ -115,6 +120,9 @@ int doall(xbm_type x)
     
   if ( is_sync != 0 )
     opt |= XBM_BUILD_OPT_SYNC;
+
+  if ( is_split != 0 )
+    opt |= XBM_BUILD_OPT_SPLIT;
   
   if ( xbm_ReadBMS(x, cl_file_list[0]) == 0 )
     return 0;
@@ -186,7 +194,7 @@ int doall(xbm_type x)
     x->tb_reset_type = tb_reset_type;
     x->tb_wait_time_ns = tb_wait_time_ns;
     xbm_SetVHDLComponentName(x, tb_dut_name);
-    xbm_WriteTestbenchVHDL(x, tb_vhdl_file_name);
+    xbm_WriteTestbenchVHDLParts(x, tb_vhdl_file_name, (int)tb_parts);
   }
   
  
@@ -32,10 +32,13 @@
 #include <assert.h>
 #include "b_io.h"
 #include "b_ff.h"
+#include "b_th.h"
 #include "dcube.h"
 #include "mcov.h"
 #include "mwc.h"
 #include "matrix.h"
+#include "b_th.h"
+#include "b_stat.h"
 
 /*-- dcInSetAll -------------------------------------------------------------*/
 void dcInSetAll(pinfo *pi, dcube *c, c_int v)
@@ -539,7 +542,7 @@ char *dcSetAllByStr(pinfo *pi, int in_cnt, int out_cnt, dcube *c_on, dcube *c_dc
 
 char *dcToStr(pinfo *pi, dcube *c, char *sep, char *post)
 {
-  static char s[CUBE_IN_SIGNALS+CUBE_SIGNALS_PER_OUT_WORD+1028*4];
+  static B_TH_LOCAL char s[CUBE_IN_SIGNALS+CUBE_SIGNALS_PER_OUT_WORD+1028*4];
   int i, l;
   for( i = 0; i < pi->in_cnt; i++ )
     s[i] = "x01-"[dcGetIn(c, i)];
@@ -553,7 +556,7 @@ char *dcToStr(pinfo *pi, dcube *c, char *sep, char *post)
 
 char *dcToStr2(pinfo *pi, dcube *c, char *sep, char *post)
 {
-  static char s[1024*8];
+  static B_TH_LOCAL char s[1024*8];
   int i, l;
   for( i = 0; i < pi->in_cnt; i++ )
     s[i] = "x01-"[dcGetIn(c, i)];
@@ -567,7 +570,7 @@ char *dcToStr2(pinfo *pi, dcube *c, char *sep, char *post)
 
 char *dcToStr3(pinfo *pi, dcube *c, char *sep, char *post)
 {
-  static char s[1024*8];
+  static B_TH_LOCAL char s[1024*8];
   int i, l;
   for( i = 0; i < pi->in_cnt; i++ )
     s[i] = "x01-"[dcGetIn(c, i)];
@@ -584,7 +587,7 @@ char *dcToStr3(pinfo *pi, dcube *c, char *sep, char *post)
 
 char *dcOutToStr(pinfo *pi, dcube *c, char *post)
 {
-  static char s[1024*16];
+  static B_TH_LOCAL char s[1024*16];
   int i;
   for( i = 0; i < pi->out_cnt; i++ )
     s[i] = "01"[dcGetOut(c, i)];
@@ -596,7 +599,7 @@ char *dcOutToStr(pinfo *pi, dcube *c, char *post)
 
 char *dcInToStr(pinfo *pi, dcube *c, char *post)
 {
-  static char s[1024*16];
+  static B_TH_LOCAL char s[1024*16];
   int i;
   for( i = 0; i < pi->in_cnt; i++ )
     s[i] = "x01-"[dcGetIn(c, i)];
@@ -1679,7 +1682,11 @@ int dclInit(dclist *cl)
 int dclInitCached(pinfo *pi, dclist *cl)
 {
   if ( pi->cache_cnt == 0 )
+  {
+    b_stat_Inc(B_STAT_CNT_CACHE_MISS);
     return dclInit(cl);
+  }
+  b_stat_Inc(B_STAT_CNT_CACHE_HIT);
   pi->cache_cnt--;
   *cl = pi->cache_cl[pi->cache_cnt];
   return 1;
@@ -3654,6 +3661,7 @@ int dclTautologyCof(pinfo *pi, dclist cl, dcube *cof, int depth)
   dcube *cofactor_right = &(pi->stack2[depth]);
   int check;
   
+  b_stat_Inc(B_STAT_CNT_TAUTOLOGY_REC);
   check = dclCheckTautology(pi, cl);
   if ( check >= 0 )
   {
@@ -3702,6 +3710,7 @@ int dclTautology(pinfo *pi, dclist cl)
   int result;
   dcube *cof = &(pi->tmp[2]);
   dcSetTautology(pi, cof);
+  b_stat_Inc(B_STAT_CNT_TAUTOLOGY);
   /* pinfoBTreeInit(pi, "Tautology"); */
   result = dclTautologyCof(pi, cl, cof, 0);
   /* pinfoBTreeFinish(pi); */
@@ -4459,6 +4468,7 @@ int dclComplementCof(pinfo *pi, dclist cl, dcube *cof, int depth)
   dcube *cof_right = &(pi->stack2[depth]);
   int left_cnt, right_cnt;
 
+  b_stat_Inc(B_STAT_CNT_COMPLEMENT_REC);
   if (depth >= PINFO_STACK_CUBES)
     return 0;
     
@@ -4597,12 +4607,16 @@ int dclComplementWithURP(pinfo *pi, dclist cl)
 {
   int result;
   dcube *cof = &(pi->tmp[2]);
+  b_stat_type stat = b_stat_Start("complement");
+  b_stat_Add(stat, "in", dclCnt(cl));
   if ( dclSCC(pi, cl) == 0 )
-    return 0;
+    return b_stat_Finish(stat), 0;
   dcSetTautology(pi, cof);
   pinfoBTreeInit(pi, "Complement URP");
   result = dclComplementCof(pi, cl, cof, 0);
   pinfoBTreeFinish(pi);
+  b_stat_Add(stat, "out", dclCnt(cl));
+  b_stat_Finish(stat);
   return result;
 }
 
@@ -4621,6 +4635,7 @@ int dclPrimesCof(pinfo *pi, dclist cl, dcube *cof, int depth)
   dcube *cof_right = &(pi->stack2[depth]);
   int left_cnt, right_cnt; 
 
+  b_stat_Inc(B_STAT_CNT_PRIMES_REC);
   if (depth >= PINFO_STACK_CUBES)
     return 0;
     
@@ -4772,12 +4787,16 @@ int dclPrimes(pinfo *pi, dclist cl)
 {
   int result;
   dcube *cof = &(pi->tmp[2]);
+  b_stat_type stat = b_stat_Start("primes");
+  b_stat_Add(stat, "in", dclCnt(cl));
   if ( dclSCC(pi, cl) == 0 )
-    return 0;
+    return b_stat_Finish(stat), 0;
   dcSetTautology(pi, cof);
   pinfoBTreeInit(pi, "Primes");
   result = dclPrimesCof(pi, cl, cof, 0);
   pinfoBTreeFinish(pi);
+  b_stat_Add(stat, "out", dclCnt(cl));
+  b_stat_Finish(stat);
   return result;
 }
 
@@ -5367,7 +5386,7 @@ int dclIrredundantMarkTaut(pinfo *pi_m, dclist cl_m, pinfo *pi, int n, dclist cl
   cl_es und cl_dc koennen auch NULL sein.
 */
 
-int dclIrredundantMark(pinfo *pi_m, dclist cl_m, pinfo *pi, dclist cl_pr, int pos, dclist cl_es, dclist cl_dc)
+static int dcl_irredundant_mark(pinfo *pi_m, dclist cl_m, pinfo *pi, dclist cl_pr, int pos, dclist cl_es, dclist cl_dc)
 {
   dclist cl_u;
   int i, added_index;
@@ -5431,8 +5450,6 @@ int dclIrredundantMark(pinfo *pi_m, dclist cl_m, pinfo *pi, dclist cl_pr, int po
   else
   */
   {
-    dclClearFlags(cl_pr);   /* obsolete? */
-    dclSetFlag(cl_pr, pos); /* obsolete? */
     if ( dclIrredundantMarkTaut(pi_m, cl_m, pi, pos, cl_u) == 0 )
       return dclDestroy(cl_u), 0;
   }
@@ -5441,20 +5458,134 @@ int dclIrredundantMark(pinfo *pi_m, dclist cl_m, pinfo *pi, dclist cl_pr, int po
   return dclDestroy(cl_u), 1;
 }
 
+int dclIrredundantMark(pinfo *pi_m, dclist cl_m, pinfo *pi, dclist cl_pr, int pos, dclist cl_es, dclist cl_dc)
+{
+  dclClearFlags(cl_pr);   /* obsolete? */
+  dclSetFlag(cl_pr, pos); /* obsolete? */
+  return dcl_irredundant_mark(pi_m, cl_m, pi, cl_pr, pos, cl_es, cl_dc);
+}
+
 /*-- dclIrredundantMatrix ---------------------------------------------------*/
 
 
 /*-- dclIrredundantDCubeMatrix ----------------------------------------------*/
 
+/*
+  The rows for each prime are independent of each other: With more
+  than one thread, each prime gets its own row list, which is calculated
+  with a thread local copy of pi and pi_m (tmp and stack cubes, cache).
+  The lists are merged in the order of the primes, so the result
+  is the same as for the sequential calculation.
+*/
+
+struct _dcl_irr_th_struct
+{
+  pinfo pi;
+  pinfo pi_m;
+};
+
+struct _dcl_irr_struct
+{
+  pinfo *pi;
+  struct _dcl_irr_th_struct *th;
+  dclist *cl_m_list;
+  dclist cl_es;
+  dclist cl_pr;
+  dclist cl_dc;
+};
+
+static int dcl_irredundant_mark_th(void *data, int th, int pos)
+{
+  struct _dcl_irr_struct *d = (struct _dcl_irr_struct *)data;
+  /* progress output is not thread safe, only the calling thread reports */
+  if ( th == 0 )
+    pinfoProcedureDo(d->pi, pos);
+  dclClearFlags(d->cl_m_list[pos]);
+  return dcl_irredundant_mark(&(d->th[th].pi_m), d->cl_m_list[pos], 
+    &(d->th[th].pi), d->cl_pr, pos, d->cl_es, d->cl_dc);
+}
+
+static int dclIrredundantDCubeMatrixThreads(pinfo *pi_m, dclist cl_m, pinfo *pi, dclist cl_es, dclist cl_pr, dclist cl_dc, int thread_cnt)
+{
+  struct _dcl_irr_struct d;
+  int i, j, th_cnt, list_cnt, cnt = dclCnt(cl_pr);
+  int is_ok = 0;
+
+  d.pi = pi;
+  d.cl_es = cl_es;
+  d.cl_pr = cl_pr;
+  d.cl_dc = cl_dc;
+  d.th = (struct _dcl_irr_th_struct *)malloc(thread_cnt*sizeof(struct _dcl_irr_th_struct));
+  if ( d.th == NULL )
+    return 0;
+  d.cl_m_list = (dclist *)malloc(cnt*sizeof(dclist));
+  if ( d.cl_m_list == NULL )
+    return free(d.th), 0;
+
+  for( list_cnt = 0; list_cnt < cnt; list_cnt++ )
+    if ( dclInit(d.cl_m_list+list_cnt) == 0 )
+      break;
+  for( th_cnt = 0; th_cnt < thread_cnt && list_cnt >= cnt; th_cnt++ )
+  {
+    if ( pinfoInitInOut(&(d.th[th_cnt].pi), pi->in_cnt, pi->out_cnt) == 0 )
+      break;
+    if ( pinfoInitInOut(&(d.th[th_cnt].pi_m), pi_m->in_cnt, pi_m->out_cnt) == 0 )
+    {
+      pinfoDestroy(&(d.th[th_cnt].pi));
+      break;
+    }
+  }
+
+  if ( list_cnt >= cnt && th_cnt >= thread_cnt )
+  {
+    if ( b_th_Do(thread_cnt, cnt, dcl_irredundant_mark_th, &d) != 0 )
+    {
+      is_ok = 1;
+      for( i = 0; i < cnt && is_ok != 0; i++ )
+        for( j = 0; j < dclCnt(d.cl_m_list[i]); j++ )
+          if ( dclSCCInvAddAndSetFlag(pi_m, cl_m, dclGet(d.cl_m_list[i], j)) == 0 )
+          {
+            is_ok = 0;
+            break;
+          }
+    }
+  }
+
+  while( th_cnt > 0 )
+  {
+    th_cnt--;
+    pinfoDestroy(&(d.th[th_cnt].pi_m));
+    pinfoDestroy(&(d.th[th_cnt].pi));
+  }
+  while( list_cnt > 0 )
+  {
+    list_cnt--;
+    dclDestroy(d.cl_m_list[list_cnt]);
+  }
+  free(d.cl_m_list);
+  free(d.th);
+  return is_ok;
+}
+
 /* diese routine erfordert vorher ZWINGEND den aufruf von dclSplitRelativeEssential */
 /* cl_pr darf keine relativ essentiellen cubes enthalten */
 int dclIrredundantDCubeMatrix(pinfo *pi_m, dclist cl_m, pinfo *pi, dclist cl_es, dclist cl_pr, dclist cl_dc)
 {
   int i, cnt = dclCnt(cl_pr);
+  int thread_cnt;
   if ( dclSetPinfoByLength(pi_m, cl_pr) == 0 )
     return 0;
   dclClear(cl_m);
   dclClearFlags(cl_m);
+  thread_cnt = b_th_GetCnt(0, cnt);
+  if ( thread_cnt > 1 )
+  {
+    pinfoProcedureInit(pi, "IrredundantDCubeMatrix", cnt);
+    if ( dclIrredundantDCubeMatrixThreads(pi_m, cl_m, pi, cl_es, cl_pr, cl_dc, thread_cnt) == 0 )
+      return pinfoProcedureFinish(pi), 0;
+    dclDeleteCubesWithFlag(pi_m, cl_m);
+    return pinfoProcedureFinish(pi), 1;
+  }
   pinfoProcedureInit(pi, "IrredundantDCubeMatrix", cnt);
   for(i = 0; i < cnt; i++ )
   {
@@ -5796,45 +5927,13 @@ int dclMinimize(pinfo *pi, dclist cl)
 /* cl and cl_dc should be disjunct! */
 /* dclSubtract(pi, cl, cl_dc) or dclSubtract(pi, cl_dc, cl) would force this */
 
-/*!
-  \ingroup dclist
-  
-  The representation of a boolean function contains three parts:
-  -# The problem info structure.
-  -# The ON-set of the boolean function (\a cl).
-  -# An optional DC (don't care) Set of the boolean function (\a cl_dc).
-
-  This function tries to reduce the number of cubes that are stored in \a cl.
-  One often assumes that the area of a hardware implementation of boolean 
-  functions decreases with the number of cubes. So it is often
-  a good idea to call this function before hardware synthesis (gnc_SynthDCL()).
-  
-  
-  \pre \a cl and \a cl_dc must be disjunct, they must have 
-  an empty intersection. This condition can be forced with
-  dclSubtract(pi, cl, cl_dc) or dclSubtract(pi, cl_dc, cl).
-  
-  \post \a cl and \a cl_dc are not disjunct any more. After a successful
-  minimization, \a cl and \a cl_dc may have a nonempty intersection.
-
-  \param pi The problem info structure for the boolean functions.
-  \param cl The ON-set of the boolean function. This argument will be modified
-    by dclMinimizeDC().
-  \param cl_dc The DC-set of the boolean function. Set this argument to \c NULL if there
-    is not DC-set.
-  \param greedy Use the recommended value 0 for an exact minimzation.
-
-  \return 0, if an error occured.
-  
-  \warning This function may take a very long time.
-  
-  \see gnc_SynthDCL()
-  \see dclImport()
-  
-*/
-int dclMinimizeDC(pinfo *pi, dclist cl, dclist cl_dc, int greedy, int is_literal)
+static int dcl_minimize_dc(pinfo *pi, dclist cl, dclist cl_dc, int greedy, int is_literal)
 {
   dclist cl_es, cl_fr, cl_pr, cl_on;
+  
+  if ( (greedy & DCL_MIN_IMPLICIT) != 0 )
+    return dclMinimizeDCWithZDD(pi, cl, cl_dc, greedy, is_literal);
+  
   dclInitVA(4, &cl_es, &cl_fr, &cl_pr, &cl_on);
   
   if ( dclCopy(pi, cl_on, cl) == 0 )
@@ -5879,6 +5978,60 @@ int dclMinimizeDC(pinfo *pi, dclist cl, dclist cl_dc, int greedy, int is_literal
 
 }
 
+/*!
+  \ingroup dclist
+  
+  The representation of a boolean function contains three parts:
+  -# The problem info structure.
+  -# The ON-set of the boolean function (\a cl).
+  -# An optional DC (don't care) Set of the boolean function (\a cl_dc).
+
+  This function tries to reduce the number of cubes that are stored in \a cl.
+  One often assumes that the area of a hardware implementation of boolean 
+  functions decreases with the number of cubes. So it is often
+  a good idea to call this function before hardware synthesis (gnc_SynthDCL()).
+  
+  
+  \pre \a cl and \a cl_dc must be disjunct, they must have 
+  an empty intersection. This condition can be forced with
+  dclSubtract(pi, cl, cl_dc) or dclSubtract(pi, cl_dc, cl).
+  
+  \post \a cl and \a cl_dc are not disjunct any more. After a successful
+  minimization, \a cl and \a cl_dc may have a nonempty intersection.
+
+  \param pi The problem info structure for the boolean functions.
+  \param cl The ON-set of the boolean function. This argument will be modified
+    by dclMinimizeDC().
+  \param cl_dc The DC-set of the boolean function. Set this argument to \c NULL if there
+    is not DC-set.
+  \param greedy Use the recommended value 0 (DCL_MIN_EXACT) for an exact minimzation.
+    DCL_MIN_GREEDY selects the heuristic cover algorithm. Add DCL_MIN_IMPLICIT
+    to calculate primes and the cyclic core with decision diagrams 
+    (dclMinimizeDCWithZDD()).
+
+  \return 0, if an error occured.
+  
+  \warning This function may take a very long time.
+  
+  \see gnc_SynthDCL()
+  \see dclImport()
+  
+*/
+int dclMinimizeDC(pinfo *pi, dclist cl, dclist cl_dc, int greedy, int is_literal)
+{
+  int result;
+  b_stat_type stat = b_stat_Start("minimize");
+  b_stat_Add(stat, "in_cnt", pi->in_cnt);
+  b_stat_Add(stat, "out_cnt", pi->out_cnt);
+  b_stat_Add(stat, "in", dclCnt(cl));
+  b_stat_Add(stat, "dc", cl_dc == NULL ? 0 : dclCnt(cl_dc));
+  result = dcl_minimize_dc(pi, cl, cl_dc, greedy, is_literal);
+  b_stat_Add(stat, "out", dclCnt(cl));
+  b_stat_Add(stat, "result", result);
+  b_stat_Finish(stat);
+  return result;
+}
+
 /*-- dclWriteBin ------------------------------------------------------------*/
 
 int dclWriteBin(pinfo *pi, dclist cl, FILE *fp)
@@ -252,6 +252,10 @@ int   dcReadBin            (pinfo *pi, dcube *c, FILE *fp);
    void  dclRestrictOutput     (pinfo *pi, dclist cl);
    int   dclMinimize           (pinfo *pi, dclist cl);
    int   dclMinimizeDC         (pinfo *pi, dclist cl, dclist cl_dc, int greedy, int is_literal);
+/* values for the 'greedy' argument of dclMinimizeDC */
+#define DCL_MIN_EXACT 0
+#define DCL_MIN_GREEDY 1
+#define DCL_MIN_IMPLICIT 2
    int   dclWriteBin           (pinfo *pi, dclist cl, FILE *fp);
    int   dclReadBin            (pinfo *pi, dclist *cl, FILE *fp);
    int   dclGetLiteralCnt      (pinfo *pi, dclist cl);
@@ -325,6 +329,15 @@ int dclHazardAnalysis(pinfo *pi, dclist cl, dcube *start, dcube *end, int out, i
 
 int dclIsHazardfreeTransition(pinfo *pi, dclist cl, dcube *start, dcube *end);
 
+/* 
+  batched versions for the transitions cl_start[i] -> cl_end[i]
+  fn is called with the position i of the transition for each output,
+  calls to fn are serialized (b_th_Lock). thread_cnt: see b_th_Do.
+*/
+int dclHazardAnalysisList(pinfo *pi, dclist cl, dclist cl_start, dclist cl_end, int thread_cnt, int (*fn)(void *data, int pos, dchazard *dch), void *data);
+/* is_hf[i] is set to 1 if dclIsHazardfreeTransition() returns 1 for transition i */
+int dclIsHazardfreeTransitionList(pinfo *pi, dclist cl, dclist cl_start, dclist cl_end, int thread_cnt, char *is_hf);
+
 /* dcex.c */
 int dclReadBEXStr(pinfo *pi, dclist cl_on, dclist cl_dc, const char *content);
 int dclReadBEX(pinfo *pi, dclist cl_on, dclist cl_dc, const char *filename);
@@ -341,7 +354,11 @@ int IsValidNEXFile(const char *filename);
 int dclBCP(pinfo *pi, dclist cl_es, dclist cl_pr, dclist cl_dc);
 int dclMinimizeDCWithBCP(pinfo *pi, dclist cl, dclist cl_dc);
 
+/* dcubezdd.c */
+int dclMinimizeDCWithZDD(pinfo *pi, dclist cl, dclist cl_dc, int greedy, int is_literal);
+
 /* dcubeustt.h */
+#define USTT_PRIME_LIMIT 20000L
 int dclPrimesUSTT(pinfo *pi, dclist cl);
 int dclMinimizeUSTT(pinfo *pi, dclist cl, void (*msg)(void *data, char *fmt, va_list va), void *data, const char *pre, const char *primes_file);
 
@@ -31,6 +31,7 @@
 #include "dcube.h"
 #include "dcubehf.h"
 #include "matrix.h"
+#include "b_th.h"
 
 #include "mwc.h"
 
@@ -91,24 +92,18 @@ int dclHazardAnalysisOut(pinfo *pi, dclist cl, dcube *start, dcube *end, int out
 
   if ( dch.f_start != 0 && dch.f_end != 0 )
   {
-    if ( dcIsIllegal(pi, r) != 0 )
+    /* r does not matter, m must be covered by one element */
+    for( i = 0; i < cnt; i++ )
+      if ( dcIsSubSet(pi, dclGet(cl, i), m) != 0 )
+        break;
+    if ( i >= cnt )
     {
-      dch.msg = DCH_MSG_ERROR_NOT_UNATE;
+      dch.msg = DCH_MSG_ERROR_SUPER_NOT_SUBSET;
     }
     else
     {
-      for( i = 0; i < cnt; i++ )
-        if ( dcIsSubSet(pi, dclGet(cl, i), m) != 0 )
-          break;
-      if ( i >= cnt )
-      {
-        dch.msg = DCH_MSG_ERROR_SUPER_NOT_SUBSET;
-      }
-      else
-      {
-        dch.is_ok = 1;
-        dch.msg = DCH_MSG_OK_SUPER_IS_SUBSET;
-      }
+      dch.is_ok = 1;
+      dch.msg = DCH_MSG_OK_SUPER_IS_SUBSET;
     }
     return dclDestroyCached(pi, dch.cl_local), fn(data, &dch);
   }
@@ -287,6 +282,376 @@ int dclIsHazardfreeTransition(pinfo *pi, dclist cl, dcube *start, dcube *end)
   return 1;
 }
 
+/*-- dclHazardAnalysisList --------------------------------------------------*/
+
+/*
+  Batched versions of dclHazardAnalysis and dclIsHazardfreeTransition
+  for the transitions cl_start[i] -> cl_end[i]. 
+  An index over the cover is built once: For each input variable there
+  is one bitmap with all cubes of cl, which contain 0 and another one 
+  with all cubes, which contain 1. For each output there is a bitmap
+  with all cubes, where the output is set. The AND of the selected 
+  bitmaps are exactly those cubes, which intersect the super cube of
+  a transition, so all other cubes can be ignored. 
+  The transitions are distributed among the threads (see b_th_Do).
+*/
+
+#define DCH_IDX_BITS 32
+#define dch_idx_map(dl, k) ((dl)->idx+(size_t)(k)*(size_t)(dl)->words)
+#define dch_idx_set(m, j) ((m)[(j)/DCH_IDX_BITS] |= 1U << ((j)%DCH_IDX_BITS))
+
+struct _dch_ws_struct
+{
+  dcube r;
+  dcube m;
+  dcube t;
+  dclist cl_local;
+  unsigned *in_cand;      /* cubes, which intersect the inputs of m */
+  unsigned *cand;         /* in_cand, restricted to one output */
+};
+typedef struct _dch_ws_struct dch_ws;
+
+struct _dch_list_struct
+{
+  pinfo *pi;
+  dclist cl;
+  dclist cl_start;
+  dclist cl_end;
+  int words;
+  unsigned *idx;          /* 2*in_cnt + out_cnt bitmaps */
+  int thread_cnt;
+  dch_ws ws[B_TH_MAX];
+  int (*fn)(void *data, int pos, dchazard *dch);
+  void *data;
+  char *is_hf;
+};
+typedef struct _dch_list_struct dch_list;
+
+static void dch_list_destroy(dch_list *dl)
+{
+  int i;
+  for( i = 0; i < dl->thread_cnt; i++ )
+  {
+    dcDestroyVA(3, &(dl->ws[i].r), &(dl->ws[i].m), &(dl->ws[i].t));
+    dclDestroy(dl->ws[i].cl_local);
+    free(dl->ws[i].in_cand);
+  }
+  if ( dl->idx != NULL )
+    free(dl->idx);
+}
+
+static int dch_list_init(dch_list *dl, pinfo *pi, dclist cl, dclist cl_start, dclist cl_end, int thread_cnt)
+{
+  int map_cnt = 2*pi->in_cnt + pi->out_cnt;
+  int i, j, k, v;
+  dch_ws *ws;
+  
+  dl->pi = pi;
+  dl->cl = cl;
+  dl->cl_start = cl_start;
+  dl->cl_end = cl_end;
+  dl->words = dclCnt(cl)/DCH_IDX_BITS+1;
+  dl->thread_cnt = 0;
+  dl->fn = NULL;
+  dl->data = NULL;
+  dl->is_hf = NULL;
+  dl->idx = (unsigned *)calloc((size_t)map_cnt*(size_t)dl->words+1, sizeof(unsigned));
+  if ( dl->idx == NULL )
+    return 0;
+  
+  for( j = 0; j < dclCnt(cl); j++ )
+  {
+    for( k = 0; k < pi->in_cnt; k++ )
+    {
+      v = dcGetIn(dclGet(cl, j), k);
+      if ( (v & 1) != 0 )
+        dch_idx_set(dch_idx_map(dl, 2*k), j);
+      if ( (v & 2) != 0 )
+        dch_idx_set(dch_idx_map(dl, 2*k+1), j);
+    }
+    for( k = 0; k < pi->out_cnt; k++ )
+      if ( dcGetOut(dclGet(cl, j), k) != 0 )
+        dch_idx_set(dch_idx_map(dl, 2*pi->in_cnt+k), j);
+  }
+
+  thread_cnt = b_th_GetCnt(thread_cnt, dclCnt(cl_start));
+  for( i = 0; i < thread_cnt; i++ )
+  {
+    ws = dl->ws+i;
+    if ( dcInitVA(pi, 3, &(ws->r), &(ws->m), &(ws->t)) == 0 )
+      return dch_list_destroy(dl), 0;
+    if ( dclInit(&(ws->cl_local)) == 0 )
+      return dcDestroyVA(3, &(ws->r), &(ws->m), &(ws->t)), dch_list_destroy(dl), 0;
+    ws->in_cand = (unsigned *)malloc(2*(size_t)dl->words*sizeof(unsigned));
+    if ( ws->in_cand == NULL )
+      return dcDestroyVA(3, &(ws->r), &(ws->m), &(ws->t)), dclDestroy(ws->cl_local), dch_list_destroy(dl), 0;
+    ws->cand = ws->in_cand + dl->words;
+    dl->thread_cnt++;
+  }
+  return 1;
+}
+
+/* m = super cube of transition pos, in_cand = cubes, which intersect m */
+static void dch_set_super(dch_list *dl, dch_ws *ws, int pos)
+{
+  pinfo *pi = dl->pi;
+  int i, k, v;
+  unsigned *m;
+  
+  dcOr(pi, &(ws->m), dclGet(dl->cl_start, pos), dclGet(dl->cl_end, pos));
+  dcOutSetAll(pi, &(ws->m), 0);
+  for( i = 0; i < dl->words; i++ )
+    ws->in_cand[i] = ~0U;
+  for( k = 0; k < pi->in_cnt; k++ )
+  {
+    v = dcGetIn(&(ws->m), k);
+    if ( v == 3 )
+      continue;
+    if ( v == 0 )
+    {
+      for( i = 0; i < dl->words; i++ )
+        ws->in_cand[i] = 0;
+      break;
+    }
+    m = dch_idx_map(dl, 2*k + (v == 2 ? 1 : 0));
+    for( i = 0; i < dl->words; i++ )
+      ws->in_cand[i] &= m[i];
+  }
+}
+
+/* restricts m and the candidates to output 'out' */
+static void dch_set_out(dch_list *dl, dch_ws *ws, int out)
+{
+  unsigned *m = dch_idx_map(dl, 2*dl->pi->in_cnt+out);
+  int i;
+  dcOutSetAll(dl->pi, &(ws->m), 0);
+  dcSetOut(&(ws->m), out, 1);
+  for( i = 0; i < dl->words; i++ )
+    ws->cand[i] = ws->in_cand[i] & m[i];
+}
+
+/* loop over the candidates, *pos must be initialized with -1 */
+static int dch_while_loop(dch_list *dl, unsigned *cand, int *pos)
+{
+  int j = *pos+1;
+  int cnt = dclCnt(dl->cl);
+  unsigned w;
+  while( j < cnt )
+  {
+    w = cand[j/DCH_IDX_BITS] >> (j%DCH_IDX_BITS);
+    if ( w == 0 )
+    {
+      j = (j/DCH_IDX_BITS+1)*DCH_IDX_BITS;
+      continue;
+    }
+    while( (w & 1U) == 0 )
+      w >>= 1, j++;
+    if ( j >= cnt )
+      break;
+    *pos = j;
+    return 1;
+  }
+  *pos = -1;
+  return 0;
+}
+
+/* f_start and f_end (see dclHazardAnalysisOut) */
+static void dch_get_f(dch_list *dl, dch_ws *ws, int pos, int *f_start, int *f_end)
+{
+  pinfo *pi = dl->pi;
+  int j = -1;
+  *f_start = 0;
+  *f_end = 0;
+  while( dch_while_loop(dl, ws->cand, &j) != 0 )
+  {
+    if ( dcIsInSubSet(pi, dclGet(dl->cl, j), dclGet(dl->cl_start, pos)) != 0 )
+      *f_start = 1;
+    if ( dcIsInSubSet(pi, dclGet(dl->cl, j), dclGet(dl->cl_end, pos)) != 0 )
+      *f_end = 1;
+  }
+}
+
+/* same as dclHazardAnalysisOut(), m and cand must be set */
+static int dch_analysis_out(dch_list *dl, dch_ws *ws, int pos, int out, dchazard *dch)
+{
+  pinfo *pi = dl->pi;
+  dcube *r = &(ws->r);
+  int j;
+  
+  dch->inter     = r;
+  dch->super     = &(ws->m);
+  dch->cl        = dl->cl;
+  dch->start     = dclGet(dl->cl_start, pos);
+  dch->end       = dclGet(dl->cl_end, pos);
+  dch->out       = out;
+  dch->is_ok     = 0;
+  dch->cl_local  = ws->cl_local;
+
+  dclClear(ws->cl_local);
+  dcSetTautology(pi, r);
+  j = -1;
+  while( dch_while_loop(dl, ws->cand, &j) != 0 )
+  {
+    if ( dcIntersection(pi, &(ws->t), dclGet(dl->cl, j), &(ws->m)) != 0 )
+    {
+      if ( dclAdd(pi, ws->cl_local, &(ws->t)) < 0 )
+        return 0;
+      dcAnd(pi, r, r, &(ws->t));
+    }
+  }
+
+  dch_get_f(dl, ws, pos, &(dch->f_start), &(dch->f_end));
+  dch->type = (dch->f_start<<1)|dch->f_end;
+
+  if ( dch->f_start != 0 && dch->f_end != 0 )
+  {
+    dch->msg = DCH_MSG_ERROR_SUPER_NOT_SUBSET;
+    j = -1;
+    while( dch_while_loop(dl, ws->cand, &j) != 0 )
+      if ( dcIsSubSet(pi, dclGet(dl->cl, j), &(ws->m)) != 0 )
+      {
+        dch->is_ok = 1;
+        dch->msg = DCH_MSG_OK_SUPER_IS_SUBSET;
+        break;
+      }
+  }
+  else if ( dch->f_start != 0 || dch->f_end != 0 )
+  {
+    dcube *c = dch->f_start != 0 ? dch->start : dch->end;
+    if ( dcIsIllegal(pi, r) != 0 )
+      dch->msg = DCH_MSG_ERROR_NOT_UNATE;
+    else if ( dcIsInSubSet(pi, r, c) == 0 )
+      dch->msg = dch->f_start != 0 ? 
+        DCH_MSG_ERROR_START_NOT_COVERED : DCH_MSG_ERROR_END_NOT_COVERED;
+    else
+    {
+      dch->is_ok = 1;
+      dch->msg = dch->f_start != 0 ? 
+        DCH_MSG_OK_START_IS_COVERED : DCH_MSG_OK_END_IS_COVERED;
+    }
+  }
+  else
+  {
+    /* both output values are zero, there must be no intersection with m */
+    j = -1;
+    if ( dch_while_loop(dl, ws->cand, &j) != 0 )
+      dch->msg = DCH_MSG_ERROR_SUPER_HAS_INTERSECTION;
+    else
+    {
+      dch->is_ok = 1;
+      dch->msg = DCH_MSG_OK_SUPER_HAS_NO_INTERSECTION;
+    }
+  }
+  return 1;
+}
+
+/* same as dclIsHazardfreeFunction(), m and cand must be set */
+static int dch_is_hazardfree_out(dch_list *dl, dch_ws *ws, int pos)
+{
+  pinfo *pi = dl->pi;
+  dcube *r = &(ws->r);
+  int j;
+  int f_start, f_end;
+
+  dcSetTautology(pi, r);
+  j = -1;
+  while( dch_while_loop(dl, ws->cand, &j) != 0 )
+    dcAnd(pi, r, r, dclGet(dl->cl, j));
+
+  dch_get_f(dl, ws, pos, &f_start, &f_end);
+  
+  if ( f_start != 0 && f_end != 0 )
+  {
+    j = -1;
+    while( dch_while_loop(dl, ws->cand, &j) != 0 )
+      if ( dcIsSubSet(pi, dclGet(dl->cl, j), &(ws->m)) != 0 )
+        return 1;
+    return 0;
+  }
+  else if ( f_start != 0 )
+  {
+    if ( dcIsIllegal(pi, r) != 0 )
+      return 0;
+    return dcIsInSubSet(pi, r, dclGet(dl->cl_start, pos));
+  }
+  else if ( f_end != 0 )
+  {
+    if ( dcIsIllegal(pi, r) != 0 )
+      return 0;
+    return dcIsInSubSet(pi, r, dclGet(dl->cl_end, pos));
+  }
+  return 1;
+}
+
+static int dch_analysis_th(void *data, int th, int pos)
+{
+  dch_list *dl = (dch_list *)data;
+  dch_ws *ws = dl->ws+th;
+  dchazard dch;
+  int out, ret;
+  
+  dch_set_super(dl, ws, pos);
+  for( out = 0; out < dl->pi->out_cnt; out++ )
+  {
+    dch_set_out(dl, ws, out);
+    if ( dch_analysis_out(dl, ws, pos, out, &dch) == 0 )
+      return 0;
+    b_th_Lock();
+    ret = dl->fn(dl->data, pos, &dch);
+    b_th_Unlock();
+    if ( ret == 0 )
+      return 0;
+  }
+  return 1;
+}
+
+static int dch_is_hazardfree_th(void *data, int th, int pos)
+{
+  dch_list *dl = (dch_list *)data;
+  dch_ws *ws = dl->ws+th;
+  int out;
+  
+  dl->is_hf[pos] = 1;
+  dch_set_super(dl, ws, pos);
+  for( out = 0; out < dl->pi->out_cnt; out++ )
+  {
+    dch_set_out(dl, ws, out);
+    if ( dch_is_hazardfree_out(dl, ws, pos) == 0 )
+    {
+      dl->is_hf[pos] = 0;
+      break;
+    }
+  }
+  return 1;
+}
+
+int dclHazardAnalysisList(pinfo *pi, dclist cl, dclist cl_start, dclist cl_end, int thread_cnt, int (*fn)(void *data, int pos, dchazard *dch), void *data)
+{
+  dch_list dl;
+  int ret;
+  assert(dclCnt(cl_start) == dclCnt(cl_end));
+  if ( dch_list_init(&dl, pi, cl, cl_start, cl_end, thread_cnt) == 0 )
+    return 0;
+  dl.fn = fn;
+  dl.data = data;
+  ret = b_th_Do(dl.thread_cnt, dclCnt(cl_start), dch_analysis_th, &dl);
+  dch_list_destroy(&dl);
+  return ret;
+}
+
+int dclIsHazardfreeTransitionList(pinfo *pi, dclist cl, dclist cl_start, dclist cl_end, int thread_cnt, char *is_hf)
+{
+  dch_list dl;
+  int ret;
+  assert(dclCnt(cl_start) == dclCnt(cl_end));
+  if ( dch_list_init(&dl, pi, cl, cl_start, cl_end, thread_cnt) == 0 )
+    return 0;
+  dl.is_hf = is_hf;
+  ret = b_th_Do(dl.thread_cnt, dclCnt(cl_start), dch_is_hazardfree_th, &dl);
+  dch_list_destroy(&dl);
+  return ret;
+}
+
 
 /*---------------------------------------------------------------------------*/
 
@@ -330,6 +695,9 @@ hfp_type hfp_Open(int in, int out)
     hfp->log_fn = hfp_dummy_cb;
     hfp->err_data = NULL;
     hfp->err_fn = hfp_dummy_cb;
+    hfp->idx_max = -1;
+    hfp->idx_words = 0;
+    hfp->idx = NULL;
     hfp->pi = pinfoOpenInOut(in, out);
     if ( hfp->pi != NULL )
     {
@@ -379,6 +747,8 @@ void hfp_Close(hfp_type hfp)
   
   dclDestroyVA(4, hfp->cl_req_on, hfp->cl_req_off, hfp->cl_on, hfp->cl_dc);
   b_set_Close(hfp->pclist);
+  if ( hfp->idx != NULL )
+    free(hfp->idx);
   pinfoClose(hfp->pi);
   free(hfp);
 }
@@ -423,6 +793,7 @@ void hfp_Error(hfp_type hfp, const char *fmt, ...)
 
 int hfp_AddPC(hfp_type hfp, pcube *pc)
 {
+  hfp->idx_max = -1;
   return b_set_Add(hfp->pclist, pc);
 }
 
@@ -695,25 +1066,171 @@ int hfp_IsIllegalIntersection(hfp_type hfp, dcube *c, int pc_id)
   return 1;
 }
 
+/*---------------------------------------------------------------------------*/
+/* 
+  Index over the transition cubes of pclist: For each input variable
+  there is one bitmap with all privileged cubes, where the variable 
+  of tc contains 0 and another bitmap where it contains 1. For each 
+  output there is a bitmap with the privileged cubes, where the output 
+  of tc is set. A cube c can only intersect the transition cubes of the 
+  AND of the bitmaps selected by the specified variables of c.
+  The index is built again after hfp_AddPC().
+*/
+
+#define HFP_IDX_BITS 32
+#define hfp_idx_map(hfp, k) ((hfp)->idx+(size_t)(k)*(size_t)(hfp)->idx_words)
+#define hfp_idx_set(m, j) ((m)[(j)/HFP_IDX_BITS] |= 1U << ((j)%HFP_IDX_BITS))
+
+static int hfp_build_index(hfp_type hfp)
+{
+  pinfo *pi = hfp->pi;
+  int map_cnt = 2*pi->in_cnt + pi->out_cnt;
+  int words = b_set_Max(hfp->pclist)/HFP_IDX_BITS+1;
+  int j, k, v;
+  dcube *tc;
+  
+  if ( hfp->idx_max >= 0 )
+    return 1;
+  
+  if ( hfp->idx != NULL )
+    free(hfp->idx);
+  hfp->idx_words = words;
+  hfp->idx = (unsigned *)calloc((size_t)map_cnt*(size_t)words, sizeof(unsigned));
+  if ( hfp->idx == NULL )
+    return 0;
+  
+  j = -1;
+  while( b_set_WhileLoop(hfp->pclist, &j) != 0 )
+  {
+    tc = &(hfp_GetPC(hfp, j)->tc);
+    for( k = 0; k < pi->in_cnt; k++ )
+    {
+      v = dcGetIn(tc, k);
+      if ( (v & 1) != 0 )
+        hfp_idx_set(hfp_idx_map(hfp, 2*k), j);
+      if ( (v & 2) != 0 )
+        hfp_idx_set(hfp_idx_map(hfp, 2*k+1), j);
+    }
+    for( k = 0; k < pi->out_cnt; k++ )
+      if ( dcGetOut(tc, k) != 0 )
+        hfp_idx_set(hfp_idx_map(hfp, 2*pi->in_cnt+k), j);
+  }
+  hfp->idx_max = b_set_Max(hfp->pclist);
+  return 1;
+}
+
+/* bitmap for hfp_get_candidates(), must be released with free() */
+static unsigned *hfp_open_candidates(hfp_type hfp)
+{
+  return (unsigned *)malloc(sizeof(unsigned)*hfp->idx_words);
+}
+
+/* 
+  Calculates the bitmap of all privileged cubes, whose transition cube 
+  might intersect with c. The bitmap is stored in cand (see
+  hfp_open_candidates()), cand is returned.
+*/
+static unsigned *hfp_get_candidates(hfp_type hfp, dcube *c, unsigned *cand)
+{
+  pinfo *pi = hfp->pi;
+  int words = hfp->idx_words;
+  unsigned *m;
+  int i, k, v;
+  
+  if ( pi->out_cnt > 0 )
+  {
+    for( i = 0; i < words; i++ )
+      cand[i] = 0;
+    for( k = 0; k < pi->out_cnt; k++ )
+      if ( dcGetOut(c, k) != 0 )
+      {
+        m = hfp_idx_map(hfp, 2*pi->in_cnt+k);
+        for( i = 0; i < words; i++ )
+          cand[i] |= m[i];
+      }
+  }
+  else
+  {
+    for( i = 0; i < words; i++ )
+      cand[i] = ~0U;
+  }
+  
+  for( k = 0; k < pi->in_cnt; k++ )
+  {
+    v = dcGetIn(c, k);
+    if ( v == 3 )
+      continue;
+    if ( v == 0 )
+    {
+      for( i = 0; i < words; i++ )
+        cand[i] = 0;
+      break;
+    }
+    m = hfp_idx_map(hfp, 2*k + (v == 2 ? 1 : 0));
+    for( i = 0; i < words; i++ )
+      cand[i] &= m[i];
+  }
+  return cand;
+}
+
+/* 
+  Same as the loop over all elements of pclist, but only the candidates 
+  of the index are returned. *pos must be initialized with -1.
+*/
+static int hfp_candidate_while_loop(hfp_type hfp, unsigned *cand, int *pos)
+{
+  int j = *pos+1;
+  unsigned w;
+  while( j < hfp->idx_max )
+  {
+    w = cand[j/HFP_IDX_BITS] >> (j%HFP_IDX_BITS);
+    if ( w == 0 )
+    {
+      j = (j/HFP_IDX_BITS+1)*HFP_IDX_BITS;
+      continue;
+    }
+    while( (w & 1U) == 0 )
+      w >>= 1, j++;
+    if ( b_set_Get(hfp->pclist, j) != NULL )
+    {
+      *pos = j;
+      return 1;
+    }
+    j++;
+  }
+  *pos = -1;
+  return 0;
+}
+
 int hfp_CheckReqCube(hfp_type hfp)
 {
   int i, j;
+  unsigned *cand;
+  
+  if ( hfp_build_index(hfp) == 0 )
+    return 0;
+  cand = hfp_open_candidates(hfp);
+  if ( cand == NULL )
+    return 0;
+  
   for(i = 0; i < dclCnt(hfp->cl_req_on); i++ )
   {
+    hfp_get_candidates(hfp, dclGet(hfp->cl_req_on, i), cand);
     j = -1;
-    while( b_set_WhileLoop(hfp->pclist, &j) != 0 )
+    while( hfp_candidate_while_loop(hfp, cand, &j) != 0 )
       if ( hfp_IsIllegalIntersection(hfp, dclGet(hfp->cl_req_on, i), j) != 0 )
       {
         hfp_Log(hfp, "HFP: req on  %s", dcToStr(hfp->pi, dclGet(hfp->cl_req_on, i) , " ",""));
         hfp_Log(hfp, "HFP: tc      %s", dcToStr(hfp->pi, &(hfp_GetPC(hfp, j)->tc) , " ",""));
         hfp_Log(hfp, "HFP: sc      %s", dcToStr(hfp->pi, &(hfp_GetPC(hfp, j)->sc) , " ",""));
-        return 0;
+        return free(cand), 0;
       }
   }  
   for(i = 0; i < dclCnt(hfp->cl_req_off); i++ )
   {
+    hfp_get_candidates(hfp, dclGet(hfp->cl_req_off, i), cand);
     j = -1;
-    while( b_set_WhileLoop(hfp->pclist, &j) != 0 )
+    while( hfp_candidate_while_loop(hfp, cand, &j) != 0 )
       if ( hfp_IsIllegalIntersection(hfp, dclGet(hfp->cl_req_off, i), j) != 0 )
       {
         hfp_Log(hfp, "HFP: req off %s", 
@@ -725,6 +1242,7 @@ int hfp_CheckReqCube(hfp_type hfp)
 */
       }
   }  
+  free(cand);
   return 1;
 }
 
@@ -734,17 +1252,24 @@ int hfp_ToDHF(hfp_type hfp)
   int is_any_illegal_intersection;
   dcube *c = &(hfp->pi->tmp[10]);
   pcube *pc;
+  unsigned *cand;
   
   dclist cl; /* result */
   
-  if ( dclInit(&cl) == 0 )
+  if ( hfp_build_index(hfp) == 0 )
     return 0;
+  cand = hfp_open_candidates(hfp);
+  if ( cand == NULL )
+    return 0;
+  
+  if ( dclInit(&cl) == 0 )
+    return free(cand), 0;
   
   if ( dclClearFlags(hfp->cl_on) == 0 )
-    return dclDestroy(cl), 0;
+    return free(cand), dclDestroy(cl), 0;
 
   if ( dclClearFlags(cl) == 0 )
-    return dclDestroy(cl), 0;
+    return free(cand), dclDestroy(cl), 0;
 
   hfp_Log(hfp, "HFP: Privileged cubes: %d", b_set_Cnt(hfp->pclist));
 
@@ -756,14 +1281,15 @@ int hfp_ToDHF(hfp_type hfp)
     dclDeleteCube(hfp->pi, hfp->cl_on, dclCnt(hfp->cl_on)-1);
     
     is_any_illegal_intersection = 0;
+    hfp_get_candidates(hfp, c, cand);
     j = -1;
-    while( b_set_WhileLoop(hfp->pclist, &j) != 0 )
+    while( hfp_candidate_while_loop(hfp, cand, &j) != 0 )
     { 
       if ( hfp_IsIllegalIntersection(hfp, c, j) != 0 )
       {
         pc = hfp_GetPC(hfp, j);
         if ( dclSCCSharpAndSetFlag(hfp->pi, hfp->cl_on, c, &(pc->tc)) == 0 )
-          return dclDestroy(cl), 0;
+          return free(cand), dclDestroy(cl), 0;
         dclDeleteCubesWithFlag(hfp->pi, hfp->cl_on);
         is_any_illegal_intersection = 1;
       }        
@@ -771,15 +1297,15 @@ int hfp_ToDHF(hfp_type hfp)
     if ( is_any_illegal_intersection == 0 )
     {
       if ( dclSCCAddAndSetFlag(hfp->pi, cl, c) == 0 )
-        return dclDestroy(cl), 0;
+        return free(cand), dclDestroy(cl), 0;
       dclDeleteCubesWithFlag(hfp->pi, cl);
     }
   }
   
   if ( dclCopy(hfp->pi, hfp->cl_on, cl) == 0 )
-    return dclDestroy(cl), 0;
+    return free(cand), dclDestroy(cl), 0;
     
-  return dclDestroy(cl), 1;
+  return free(cand), dclDestroy(cl), 1;
 }
 
 static int dclMergeEqualIn(pinfo *pi, dclist cl)
@@ -957,3 +1483,245 @@ int hfp_Minimize(hfp_type hfp, int is_greedy, int is_literal)
 
 
 
+
+/*---------------------------------------------------------------------------*/
+/*
+  Direct calculation of the dhf-primes (hfp_MinimizeDHF)
+  
+  A cube is a dhf-implicant, if it does not intersect the off-set
+  (cl_req_off) and if there is no illegal intersection with a 
+  privileged cube. A hazardfree cover only requires those dhf-primes, 
+  which contain at least one of the required cubes. For each required 
+  cube these dhf-primes are calculated by raising the input variables
+  and the outputs: An illegal intersection with a privileged cube is 
+  removed during the expansion by adding the start cube (supercube). 
+  A variable can not be raised, if this leads into the off-set. 
+  Because the expansion is monotone, this finds all dhf-primes, which 
+  contain the required cube. A greedy expansion is used if more than
+  HFP_DHF_NODE_LIMIT expansion steps are required.
+*/
+
+struct _hfp_dhf_struct
+{
+  hfp_type hfp;
+  int var_cnt;      /* inputs and outputs */
+  dclist cl_stack;  /* one cube for each variable and two temp. cubes */
+  dclist cl_pr;     /* result: dhf-primes */
+  unsigned *cand;   /* bitmap for hfp_get_candidates() */
+  long node_cnt;
+};
+typedef struct _hfp_dhf_struct hfp_dhf_struct;
+
+static int hfp_dhf_is_off(hfp_type hfp, dcube *c)
+{
+  int i, cnt = dclCnt(hfp->cl_req_off);
+  for( i = 0; i < cnt; i++ )
+    if ( dcIsDeltaNoneZero(hfp->pi, dclGet(hfp->cl_req_off, i), c) == 0 )
+      return 1;
+  return 0;
+}
+
+/* extends c to a dhf-implicant, returns 0 if this is not possible */
+static int hfp_dhf_closure(hfp_type hfp, dcube *c, unsigned *cand)
+{
+  int j, is_changed;
+  do
+  {
+    if ( hfp_dhf_is_off(hfp, c) != 0 )
+      return 0;
+    is_changed = 0;
+    hfp_get_candidates(hfp, c, cand);
+    j = -1;
+    while( hfp_candidate_while_loop(hfp, cand, &j) != 0 )
+      if ( hfp_IsIllegalIntersection(hfp, c, j) != 0 )
+      {
+        dcOr(hfp->pi, c, c, &(hfp_GetPC(hfp, j)->sc));
+        is_changed = 1;
+      }
+  } while( is_changed != 0 );
+  return 1;
+}
+
+/* variables 0..in_cnt-1 are the inputs, the outputs follow */
+static int hfp_dhf_is_raised(hfp_type hfp, dcube *c, int k)
+{
+  if ( k < hfp->pi->in_cnt )
+    return dcGetIn(c, k) == 3 ? 1 : 0;
+  return dcGetOut(c, k - hfp->pi->in_cnt) != 0 ? 1 : 0;
+}
+
+static int hfp_dhf_raise(hfp_type hfp, dcube *r, dcube *c, int k, unsigned *cand)
+{
+  dcCopy(hfp->pi, r, c);
+  if ( k < hfp->pi->in_cnt )
+    dcSetIn(r, k, 3);
+  else
+    dcSetOut(r, k - hfp->pi->in_cnt, 1);
+  return hfp_dhf_closure(hfp, r, cand);
+}
+
+/* returns 0 (memory error), 1 (ok) or 2 (node limit reached) */
+static int hfp_dhf_expand(hfp_dhf_struct *de, dcube *c, int k)
+{
+  hfp_type hfp = de->hfp;
+  dcube *r;
+  int i, rtc;
+  
+  for(;;)
+  {
+    while( k < de->var_cnt && hfp_dhf_is_raised(hfp, c, k) != 0 )
+      k++;
+    if ( k >= de->var_cnt )
+      break;
+    de->node_cnt++;
+    if ( de->node_cnt > HFP_DHF_NODE_LIMIT )
+      return 2;
+    r = dclGet(de->cl_stack, k);
+    if ( hfp_dhf_raise(hfp, r, c, k, de->cand) != 0 )
+    {
+      rtc = hfp_dhf_expand(de, r, k+1);
+      if ( rtc != 1 )
+        return rtc;
+    }
+    k++;
+  }
+  
+  /* skip c, if one of the fixed variables can be raised */
+  r = dclGet(de->cl_stack, de->var_cnt);
+  for( i = 0; i < de->var_cnt; i++ )
+    if ( hfp_dhf_is_raised(hfp, c, i) == 0 )
+      if ( hfp_dhf_raise(hfp, r, c, i, de->cand) != 0 )
+        return 1;
+  
+  if ( dclSCCAddAndSetFlag(hfp->pi, de->cl_pr, c) == 0 )
+    return 0;
+  return 1;
+}
+
+static int hfp_dhf_greedy(hfp_dhf_struct *de, dcube *c)
+{
+  dcube *r = dclGet(de->cl_stack, de->var_cnt);
+  int k;
+  for( k = 0; k < de->var_cnt; k++ )
+    if ( hfp_dhf_is_raised(de->hfp, c, k) == 0 )
+      if ( hfp_dhf_raise(de->hfp, r, c, k, de->cand) != 0 )
+        dcCopy(de->hfp->pi, c, r);
+  return dclSCCAddAndSetFlag(de->hfp->pi, de->cl_pr, c);
+}
+
+/* 
+  Calculates the dhf-primes, which contain one of the cubes of
+  cl_req_on. Result is stored in cl_pr.
+*/
+static int hfp_DHFPrimes(hfp_type hfp, dclist cl_pr)
+{
+  pinfo *pi = hfp->pi;
+  hfp_dhf_struct de;
+  dcube *c;
+  int i, rtc, greedy_cnt = 0;
+  
+  if ( hfp_build_index(hfp) == 0 )
+    return 0;
+  
+  de.hfp = hfp;
+  de.var_cnt = pi->in_cnt + pi->out_cnt;
+  de.cl_pr = cl_pr;
+  dclRealClear(cl_pr);
+  if ( dclClearFlags(cl_pr) == 0 )
+    return 0;
+  de.cand = hfp_open_candidates(hfp);
+  if ( de.cand == NULL )
+    return 0;
+  if ( dclInit(&(de.cl_stack)) == 0 )
+    return free(de.cand), 0;
+  for( i = 0; i < de.var_cnt+2; i++ )
+    if ( dclAdd(pi, de.cl_stack, &(pi->tmp[0])) < 0 )
+      return free(de.cand), dclDestroy(de.cl_stack), 0;
+  c = dclGet(de.cl_stack, de.var_cnt+1);
+  
+  for( i = 0; i < dclCnt(hfp->cl_req_on); i++ )
+  {
+    dcCopy(pi, c, dclGet(hfp->cl_req_on, i));
+    de.node_cnt = 0;
+    rtc = hfp_dhf_expand(&de, c, 0);
+    if ( rtc == 0 )
+      return free(de.cand), dclDestroy(de.cl_stack), 0;
+    if ( rtc == 2 )
+    {
+      greedy_cnt++;
+      if ( hfp_dhf_greedy(&de, c) == 0 )
+        return free(de.cand), dclDestroy(de.cl_stack), 0;
+    }
+    dclDeleteCubesWithFlag(pi, cl_pr);
+  }
+  
+  if ( greedy_cnt > 0 )
+    hfp_Log(hfp, "HFP: Greedy expansion of %d required cube(s).", greedy_cnt);
+
+  return free(de.cand), dclDestroy(de.cl_stack), 1;
+}
+
+/*
+  Same as hfp_Minimize, but the dhf-primes are calculated directly 
+  (see above) instead of the sharp operation of hfp_ToDHF.
+*/
+int hfp_MinimizeDHF(hfp_type hfp, int is_greedy, int is_literal)
+{
+  pinfo *pi = hfp->pi;
+  dclist cl_es, cl_fr, cl_pr, cl_on;
+  
+  if ( dclInitVA(4, &cl_es, &cl_fr, &cl_pr, &cl_on) == 0 )
+    return 0;
+
+  if ( dclSCC(pi, hfp->cl_req_on) == 0 || dclSCC(pi, hfp->cl_req_off) == 0 )
+    return dclDestroyVA(4, cl_es, cl_fr, cl_pr, cl_on), 0;   
+
+  if ( hfp_CheckReqCube(hfp) == 0 )
+    return dclDestroyVA(4, cl_es, cl_fr, cl_pr, cl_on), 0;   
+
+  hfp_Log(hfp, "HFP: Required on cubes: %d", dclCnt(hfp->cl_req_on));
+  hfp_Log(hfp, "HFP: Required off cubes: %d", dclCnt(hfp->cl_req_off));
+
+  if ( dclSCCUnion(pi, hfp->cl_on, hfp->cl_req_on) == 0 )
+    return dclDestroyVA(4, cl_es, cl_fr, cl_pr, cl_on), 0;   
+  if ( dclCopy(pi, hfp->cl_dc, hfp->cl_on) == 0 )
+    return dclDestroyVA(4, cl_es, cl_fr, cl_pr, cl_on), 0;   
+  if ( dclSCCUnion(pi, hfp->cl_dc, hfp->cl_req_off) == 0 )
+    return dclDestroyVA(4, cl_es, cl_fr, cl_pr, cl_on), 0;   
+  if ( dclMergeEqualIn(pi, hfp->cl_dc) == 0 )
+    return dclDestroyVA(4, cl_es, cl_fr, cl_pr, cl_on), 0;   
+  if ( dclComplement(pi, hfp->cl_dc) == 0 )
+    return dclDestroyVA(4, cl_es, cl_fr, cl_pr, cl_on), 0;   
+  if ( dclCopy(pi, cl_on, hfp->cl_on) == 0 )
+    return dclDestroyVA(4, cl_es, cl_fr, cl_pr, cl_on), 0;   
+
+  hfp_Log(hfp, "HFP: Privileged cubes: %d", b_set_Cnt(hfp->pclist));
+  
+  if ( hfp_DHFPrimes(hfp, hfp->cl_on) == 0 )
+    return dclDestroyVA(4, cl_es, cl_fr, cl_pr, cl_on), 0;   
+
+  hfp_Log(hfp, "HFP: DHF primes: %d", dclCnt(hfp->cl_on));
+
+  if ( dclSplitRelativeEssential(pi, cl_es, cl_fr, cl_pr, hfp->cl_on, hfp->cl_dc, hfp->cl_req_on) == 0 )
+    return dclDestroyVA(4, cl_es, cl_fr, cl_pr, cl_on), 0;
+
+  if ( maMatrixIrredundant(pi, cl_es, cl_pr, hfp->cl_dc, hfp->cl_req_on, is_greedy, 
+         is_literal != 0 ? MA_LIT_SOP : MA_LIT_NONE) == 0 )
+    return dclDestroyVA(4, cl_es, cl_fr, cl_pr, cl_on), 0;
+
+  if ( dclJoin(pi, cl_pr, cl_es) == 0 )
+    return dclDestroyVA(4, cl_es, cl_fr, cl_pr, cl_on), 0;
+    
+  dclRestrictOutput(pi, cl_pr);
+  
+  if( dclIsEquivalentDC(pi, cl_pr, cl_on, hfp->cl_dc) == 0 )
+    return dclDestroyVA(4, cl_es, cl_fr, cl_pr, cl_on), 0;
+    
+  if ( dclCopy(pi, hfp->cl_on, cl_pr) == 0 )
+    return dclDestroyVA(4, cl_es, cl_fr, cl_pr, cl_on), 0;   
+
+  hfp_Log(hfp, "HFP: Selected primes: %d", dclCnt(hfp->cl_on));
+  
+  dclDestroyVA(4, cl_es, cl_fr, cl_pr, cl_on);
+  return 1;
+}
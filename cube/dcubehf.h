@@ -41,6 +41,12 @@ struct _hfp_struct
 {
   pinfo *pi;
   b_set_type pclist;  /* list of privileged cubes */
+  
+  /* index over the transition cubes, see hfp_build_index() */
+  int idx_max;        /* indexed positions of pclist, -1: invalid */
+  int idx_words;      /* unsigned words of one bitmap */
+  unsigned *idx;      /* 2*in_cnt + out_cnt bitmaps */
+  
   dclist cl_req_on;
   dclist cl_req_off;
   dclist cl_dc;
@@ -84,5 +90,9 @@ int hfp_AddFromToTransition(hfp_type hfp, dcube *from, dcube *to);
 
 int hfp_Minimize(hfp_type hfp, int is_greedy, int is_literal);
 
+/* max. number of expansion steps for each required cube */
+#define HFP_DHF_NODE_LIMIT 20000L
+int hfp_MinimizeDHF(hfp_type hfp, int is_greedy, int is_literal);
+
 #endif /* _DCUBEHF_H */
 
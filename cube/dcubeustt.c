@@ -32,6 +32,8 @@
 */
 
 #include <stdarg.h>
+#include <stdlib.h>
+#include <string.h>
 #include <assert.h>
 #include "dcube.h"
 #include "matrix.h"
@@ -62,160 +64,141 @@
 */
 
 #include "dcube.h"
+#include "dich.h"
 #include <assert.h>
 
+/*
+  The prime partitions are calculated with the dichotomy bitsets
+  of dich.c. Both orientations of a partition are valid, only
+  one of them is returned.
+  returns 0 (memory error), 1 (ok) or 2 (limit of USTT_PRIME_LIMIT
+  prime partitions reached)
+*/
 int dclPrimesUSTT(pinfo *pi, dclist cl)
-{ 
-  dcube *cp = &(pi->tmp[1]);
-  int i, cnt = dclCnt(cl);
-  int j;
-  dclist clt;
-
-  /* add inverted cubes */
-  
-  for( i = 0; i < cnt; i++ )
-  {
-    dcCopy(pi, cp, dclGet(cl, i));
-    dcInvIn(pi, cp);
-    if ( dclAdd(pi, cl, cp) < 0 )
-      return 0;
-  }
-  
-  /* calculate prime partitions/dichotimies  */
+{
+  dich_type d;
+  int r;
 
-  if ( dclInit(&clt) == 0 )
+  d = dich_Open(pi->in_cnt);
+  if ( d == NULL )
     return 0;
-  if ( dclCopy(pi, clt, cl) == 0 )
-    return dclDestroy(clt), 0;
-  if ( dclPrimesInv(pi, cl) == 0 )
-    return dclDestroy(clt), 0;
-
-  /* do some verification of the result */
-
-  for( i = 0; i < dclCnt(clt); i++ )
-  {
-    for( j = 0; j < dclCnt(cl); j++ )
-    {
-      if ( dcIsSubSet(pi, dclGet(clt, i), dclGet(cl, j)) != 0 )
-        break;
-    }
-    if ( j >= dclCnt(cl) )
-    {
-      assert(0);
-    }
-  }
-  dclDestroy(clt);
-
-  /* reduce to a unique solution */
-
-  dclClearFlags(cl);
-  for( i = 0; i < dclCnt(cl); i++ )
-  {
-    if ( dclIsFlag(cl, i) == 0 )
-    {
-      dcCopy(pi, cp, dclGet(cl, i));
-      dcInvIn(pi, cp);
-      for( j = i+1; j < dclCnt(cl); j++ )
-      {
-        if ( dclIsFlag(cl, i) == 0 )
-        {
-          if ( dcIsEqual(pi, cp, dclGet(cl, j)) != 0 )
-          {
-            dclSetFlag(cl, j);
-          }
-        }
-      }
-    }
-  }
-  dclDeleteCubesWithFlag(pi, cl);
- 
-  return 1;
+  if ( dich_AddDCL(d, pi, cl) == 0 )
+    return dich_Close(d), 0;
+  r = dich_PrimesUSTT(d, 0, USTT_PRIME_LIMIT);
+  if ( r == 0 )
+    return dich_Close(d), 0;
+  if ( dich_ToDCL(d, pi, cl) == 0 )
+    return dich_Close(d), 0;
+  dich_Close(d);
+  return r;
 }
 
 #include "fsm.h"
 
-static int async_PartitionCoverElement(pinfo *pi_m, dclist cl_m, pinfo *pi, dcube *c, dclist cl_i)
+static void ustt_do_msg(void (*msg)(void *data, char *fmt, va_list va), void *data, char *fmt, ...)
 {
-  int i, cnt = dclCnt(cl_i);
-  dcube *m = &(pi_m->tmp[9]);
-  dcube *cp = &(pi->tmp[1]);
-  dcOutSetAll(pi_m, m, 0);
-  dcInSetAll(pi_m, m, CUBE_IN_MASK_DC);
-  dcCopy(pi, cp, c);
-  dcInvIn(pi, cp);
-  
-  for( i = 0; i < cnt; i++ )
-  {
-    if ( dcIsSubSet(pi, dclGet(cl_i, i), c) != 0 )
-      dcSetOut(m, i, 1);
-    if ( dcIsSubSet(pi, dclGet(cl_i, i), cp) != 0 )
-      dcSetOut(m, i, 1);
-  }
-      
-  if ( dclAdd(pi_m, cl_m, m) < 0 )
-    return 0;
-  return 1;
+  va_list va;
+  va_start(va, fmt);
+  msg(data, fmt, va);
+  va_end(va);
 }
 
-/* no need to transpose! */
-static int async_PartitionDCubeCoverMatrix(pinfo *pi_m, dclist cl_m, pinfo *pi, dclist cl_p, dclist cl_i)
+/* 
+  The partition cover matrix is calculated with the bitsets of dich.c 
+  (dich_OpenCoverMatrix). The primes of the minimal cover are marked
+  in 'sel'.
+*/
+static int async_MinimizeCoverMatrix(dich_type d, dich_type p, char *sel, 
+  void (*msg)(void *data, char *fmt, va_list va), void *data, const char *pre)
 {
-  int i, cnt = dclCnt(cl_p);
-
-  if ( dclSetPinfoByLength(pi_m, cl_i) == 0 )
+  unsigned *m, *col;
+  int words = dich_CoverWords(d);
+  int i, j;
+  pinfo pi_m;
+  dclist cl_m;
+  dcube *c;
+  
+  m = dich_OpenCoverMatrix(d, p, 0);
+  if ( m == NULL )
     return 0;
-
-  dclClear(cl_m);
-  dclClearFlags(cl_m);
-
-  for(i = 0; i < cnt; i++ )
+  
+  if ( pinfoInit(&pi_m) == 0 )
+    return free(m), 0;
+  if ( dclInit(&cl_m) == 0 )
+    return pinfoDestroy(&pi_m), free(m), 0;
+  if ( pinfoSetInCnt(&pi_m, 1) == 0 || pinfoSetOutCnt(&pi_m, d->cnt) == 0 )
+    return dclDestroy(cl_m), pinfoDestroy(&pi_m), free(m), 0;
+  
+  for( j = 0; j < p->cnt; j++ )
   {
-    if ( async_PartitionCoverElement(pi_m, cl_m, pi, dclGet(cl_p, i), cl_i) == 0 )
-      return 0;
+    c = dclAddEmptyCube(&pi_m, cl_m);
+    if ( c == NULL )
+      return dclDestroy(cl_m), pinfoDestroy(&pi_m), free(m), 0;
+    dcInSetAll(&pi_m, c, CUBE_IN_MASK_DC);
+    dcOutSetAll(&pi_m, c, 0);
+    col = m+(size_t)j*(size_t)words;
+    for( i = 0; i < d->cnt; i++ )
+      if ( ((col[i/DICH_BITS] >> (i%DICH_BITS)) & 1U) != 0 )
+        dcSetOut(c, i, 1);
   }
-  assert(dclCnt(cl_p) == dclCnt(cl_m));
-  return 1;
-}
+  free(m);
+  
+  ustt_do_msg(msg, data, "%sPartition cover matrix contains %d conditions.", pre, dclCnt(cl_m));
 
-static void ustt_do_msg(void (*msg)(void *data, char *fmt, va_list va), void *data, char *fmt, ...)
-{
-  va_list va;
-  va_start(va, fmt);
-  msg(data, fmt, va);
-  va_end(va);
+  /*
+  if ( fsm != NULL )    
+    fsm_LogDCLLev(fsm, 1, "FSM: ", 1, "Partition cover matrix", &pi_m, cl_m);
+  */
+  
+  if ( maMatrixDCL(&pi_m, cl_m, 1, MA_LIT_NONE) == 0 )
+    return dclDestroy(cl_m), pinfoDestroy(&pi_m), 0;
+  
+  for( j = 0; j < p->cnt; j++ )
+    sel[j] = dclIsFlag(cl_m, j) != 0 ? 1 : 0;
+  
+  return dclDestroy(cl_m), pinfoDestroy(&pi_m), 1;
 }
 
 int dclMinimizeUSTT(pinfo *pi, dclist cl, void (*msg)(void *data, char *fmt, va_list va), void *data, const char *pre, const char *primes_file)
 {
   dclist cl_p;
-  dclist cl_m;
-  pinfo pi_m;
-  int i, j;
+  dich_type d, p;
+  char *sel;
+  int i, j, r;
   dcube *cp = &(pi->tmp[1]);
 
-  if ( dclInitVA(2, &cl_p, &cl_m) == 0 )
+  /* conditions (d) and prime partitions (p) */
+  d = dich_Open(pi->in_cnt);
+  if ( d == NULL )
     return 0;
-  if ( pinfoInit(&pi_m) == 0 )
-    return dclDestroyVA(2, cl_p, cl_m), 0;
-    
-  if ( dclCopy(pi, cl_p, cl) == 0 )
-    return dclDestroyVA(2, cl_p, cl_m), pinfoDestroy(&pi_m), 0;
+  p = dich_Open(pi->in_cnt);
+  if ( p == NULL )
+    return dich_Close(d), 0;
+  if ( dich_AddDCL(d, pi, cl) == 0 || dich_AddDCL(p, pi, cl) == 0 )
+    return dich_Close(p), dich_Close(d), 0;
+  if ( dclInit(&cl_p) == 0 )
+    return dich_Close(p), dich_Close(d), 0;
 
   ustt_do_msg(msg, data, "%sCalculating prime partitions.", pre);
     
-  if ( dclPrimesUSTT(pi, cl_p) == 0 )
-    return dclDestroyVA(2, cl_p, cl_m), pinfoDestroy(&pi_m), 0;
+  r = dich_PrimesUSTT(p, 0, USTT_PRIME_LIMIT);
+  if ( r == 0 )
+    return dclDestroy(cl_p), dich_Close(p), dich_Close(d), 0;
+  if ( r == 2 )
+    ustt_do_msg(msg, data, "%sLimit of %ld prime partitions reached.", pre, (long)USTT_PRIME_LIMIT);
     
   if ( primes_file != NULL )
   {
     ustt_do_msg(msg, data, "%sWriting prime partitions to PLA file '%s'.", 
       pre, primes_file);
+    if ( dich_ToDCL(p, pi, cl_p) == 0 )
+      return dclDestroy(cl_p), dich_Close(p), dich_Close(d), 0;
     dclWritePLA(pi, cl_p, primes_file);
   }
     
 
   ustt_do_msg(msg, data, "%s%d prime partition%s.", 
-    pre, dclCnt(cl_p), dclCnt(cl_p)==1?"":"s");
+    pre, p->cnt, p->cnt==1?"":"s");
 
   /*
   if ( fsm != NULL )    
@@ -223,27 +206,31 @@ int dclMinimizeUSTT(pinfo *pi, dclist cl, void (*msg)(void *data, char *fmt, va_
   */
 
   ustt_do_msg(msg, data, "%sMinimal cover for prime partitions.", pre);
-    
-  if ( async_PartitionDCubeCoverMatrix(&pi_m, cl_m, pi, cl_p, cl) == 0 )
-    return dclDestroyVA(2, cl_p, cl_m), pinfoDestroy(&pi_m), 0;
-
-  ustt_do_msg(msg, data, "%sPartition cover matrix contains %d conditions.", pre, dclCnt(cl_m));
-
-  /*
-  if ( fsm != NULL )    
-    fsm_LogDCLLev(fsm, 1, "FSM: ", 1, "Partition cover matrix", &pi_m, cl_m);
-  */
-
-  if ( maMatrixDCL(&pi_m, cl_m, 1, MA_LIT_NONE) == 0 )
-    return dclDestroyVA(2, cl_p, cl_m), pinfoDestroy(&pi_m), 0;
-
-  dclClearFlags(cl_p);
-  for(i = 0; i < dclCnt(cl_m); i++)
+  
+  sel = (char *)malloc(p->cnt+1);
+  if ( sel == NULL )
+    return dclDestroy(cl_p), dich_Close(p), dich_Close(d), 0;
+  if ( async_MinimizeCoverMatrix(d, p, sel, msg, data, pre) == 0 )
+    return free(sel), dclDestroy(cl_p), dich_Close(p), dich_Close(d), 0;
+  
+  /* keep the selected primes */
+  j = 0;
+  for( i = 0; i < p->cnt; i++ )
   {
-    if ( dclIsFlag(cl_m, i) == 0 )
-      dclSetFlag(cl_p, i);
+    if ( sel[i] != 0 )
+    {
+      if ( i != j )
+        memcpy(dich_GetBlock(p, j, 0), dich_GetBlock(p, i, 0), sizeof(unsigned)*2*p->words);
+      j++;
+    }
   }
-  dclDeleteCubesWithFlag(pi, cl_p);
+  p->cnt = j;
+  free(sel);
+  dich_Close(d);
+  
+  if ( dich_ToDCL(p, pi, cl_p) == 0 )
+    return dclDestroy(cl_p), dich_Close(p), 0;
+  dich_Close(p);
 
   /* verify the result: each condition must be satisfied */
 
@@ -286,18 +273,18 @@ int dclMinimizeUSTT(pinfo *pi, dclist cl, void (*msg)(void *data, char *fmt, va_
       */
       ustt_do_msg(msg, data, "%sInvald encoding (internal error, %d:%s not satisfied).", 
         pre, i, dcToStr(pi, dclGet(cl, i), " ", ""));
-      return dclDestroyVA(2, cl_p, cl_m), pinfoDestroy(&pi_m), 0;
+      return dclDestroy(cl_p), 0;
     }
   }
 
 
   if ( dclCopy(pi, cl, cl_p) == 0 )
-    return dclDestroyVA(2, cl_p, cl_m), pinfoDestroy(&pi_m), 0;
+    return dclDestroy(cl_p), 0;
 
   ustt_do_msg(msg, data, "%sSelection of prime partitions is valid (old: %d, new: %d).", 
     pre, dclCnt(cl), dclCnt(cl_p));
 
-  return dclDestroyVA(2, cl_p, cl_m), pinfoDestroy(&pi_m), 1;
+  return dclDestroy(cl_p), 1;
 }
 
 
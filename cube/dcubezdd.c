@@ -0,0 +1,391 @@
+/*
+
+  dcubezdd.c
+
+  implicit prime generation and cyclic core reduction
+
+  Copyright (C) 2001 Oliver Kraus (olikraus@yahoo.com)
+
+  This file is part of DGC.
+
+  DGC is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 2 of the License, or
+  (at your option) any later version.
+
+  DGC is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with DGC; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+
+  A multiple output function is described by the characteristic function
+
+    H(x,y) = AND_o ( !y_o + ON_o(x) + DC_o(x) )
+
+  The primes of H correspond to the multiple output primes: a prime of H
+  contains the literal !y_o, if and only if output o is NOT part of the
+  multiple output prime. A prime of H never contains a positive
+  literal y_o.
+
+  The rows of the covering problem are the minterms of
+
+    R(x,y) = OR_o ( ON_o(x) y_o AND_{o'!=o} !y_o' )
+
+  Primes and rows are never converted into cubes before the cyclic core
+  has been reached: Primes, which do not cover any remaining row, are
+  removed, essential primes (primes, which cover a row, that is covered
+  only once) are moved to the result.
+
+  The cyclic core is reduced further by row and column dominance: Each
+  prime gets a name variable, each row becomes the set of names of the
+  primes, which cover the row. Rows, which are a superset of another row,
+  are removed (zddMinimal()). A prime is removed, if another prime
+  with the same or a lower cost covers all of its rows. Rows with only
+  one prime are essential. This is repeated until nothing changes.
+  Only the remaining primes are solved with maMatrixIrredundant().
+
+*/
+
+#include "dcube.h"
+#include "matrix.h"
+#include "zdd.h"
+#include "mwc.h"
+
+/* upper limit for the number of BDD/ZDD nodes, fallback to dclPrimesDC */
+#define DCL_ZDD_NODE_LIMIT 4000000
+
+static int dcl_zdd_cube(zdd_type z, pinfo *pi, dcube *c)
+{
+  int i, f = BDD_TRUE;
+  for( i = pi->in_cnt-1; i >= 0; i-- )
+  {
+    switch(dcGetIn(c, i))
+    {
+      case 1: f = bddAnd(z, bddNot(z, bddVar(z, i)), f); break;
+      case 2: f = bddAnd(z, bddVar(z, i), f); break;
+      case 0: return BDD_FALSE;
+    }
+  }
+  return f;
+}
+
+/* BDD of output 'o' of 'cl', 'cl' can be NULL */
+static int dcl_zdd_out(zdd_type z, pinfo *pi, dclist cl, int o)
+{
+  int i, f = BDD_FALSE;
+  if ( cl == NULL )
+    return BDD_FALSE;
+  for( i = 0; i < dclCnt(cl); i++ )
+    if ( dcGetOut(dclGet(cl, i), o) != 0 )
+      f = bddOr(z, f, dcl_zdd_cube(z, pi, dclGet(cl, i)));
+  return f;
+}
+
+struct _dcl_zdd_add_struct
+{
+  pinfo *pi;
+  dclist cl;
+  dcube *c;
+};
+
+static int dcl_zdd_add_cb(void *data, int *lit, int cnt)
+{
+  struct _dcl_zdd_add_struct *a = (struct _dcl_zdd_add_struct *)data;
+  pinfo *pi = a->pi;
+  int i, v;
+
+  dcSetTautology(pi, a->c);
+  for( i = 0; i < cnt; i++ )
+  {
+    v = lit[i]/2;
+    if ( v < pi->in_cnt )
+      dcSetIn(a->c, v, (lit[i]&1) != 0 ? 1 : 2);
+    else
+      dcSetOut(a->c, v-pi->in_cnt, 0);
+  }
+  if ( dcOutCnt(pi, a->c) == 0 )
+    return 1;
+  return dclAdd(pi, a->cl, a->c) < 0 ? 0 : 1;
+}
+
+static int dcl_zdd_add(zdd_type z, pinfo *pi, dclist cl, int p)
+{
+  struct _dcl_zdd_add_struct a;
+  dcube c;
+  int r;
+  if ( dcInit(pi, &c) == 0 )
+    return 0;
+  a.pi = pi;
+  a.cl = cl;
+  a.c = &c;
+  r = zddForEachCube(z, p, dcl_zdd_add_cb, &a);
+  dcDestroy(&c);
+  return r;
+}
+
+/* ZDD set of the literals of 'c', followed by the name variable 'name' */
+static int dcl_zdd_named_cube(zdd_type z, pinfo *pi, dcube *c, int name)
+{
+  int i, a;
+  a = zddAddLiteral(z, name, ZDD_BASE);
+  for( i = pi->out_cnt-1; i >= 0; i-- )
+    if ( dcGetOut(c, i) == 0 )
+      a = zddAddLiteral(z, ZDD_NEG(pi->in_cnt+i), a);
+  for( i = pi->in_cnt-1; i >= 0; i-- )
+  {
+    switch(dcGetIn(c, i))
+    {
+      case 1: a = zddAddLiteral(z, ZDD_NEG(i), a); break;
+      case 2: a = zddAddLiteral(z, ZDD_POS(i), a); break;
+    }
+  }
+  return a;
+}
+
+/*
+  Row and column dominance for the cyclic core 'cl_pr' with the rows 'r'.
+  Essential primes are moved to 'cl_es', dominated primes are removed.
+  Nothing is changed, if the node limit is reached.
+  returns 0 for memory error.
+*/
+static int dcl_zdd_dominance(zdd_type z, pinfo *pi, dclist cl_es, dclist cl_pr, int r, int is_literal)
+{
+  int var_cnt = pi->in_cnt+pi->out_cnt;
+  int cnt = dclCnt(cl_pr);
+  int i, j, q, f, fi, c, is_changed;
+  int *cost;
+  char *state;    /* 0: alive, 1: essential, 2: removed */
+
+  if ( cnt == 0 )
+    return 1;
+
+  cost = (int *)malloc(cnt*sizeof(int));
+  if ( cost == NULL )
+    return 0;
+  state = (char *)malloc(cnt);
+  if ( state == NULL )
+    return free(cost), 0;
+
+  q = ZDD_EMPTY;
+  for( i = 0; i < cnt; i++ )
+  {
+    cost[i] = is_literal != 0 ? dcGetLiteralCnt(pi, dclGet(cl_pr, i)) : 1;
+    state[i] = 0;
+    q = zddUnion(z, q, dcl_zdd_named_cube(z, pi, dclGet(cl_pr, i), ZDD_POS(var_cnt)+i));
+  }
+  f = zddRowSets(z, r, q, var_cnt);
+
+  do
+  {
+    is_changed = 0;
+    f = zddMinimal(z, f);
+    for( i = 0; i < cnt && zddIsOverflow(z) == 0; i++ )
+    {
+      if ( state[i] != 0 )
+        continue;
+      fi = zddSubset1(z, f, ZDD_POS(var_cnt)+i);
+      if ( fi == ZDD_EMPTY )
+      {
+        state[i] = 2;
+        continue;
+      }
+      if ( zddHasEmpty(z, fi) != 0 )
+      {
+        state[i] = 1;
+        f = zddSubset0(z, f, ZDD_POS(var_cnt)+i);
+        is_changed = 1;
+        continue;
+      }
+      for( c = zddCommon(z, fi); c != ZDD_BASE; c = zddHi(z, c) )
+      {
+        j = zddVar(z, c) - ZDD_POS(var_cnt);
+        if ( j != i && state[j] == 0 && cost[j] <= cost[i] )
+          break;
+      }
+      if ( c != ZDD_BASE )
+      {
+        state[i] = 2;
+        f = zddUnion(z, zddSubset0(z, f, ZDD_POS(var_cnt)+i), fi);
+        is_changed = 1;
+      }
+    }
+  } while( is_changed != 0 && zddIsOverflow(z) == 0 );
+
+  if ( zddIsOverflow(z) == 0 )
+  {
+    dclClearFlags(cl_pr);
+    for( i = 0; i < cnt; i++ )
+    {
+      if ( state[i] == 1 )
+        if ( dclAdd(pi, cl_es, dclGet(cl_pr, i)) < 0 )
+          return free(cost), free(state), 0;
+      if ( state[i] != 0 )
+        dclSetFlag(cl_pr, i);
+    }
+    dclDeleteCubesWithFlag(pi, cl_pr);
+  }
+
+  free(cost);
+  free(state);
+  return 1;
+}
+
+/*
+  Calculate primes and essential primes with BDD/ZDD.
+  Essential primes are stored in cl_es, the primes of the cyclic core
+  are stored in cl_pr.
+  returns
+    0   memory error
+    1   ok
+    2   node limit reached, cl_es and cl_pr are invalid
+*/
+static int dcl_zdd_core(zdd_type z, pinfo *pi, dclist cl_es, dclist cl_pr, dclist cl_on, dclist cl_dc, int is_literal)
+{
+  int o, h, r, f, on, y, p, e;
+
+  h = BDD_TRUE;
+  r = BDD_FALSE;
+  for( o = 0; o < pi->out_cnt; o++ )
+  {
+    on = dcl_zdd_out(z, pi, cl_on, o);
+    f = bddOr(z, on, dcl_zdd_out(z, pi, cl_dc, o));
+    y = bddVar(z, pi->in_cnt+o);
+    h = bddAnd(z, h, bddOr(z, bddNot(z, y), f));
+
+    f = bddAnd(z, on, y);
+    for( e = 0; e < pi->out_cnt; e++ )
+      if ( e != o )
+        f = bddAnd(z, f, bddNot(z, bddVar(z, pi->in_cnt+e)));
+    r = bddOr(z, r, f);
+  }
+
+  p = zddPrimes(z, h);
+  p = zddIntersecting(z, p, r);
+  e = ZDD_EMPTY;
+
+  /* cyclic core */
+  for(;;)
+  {
+    if ( zddIsOverflow(z) != 0 )
+      break;
+    f = zddIntersecting(z, p, bddAnd(z, r, bddNot(z, zddCoverTwice(z, p))));
+    if ( f == ZDD_EMPTY )
+      break;
+    e = zddUnion(z, e, f);
+    r = bddAnd(z, r, bddNot(z, zddCover(z, f)));
+    if ( r == BDD_FALSE )
+    {
+      p = ZDD_EMPTY;
+      break;
+    }
+    p = zddIntersecting(z, zddDiff(z, p, f), r);
+  }
+
+  if ( zddIsOverflow(z) != 0 )
+    return 2;
+
+  dclClear(cl_es);
+  dclClear(cl_pr);
+  if ( dcl_zdd_add(z, pi, cl_es, e) == 0 )
+    return 0;
+  if ( dcl_zdd_add(z, pi, cl_pr, p) == 0 )
+    return 0;
+  if ( p != ZDD_EMPTY )
+    if ( dcl_zdd_dominance(z, pi, cl_es, cl_pr, r, is_literal) == 0 )
+      return 0;
+  return 1;
+}
+
+/* same as dclIsEquivalentDC(), but uses the BDD package */
+static int dcl_zdd_is_equivalent(zdd_type z, pinfo *pi, dclist cl, dclist cl_on, dclist cl_dc)
+{
+  int o, f, on, dc;
+  for( o = 0; o < pi->out_cnt; o++ )
+  {
+    f = dcl_zdd_out(z, pi, cl, o);
+    on = dcl_zdd_out(z, pi, cl_on, o);
+    dc = bddOr(z, on, dcl_zdd_out(z, pi, cl_dc, o));
+    if ( bddAnd(z, on, bddNot(z, f)) != BDD_FALSE )
+      break;
+    if ( bddAnd(z, f, bddNot(z, dc)) != BDD_FALSE )
+      break;
+  }
+  if ( zddIsOverflow(z) != 0 )
+    return dclIsEquivalentDC(pi, cl, cl_on, cl_dc);
+  return o >= pi->out_cnt ? 1 : 0;
+}
+
+/*!
+  \ingroup dclist
+
+  Same as dclMinimizeDC(), but primes and the essential primes are
+  calculated implicitly. Only the cyclic core is converted into
+  a list of cubes. If the number of decision diagram nodes becomes
+  too large, dclMinimizeDC() is used instead.
+
+  \param greedy DCL_MIN_EXACT or DCL_MIN_GREEDY.
+
+  \return 0, if an error occured.
+
+  \see dclMinimizeDC()
+*/
+int dclMinimizeDCWithZDD(pinfo *pi, dclist cl, dclist cl_dc, int greedy, int is_literal)
+{
+  zdd_type z;
+  dclist cl_es, cl_pr, cl_on;
+  int r;
+
+  greedy &= ~DCL_MIN_IMPLICIT;
+
+  z = zddOpen(DCL_ZDD_NODE_LIMIT);
+  if ( z == NULL )
+    return 0;
+
+  if ( dclInitVA(3, &cl_es, &cl_pr, &cl_on) == 0 )
+    return zddClose(z), 0;
+
+  if ( dclCopy(pi, cl_on, cl) == 0 )
+    return zddClose(z), dclDestroyVA(3, cl_es, cl_pr, cl_on), 0;
+
+  r = dcl_zdd_core(z, pi, cl_es, cl_pr, cl, cl_dc, is_literal);
+  if ( r == 0 )
+    return zddClose(z), dclDestroyVA(3, cl_es, cl_pr, cl_on), 0;
+  if ( r == 2 )
+    return zddClose(z), dclDestroyVA(3, cl_es, cl_pr, cl_on), 
+      dclMinimizeDC(pi, cl, cl_dc, greedy, is_literal);
+
+  /* cl_es: essential primes, cl_pr: cyclic core */
+  if ( dclCnt(cl_pr) > 0 )
+    if ( maMatrixIrredundant(pi, cl_es, cl_pr, cl_dc, NULL, greedy,
+          is_literal != 0 ? MA_LIT_SOP : MA_LIT_NONE) == 0 )
+      return zddClose(z), dclDestroyVA(3, cl_es, cl_pr, cl_on), 0;
+
+  if ( dclJoin(pi, cl_pr, cl_es) == 0 )
+    return zddClose(z), dclDestroyVA(3, cl_es, cl_pr, cl_on), 0;
+
+  dclRestrictOutput(pi, cl_pr);
+
+  /* the node limit might have been reached by the dominance reduction */
+  if ( zddIsOverflow(z) != 0 )
+  {
+    zddClose(z);
+    z = zddOpen(DCL_ZDD_NODE_LIMIT);
+    if ( z == NULL )
+      return dclDestroyVA(3, cl_es, cl_pr, cl_on), 0;
+  }
+
+  if( dcl_zdd_is_equivalent(z, pi, cl_pr, cl_on, cl_dc) == 0 )
+    return zddClose(z), dclDestroyVA(3, cl_es, cl_pr, cl_on), 0;
+
+  if ( dclCopy(pi, cl, cl_pr) == 0 )
+    return zddClose(z), dclDestroyVA(3, cl_es, cl_pr, cl_on), 0;
+
+  zddClose(z);
+  dclDestroyVA(3, cl_es, cl_pr, cl_on);
+  return 1;
+}
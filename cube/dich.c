@@ -0,0 +1,546 @@
+/*
+
+  dich.c
+
+  dichotomies (state partitions) for the USTT state encoding
+
+  Copyright (C) 2001 Oliver Kraus (olikraus@yahoo.com)
+
+  This file is part of DGC.
+
+  DGC is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 2 of the License, or
+  (at your option) any later version.
+
+  DGC is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with DGC; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+
+  Prime dichotomies (Tracey 1966):
+    1. add the inverse of each dichotomy
+    2. remove covered dichotomies
+    3. each maximal clique of the compatibility graph is merged into
+       one prime dichotomy
+  A dichotomy a is covered by b, if block 0 of a is a subset of block 0
+  of b and block 1 of a is a subset of block 1 of b. For the cube
+  representation this means, that the cube of b is a subset of the
+  cube of a.
+
+*/
+
+#include <stdlib.h>
+#include <string.h>
+#include "dich.h"
+#include "b_mc.h"
+#include "b_th.h"
+#include "mwc.h"
+
+#define dich_get(s,v) (((s)[(v)/DICH_BITS] >> ((v)%DICH_BITS)) & 1U)
+#define dich_set(s,v) ((s)[(v)/DICH_BITS] |= 1U << ((v)%DICH_BITS))
+#define dich_clr(s,v) ((s)[(v)/DICH_BITS] &= ~(1U << ((v)%DICH_BITS)))
+
+dich_type dich_Open(int n)
+{
+  dich_type d;
+  d = (dich_type)malloc(sizeof(struct _dich_struct));
+  if ( d != NULL )
+  {
+    d->n = n;
+    d->words = (n+DICH_BITS-1)/DICH_BITS;
+    if ( d->words == 0 )
+      d->words = 1;
+    d->cnt = 0;
+    d->max = 0;
+    d->b = NULL;
+    return d;
+  }
+  return NULL;
+}
+
+void dich_Close(dich_type d)
+{
+  if ( d->b != NULL )
+    free(d->b);
+  free(d);
+}
+
+static int dich_expand(dich_type d)
+{
+  void *ptr;
+  int max = d->max*2+16;
+  ptr = realloc(d->b, sizeof(unsigned)*2*(size_t)d->words*(size_t)max);
+  if ( ptr == NULL )
+    return 0;
+  d->b = (unsigned *)ptr;
+  d->max = max;
+  return 1;
+}
+
+int dich_AddEmpty(dich_type d)
+{
+  if ( d->cnt >= d->max )
+    if ( dich_expand(d) == 0 )
+      return -1;
+  memset(dich_GetBlock(d, d->cnt, 0), 0, sizeof(unsigned)*2*d->words);
+  d->cnt++;
+  return d->cnt-1;
+}
+
+void dich_SetState(dich_type d, int i, int s, int v)
+{
+  unsigned *b0 = dich_GetBlock(d, i, 0);
+  unsigned *b1 = dich_GetBlock(d, i, 1);
+  dich_clr(b0, s);
+  dich_clr(b1, s);
+  if ( v == 1 )
+    dich_set(b0, s);
+  else if ( v == 2 )
+    dich_set(b1, s);
+}
+
+int dich_GetState(dich_type d, int i, int s)
+{
+  if ( dich_get(dich_GetBlock(d, i, 0), s) != 0 )
+    return 1;
+  if ( dich_get(dich_GetBlock(d, i, 1), s) != 0 )
+    return 2;
+  return 3;
+}
+
+void dich_Invert(dich_type d, int i)
+{
+  unsigned *b0 = dich_GetBlock(d, i, 0);
+  unsigned *b1 = dich_GetBlock(d, i, 1);
+  unsigned t;
+  int j;
+  for( j = 0; j < d->words; j++ )
+  {
+    t = b0[j];
+    b0[j] = b1[j];
+    b1[j] = t;
+  }
+}
+
+int dich_AddCube(dich_type d, pinfo *pi, dcube *c)
+{
+  int i, s;
+  i = dich_AddEmpty(d);
+  if ( i < 0 )
+    return 0;
+  for( s = 0; s < d->n && s < pi->in_cnt; s++ )
+    dich_SetState(d, i, s, dcGetIn(c, s));
+  return 1;
+}
+
+int dich_AddDCL(dich_type d, pinfo *pi, dclist cl)
+{
+  int i, cnt = dclCnt(cl);
+  for( i = 0; i < cnt; i++ )
+    if ( dich_AddCube(d, pi, dclGet(cl, i)) == 0 )
+      return 0;
+  return 1;
+}
+
+int dich_ToDCL(dich_type d, pinfo *pi, dclist cl)
+{
+  int i, s;
+  dcube *c;
+  dclRealClear(cl);
+  for( i = 0; i < d->cnt; i++ )
+  {
+    c = dclAddEmptyCube(pi, cl);
+    if ( c == NULL )
+      return 0;
+    dcInSetAll(pi, c, CUBE_IN_MASK_DC);
+    dcOutSetAll(pi, c, CUBE_OUT_MASK);
+    for( s = 0; s < d->n && s < pi->in_cnt; s++ )
+      dcSetIn(c, s, dich_GetState(d, i, s));
+  }
+  return 1;
+}
+
+/*---------------------------------------------------------------------------*/
+
+int dich_IsValid(dich_type d, int i)
+{
+  unsigned *b0 = dich_GetBlock(d, i, 0);
+  unsigned *b1 = dich_GetBlock(d, i, 1);
+  unsigned u0 = 0, u1 = 0;
+  int j;
+  for( j = 0; j < d->words; j++ )
+  {
+    u0 |= b0[j];
+    u1 |= b1[j];
+  }
+  return u0 != 0 && u1 != 0 ? 1 : 0;
+}
+
+int dich_IsEqual(dich_type d, int a, int b)
+{
+  return memcmp(dich_GetBlock(d, a, 0), dich_GetBlock(d, b, 0),
+    sizeof(unsigned)*2*d->words) == 0 ? 1 : 0;
+}
+
+int dich_IsCovered(dich_type d, int a, int b)
+{
+  unsigned *pa = dich_GetBlock(d, a, 0);
+  unsigned *pb = dich_GetBlock(d, b, 0);
+  int j, words = 2*d->words;
+  for( j = 0; j < words; j++ )
+    if ( (pa[j] & ~pb[j]) != 0 )
+      return 0;
+  return 1;
+}
+
+int dich_IsCompatible(dich_type d, int a, int b)
+{
+  unsigned *a0 = dich_GetBlock(d, a, 0);
+  unsigned *a1 = dich_GetBlock(d, a, 1);
+  unsigned *b0 = dich_GetBlock(d, b, 0);
+  unsigned *b1 = dich_GetBlock(d, b, 1);
+  int j;
+  for( j = 0; j < d->words; j++ )
+    if ( (a0[j] & b1[j]) != 0 || (a1[j] & b0[j]) != 0 )
+      return 0;
+  return 1;
+}
+
+int dich_IsSeparated(dich_type d, int cnt, int s1, int s2)
+{
+  int i;
+  unsigned *b0, *b1;
+  for( i = 0; i < cnt; i++ )
+  {
+    b0 = dich_GetBlock(d, i, 0);
+    b1 = dich_GetBlock(d, i, 1);
+    if ( dich_get(b0, s1) != 0 && dich_get(b1, s2) != 0 )
+      return 1;
+    if ( dich_get(b1, s1) != 0 && dich_get(b0, s2) != 0 )
+      return 1;
+  }
+  return 0;
+}
+
+/*---------------------------------------------------------------------------*/
+
+/* see dclSCCInv() */
+int dich_SCC(dich_type d)
+{
+  int i, j, k, cnt = d->cnt;
+  char *flag;
+
+  flag = (char *)calloc(cnt+1, 1);
+  if ( flag == NULL )
+    return 0;
+  for( i = 0; i < cnt; i++ )
+  {
+    if ( flag[i] == 0 )
+      for( j = i+1; j < cnt; j++ )
+      {
+        if ( flag[j] == 0 )
+        {
+          if ( dich_IsCovered(d, i, j) != 0 )
+            flag[i] = 1;
+          else if ( dich_IsCovered(d, j, i) != 0 )
+            flag[j] = 1;
+        }
+      }
+  }
+
+  k = 0;
+  for( i = 0; i < cnt; i++ )
+  {
+    if ( flag[i] == 0 )
+    {
+      if ( k != i )
+        memcpy(dich_GetBlock(d, k, 0), dich_GetBlock(d, i, 0), sizeof(unsigned)*2*d->words);
+      k++;
+    }
+  }
+  d->cnt = k;
+  free(flag);
+  return 1;
+}
+
+/*---------------------------------------------------------------------------*/
+
+struct _dich_pr_struct
+{
+  dich_type d;          /* reduced dichotomies (vertices) */
+  dich_type p;          /* prime dichotomies */
+};
+
+/* merges the dichotomies of a clique, returns the position or -1 */
+static int dich_pr_union(struct _dich_pr_struct *pr, int *v, int cnt)
+{
+  unsigned *p0, *p1, *d0, *d1;
+  int i, j, words = pr->d->words;
+
+  i = dich_AddEmpty(pr->p);
+  if ( i < 0 )
+    return -1;
+  p0 = dich_GetBlock(pr->p, i, 0);
+  p1 = dich_GetBlock(pr->p, i, 1);
+  while( cnt > 0 )
+  {
+    cnt--;
+    d0 = dich_GetBlock(pr->d, v[cnt], 0);
+    d1 = dich_GetBlock(pr->d, v[cnt], 1);
+    for( j = 0; j < words; j++ )
+    {
+      p0[j] |= d0[j];
+      p1[j] |= d1[j];
+    }
+  }
+  return i;
+}
+
+/* returns 1 if the lowest state of dichotomy i is an element of block 0 */
+static int dich_is_normal(dich_type d, int i)
+{
+  unsigned *b0 = dich_GetBlock(d, i, 0);
+  unsigned *b1 = dich_GetBlock(d, i, 1);
+  unsigned u;
+  int j;
+  for( j = 0; j < d->words; j++ )
+  {
+    u = b0[j] | b1[j];
+    if ( u != 0 )
+      return (b0[j] & u & (~u+1U)) != 0 ? 1 : 0;
+  }
+  return 1;
+}
+
+static int dich_pr_cb(void *data, int *v, int cnt)
+{
+  struct _dich_pr_struct *pr = (struct _dich_pr_struct *)data;
+  int i = dich_pr_union(pr, v, cnt);
+  if ( i < 0 )
+    return 0;
+  /* the inverse clique is also reported, keep only one of them */
+  if ( dich_is_normal(pr->p, i) == 0 )
+    pr->p->cnt--;
+  return 1;
+}
+
+/* dichotomy i of d is covered by dichotomy j of p or by its inverse */
+static int dich_pr_is_covered(dich_type d, int i, dich_type p, int j)
+{
+  unsigned *a0 = dich_GetBlock(d, i, 0);
+  unsigned *a1 = dich_GetBlock(d, i, 1);
+  unsigned *b0 = dich_GetBlock(p, j, 0);
+  unsigned *b1 = dich_GetBlock(p, j, 1);
+  int w;
+  for( w = 0; w < d->words; w++ )
+    if ( (a0[w] & ~b0[w]) != 0 || (a1[w] & ~b1[w]) != 0 )
+      break;
+  if ( w >= d->words )
+    return 1;
+  for( w = 0; w < d->words; w++ )
+    if ( (a0[w] & ~b1[w]) != 0 || (a1[w] & ~b0[w]) != 0 )
+      return 0;
+  return 1;
+}
+
+/* limit reached: each dichotomy must be covered by one of the primes */
+static int dich_pr_complete(struct _dich_pr_struct *pr, b_mc_type mc)
+{
+  int *v;
+  int i, j, k;
+  v = (int *)malloc(sizeof(int)*(pr->d->cnt+1));
+  if ( v == NULL )
+    return 0;
+  for( i = 0; i < pr->d->cnt; i++ )
+  {
+    for( j = 0; j < pr->p->cnt; j++ )
+      if ( dich_pr_is_covered(pr->d, i, pr->p, j) != 0 )
+        break;
+    if ( j >= pr->p->cnt )
+    {
+      v[0] = i;
+      k = dich_pr_union(pr, v, b_mc_Extend(mc, v, 1, NULL));
+      if ( k < 0 )
+        return free(v), 0;
+      if ( dich_is_normal(pr->p, k) == 0 )
+        dich_Invert(pr->p, k);
+    }
+  }
+  free(v);
+  return 1;
+}
+
+/* sort key: a block of the dichotomy list and its size */
+struct dich_key_struct
+{
+  const unsigned *b;
+  int words;
+};
+
+static int dich_cmp(const void *ap, const void *bp)
+{
+  const struct dich_key_struct *a = (const struct dich_key_struct *)ap;
+  const struct dich_key_struct *b = (const struct dich_key_struct *)bp;
+  int j;
+  for( j = 0; j < a->words; j++ )
+  {
+    if ( a->b[j] < b->b[j] )
+      return -1;
+    if ( a->b[j] > b->b[j] )
+      return 1;
+  }
+  return 0;
+}
+
+/* the order of the cliques depends on the threads */
+static int dich_sort(dich_type d)
+{
+  struct dich_key_struct *key;
+  unsigned *b;
+  int i;
+  key = (struct dich_key_struct *)malloc(sizeof(struct dich_key_struct)*(d->cnt+1));
+  if ( key == NULL )
+    return 0;
+  b = (unsigned *)malloc(sizeof(unsigned)*2*(size_t)d->words*(size_t)(d->cnt+1));
+  if ( b == NULL )
+    return free(key), 0;
+  for( i = 0; i < d->cnt; i++ )
+  {
+    key[i].b = dich_GetBlock(d, i, 0);
+    key[i].words = 2*d->words;
+  }
+  qsort(key, d->cnt, sizeof(struct dich_key_struct), dich_cmp);
+  for( i = 0; i < d->cnt; i++ )
+    memcpy(b+(size_t)i*2*d->words, key[i].b, sizeof(unsigned)*2*d->words);
+  free(d->b);
+  d->b = b;
+  d->max = d->cnt+1;
+  free(key);
+  return 1;
+}
+
+int dich_PrimesUSTT(dich_type d, int thread_cnt, long limit)
+{
+  struct _dich_pr_struct pr;
+  b_mc_type mc;
+  int i, j, r, cnt = d->cnt;
+
+  for( i = 0; i < cnt; i++ )
+  {
+    j = dich_AddEmpty(d);
+    if ( j < 0 )
+      return 0;
+    memcpy(dich_GetBlock(d, j, 0), dich_GetBlock(d, i, 0), sizeof(unsigned)*2*d->words);
+    dich_Invert(d, j);
+  }
+
+  if ( dich_SCC(d) == 0 )
+    return 0;
+  if ( d->cnt == 0 )
+    return 1;
+
+  mc = b_mc_Open(d->cnt);
+  if ( mc == NULL )
+    return 0;
+  for( i = 0; i < d->cnt; i++ )
+    for( j = 0; j < i; j++ )
+      if ( dich_IsCompatible(d, i, j) != 0 )
+        b_mc_SetEdge(mc, i, j);
+
+  pr.d = d;
+  pr.p = dich_Open(d->n);
+  if ( pr.p == NULL )
+    return b_mc_Close(mc), 0;
+  /* each prime is reported twice */
+  b_mc_SetLimit(mc, limit*2);
+  r = b_mc_Do(mc, thread_cnt, dich_pr_cb, &pr);
+  if ( r == 0 )
+    return dich_Close(pr.p), b_mc_Close(mc), 0;
+  if ( r == 2 )
+    if ( dich_pr_complete(&pr, mc) == 0 )
+      return dich_Close(pr.p), b_mc_Close(mc), 0;
+  b_mc_Close(mc);
+
+  if ( dich_sort(pr.p) == 0 )
+    return dich_Close(pr.p), 0;
+
+  free(d->b);
+  d->b = pr.p->b;
+  d->cnt = pr.p->cnt;
+  d->max = pr.p->max;
+  pr.p->b = NULL;
+  dich_Close(pr.p);
+  return r;
+}
+
+/*---------------------------------------------------------------------------*/
+
+/* number of primes (columns) of one b_th_Do step */
+#define DICH_CM_BLOCK 64
+
+struct _dich_cm_struct
+{
+  dich_type d;
+  dich_type p;
+  unsigned *m;
+};
+
+static int dich_cm_th(void *data, int th, int pos)
+{
+  struct _dich_cm_struct *cm = (struct _dich_cm_struct *)data;
+  int words = dich_CoverWords(cm->d);
+  int i, j, end;
+  unsigned *col;
+  
+  end = (pos+1)*DICH_CM_BLOCK;
+  if ( end > cm->p->cnt )
+    end = cm->p->cnt;
+  for( j = pos*DICH_CM_BLOCK; j < end; j++ )
+  {
+    col = cm->m+(size_t)j*(size_t)words;
+    for( i = 0; i < cm->d->cnt; i++ )
+      if ( dich_pr_is_covered(cm->d, i, cm->p, j) != 0 )
+        dich_set(col, i);
+  }
+  return 1;
+}
+
+unsigned *dich_OpenCoverMatrix(dich_type d, dich_type p, int thread_cnt)
+{
+  struct _dich_cm_struct cm;
+  int words = dich_CoverWords(d);
+  
+  cm.d = d;
+  cm.p = p;
+  cm.m = (unsigned *)calloc((size_t)words*(size_t)p->cnt+1, sizeof(unsigned));
+  if ( cm.m == NULL )
+    return NULL;
+  if ( b_th_Do(thread_cnt, (p->cnt+DICH_CM_BLOCK-1)/DICH_CM_BLOCK, 
+         dich_cm_th, &cm) == 0 )
+    return free(cm.m), NULL;
+  return cm.m;
+}
+
+/*---------------------------------------------------------------------------*/
+
+int dclSCCInvDich(pinfo *pi, dclist cl)
+{
+  dich_type d;
+  d = dich_Open(pi->in_cnt);
+  if ( d == NULL )
+    return 0;
+  if ( dich_AddDCL(d, pi, cl) == 0 )
+    return dich_Close(d), 0;
+  if ( dich_SCC(d) == 0 )
+    return dich_Close(d), 0;
+  if ( dich_ToDCL(d, pi, cl) == 0 )
+    return dich_Close(d), 0;
+  dich_Close(d);
+  return 1;
+}
@@ -0,0 +1,114 @@
+/*
+
+  dich.h
+
+  dichotomies (state partitions) for the USTT state encoding
+
+  Copyright (C) 2001 Oliver Kraus (olikraus@yahoo.com)
+
+  This file is part of DGC.
+
+  DGC is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 2 of the License, or
+  (at your option) any later version.
+
+  DGC is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with DGC; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+  A dichotomy is a pair of disjoint state sets (block 0 and block 1),
+  stored as two bitsets. The cube representation (pi_async) uses one
+  input variable for each state:
+    1 (zero)  the state is an element of block 0
+    2 (one)   the state is an element of block 1
+    3 (dc)    the state is not assigned
+
+  Two dichotomies are compatible, if they can be merged into one
+  dichotomy. The prime dichotomies are the maximal compatibles, they
+  are calculated as the maximal cliques of the compatibility graph
+  (see b_mc.h).
+
+*/
+
+#ifndef _DICH_H
+#define _DICH_H
+
+#include "dcube.h"
+
+#define DICH_BITS 32
+
+struct _dich_struct
+{
+  int n;                /* number of states */
+  int words;            /* unsigned words of one block */
+  int cnt;              /* number of dichotomies */
+  int max;
+  unsigned *b;          /* dichotomy i: block 0 and block 1 at b+2*i*words */
+};
+typedef struct _dich_struct *dich_type;
+
+#define dich_Cnt(d) ((d)->cnt)
+#define dich_Clear(d) ((d)->cnt = 0)
+#define dich_GetBlock(d,i,k) ((d)->b+((size_t)(2*(i)+(k)))*(size_t)(d)->words)
+#define dich_DelLast(d) ((d)->cnt--)
+
+dich_type dich_Open(int n);
+void dich_Close(dich_type d);
+
+/* returns the position of a new empty dichotomy or -1 */
+int dich_AddEmpty(dich_type d);
+/* v = 1: block 0, v = 2: block 1, v = 3: not assigned (dcSetIn values) */
+void dich_SetState(dich_type d, int i, int s, int v);
+int dich_GetState(dich_type d, int i, int s);
+void dich_Invert(dich_type d, int i);
+
+int dich_AddCube(dich_type d, pinfo *pi, dcube *c);
+int dich_AddDCL(dich_type d, pinfo *pi, dclist cl);
+/* replaces the content of 'cl' */
+int dich_ToDCL(dich_type d, pinfo *pi, dclist cl);
+
+/* both blocks contain at least one state */
+int dich_IsValid(dich_type d, int i);
+int dich_IsEqual(dich_type d, int a, int b);
+/* dichotomy a is covered by dichotomy b */
+int dich_IsCovered(dich_type d, int a, int b);
+int dich_IsCompatible(dich_type d, int a, int b);
+/* checks dichotomies 0..cnt-1 for a separation of s1 and s2 */
+int dich_IsSeparated(dich_type d, int cnt, int s1, int s2);
+
+/* removes covered dichotomies, same result as dclSCCInv() */
+int dich_SCC(dich_type d);
+
+/*
+  Replaces the content with the prime dichotomies. Only one of
+  a dichotomy and its inverse is part of the result (block 0
+  contains the lowest state). The result is sorted.
+  thread_cnt: see b_th_Do
+  limit: max. number of primes, <= 0: no limit. If the limit has been
+    reached, each dichotomy gets one greedily extended prime, so
+    that a cover still exists.
+  returns 0 (memory error), 1 (ok) or 2 (limit reached)
+*/
+int dich_PrimesUSTT(dich_type d, int thread_cnt, long limit);
+
+/* number of unsigned words of one column of the cover matrix */
+#define dich_CoverWords(d) (((d)->cnt+DICH_BITS-1)/DICH_BITS)
+
+/*
+  Returns the partition cover matrix or NULL (memory error). Bit i of
+  column j (at m+j*dich_CoverWords(d)) is set, if dichotomy i of 'd' 
+  is covered by dichotomy j of 'p' or by its inverse. Use free().
+  thread_cnt: see b_th_Do
+*/
+unsigned *dich_OpenCoverMatrix(dich_type d, dich_type p, int thread_cnt);
+
+/* dclSCCInv() for cubes with dichotomies */
+int dclSCCInvDich(pinfo *pi, dclist cl);
+
+#endif /* _DICH_H */
@@ -89,7 +89,12 @@ static fsmnode_type fsmnode_Open(fsm_type fsm)
           n->str_output = NULL;
           if ( dcInit(fsm->pi_code, &(n->c_code)) != 0 )
           {
-            return n;
+            n->cover_valid = 0;
+            if ( dclInitVA(3, n->cl_cover+0, n->cl_cover+1, n->cl_cover+2) != 0 )
+            {
+              return n;
+            }
+            dcDestroy(&(n->c_code));
           }
           dclDestroy(n->cl_output);
         }
@@ -106,6 +111,7 @@ static void fsmnode_Close(fsmnode_type n)
 {
   dcDestroy(&(n->c_code));
   dclDestroy(n->cl_output);
+  dclDestroyVA(3, n->cl_cover[0], n->cl_cover[1], n->cl_cover[2]);
   fsmnode_SetOutput(n, NULL);
   fsmnode_SetName(n, NULL);
   b_il_Close(n->in_edges);
@@ -206,11 +212,16 @@ static fsmedge_type fsmedge_Open(fsm_type fsm)
     e->tree_cond = NULL;
     e->str_output = 0;
     e->tree_output = NULL;
+    e->is_dirty = 1;
     if ( dclInit(&(e->cl_output)) != 0 )
     {
       if ( dclInit(&(e->cl_cond)) != 0 )
       {
-        return e;
+        if ( dclInitVA(2, &(e->cl_m_on), &(e->cl_m_off)) != 0 )
+        {
+          return e;
+        }
+        dclDestroy(e->cl_cond);
       }
       dclDestroy(e->cl_output);
     }
@@ -225,6 +236,7 @@ static void fsmedge_Close(fsmedge_type e)
   fsmedge_SetOutput(e, NULL);
   dclDestroy(e->cl_output);
   dclDestroy(e->cl_cond);
+  dclDestroyVA(2, e->cl_m_on, e->cl_m_off);
   e->source_node = -1;
   e->dest_node = -1;
   if ( e->tree_cond != NULL )
@@ -263,6 +275,80 @@ static void fsm_log_fn(void *data, int ll, char *fmt, va_list va)
   puts("");
 }
 
+/*---------------------------------------------------------------------------*/
+
+struct _fsm_edge_key_struct
+{
+  int source_node;
+  int dest_node;
+};
+
+static int fsm_node_name_cmp(void *data, int el, const void *key)
+{
+  return strcmp(fsm_GetNode((fsm_type)data, el)->name, (const char *)key);
+}
+
+static int fsm_edge_cmp(void *data, int el, const void *key)
+{
+  fsmedge_type e = fsm_GetEdge((fsm_type)data, el);
+  const struct _fsm_edge_key_struct *k = (const struct _fsm_edge_key_struct *)key;
+  if ( e->source_node == k->source_node && e->dest_node == k->dest_node )
+    return 0;
+  return 1;
+}
+
+static int fsm_ih_AddNode(fsm_type fsm, int node_id)
+{
+  const char *name = fsm_GetNode(fsm, node_id)->name;
+  if ( name == NULL )
+    return 1;
+  return b_ih_Ins(fsm->node_name_ih, node_id, b_ih_StrHash(name));
+}
+
+static void fsm_ih_DelNode(fsm_type fsm, int node_id)
+{
+  const char *name = fsm_GetNode(fsm, node_id)->name;
+  if ( name == NULL )
+    return;
+  b_ih_Del(fsm->node_name_ih, node_id, b_ih_StrHash(name));
+}
+
+/* only edges with source and destination are part of the index */
+static int fsm_ih_AddEdge(fsm_type fsm, int edge_id)
+{
+  fsmedge_type e = fsm_GetEdge(fsm, edge_id);
+  if ( e->source_node < 0 || e->dest_node < 0 )
+    return 1;
+  return b_ih_Ins(fsm->edge_ih, edge_id, b_ih_IntHash(e->source_node, e->dest_node));
+}
+
+static void fsm_ih_DelEdge(fsm_type fsm, int edge_id)
+{
+  fsmedge_type e = fsm_GetEdge(fsm, edge_id);
+  if ( e->source_node < 0 || e->dest_node < 0 )
+    return;
+  b_ih_Del(fsm->edge_ih, edge_id, b_ih_IntHash(e->source_node, e->dest_node));
+}
+
+/* rebuild both hash indices, required after fsm_Read() */
+static int fsm_ih_Build(fsm_type fsm)
+{
+  int i;
+  b_ih_Clear(fsm->node_name_ih);
+  b_ih_Clear(fsm->edge_ih);
+  i = -1;
+  while( b_set_WhileLoop(fsm->nodes, &i) != 0 )
+    if ( fsm_ih_AddNode(fsm, i) == 0 )
+      return 0;
+  i = -1;
+  while( b_set_WhileLoop(fsm->edges, &i) != 0 )
+    if ( fsm_ih_AddEdge(fsm, i) == 0 )
+      return 0;
+  return 1;
+}
+
+/*---------------------------------------------------------------------------*/
+
 static int fsm_Init(fsm_type fsm)
 {
   fsm->name = NULL;
@@ -286,6 +372,9 @@ static int fsm_Init(fsm_type fsm)
   fsm->cl_machine_dc = NULL;
   fsm->cl_m_state = NULL;
   fsm->cl_m_output = NULL;
+  fsm->machine_type = FSM_MACHINE_NONE;
+  fsm->cl_m_del_on = NULL;
+  fsm->cl_m_del_off = NULL;
 
   fsm->linebuf[0] = '\0';
   fsm->labelbuf[0] = '\0';
@@ -295,6 +384,8 @@ static int fsm_Init(fsm_type fsm)
   fsm->groups = b_set_Open();
   fsm->input_sl = b_sl_Open();
   fsm->output_sl = b_sl_Open();
+  fsm->node_name_ih = b_ih_Open();
+  fsm->edge_ih = b_ih_Open();
 
   fsm->dcex = dcexOpen();
   
@@ -307,6 +398,8 @@ static int fsm_Init(fsm_type fsm)
   
   dclInit(&(fsm->cl_m_state));
   dclInit(&(fsm->cl_m_output));
+  dclInit(&(fsm->cl_m_del_on));
+  dclInit(&(fsm->cl_m_del_off));
 
   fsm->pi_m_state = pinfoOpen();
   fsm->pi_m_output = pinfoOpen();
@@ -316,6 +409,8 @@ static int fsm_Init(fsm_type fsm)
         fsm->groups         == NULL ||
         fsm->input_sl       == NULL || 
         fsm->output_sl      == NULL ||
+        fsm->node_name_ih   == NULL ||
+        fsm->edge_ih        == NULL ||
         fsm->dcex           == NULL ||
         fsm->pi_cond        == NULL ||
         fsm->pi_output      == NULL ||
@@ -325,6 +420,8 @@ static int fsm_Init(fsm_type fsm)
         fsm->cl_machine_dc  == NULL ||
         fsm->cl_m_state     == NULL ||
         fsm->cl_m_output    == NULL ||
+        fsm->cl_m_del_on    == NULL ||
+        fsm->cl_m_del_off   == NULL ||
         fsm->pi_m_state     == NULL ||
         fsm->pi_m_output    == NULL
         )
@@ -334,6 +431,8 @@ static int fsm_Init(fsm_type fsm)
     if ( fsm->groups != NULL )         b_set_Close(fsm->groups);
     if ( fsm->input_sl != NULL )       b_sl_Close(fsm->input_sl);
     if ( fsm->output_sl != NULL )      b_sl_Close(fsm->output_sl);
+    if ( fsm->node_name_ih != NULL )   b_ih_Close(fsm->node_name_ih);
+    if ( fsm->edge_ih != NULL )        b_ih_Close(fsm->edge_ih);
     if ( fsm->dcex != NULL )           dcexClose(fsm->dcex);
     if ( fsm->pi_cond != NULL )        pinfoClose(fsm->pi_cond);
     if ( fsm->pi_output != NULL )      pinfoClose(fsm->pi_output);
@@ -343,12 +442,17 @@ static int fsm_Init(fsm_type fsm)
     if ( fsm->cl_machine_dc != NULL )  dclDestroy(fsm->cl_machine_dc);
     if ( fsm->cl_m_state != NULL )     dclDestroy(fsm->cl_m_state);
     if ( fsm->cl_m_output != NULL )    dclDestroy(fsm->cl_m_output);
+    if ( fsm->cl_m_del_on != NULL )    dclDestroy(fsm->cl_m_del_on);
+    if ( fsm->cl_m_del_off != NULL )   dclDestroy(fsm->cl_m_del_off);
     if ( fsm->pi_m_state != NULL )     pinfoClose(fsm->pi_m_state);
     if ( fsm->pi_m_output != NULL )    pinfoClose(fsm->pi_m_output);
 
 
     return 0;
   }
+  
+  b_ih_SetCmpFn(fsm->node_name_ih, fsm_node_name_cmp, fsm);
+  b_ih_SetCmpFn(fsm->edge_ih, fsm_edge_cmp, fsm);
         
   return 1;
 }
@@ -383,7 +487,10 @@ void fsm_Clear(fsm_type fsm)
   while( b_set_WhileLoop(fsm->groups, &i) != 0 )
     fsmgrp_Close(fsm_GetGroup(fsm, i));
   b_set_Clear(fsm->groups);
+  b_ih_Clear(fsm->node_name_ih);
+  b_ih_Clear(fsm->edge_ih);
   fsm->reset_node_id = -1;
+  fsm_SetMachineInvalid(fsm);
 }
 
 void fsm_Close(fsm_type fsm)
@@ -398,6 +505,8 @@ void fsm_Close(fsm_type fsm)
   if ( fsm->groups != NULL )         b_set_Close(fsm->groups);
   if ( fsm->input_sl != NULL )       b_sl_Close(fsm->input_sl);
   if ( fsm->output_sl != NULL )      b_sl_Close(fsm->output_sl);
+  if ( fsm->node_name_ih != NULL )   b_ih_Close(fsm->node_name_ih);
+  if ( fsm->edge_ih != NULL )        b_ih_Close(fsm->edge_ih);
   if ( fsm->dcex != NULL )           dcexClose(fsm->dcex);
   if ( fsm->pi_cond != NULL )        pinfoClose(fsm->pi_cond);
   if ( fsm->pi_output != NULL )      pinfoClose(fsm->pi_output);
@@ -407,6 +516,8 @@ void fsm_Close(fsm_type fsm)
   if ( fsm->cl_machine_dc != NULL )  dclDestroy(fsm->cl_machine_dc);
   if ( fsm->cl_m_state != NULL )     dclDestroy(fsm->cl_m_state);
   if ( fsm->cl_m_output != NULL )    dclDestroy(fsm->cl_m_output);
+  if ( fsm->cl_m_del_on != NULL )    dclDestroy(fsm->cl_m_del_on);
+  if ( fsm->cl_m_del_off != NULL )   dclDestroy(fsm->cl_m_del_off);
   if ( fsm->pi_m_state != NULL )     pinfoClose(fsm->pi_m_state);
   if ( fsm->pi_m_output != NULL )    pinfoClose(fsm->pi_m_output);
 
@@ -673,6 +784,20 @@ static int fsm_find_edge(fsm_type fsm, int source_node_id, int dest_node_id)
   fsmnode_type n;
   fsmedge_type e;
   int i;
+  if ( source_node_id >= 0 && dest_node_id >= 0 )
+  {
+    struct _fsm_edge_key_struct key;
+    int pos = -1;
+    key.source_node = source_node_id;
+    key.dest_node = dest_node_id;
+    i = b_ih_FindNext(fsm->edge_ih, &key, b_ih_IntHash(source_node_id, dest_node_id), &pos);
+    if ( i < 0 )
+      return -1;
+    /* multiple edges: return the first edge of the out-edge list */
+    if ( b_ih_FindNext(fsm->edge_ih, &key, b_ih_IntHash(source_node_id, dest_node_id), &pos) < 0 )
+      return i;
+  }
+  
   if ( source_node_id >= 0 )
   {
     n = fsm_GetNode(fsm, source_node_id);
@@ -729,10 +854,16 @@ static int fsm_connect_edge(fsm_type fsm, int pos, int source_node_id, int dest_
     {
       e->source_node = source_node_id;
       e->dest_node = dest_node_id;
-      return 1;
+      fsm_SetEdgeDirty(fsm, pos);
+      if ( fsm_ih_AddEdge(fsm, pos) != 0 )
+        return 1;
+      e->source_node = -1;
+      e->dest_node = -1;
+      if ( dest_node_id >= 0 )
+        b_il_DelByVal(fsm_GetNode(fsm, dest_node_id)->in_edges, pos);
     }
-    n = fsm_GetNode(fsm, source_node_id);
-    b_il_DelByVal(n->out_edges, pos);
+    if ( source_node_id >= 0 )
+      b_il_DelByVal(fsm_GetNode(fsm, source_node_id)->out_edges, pos);
   }
   return 0;
 }
@@ -743,6 +874,9 @@ static void fsm_disconnect_edge(fsm_type fsm, int pos)
   fsmedge_type e = fsm_GetEdge(fsm, pos);
   fsmnode_type n;
   
+  fsm_ih_DelEdge(fsm, pos);
+  fsm_SetEdgeDirty(fsm, pos);
+  
   if ( e->source_node >= 0 )
   {
     n = fsm_GetNode(fsm, e->source_node);
@@ -778,6 +912,13 @@ int fsm_ConnectEdge(fsm_type fsm, int edge_id,
 
 void fsm_DeleteEdge(fsm_type fsm, int edge_id)
 {
+  if ( fsm->machine_type != FSM_MACHINE_NONE )
+  {
+    /* remember the rows for fsm_UpdateMachine */
+    if ( dclJoin(fsm->pi_machine, fsm->cl_m_del_on, fsm_GetEdge(fsm, edge_id)->cl_m_on) == 0 ||
+         dclJoin(fsm->pi_machine, fsm->cl_m_del_off, fsm_GetEdge(fsm, edge_id)->cl_m_off) == 0 )
+      fsm_SetMachineInvalid(fsm);
+  }
   fsm_disconnect_edge(fsm, edge_id);
   fsmedge_Close(fsm_GetEdge(fsm, edge_id));
   b_set_Del(fsm->edges, edge_id);
@@ -824,6 +965,7 @@ void fsm_Disconnect(fsm_type fsm, int source_node_id, int dest_node_id)
 /* This does not change the connection of nodes! */
 int fsm_CopyEdge(fsm_type fsm, int dest_edge_id, int src_edge_id)
 {
+  fsm_SetEdgeDirty(fsm, dest_edge_id);
   if ( dclCopy(fsm_GetConditionPINFO(fsm), 
     fsm_GetEdgeCondition(fsm,dest_edge_id), 
     fsm_GetEdgeCondition(fsm,src_edge_id)) == 0 )
@@ -860,12 +1002,14 @@ int fsm_AddNodeOutputCube(fsm_type fsm, int node_id, dcube *c)
 /* returns position or -1 */
 int fsm_AddEdgeOutputCube(fsm_type fsm, int edge_id, dcube *c)
 {
+  fsm_SetEdgeDirty(fsm, edge_id);
   return dclAdd(fsm_GetOutputPINFO(fsm), fsm_GetEdgeOutput(fsm, edge_id), c);
 }
 
 /* returns position or -1 */
 int fsm_AddEdgeConditionCube(fsm_type fsm, int edge_id, dcube *c)
 {
+  fsm_SetEdgeDirty(fsm, edge_id);
   return dclAdd(fsm_GetConditionPINFO(fsm), fsm_GetEdgeCondition(fsm, edge_id), c);
 }
 
@@ -878,11 +1022,13 @@ int fsm_SetNodeOutputStr(fsm_type fsm, int node_id, char *s)
 
 int fsm_SetEdgeOutputStr(fsm_type fsm, int edge_id, char *s)
 {
+  fsm_SetEdgeDirty(fsm, edge_id);
   return fsmedge_SetOutput( fsm_GetEdge(fsm, edge_id), s);
 }
 
 int fsm_SetEdgeConditionStr(fsm_type fsm, int edge_id, char *s)
 {
+  fsm_SetEdgeDirty(fsm, edge_id);
   return fsmedge_SetCond( fsm_GetEdge(fsm, edge_id), s);
 }
 
@@ -950,6 +1096,7 @@ void fsm_DeleteNode(fsm_type fsm, int node_id)
   while(b_il_GetCnt(n->in_edges) > 0)
     fsm_DeleteEdge(fsm, b_il_GetVal(n->in_edges, 0));
     
+  fsm_ih_DelNode(fsm, node_id);
   fsmnode_Close(fsm_GetNode(fsm, node_id));
   b_set_Del(fsm->nodes, node_id);
   
@@ -971,14 +1118,16 @@ char *fsm_GetNodeNameStr(fsm_type fsm, int node_id)
   return s;
 }
 
+/* returns the lowest node_id with the specified name or -1 */
 int fsm_GetNodeIdByName(fsm_type fsm, const char *name)
 {
-  int i;
-  i = -1;
-  while( b_set_WhileLoop(fsm->nodes, &i) != 0 )
-    if ( strcmp( fsm_GetNode(fsm, i)->name, name ) == 0 )
-      return i;
-  return -1;
+  int node_id, min_node_id = -1;
+  int pos = -1;
+  unsigned hash = b_ih_StrHash(name);
+  while( (node_id = b_ih_FindNext(fsm->node_name_ih, name, hash, &pos)) >= 0 )
+    if ( min_node_id < 0 || min_node_id > node_id )
+      min_node_id = node_id;
+  return min_node_id;
 }
 
 /* returns node_id or -1 */
@@ -992,6 +1141,8 @@ int fsm_AddNodeByName(fsm_type fsm, char *name)
     return -1;
   if ( fsmnode_SetName(fsm_GetNode(fsm, node_id), name) == 0 )
     return fsm_DeleteNode(fsm, node_id), -1;
+  if ( fsm_ih_AddNode(fsm, node_id) == 0 )
+    return fsm_DeleteNode(fsm, node_id), -1;
   return node_id;
 }
 
@@ -1004,6 +1155,8 @@ int fsm_AddNewNodeByName(fsm_type fsm, char *name)
     return -1;
   if ( fsmnode_SetName(fsm_GetNode(fsm, node_id), name) == 0 )
     return fsm_DeleteNode(fsm, node_id), -1;
+  if ( fsm_ih_AddNode(fsm, node_id) == 0 )
+    return fsm_DeleteNode(fsm, node_id), -1;
   return node_id;
 }
 
@@ -1312,6 +1465,7 @@ int fsm_TreeToCube(fsm_type fsm)
     dclClear(e->cl_output);
     dclClear(e->cl_cond);
   }
+  fsm_SetCoverInvalid(fsm);
   
   pinfoSetInCnt(fsm->pi_cond, b_sl_GetCnt(fsm->input_sl));
   pinfoSetOutCnt(fsm->pi_cond, 0);
@@ -1403,6 +1557,8 @@ int fsm_SetInCnt(fsm_type fsm, int in_cnt)
   }
   dclRealClear(fsm->cl_machine);
   dclRealClear(fsm->cl_machine_dc);
+  fsm_SetMachineInvalid(fsm);
+  fsm_SetCoverInvalid(fsm);
   return 1;
 }
 
@@ -1427,6 +1583,8 @@ int fsm_SetOutCnt(fsm_type fsm, int out_cnt)
   }
   dclRealClear(fsm->cl_machine);
   dclRealClear(fsm->cl_machine_dc);
+  fsm_SetMachineInvalid(fsm);
+  fsm_SetCoverInvalid(fsm);
   return 1;
 }
 
@@ -1463,6 +1621,7 @@ int fsm_SetCodeWidth(fsm_type fsm, int code_width, int code_option)
     
   dclRealClear(fsm->cl_machine);
   dclRealClear(fsm->cl_machine_dc);
+  fsm_SetMachineInvalid(fsm);
   return 1;
 }
 
@@ -1788,62 +1947,25 @@ int fsm_AssignLabelsToMachine(fsm_type fsm, int code_option)
 int fsm_BuildMachine(fsm_type fsm)
 {
   int node_id;
-  int src_node_id;
   int edge_id;
   int loop;
-  dcube *state_code;
-  dcube *src_state_code;
-  dcube *c;
-  dclist cl;
-  int i, cnt;
   
   dclRealClear(fsm->cl_machine);
   dclRealClear(fsm->cl_machine_dc);
-  c = &(fsm->pi_machine->tmp[9]);
+  fsm_SetMachineInvalid(fsm);
   node_id = -1;
   while( fsm_LoopNodes(fsm, &node_id) != 0 )
   {
     loop = -1;
-    state_code = fsm_GetNodeCode(fsm, node_id);
     while( fsm_LoopNodeInEdges(fsm, node_id, &loop, &edge_id) != 0 )
     {
-      src_node_id = fsm_GetEdgeSrcNode(fsm, edge_id);
-      src_state_code = fsm_GetNodeCode(fsm, src_node_id);
-      cl = fsm_GetEdgeCondition(fsm, edge_id);
-      cnt = dclCnt(cl);
-      for( i = 0; i < cnt; i++ )
-      {
-        dcInSetAll(fsm->pi_machine, c, CUBE_IN_MASK_DC);
-        dcOutSetAll(fsm->pi_machine, c, 0);
-        
-        dcCopyInToIn(  fsm->pi_machine, c, 0,                    fsm->pi_cond, dclGet(cl, i));
-        dcCopyOutToIn( fsm->pi_machine, c, fsm->pi_cond->in_cnt, fsm->pi_code, src_state_code);
-        dcCopyOutToOut(fsm->pi_machine, c, 0,                    fsm->pi_code, state_code);
-        
-        if ( dcIsIllegal(fsm->pi_machine, c) == 0 )
-          if ( dclAdd(fsm->pi_machine, fsm->cl_machine, c) < 0 )
-            return 0;
-      }
-      if ( fsm->is_with_output != 0 )
-      {
-        cl = fsm_GetEdgeOutput(fsm, edge_id);
-        cnt = dclCnt(cl);
-        for( i = 0; i < cnt; i++ )
-        {
-          dcInSetAll(fsm->pi_machine, c, CUBE_IN_MASK_DC);
-          dcOutSetAll(fsm->pi_machine, c, 0);
-
-          dcCopyInToIn(  fsm->pi_machine, c, 0,                     fsm->pi_output, dclGet(cl, i));
-          dcCopyOutToIn( fsm->pi_machine, c, fsm->pi_cond->in_cnt,  fsm->pi_code,   src_state_code);
-          dcCopyOutToOut(fsm->pi_machine, c, fsm->pi_code->out_cnt, fsm->pi_output, dclGet(cl, i));
-
-          if ( dcIsIllegal(fsm->pi_machine, c) == 0 )
-            if ( dclAdd(fsm->pi_machine, fsm->cl_machine, c) < 0 )
-              return 0;
-        }
-      }
+      if ( fsm_BuildEdgeMachine(fsm, edge_id, FSM_MACHINE_DFF, fsm_GetEdge(fsm, edge_id)->cl_m_on, NULL) == 0 )
+        return 0;
+      if ( dclJoin(fsm->pi_machine, fsm->cl_machine, fsm_GetEdge(fsm, edge_id)->cl_m_on) == 0 )
+        return 0;
     }
   }
+  fsm->machine_type = FSM_MACHINE_DFF;
 
   return fsm_AssignLabelsToMachine(fsm, FSM_CODE_DFF_EXTRA_OUTPUT);
 }
@@ -1856,52 +1978,29 @@ int fsm_BuildMachine(fsm_type fsm)
 int fsm_BuildTransferfunction(fsm_type fsm)
 {
   int node_id;
-  int src_node_id;
   int edge_id;
   int loop;
-  dcube *state_code;
-  dcube *src_state_code;
-  dcube *c;
-  dclist cl;
   dclist cl_off;
-  int i, cnt;
   
   if ( dclInit(&cl_off) == 0 )
     return 0;
   
   dclRealClear(fsm->cl_machine);
   dclRealClear(fsm->cl_machine_dc);
-  c = &(fsm->pi_machine->tmp[9]);
+  fsm_SetMachineInvalid(fsm);
   node_id = -1;
   while( fsm_LoopNodes(fsm, &node_id) != 0 )
   {
     loop = -1;
-    state_code = fsm_GetNodeCode(fsm, node_id);
     while( fsm_LoopNodeInEdges(fsm, node_id, &loop, &edge_id) != 0 )
     {
-      src_node_id = fsm_GetEdgeSrcNode(fsm, edge_id);
-      src_state_code = fsm_GetNodeCode(fsm, src_node_id);
-      cl = fsm_GetEdgeOutput(fsm, edge_id);
-      cnt = dclCnt(cl);
-      for( i = 0; i < cnt; i++ )
-      {
-        dcInSetAll(fsm->pi_machine, c, CUBE_IN_MASK_DC);
-        dcOutSetAll(fsm->pi_machine, c, 0);
-        
-        dcCopyInToIn(  fsm->pi_machine, c, 0,                     fsm->pi_cond,   dclGet(cl, i));
-        dcCopyOutToIn( fsm->pi_machine, c, fsm->pi_cond->in_cnt,  fsm->pi_code,   src_state_code);
-        dcCopyOutToOut(fsm->pi_machine, c, 0,                     fsm->pi_code,   state_code);
-        dcCopyOutToOut(fsm->pi_machine, c, fsm->pi_code->out_cnt, fsm->pi_output, dclGet(cl, i));
-        
-        if ( dcIsIllegal(fsm->pi_machine, c) == 0 )
-          if ( dclAdd(fsm->pi_machine, fsm->cl_machine, c) < 0 )
-            return dclDestroy(cl_off), 0;
-            
-        dcInvOut(fsm->pi_machine, c);
-        if ( dcIsIllegal(fsm->pi_machine, c) == 0 )
-          if ( dclAdd(fsm->pi_machine, cl_off, c) < 0 )
-            return dclDestroy(cl_off), 0;
-      }
+      fsmedge_type e = fsm_GetEdge(fsm, edge_id);
+      if ( fsm_BuildEdgeMachine(fsm, edge_id, FSM_MACHINE_TRANSFER, e->cl_m_on, e->cl_m_off) == 0 )
+        return dclDestroy(cl_off), 0;
+      if ( dclJoin(fsm->pi_machine, fsm->cl_machine, e->cl_m_on) == 0 )
+        return dclDestroy(cl_off), 0;
+      if ( dclJoin(fsm->pi_machine, cl_off, e->cl_m_off) == 0 )
+        return dclDestroy(cl_off), 0;
     }
   }
   
@@ -1914,6 +2013,7 @@ int fsm_BuildTransferfunction(fsm_type fsm)
     return dclDestroy(cl_off), 0;
   
   dclDestroy(cl_off);
+  fsm->machine_type = FSM_MACHINE_TRANSFER;
 
   return fsm_AssignLabelsToMachine(fsm, FSM_CODE_DFF_EXTRA_OUTPUT);
 }
@@ -1928,64 +2028,122 @@ int fsm_BuildTransferfunction(fsm_type fsm)
 int fsm_BuildMachineToggleFF(fsm_type fsm)
 {
   int node_id;
-  int src_node_id;
   int edge_id;
   int loop;
+  
+  dclRealClear(fsm->cl_machine);
+  dclRealClear(fsm->cl_machine_dc);
+  fsm_SetMachineInvalid(fsm);
+  node_id = -1;
+  while( fsm_LoopNodes(fsm, &node_id) != 0 )
+  {
+    loop = -1;
+    while( fsm_LoopNodeInEdges(fsm, node_id, &loop, &edge_id) != 0 )
+    {
+      if ( fsm_BuildEdgeMachine(fsm, edge_id, FSM_MACHINE_TOGGLE, fsm_GetEdge(fsm, edge_id)->cl_m_on, NULL) == 0 )
+        return 0;
+      if ( dclJoin(fsm->pi_machine, fsm->cl_machine, fsm_GetEdge(fsm, edge_id)->cl_m_on) == 0 )
+        return 0;
+    }
+  }
+  fsm->machine_type = FSM_MACHINE_TOGGLE;
+  return 1;
+}
+
+/*
+  The rows of the transfer function, which are created by one edge.
+  machine_type:
+    FSM_MACHINE_DFF       rows of fsm_BuildMachine
+    FSM_MACHINE_TOGGLE    rows of fsm_BuildMachineToggleFF
+    FSM_MACHINE_TRANSFER  rows of fsm_BuildTransferfunction, cl_off
+                          gets the rows of the off-set
+  The old contents of cl_on and cl_off are removed.
+*/
+int fsm_BuildEdgeMachine(fsm_type fsm, int edge_id, int machine_type, dclist cl_on, dclist cl_off)
+{
   dcube *state_code;
   dcube *src_state_code;
   dcube *c;
   dcube *code_tmp;
   dclist cl;
   int i, cnt;
-  
-  dclRealClear(fsm->cl_machine);
-  dclRealClear(fsm->cl_machine_dc);
+
+  dclRealClear(cl_on);
+  if ( cl_off != NULL )
+    dclRealClear(cl_off);
+  fsm_GetEdge(fsm, edge_id)->is_dirty = 0;
+
   c = &(fsm->pi_machine->tmp[9]);
   code_tmp = &(fsm->pi_code->tmp[9]);
-  node_id = -1;
-  while( fsm_LoopNodes(fsm, &node_id) != 0 )
+  state_code = fsm_GetNodeCode(fsm, fsm_GetEdgeDestNode(fsm, edge_id));
+  src_state_code = fsm_GetNodeCode(fsm, fsm_GetEdgeSrcNode(fsm, edge_id));
+
+  if ( machine_type == FSM_MACHINE_TRANSFER )
   {
-    loop = -1;
-    state_code = fsm_GetNodeCode(fsm, node_id);
-    while( fsm_LoopNodeInEdges(fsm, node_id, &loop, &edge_id) != 0 )
+    cl = fsm_GetEdgeOutput(fsm, edge_id);
+    cnt = dclCnt(cl);
+    for( i = 0; i < cnt; i++ )
     {
-      src_node_id = fsm_GetEdgeSrcNode(fsm, edge_id);
-      src_state_code = fsm_GetNodeCode(fsm, src_node_id);
-      cl = fsm_GetEdgeCondition(fsm, edge_id);
-      cnt = dclCnt(cl);
-      for( i = 0; i < cnt; i++ )
-      {
-        dcInSetAll(fsm->pi_machine, c, CUBE_IN_MASK_DC);
-        dcOutSetAll(fsm->pi_machine, c, 0);
-        
-        dcCopyInToIn(  fsm->pi_machine, c, 0,                    fsm->pi_cond, dclGet(cl, i));
-        dcCopyOutToIn( fsm->pi_machine, c, fsm->pi_cond->in_cnt, fsm->pi_code, src_state_code);
-        
-        dcXorOut(fsm->pi_code, code_tmp, src_state_code, state_code);
-        dcCopyOutToOut(fsm->pi_machine, c, 0,                    fsm->pi_code, code_tmp);
-        
-        if ( dcIsIllegal(fsm->pi_machine, c) == 0 )
-          if ( dclAdd(fsm->pi_machine, fsm->cl_machine, c) < 0 )
-            return 0;
-      }
-      if ( fsm->is_with_output != 0 )
-      {
-        cl = fsm_GetEdgeOutput(fsm, edge_id);
-        cnt = dclCnt(cl);
-        for( i = 0; i < cnt; i++ )
-        {
-          dcInSetAll(fsm->pi_machine, c, CUBE_IN_MASK_DC);
-          dcOutSetAll(fsm->pi_machine, c, 0);
+      dcInSetAll(fsm->pi_machine, c, CUBE_IN_MASK_DC);
+      dcOutSetAll(fsm->pi_machine, c, 0);
+      
+      dcCopyInToIn(  fsm->pi_machine, c, 0,                     fsm->pi_cond,   dclGet(cl, i));
+      dcCopyOutToIn( fsm->pi_machine, c, fsm->pi_cond->in_cnt,  fsm->pi_code,   src_state_code);
+      dcCopyOutToOut(fsm->pi_machine, c, 0,                     fsm->pi_code,   state_code);
+      dcCopyOutToOut(fsm->pi_machine, c, fsm->pi_code->out_cnt, fsm->pi_output, dclGet(cl, i));
+      
+      if ( dcIsIllegal(fsm->pi_machine, c) == 0 )
+        if ( dclAdd(fsm->pi_machine, cl_on, c) < 0 )
+          return 0;
+          
+      dcInvOut(fsm->pi_machine, c);
+      if ( dcIsIllegal(fsm->pi_machine, c) == 0 )
+        if ( cl_off != NULL && dclAdd(fsm->pi_machine, cl_off, c) < 0 )
+          return 0;
+    }
+    return 1;
+  }
+
+  cl = fsm_GetEdgeCondition(fsm, edge_id);
+  cnt = dclCnt(cl);
+  for( i = 0; i < cnt; i++ )
+  {
+    dcInSetAll(fsm->pi_machine, c, CUBE_IN_MASK_DC);
+    dcOutSetAll(fsm->pi_machine, c, 0);
+    
+    dcCopyInToIn(  fsm->pi_machine, c, 0,                    fsm->pi_cond, dclGet(cl, i));
+    dcCopyOutToIn( fsm->pi_machine, c, fsm->pi_cond->in_cnt, fsm->pi_code, src_state_code);
+    
+    if ( machine_type == FSM_MACHINE_TOGGLE )
+    {
+      dcXorOut(fsm->pi_code, code_tmp, src_state_code, state_code);
+      dcCopyOutToOut(fsm->pi_machine, c, 0,                  fsm->pi_code, code_tmp);
+    }
+    else
+    {
+      dcCopyOutToOut(fsm->pi_machine, c, 0,                  fsm->pi_code, state_code);
+    }
+    
+    if ( dcIsIllegal(fsm->pi_machine, c) == 0 )
+      if ( dclAdd(fsm->pi_machine, cl_on, c) < 0 )
+        return 0;
+  }
+  if ( fsm->is_with_output != 0 )
+  {
+    cl = fsm_GetEdgeOutput(fsm, edge_id);
+    cnt = dclCnt(cl);
+    for( i = 0; i < cnt; i++ )
+    {
+      dcInSetAll(fsm->pi_machine, c, CUBE_IN_MASK_DC);
+      dcOutSetAll(fsm->pi_machine, c, 0);
 
-          dcCopyInToIn(  fsm->pi_machine, c, 0,                     fsm->pi_output, dclGet(cl, i));
-          dcCopyOutToIn( fsm->pi_machine, c, fsm->pi_cond->in_cnt,  fsm->pi_code,   src_state_code);
-          dcCopyOutToOut(fsm->pi_machine, c, fsm->pi_code->out_cnt, fsm->pi_output, dclGet(cl, i));
+      dcCopyInToIn(  fsm->pi_machine, c, 0,                     fsm->pi_output, dclGet(cl, i));
+      dcCopyOutToIn( fsm->pi_machine, c, fsm->pi_cond->in_cnt,  fsm->pi_code,   src_state_code);
+      dcCopyOutToOut(fsm->pi_machine, c, fsm->pi_code->out_cnt, fsm->pi_output, dclGet(cl, i));
 
-          if ( dcIsIllegal(fsm->pi_machine, c) == 0 )
-            if ( dclAdd(fsm->pi_machine, fsm->cl_machine, c) < 0 )
-              return 0;
-        }
-      }
+      if ( dcIsIllegal(fsm->pi_machine, c) == 0 )
+        if ( dclAdd(fsm->pi_machine, cl_on, c) < 0 )
+          return 0;
     }
   }
   return 1;
@@ -2077,7 +2235,7 @@ int fsm_GetNodeInOCover(fsm_type fsm, int node_id, dclist cl)
 
 /*---------------------------------------------------------------------------*/
 
-int fsm_GetNodePreCover(fsm_type fsm, int node_id, dclist cl)
+int fsm_GetNodePreCoverPI(fsm_type fsm, pinfo *pi, int node_id, dclist cl)
 {
   int loop;
   int edge_id;
@@ -2088,12 +2246,17 @@ int fsm_GetNodePreCover(fsm_type fsm, int node_id, dclist cl)
   edge_id = -1;
   while( fsm_LoopNodeInEdges(fsm, node_id, &loop, &edge_id) != 0 )
     if ( node_id != fsm_GetEdgeSrcNode(fsm, edge_id) )
-      if ( dclSCCUnion(fsm_GetConditionPINFO(fsm), cl, fsm_GetEdgeCondition(fsm, edge_id)) == 0 )
+      if ( dclSCCUnion(pi, cl, fsm_GetEdgeCondition(fsm, edge_id)) == 0 )
         return 0;
   return 1;
 }
 
-int fsm_GetNodePostCover(fsm_type fsm, int node_id, dclist cl)
+int fsm_GetNodePreCover(fsm_type fsm, int node_id, dclist cl)
+{
+  return fsm_GetNodePreCoverPI(fsm, fsm_GetConditionPINFO(fsm), node_id, cl);
+}
+
+int fsm_GetNodePostCoverPI(fsm_type fsm, pinfo *pi, int node_id, dclist cl)
 {
   int loop;
   int edge_id;
@@ -2104,11 +2267,16 @@ int fsm_GetNodePostCover(fsm_type fsm, int node_id, dclist cl)
   edge_id = -1;
   while( fsm_LoopNodeOutEdges(fsm, node_id, &loop, &edge_id) != 0 )
     if ( node_id != fsm_GetEdgeDestNode(fsm, edge_id) )
-      if ( dclJoin(fsm_GetConditionPINFO(fsm), cl, fsm_GetEdgeCondition(fsm, edge_id)) == 0 )
+      if ( dclJoin(pi, cl, fsm_GetEdgeCondition(fsm, edge_id)) == 0 )
         return 0;
   return 1;
 }
 
+int fsm_GetNodePostCover(fsm_type fsm, int node_id, dclist cl)
+{
+  return fsm_GetNodePostCoverPI(fsm, fsm_GetConditionPINFO(fsm), node_id, cl);
+}
+
 int fsm_GetNodePreOCover(fsm_type fsm, int node_id, dclist cl)
 {
   int loop;
@@ -2166,7 +2334,7 @@ int fsm_GetNodePreOutput(fsm_type fsm, int node_id, dclist cl)
   return 1;
 }
 
-int fsm_GetNodePostOutput(fsm_type fsm, int node_id, dclist cl)
+int fsm_GetNodePostOutputPI(fsm_type fsm, pinfo *pi, int node_id, dclist cl)
 {
   int loop;
   int edge_id;
@@ -2177,11 +2345,16 @@ int fsm_GetNodePostOutput(fsm_type fsm, int node_id, dclist cl)
   edge_id = -1;
   while( fsm_LoopNodeOutEdges(fsm, node_id, &loop, &edge_id) != 0 )
     if ( node_id != fsm_GetEdgeDestNode(fsm, edge_id) )
-      if ( dclJoin(fsm_GetOutputPINFO(fsm), cl, fsm_GetEdgeOutput(fsm, edge_id)) == 0 )
+      if ( dclJoin(pi, cl, fsm_GetEdgeOutput(fsm, edge_id)) == 0 )
         return 0;
   return 1;
 }
 
+int fsm_GetNodePostOutput(fsm_type fsm, int node_id, dclist cl)
+{
+  return fsm_GetNodePostOutputPI(fsm, fsm_GetOutputPINFO(fsm), node_id, cl);
+}
+
 dclist fsm_GetNodeSelfOutput(fsm_type fsm, int node_id)
 {
   int edge_id = fsm_FindEdge(fsm, node_id, node_id);
@@ -2192,6 +2365,53 @@ dclist fsm_GetNodeSelfOutput(fsm_type fsm, int node_id)
 
 /*---------------------------------------------------------------------------*/
 
+/*
+  The pre and post covers of a node are calculated on first use and
+  kept until an edge of the node is connected, disconnected or marked
+  as dirty (fsm_SetEdgeDirty). Self transitions are not part of these
+  covers, but they invalidate the cache of their node, too.
+*/
+
+void fsm_SetNodeCoverInvalid(fsm_type fsm, int node_id)
+{
+  fsm_GetNode(fsm, node_id)->cover_valid = 0;
+}
+
+void fsm_SetCoverInvalid(fsm_type fsm)
+{
+  int node_id = -1;
+  while( fsm_LoopNodes(fsm, &node_id) != 0 )
+    fsm_SetNodeCoverInvalid(fsm, node_id);
+}
+
+dclist fsm_GetNodeCachedCover(fsm_type fsm, pinfo *pi, int node_id, int cover)
+{
+  fsmnode_type n = fsm_GetNode(fsm, node_id);
+  dclist cl = n->cl_cover[cover];
+  int ok = 0;
+  
+  if ( (n->cover_valid & (1<<cover)) != 0 )
+    return cl;
+  switch(cover)
+  {
+    case FSM_COVER_PRE:
+      ok = fsm_GetNodePreCoverPI(fsm, pi, node_id, cl);
+      break;
+    case FSM_COVER_POST:
+      ok = fsm_GetNodePostCoverPI(fsm, pi, node_id, cl);
+      break;
+    case FSM_COVER_POST_OUTPUT:
+      ok = fsm_GetNodePostOutputPI(fsm, pi, node_id, cl);
+      break;
+  }
+  if ( ok == 0 )
+    return NULL;
+  n->cover_valid |= 1<<cover;
+  return cl;
+}
+
+/*---------------------------------------------------------------------------*/
+
 /* should I better use fsm_GetNextStateCode()??? */
 /*
   If the FSM is in state 'node_id' there is target state 'dest_node_id' that
@@ -2425,6 +2645,7 @@ int fsm_Read(fsm_type fsm, FILE *fp)
   if ( b_sl_Read(fsm->input_sl, fp) == 0 )                       return 0;
   if ( b_sl_Read(fsm->output_sl, fp) == 0 )                      return 0;
   if ( b_io_ReadInt(fp, &fsm->reset_node_id) == 0 )              return 0;
+  if ( fsm_ih_Build(fsm) == 0 )                                  return 0;
   return 1;
 }
 
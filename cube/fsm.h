@@ -32,6 +32,7 @@
 #include "b_set.h"
 #include "b_il.h"
 #include "b_sl.h"
+#include "b_ih.h"
 #include "dcube.h"
 #include "pinfo.h"
 #include "dcex.h"
@@ -49,6 +50,12 @@ struct _fsmgrp_struct
 typedef struct _fsmgrp_struct fsmgrp_struct;
 typedef struct _fsmgrp_struct *fsmgrp_type;
 
+/* fsm_GetNodeCachedCover */
+#define FSM_COVER_PRE 0           /* fsm_GetNodePreCover */
+#define FSM_COVER_POST 1          /* fsm_GetNodePostCover */
+#define FSM_COVER_POST_OUTPUT 2   /* fsm_GetNodePostOutput */
+#define FSM_COVER_CNT 3
+
 struct _fsmnode_struct
 {
   char *name;
@@ -66,6 +73,9 @@ struct _fsmnode_struct
   int g_d;
   int g_predecessor;
   int group_index;
+  /* fsm_GetNodeCachedCover */
+  dclist cl_cover[FSM_COVER_CNT];
+  int cover_valid;    /* bit i is set, if cl_cover[i] is valid */
 };
 
 typedef struct _fsmnode_struct fsmnode_struct;
@@ -84,6 +94,10 @@ struct _fsmedge_struct
   void *user_data;    /* pointer to dg_edge_struct, see dg_edge.h */
   int is_visited;
   dcube tmp_cube;     /* no automatic init or destroy is done on this cube */
+  /* fsm_UpdateMachine */
+  int is_dirty;       /* condition, output or destination has been changed */
+  dclist cl_m_on;     /* the rows of cl_machine, created by this edge */
+  dclist cl_m_off;    /* the rows of the off-set (FSM_MACHINE_TRANSFER) */
 };
 
 typedef struct _fsmedge_struct fsmedge_struct;
@@ -106,6 +120,9 @@ struct _fsm_struct
   b_sl_type input_sl;
   b_sl_type output_sl;
   int reset_node_id;
+  
+  b_ih_type node_name_ih;   /* name --> node id */
+  b_ih_type edge_ih;        /* (source, dest) --> edge id */
 
   dcex_type dcex;
   pinfo *pi_cond;
@@ -120,6 +137,11 @@ struct _fsm_struct
   
   dclist cl_m_state;
   dclist cl_m_output;
+
+  /* fsm_UpdateMachine */
+  int machine_type;         /* FSM_MACHINE_xxx */
+  dclist cl_m_del_on;       /* rows of deleted edges */
+  dclist cl_m_del_off;
   
   pinfo *pi_m_state;
   pinfo *pi_m_output;
@@ -280,6 +302,20 @@ const char *fsm_GetStateLabel(fsm_type fsm, int pos, const char *prefix);
 int fsm_AssignLabelsToMachine(fsm_type fsm, int code_option);
 int fsm_BuildMachine(fsm_type fsm);
 int fsm_BuildMachineToggleFF(fsm_type fsm);
+int fsm_BuildTransferfunction(fsm_type fsm);
+
+/* builder of cl_machine, required for fsm_UpdateMachine() */
+#define FSM_MACHINE_NONE 0
+#define FSM_MACHINE_DFF 1         /* fsm_BuildMachine */
+#define FSM_MACHINE_TOGGLE 2      /* fsm_BuildMachineToggleFF */
+#define FSM_MACHINE_TRANSFER 3    /* fsm_BuildTransferfunction */
+int fsm_BuildEdgeMachine(fsm_type fsm, int edge_id, int machine_type, dclist cl_on, dclist cl_off);
+
+/* fsminc.c */
+/* call this after the condition or output of an edge has been changed */
+void fsm_SetEdgeDirty(fsm_type fsm, int edge_id);
+void fsm_SetMachineInvalid(fsm_type fsm);
+int fsm_UpdateMachine(fsm_type fsm);
 
 
 /* int fsm_MinimizeClockedMachine(fsm_type fsm); */ /* moved to fsmenc.h */
@@ -294,6 +330,9 @@ int fsm_GetNodeInOCover(fsm_type fsm, int node_id, dclist cl);
 /* these two function EXCLUDE the self condition */
 int fsm_GetNodePreCover(fsm_type fsm, int node_id, dclist cl);
 int fsm_GetNodePostCover(fsm_type fsm, int node_id, dclist cl);
+/* same as above, but use 'pi' instead of fsm_GetConditionPINFO(fsm) */
+int fsm_GetNodePreCoverPI(fsm_type fsm, pinfo *pi, int node_id, dclist cl);
+int fsm_GetNodePostCoverPI(fsm_type fsm, pinfo *pi, int node_id, dclist cl);
 
 int fsm_GetNodePreOCover(fsm_type fsm, int node_id, dclist cl);
 int fsm_GetNodePostOCover(fsm_type fsm, int node_id, dclist cl);
@@ -301,11 +340,22 @@ int fsm_GetNodePostOCover(fsm_type fsm, int node_id, dclist cl);
 /* hmmm.. the following two functions should be replaced by the OCover fns */
 int fsm_GetNodePreOutput(fsm_type fsm, int node_id, dclist cl);
 int fsm_GetNodePostOutput(fsm_type fsm, int node_id, dclist cl);
+/* same as above, but use 'pi' instead of fsm_GetOutputPINFO(fsm) */
+int fsm_GetNodePostOutputPI(fsm_type fsm, pinfo *pi, int node_id, dclist cl);
 
 
 dclist fsm_GetNodeSelfCondtion(fsm_type fsm, int node_id);
 dclist fsm_GetNodeSelfOutput(fsm_type fsm, int node_id);
 
+/* 
+  cached result of the pre/post functions above, calculated with 'pi' 
+  cover: FSM_COVER_PRE, FSM_COVER_POST or FSM_COVER_POST_OUTPUT
+  returns NULL for memory errors, the list must not be modified 
+*/
+dclist fsm_GetNodeCachedCover(fsm_type fsm, pinfo *pi, int node_id, int cover);
+void fsm_SetNodeCoverInvalid(fsm_type fsm, int node_id);
+void fsm_SetCoverInvalid(fsm_type fsm);
+
 void fsm_GetNextNodeCode(fsm_type fsm, int node_id, dcube *c, int *dest_node_id, dcube *dest_code);
 
 int fsm_IsValid(fsm_type fsm);
@@ -376,6 +426,35 @@ int fsm_ConvertToMoore(fsm_type fsm);
 int fsm_DoShortestPath(fsm_type fsm, int src_id, int dest_id, int fn(void *data, fsm_type fsm, int edge_id, int i, int cnt), void *data);
 void fsm_ShowAllShortestPath(fsm_type fsm);
 
+/* next hop table for all pairs of nodes, shortest paths (ties may differ from fsm_DoShortestPath) */
+struct _fsmsp_struct
+{
+  fsm_type fsm;
+  int n;                  /* number of nodes */
+  int *node_idx;          /* node id --> 0..n-1 */
+  int *idx_node;          /* 0..n-1 --> node id */
+  int *out_start;         /* out edges of i: out_edge[out_start[i]..out_start[i+1]-1] */
+  int *out_edge;
+  int *out_dest;          /* index of the destination node */
+  int *in_start;          /* in edges of i: in_src[in_start[i]..in_start[i+1]-1] */
+  int *in_src;
+  unsigned short *in_pos; /* position of fsm_FindEdge(in_src, i) in the out edges of in_src */
+  unsigned short *hop;    /* hop[dest*n+src]: position of the first edge in the out edges of src */
+};
+typedef struct _fsmsp_struct *fsmsp_type;
+
+#define FSMSP_NONE 0x0ffff
+/* upper limit for n*n */
+#define FSMSP_MAX_TABLE (1L<<27)
+
+/* thread_cnt: see b_th_Do(), returns NULL if the table is too large */
+fsmsp_type fsmsp_Open(fsm_type fsm, int thread_cnt);
+void fsmsp_Close(fsmsp_type sp);
+/* -1 if there is no path */
+int fsmsp_GetDist(fsmsp_type sp, int src_id, int dest_id);
+/* see fsm_DoShortestPath */
+int fsmsp_DoPath(fsmsp_type sp, int src_id, int dest_id, int fn(void *data, fsm_type fsm, int edge_id, int i, int cnt), void *data);
+
 /* fsmbm.c  */
 /* for enc_options see fsm_EncodePartition() */
 int fsm_BuildRobustBurstModeTransferFunction(fsm_type fsm);
@@ -25,7 +25,13 @@
 #include "fsm.h"
 #include "dcube.h"
 #include "mcov.h"
+#include "b_th.h"
+#include "b_sl.h"
 #include <assert.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <stdarg.h>
+#include <sys/time.h>
 #include "mwc.h"
 
 
@@ -42,15 +48,237 @@ static int fsm_is_cl_machine_ok(fsm_type fsm)
   return 1;
 }
 
-static int fsm_add_hazard_free_edge(fsm_type fsm, int edge_id)
+/*---------------------------------------------------------------------------*/
+
+/*
+  The edges are independent of each other. With more than one thread
+  (b_th_Do, DGC_THREADS), each thread gets a copy of pi_machine, pi_cond 
+  and pi_output (tmp and stack cubes), each edge gets its own result list
+  and message list. Results and messages are merged in the order of 
+  the edges, so the result is the same as for the sequential loop.
+*/
+
+/* minimum number of edges for each thread */
+#define FSM_HF_TH_EDGES 32
+
+struct fsm_hf_ws_struct
+{
+  fsm_type fsm;
+  pinfo *pi_m;      /* fsm->pi_machine or a thread local copy */
+  pinfo *pi_c;      /* fsm->pi_cond or a thread local copy */
+  pinfo *pi_o;      /* fsm->pi_output or a thread local copy */
+  pinfo pi_m_copy;
+  pinfo pi_c_copy;
+  pinfo pi_o_copy;
+  b_sl_type sl;     /* NULL: messages go to fsm_Log */
+  char *buf;        /* dcToStr is not thread safe */
+};
+
+struct fsm_hf_th_struct
+{
+  fsm_type fsm;
+  int is_self_transition;
+  int *edge;
+  struct fsm_hf_ws_struct *ws;  /* one for each thread */
+  dclist *cl_list;              /* fsm_BuildHazardfreeMachine */
+  b_sl_type *sl_list;           /* fsm_CheckHazardfreeMachine */
+  int *result;
+  int *error_cnt;
+  double *ms;                   /* time for each edge */
+};
+
+static double fsm_hf_time(void)
+{
+  struct timeval tv;
+  gettimeofday(&tv, NULL);
+  return (double)tv.tv_sec*1000.0 + (double)tv.tv_usec/1000.0;
+}
+
+static void fsm_hf_log(struct fsm_hf_ws_struct *ws, char *fmt, ...)
+{
+  va_list va;
+  va_start(va, fmt);
+  if ( ws->sl == NULL )
+  {
+    fsm_LogVA(ws->fsm, fmt, va);
+  }
+  else
+  {
+    char s[FSM_LINE_LEN];
+    vsnprintf(s, FSM_LINE_LEN, fmt, va);
+    b_sl_Add(ws->sl, s);
+  }
+  va_end(va);
+}
+
+/* same as dcToStr(pi_m, c, " ", "") */
+static char *fsm_hf_str(struct fsm_hf_ws_struct *ws, dcube *c)
+{
+  pinfo *pi = ws->pi_m;
+  int i;
+  for( i = 0; i < pi->in_cnt; i++ )
+    ws->buf[i] = "x01-"[dcGetIn(c, i)];
+  ws->buf[pi->in_cnt] = ' ';
+  for( i = 0; i < pi->out_cnt; i++ )
+    ws->buf[pi->in_cnt+1+i] = "01"[dcGetOut(c, i)];
+  ws->buf[pi->in_cnt+1+pi->out_cnt] = '\0';
+  return ws->buf;
+}
+
+static void fsm_hf_ws_destroy(struct fsm_hf_ws_struct *ws)
 {
-  dcube *c = &(fsm->pi_machine->tmp[9]);
-  dcube *cc = &(fsm->pi_machine->tmp[10]);
+  if ( ws->pi_m == &(ws->pi_m_copy) )
+    pinfoDestroy(ws->pi_m);
+  if ( ws->pi_c == &(ws->pi_c_copy) )
+    pinfoDestroy(ws->pi_c);
+  if ( ws->pi_o == &(ws->pi_o_copy) )
+    pinfoDestroy(ws->pi_o);
+  free(ws->buf);
+}
+
+/* is_copy == 0: use the pinfo structures of the fsm */
+static int fsm_hf_ws_init(struct fsm_hf_ws_struct *ws, fsm_type fsm, int is_copy)
+{
+  pinfo *pi_o = fsm_GetOutputPINFO(fsm);
+  ws->fsm = fsm;
+  ws->pi_m = fsm->pi_machine;
+  ws->pi_c = fsm->pi_cond;
+  ws->pi_o = pi_o;
+  ws->sl = NULL;
+  ws->buf = (char *)malloc(fsm->pi_machine->in_cnt+fsm->pi_machine->out_cnt+2);
+  if ( ws->buf == NULL )
+    return 0;
+  if ( is_copy == 0 )
+    return 1;
+  
+  if ( pinfoInitInOut(&(ws->pi_m_copy), fsm->pi_machine->in_cnt, fsm->pi_machine->out_cnt) == 0 )
+    return fsm_hf_ws_destroy(ws), 0;
+  ws->pi_m = &(ws->pi_m_copy);
+  if ( pinfoInitInOut(&(ws->pi_c_copy), fsm->pi_cond->in_cnt, fsm->pi_cond->out_cnt) == 0 )
+    return fsm_hf_ws_destroy(ws), 0;
+  ws->pi_c = &(ws->pi_c_copy);
+  if ( pinfoInitInOut(&(ws->pi_o_copy), pi_o->in_cnt, pi_o->out_cnt) == 0 )
+    return fsm_hf_ws_destroy(ws), 0;
+  ws->pi_o = &(ws->pi_o_copy);
+  return 1;
+}
+
+static void fsm_hf_th_close(struct fsm_hf_th_struct *d, int ws_cnt, int list_cnt)
+{
+  while( ws_cnt > 0 )
+    fsm_hf_ws_destroy(d->ws + (--ws_cnt));
+  while( list_cnt > 0 )
+  {
+    list_cnt--;
+    if ( d->cl_list != NULL )
+      dclDestroy(d->cl_list[list_cnt]);
+    if ( d->sl_list != NULL )
+      b_sl_Close(d->sl_list[list_cnt]);
+  }
+  free(d->edge);
+  free(d->ws);
+  free(d->cl_list);
+  free(d->sl_list);
+  free(d->result);
+  free(d->error_cnt);
+  free(d->ms);
+}
+
+/* cnt: number of edges */
+static int fsm_hf_th_open(struct fsm_hf_th_struct *d, fsm_type fsm, int thread_cnt, int cnt, int is_build)
+{
+  int i, edge_id, ws_cnt, list_cnt;
+  
+  d->fsm = fsm;
+  d->edge = (int *)malloc(sizeof(int)*(cnt+1));
+  d->ws = (struct fsm_hf_ws_struct *)malloc(sizeof(struct fsm_hf_ws_struct)*thread_cnt);
+  d->cl_list = is_build ? (dclist *)malloc(sizeof(dclist)*(cnt+1)) : NULL;
+  d->sl_list = is_build ? NULL : (b_sl_type *)malloc(sizeof(b_sl_type)*(cnt+1));
+  d->result = (int *)malloc(sizeof(int)*(cnt+1));
+  d->error_cnt = (int *)calloc(cnt+1, sizeof(int));
+  d->ms = (double *)malloc(sizeof(double)*(cnt+1));
+  if ( d->edge == NULL || d->ws == NULL || d->result == NULL || 
+       d->error_cnt == NULL || d->ms == NULL ||
+       (is_build != 0 && d->cl_list == NULL) || (is_build == 0 && d->sl_list == NULL) )
+    return fsm_hf_th_close(d, 0, 0), 0;
+  
+  i = 0;
+  edge_id = -1;
+  while( fsm_LoopEdges(fsm, &edge_id) != 0 )
+    d->edge[i++] = edge_id;
+  
+  for( ws_cnt = 0; ws_cnt < thread_cnt; ws_cnt++ )
+    if ( fsm_hf_ws_init(d->ws+ws_cnt, fsm, 1) == 0 )
+      return fsm_hf_th_close(d, ws_cnt, 0), 0;
+
+  for( list_cnt = 0; list_cnt < cnt; list_cnt++ )
+  {
+    if ( is_build != 0 )
+    {
+      if ( dclInit(d->cl_list+list_cnt) == 0 )
+        return fsm_hf_th_close(d, ws_cnt, list_cnt), 0;
+    }
+    else
+    {
+      d->sl_list[list_cnt] = b_sl_Open();
+      if ( d->sl_list[list_cnt] == NULL )
+        return fsm_hf_th_close(d, ws_cnt, list_cnt), 0;
+    }
+  }
+  return 1;
+}
+
+/* per edge time: sum and maximum */
+struct fsm_hf_time_struct
+{
+  double start;
+  double sum;
+  double max;
+  int max_edge_id;
+};
+
+static void fsm_hf_time_start(struct fsm_hf_time_struct *t)
+{
+  t->start = fsm_hf_time();
+  t->sum = 0.0;
+  t->max = -1.0;
+  t->max_edge_id = -1;
+}
+
+static void fsm_hf_time_add(struct fsm_hf_time_struct *t, int edge_id, double ms)
+{
+  t->sum += ms;
+  if ( t->max < ms )
+  {
+    t->max = ms;
+    t->max_edge_id = edge_id;
+  }
+}
+
+static void fsm_hf_time_log(fsm_type fsm, struct fsm_hf_time_struct *t, int cnt, int thread_cnt)
+{
+  int e = t->max_edge_id;
+  if ( e < 0 )
+    return;
+  fsm_LogLev(fsm, 1, "FSM: %d edges, %d thread(s), %.1f ms (edges: %.1f ms, max. %.1f ms for %s -> %s).",
+    cnt, thread_cnt, fsm_hf_time()-t->start, t->sum, t->max,
+    fsm_GetNodeName(fsm, fsm_GetEdgeSrcNode(fsm, e))==NULL?"":fsm_GetNodeName(fsm, fsm_GetEdgeSrcNode(fsm, e)),
+    fsm_GetNodeName(fsm, fsm_GetEdgeDestNode(fsm, e))==NULL?"":fsm_GetNodeName(fsm, fsm_GetEdgeDestNode(fsm, e)));
+}
+
+/*---------------------------------------------------------------------------*/
+
+/* adds the implicants of the edge to 'cl_dest' */
+static int fsm_add_hazard_free_edge(struct fsm_hf_ws_struct *ws, int edge_id, dclist cl_dest)
+{
+  fsm_type fsm = ws->fsm;
+  dcube *c = &(ws->pi_m->tmp[9]);
+  dcube *cc = &(ws->pi_m->tmp[10]);
   int src_node = fsm_GetEdgeSrcNode(fsm, edge_id);
   int dest_node = fsm_GetEdgeDestNode(fsm, edge_id);
   dclist cl;
-  pinfo *pie = fsm_GetOutputPINFO(fsm);
-  pinfo *pim = fsm->pi_machine;
+  pinfo *pie = ws->pi_o;
+  pinfo *pim = ws->pi_m;
   int i, cnt;
   
   if ( dclInit(&cl) == 0 )
@@ -90,25 +318,74 @@ static int fsm_add_hazard_free_edge(fsm_type fsm, int edge_id)
     dcCopyOutToOut(pim, c, fsm->code_width, pie, dclGet(cl, i));
 
     if ( dcIsIllegal(pim, c) == 0 )
-      if ( dclAdd(pim, fsm->cl_machine, c) < 0 )
+      if ( dclAdd(pim, cl_dest, c) < 0 )
         return dclDestroy(cl), 0;
   }
   return dclDestroy(cl), 1;
 }
 
+static int fsm_add_hazard_free_edge_th(void *data, int th, int pos)
+{
+  struct fsm_hf_th_struct *d = (struct fsm_hf_th_struct *)data;
+  double t = fsm_hf_time();
+  d->result[pos] = fsm_add_hazard_free_edge(d->ws+th, d->edge[pos], d->cl_list[pos]);
+  d->ms[pos] = fsm_hf_time() - t;
+  return d->result[pos];
+}
+
+static int fsm_add_hazard_free_edges(fsm_type fsm)
+{
+  struct fsm_hf_th_struct d;
+  struct fsm_hf_ws_struct ws;
+  struct fsm_hf_time_struct t;
+  int edge_id, i;
+  int cnt = b_set_Cnt(fsm->edges);
+  int thread_cnt = b_th_GetCnt(0, cnt/FSM_HF_TH_EDGES);
+  double ms;
+  
+  fsm_hf_time_start(&t);
+  if ( thread_cnt <= 1 )
+  {
+    if ( fsm_hf_ws_init(&ws, fsm, 0) == 0 )
+      return 0;
+    edge_id = -1;
+    while( fsm_LoopEdges(fsm, &edge_id) != 0 )
+    {
+      ms = fsm_hf_time();
+      if ( fsm_add_hazard_free_edge(&ws, edge_id, fsm->cl_machine) == 0 )
+        return fsm_hf_ws_destroy(&ws), 0;
+      fsm_hf_time_add(&t, edge_id, fsm_hf_time()-ms);
+    }
+    fsm_hf_time_log(fsm, &t, cnt, 1);
+    return fsm_hf_ws_destroy(&ws), 1;
+  }
+  
+  if ( fsm_hf_th_open(&d, fsm, thread_cnt, cnt, 1) == 0 )
+    return 0;
+  if ( b_th_Do(thread_cnt, cnt, fsm_add_hazard_free_edge_th, &d) == 0 )
+    return fsm_hf_th_close(&d, thread_cnt, cnt), 0;
+  for( i = 0; i < cnt; i++ )
+  {
+    if ( dclJoin(fsm->pi_machine, fsm->cl_machine, d.cl_list[i]) == 0 )
+      return fsm_hf_th_close(&d, thread_cnt, cnt), 0;
+    fsm_hf_time_add(&t, d.edge[i], d.ms[i]);
+  }
+  fsm_hf_time_log(fsm, &t, cnt, thread_cnt);
+  fsm_hf_th_close(&d, thread_cnt, cnt);
+  return 1;
+}
+
 /*
 */
 int fsm_BuildHazardfreeMachine(fsm_type fsm)
 {
-  int edge_id;
   dclRealClear(fsm->cl_machine);
+  fsm_SetMachineInvalid(fsm);
 
   fsm_Log(fsm, "FSM: Building hazardfree control function.");
 
-  edge_id = -1;
-  while( fsm_LoopEdges(fsm, &edge_id) != 0 )
-    if ( fsm_add_hazard_free_edge(fsm, edge_id) == 0 )
-      return 0;
+  if ( fsm_add_hazard_free_edges(fsm) == 0 )
+    return 0;
 
   /*  
   edge_id = -1;
@@ -193,17 +470,58 @@ int fsm_MinimizeAsynchonousMachine(fsm_type fsm)
 
 /*---------------------------------------------------------------------------*/
 
-static int fsm_check_hazard_free_edge(fsm_type fsm, int edge_id, int is_self_transition, int *error_cnt)
+/* c = (in, code of state node) -> code of next node */
+static void fsm_hf_set_cube(struct fsm_hf_ws_struct *ws, dcube *c, dcube *in, int node_id, int next_node_id)
 {
-  dcube *c = &(fsm->pi_machine->tmp[9]);
-  dcube *cc = &(fsm->pi_machine->tmp[10]);
-  dcube *m = &(fsm->pi_machine->tmp[14]);
+  fsm_type fsm = ws->fsm;
+  dcInSetAll(ws->pi_m, c, CUBE_IN_MASK_DC);
+  dcOutSetAll(ws->pi_m, c, 0);
+  dcCopyInToIn(ws->pi_m, c, 
+    0, ws->pi_c, in);
+  dcCopyOutToIn(ws->pi_m, c, 
+    ws->pi_c->in_cnt, fsm->pi_code, fsm_GetNodeCode(fsm, node_id));
+  dcCopyOutToOut(ws->pi_m, c, 
+    0, fsm->pi_code, fsm_GetNodeCode(fsm, next_node_id));
+}
+
+/* callback for dclHazardAnalysisList() */
+static int fsm_hf_analysis_cb(void *data, int pos, dchazard *dch)
+{
+  char *is_hf = (char *)data;
+  /* like dclIsHazardfreeTransition(): static 0 transitions are not checked */
+  if ( dch->is_ok == 0 && dch->type != 0 )
+    is_hf[pos] = 0;
+  return 1;
+}
+
+/* is_hf[i] = 1 if cl_start[i] -> cl_end[i] is hazardfree, NULL for memory errors */
+static char *fsm_hf_analysis(struct fsm_hf_ws_struct *ws, dclist cl_start, dclist cl_end)
+{
+  int i, cnt = dclCnt(cl_start);
+  char *is_hf = (char *)malloc(cnt+1);
+  if ( is_hf == NULL )
+    return NULL;
+  for( i = 0; i < cnt; i++ )
+    is_hf[i] = 1;
+  if ( dclHazardAnalysisList(ws->pi_m, ws->fsm->cl_machine, cl_start, cl_end, 0, fsm_hf_analysis_cb, is_hf) == 0 )
+    return free(is_hf), (char *)NULL;
+  return is_hf;
+}
+
+static int fsm_check_hazard_free_edge(struct fsm_hf_ws_struct *ws, int edge_id, int is_self_transition, int *error_cnt)
+{
+  fsm_type fsm = ws->fsm;
+  dcube *c = &(ws->pi_m->tmp[9]);
+  dcube *m = &(ws->pi_m->tmp[14]);
   int src_node_id = fsm_GetEdgeSrcNode(fsm, edge_id);
   int dest_node_id = fsm_GetEdgeDestNode(fsm, edge_id);
   dclist edge_cl;
   dclist self_cl;
+  dclist cl_start, cl_end;
+  char *is_hf;
   int i_edge, cnt_edge;
   int i_self, cnt_self;
+  int i, cnt;
   int src_self_edge_id;
   int is_error = 0;
 
@@ -213,19 +531,19 @@ static int fsm_check_hazard_free_edge(fsm_type fsm, int edge_id, int is_self_tra
   src_self_edge_id = fsm_FindEdge(fsm, src_node_id, src_node_id);
   if ( src_self_edge_id < 0 )
   {
-    fsm_Log(fsm, "FSM HF: Node %d (%s) is not stable.", 
+    fsm_hf_log(ws, "FSM HF: Node %d (%s) is not stable.", 
       src_node_id, 
       fsm_GetNodeName(fsm, src_node_id)==NULL?"":fsm_GetNodeName(fsm, src_node_id)
       );
     return 0;
   }
   
-  if ( dclInit(&self_cl) == 0 )
+  if ( dclInitVA(3, &self_cl, &cl_start, &cl_end) == 0 )
     return 0;
   
   edge_cl = fsm_GetEdgeCondition(fsm, edge_id);
-  if ( dclCopy(fsm->pi_cond, self_cl, fsm_GetEdgeCondition(fsm, src_self_edge_id)) == 0 )
-    return dclDestroy(self_cl), 0;
+  if ( dclCopy(ws->pi_c, self_cl, fsm_GetEdgeCondition(fsm, src_self_edge_id)) == 0 )
+    return dclDestroyVA(3, self_cl, cl_start, cl_end), 0;
     
   cnt_edge = dclCnt(edge_cl);
   cnt_self = dclCnt(self_cl);
@@ -234,209 +552,192 @@ static int fsm_check_hazard_free_edge(fsm_type fsm, int edge_id, int is_self_tra
 
   for( i_edge = 0; i_edge < cnt_edge; i_edge++ )
   {
-
     /* start */
-
-    dcInSetAll(fsm->pi_machine, c, CUBE_IN_MASK_DC);
-    dcOutSetAll(fsm->pi_machine, c, 0);
-
-    dcCopyInToIn(fsm->pi_machine, c, 
-      0, fsm->pi_cond, dclGet(edge_cl, i_edge));
-    dcCopyOutToIn(fsm->pi_machine, c, 
-      fsm->pi_cond->in_cnt, fsm->pi_code, fsm_GetNodeCode(fsm, src_node_id));
-    dcCopyOutToOut(fsm->pi_machine, c, 
-      0, fsm->pi_code, fsm_GetNodeCode(fsm, dest_node_id));
-
+    fsm_hf_set_cube(ws, c, dclGet(edge_cl, i_edge), src_node_id, dest_node_id);
+    if ( dclAdd(ws->pi_m, cl_start, c) < 0 )
+      return dclDestroyVA(3, self_cl, cl_start, cl_end), 0;
     /* end */
+    fsm_hf_set_cube(ws, c, dclGet(edge_cl, i_edge), dest_node_id, dest_node_id);
+    if ( dclAdd(ws->pi_m, cl_end, c) < 0 )
+      return dclDestroyVA(3, self_cl, cl_start, cl_end), 0;
+  }
 
-    dcInSetAll(fsm->pi_machine, cc, CUBE_IN_MASK_DC);
-    dcOutSetAll(fsm->pi_machine, cc, 0);
-
-    dcCopyInToIn(fsm->pi_machine, cc, 
-      0, fsm->pi_cond, dclGet(edge_cl, i_edge));
-    dcCopyOutToIn(fsm->pi_machine, cc, 
-      fsm->pi_cond->in_cnt, fsm->pi_code, fsm_GetNodeCode(fsm, dest_node_id));
-    dcCopyOutToOut(fsm->pi_machine, cc, 
-      0, fsm->pi_code, fsm_GetNodeCode(fsm, dest_node_id));
+  is_hf = fsm_hf_analysis(ws, cl_start, cl_end);
+  if ( is_hf == NULL )
+    return dclDestroyVA(3, self_cl, cl_start, cl_end), 0;
 
-    if ( dclIsHazardfreeTransition(fsm->pi_machine, fsm->cl_machine, c, cc) == 0 )
+  cnt = dclCnt(cl_start);
+  for( i = 0; i < cnt; i++ )
+  {
+    if ( is_hf[i] == 0 )
     {
-      fsm_Log(fsm, "FSM HF: State transition from %d (%s) to %d (%s) is invalid.",
+      fsm_hf_log(ws, "FSM HF: State transition from %d (%s) to %d (%s) is invalid.",
         src_node_id, 
         fsm_GetNodeName(fsm, src_node_id)==NULL?"":fsm_GetNodeName(fsm, src_node_id),
         dest_node_id, 
         fsm_GetNodeName(fsm, dest_node_id)==NULL?"":fsm_GetNodeName(fsm, dest_node_id)
       );
-      fsm_Log(fsm, "FSM HF:         Source Point: %s.", 
-        dcToStr(fsm->pi_machine, c, " ", ""));
-      fsm_Log(fsm, "FSM HF:    Destination Point: %s.", 
-        dcToStr(fsm->pi_machine, cc, " ", ""));
+      fsm_hf_log(ws, "FSM HF:         Source Point: %s.", 
+        fsm_hf_str(ws, dclGet(cl_start, i)));
+      fsm_hf_log(ws, "FSM HF:    Destination Point: %s.", 
+        fsm_hf_str(ws, dclGet(cl_end, i)));
       is_error = 1;
       (*error_cnt)++;
     }
     else
     {
       /*
-      fsm_Log(fsm, "FSM HF: State transition from %d (%s) to %d (%s) is valid.",
+      fsm_hf_log(ws, "FSM HF: State transition from %d (%s) to %d (%s) is valid.",
         src_node_id, 
         fsm_GetNodeName(fsm, src_node_id)==NULL?"":fsm_GetNodeName(fsm, src_node_id),
         dest_node_id, 
         fsm_GetNodeName(fsm, dest_node_id)==NULL?"":fsm_GetNodeName(fsm, dest_node_id)
       );
-      fsm_Log(fsm, "FSM HF:         Source Point: %s.", 
-        dcToStr(fsm->pi_machine, c, " ", ""));
-      fsm_Log(fsm, "FSM HF:    Destination Point: %s.", 
-        dcToStr(fsm->pi_machine, cc, " ", ""));
+      fsm_hf_log(ws, "FSM HF:         Source Point: %s.", 
+        fsm_hf_str(ws, dclGet(cl_start, i)));
+      fsm_hf_log(ws, "FSM HF:    Destination Point: %s.", 
+        fsm_hf_str(ws, dclGet(cl_end, i)));
       */
     }
   }
+  free(is_hf);
 
   /* INPUT TRANSITION */
 
   edge_cl = fsm_GetEdgeCondition(fsm, edge_id);
     
   cnt_edge = dclCnt(edge_cl);
+  dclClear(cl_start);
+  dclClear(cl_end);
 
   for( i_edge = 0; i_edge < cnt_edge; i_edge++ )
   {
     /* arbitrary change conditions */
     /*
-    if ( dclCopy(fsm->pi_cond, self_cl, fsm_GetEdgeCondition(fsm, src_self_edge_id)) == 0 )
-      return dclDestroy(self_cl), 0;
-    if ( dclDontCareExpand(fsm->pi_cond, self_cl) == 0 )
-      return dclDestroy(self_cl), 0;
+    if ( dclCopy(ws->pi_c, self_cl, fsm_GetEdgeCondition(fsm, src_self_edge_id)) == 0 )
+      return dclDestroyVA(3, self_cl, cl_start, cl_end), 0;
+    if ( dclDontCareExpand(ws->pi_c, self_cl) == 0 )
+      return dclDestroyVA(3, self_cl, cl_start, cl_end), 0;
     */
 
     /* SIC conditions */
     /*
-    if ( dclCopy(fsm->pi_cond, self_cl, fsm_GetEdgeCondition(fsm, src_self_edge_id)) == 0 )
-      return dclDestroy(self_cl), 0;
-    if ( dclRestrictByDistance1(fsm->pi_cond, self_cl, edge_cl) == 0 )
-      return dclDestroy(self_cl), 0;
+    if ( dclCopy(ws->pi_c, self_cl, fsm_GetEdgeCondition(fsm, src_self_edge_id)) == 0 )
+      return dclDestroyVA(3, self_cl, cl_start, cl_end), 0;
+    if ( dclRestrictByDistance1(ws->pi_c, self_cl, edge_cl) == 0 )
+      return dclDestroyVA(3, self_cl, cl_start, cl_end), 0;
     */
 
     /* burst mode conditions */
     if ( fsm_GetNodePreCover(fsm, src_node_id, self_cl) == 0 )
-      return dclDestroy(self_cl), 0;
-    if ( dclPrimes(fsm->pi_cond, self_cl) == 0 )
-      return 0;
-    dclAndElements(fsm->pi_cond, m, self_cl);
+      return dclDestroyVA(3, self_cl, cl_start, cl_end), 0;
+    if ( dclPrimes(ws->pi_c, self_cl) == 0 )
+      return dclDestroyVA(3, self_cl, cl_start, cl_end), 0;
+    dclAndElements(ws->pi_c, m, self_cl);
     
-    if ( dclDontCareExpand(fsm->pi_cond, self_cl) == 0 )
-      return dclDestroy(self_cl), 0;
+    if ( dclDontCareExpand(ws->pi_c, self_cl) == 0 )
+      return dclDestroyVA(3, self_cl, cl_start, cl_end), 0;
       
     cnt_self = dclCnt(self_cl);
     
     for( i_self = 0; i_self < cnt_self; i_self++ )
     {
-    
       /* start */
-    
-      dcInSetAll(fsm->pi_machine, c, CUBE_IN_MASK_DC);
-      dcOutSetAll(fsm->pi_machine, c, 0);
-
-      dcCopyInToIn(fsm->pi_machine, c, 
-        0, fsm->pi_cond, dclGet(self_cl, i_self));
-      dcCopyOutToIn(fsm->pi_machine, c, 
-        fsm->pi_cond->in_cnt, fsm->pi_code, fsm_GetNodeCode(fsm, src_node_id));
-      dcCopyOutToOut(fsm->pi_machine, c, 
-        0, fsm->pi_code, fsm_GetNodeCode(fsm, src_node_id));
-
+      fsm_hf_set_cube(ws, c, dclGet(self_cl, i_self), src_node_id, src_node_id);
+      if ( dclAdd(ws->pi_m, cl_start, c) < 0 )
+        return dclDestroyVA(3, self_cl, cl_start, cl_end), 0;
       /* end */
+      fsm_hf_set_cube(ws, c, dclGet(edge_cl, i_edge), src_node_id, src_node_id);
+      if ( dclAdd(ws->pi_m, cl_end, c) < 0 )
+        return dclDestroyVA(3, self_cl, cl_start, cl_end), 0;
+    }
+  }
+
+  is_hf = fsm_hf_analysis(ws, cl_start, cl_end);
+  if ( is_hf == NULL )
+    return dclDestroyVA(3, self_cl, cl_start, cl_end), 0;
 
-      dcInSetAll(fsm->pi_machine, cc, CUBE_IN_MASK_DC);
-      dcOutSetAll(fsm->pi_machine, cc, 0);
-
-      dcCopyInToIn(fsm->pi_machine, cc, 
-        0, fsm->pi_cond, dclGet(edge_cl, i_edge));
-      dcCopyOutToIn(fsm->pi_machine, cc, 
-        fsm->pi_cond->in_cnt, fsm->pi_code, fsm_GetNodeCode(fsm, src_node_id));
-      dcCopyOutToOut(fsm->pi_machine, cc, 
-        0, fsm->pi_code, fsm_GetNodeCode(fsm, src_node_id));
-
-      if ( dclIsHazardfreeTransition(fsm->pi_machine, fsm->cl_machine, c, cc) == 0 )
-      {
-        fsm_Log(fsm, "FSM HF: Input only transition from %s to %s is invalid.",
-          fsm_GetNodeName(fsm, src_node_id)==NULL?"":fsm_GetNodeName(fsm, src_node_id),
-          fsm_GetNodeName(fsm, dest_node_id)==NULL?"":fsm_GetNodeName(fsm, dest_node_id)
-        );
-        fsm_Log(fsm, "FSM HF:         Source Point: %s.", 
-          dcToStr(fsm->pi_machine, c, " ", ""));
-        fsm_Log(fsm, "FSM HF:    Destination Point: %s.", 
-          dcToStr(fsm->pi_machine, cc, " ", ""));
-        is_error = 1;
-        (*error_cnt)++;
-      }
-      else
-      {
-        fsm_Log(fsm, "FSM HF:         Source Point: %s.", 
-          dcToStr(fsm->pi_machine, c, " ", ""));
-        fsm_Log(fsm, "FSM HF:    Destination Point: %s.", 
-          dcToStr(fsm->pi_machine, cc, " ", ""));
-      }
+  cnt = dclCnt(cl_start);
+  for( i = 0; i < cnt; i++ )
+  {
+    if ( is_hf[i] == 0 )
+    {
+      fsm_hf_log(ws, "FSM HF: Input only transition from %s to %s is invalid.",
+        fsm_GetNodeName(fsm, src_node_id)==NULL?"":fsm_GetNodeName(fsm, src_node_id),
+        fsm_GetNodeName(fsm, dest_node_id)==NULL?"":fsm_GetNodeName(fsm, dest_node_id)
+      );
+      fsm_hf_log(ws, "FSM HF:         Source Point: %s.", 
+        fsm_hf_str(ws, dclGet(cl_start, i)));
+      fsm_hf_log(ws, "FSM HF:    Destination Point: %s.", 
+        fsm_hf_str(ws, dclGet(cl_end, i)));
+      is_error = 1;
+      (*error_cnt)++;
+    }
+    else
+    {
+      fsm_hf_log(ws, "FSM HF:         Source Point: %s.", 
+        fsm_hf_str(ws, dclGet(cl_start, i)));
+      fsm_hf_log(ws, "FSM HF:    Destination Point: %s.", 
+        fsm_hf_str(ws, dclGet(cl_end, i)));
     }
   }
+  free(is_hf);
 
 /* #define FULL_CHECK */
 #ifdef FULL_CHECK
 
   edge_cl = fsm_GetEdgeCondition(fsm, edge_id);
-  if ( dclCopy(fsm->pi_cond, self_cl, fsm_GetEdgeCondition(fsm, src_self_edge_id)) == 0 )
-    return dclDestroy(self_cl), 0;
+  if ( dclCopy(ws->pi_c, self_cl, fsm_GetEdgeCondition(fsm, src_self_edge_id)) == 0 )
+    return dclDestroyVA(3, self_cl, cl_start, cl_end), 0;
     
   cnt_edge = dclCnt(edge_cl);
   cnt_self = dclCnt(self_cl);
+  dclClear(cl_start);
+  dclClear(cl_end);
   
   for( i_self = 0; i_self < cnt_self; i_self++ )
   {
     for( i_edge = 0; i_edge < cnt_edge; i_edge++ )
     {
-    
       /* start */
-    
-      dcInSetAll(fsm->pi_machine, c, CUBE_IN_MASK_DC);
-      dcOutSetAll(fsm->pi_machine, c, 0);
-
-      dcCopyInToIn(fsm->pi_machine, c, 
-        0, fsm->pi_cond, dclGet(self_cl, i_self));
-      dcCopyOutToIn(fsm->pi_machine, c, 
-        fsm->pi_cond->in_cnt, fsm->pi_code, fsm_GetNodeCode(fsm, src_node_id));
-      dcCopyOutToOut(fsm->pi_machine, c, 
-        0, fsm->pi_code, fsm_GetNodeCode(fsm, dest_node_id));
-
+      fsm_hf_set_cube(ws, c, dclGet(self_cl, i_self), src_node_id, dest_node_id);
+      if ( dclAdd(ws->pi_m, cl_start, c) < 0 )
+        return dclDestroyVA(3, self_cl, cl_start, cl_end), 0;
       /* end */
+      fsm_hf_set_cube(ws, c, dclGet(edge_cl, i_edge), dest_node_id, dest_node_id);
+      if ( dclAdd(ws->pi_m, cl_end, c) < 0 )
+        return dclDestroyVA(3, self_cl, cl_start, cl_end), 0;
+    }
+  }
 
-      dcInSetAll(fsm->pi_machine, cc, CUBE_IN_MASK_DC);
-      dcOutSetAll(fsm->pi_machine, cc, 0);
-
-      dcCopyInToIn(fsm->pi_machine, cc, 
-        0, fsm->pi_cond, dclGet(edge_cl, i_edge));
-      dcCopyOutToIn(fsm->pi_machine, cc, 
-        fsm->pi_cond->in_cnt, fsm->pi_code, fsm_GetNodeCode(fsm, dest_node_id));
-      dcCopyOutToOut(fsm->pi_machine, cc, 
-        0, fsm->pi_code, fsm_GetNodeCode(fsm, dest_node_id));
-
-      if ( dclIsHazardfreeTransition(fsm->pi_machine, fsm->cl_machine, c, cc) == 0 )
-      {
-        fsm_Log(fsm, "FSM HF: Full transition from %d (%s) to %d (%s) is invalid.",
-          src_node_id, 
-          fsm_GetNodeName(fsm, src_node_id)==NULL?"":fsm_GetNodeName(fsm, src_node_id),
-          dest_node_id, 
-          fsm_GetNodeName(fsm, dest_node_id)==NULL?"":fsm_GetNodeName(fsm, dest_node_id)
-        );
-        fsm_Log(fsm, "FSM HF:         Source Point: %s.", 
-          dcToStr(fsm->pi_machine, c, " ", ""));
-        fsm_Log(fsm, "FSM HF:    Destination Point: %s.", 
-          dcToStr(fsm->pi_machine, cc, " ", ""));
-        is_error = 1;
-        (*error_cnt)++;
-      }
+  is_hf = fsm_hf_analysis(ws, cl_start, cl_end);
+  if ( is_hf == NULL )
+    return dclDestroyVA(3, self_cl, cl_start, cl_end), 0;
+
+  cnt = dclCnt(cl_start);
+  for( i = 0; i < cnt; i++ )
+  {
+    if ( is_hf[i] == 0 )
+    {
+      fsm_hf_log(ws, "FSM HF: Full transition from %d (%s) to %d (%s) is invalid.",
+        src_node_id, 
+        fsm_GetNodeName(fsm, src_node_id)==NULL?"":fsm_GetNodeName(fsm, src_node_id),
+        dest_node_id, 
+        fsm_GetNodeName(fsm, dest_node_id)==NULL?"":fsm_GetNodeName(fsm, dest_node_id)
+      );
+      fsm_hf_log(ws, "FSM HF:         Source Point: %s.", 
+        fsm_hf_str(ws, dclGet(cl_start, i)));
+      fsm_hf_log(ws, "FSM HF:    Destination Point: %s.", 
+        fsm_hf_str(ws, dclGet(cl_end, i)));
+      is_error = 1;
+      (*error_cnt)++;
     }
   }
+  free(is_hf);
 
 #endif  
 
-  dclDestroy(self_cl);
+  dclDestroyVA(3, self_cl, cl_start, cl_end);
 
   if ( is_error != 0 )
     return 0;
@@ -444,18 +745,75 @@ static int fsm_check_hazard_free_edge(fsm_type fsm, int edge_id, int is_self_tra
   
 }
 
+static int fsm_check_hazard_free_edge_th(void *data, int th, int pos)
+{
+  struct fsm_hf_th_struct *d = (struct fsm_hf_th_struct *)data;
+  struct fsm_hf_ws_struct *ws = d->ws+th;
+  double t = fsm_hf_time();
+  ws->sl = d->sl_list[pos];
+  d->result[pos] = fsm_check_hazard_free_edge(ws, d->edge[pos], d->is_self_transition, d->error_cnt+pos);
+  ws->sl = NULL;
+  d->ms[pos] = fsm_hf_time() - t;
+  /* a failed check is not an error of the loop */
+  return 1;
+}
+
+/* returns 0 for memory errors */
+static int fsm_check_hazard_free_edges(fsm_type fsm, int is_self_transition, int *check_ok, int *error_cnt)
+{
+  struct fsm_hf_th_struct d;
+  struct fsm_hf_ws_struct ws;
+  struct fsm_hf_time_struct t;
+  int edge_id, i, j;
+  int cnt = b_set_Cnt(fsm->edges);
+  int thread_cnt = b_th_GetCnt(0, cnt/FSM_HF_TH_EDGES);
+  double ms;
+  
+  fsm_hf_time_start(&t);
+  if ( thread_cnt <= 1 )
+  {
+    if ( fsm_hf_ws_init(&ws, fsm, 0) == 0 )
+      return 0;
+    edge_id = -1;
+    while( fsm_LoopEdges(fsm, &edge_id) != 0 )
+    {
+      ms = fsm_hf_time();
+      if ( fsm_check_hazard_free_edge(&ws, edge_id, is_self_transition, error_cnt) == 0 )
+        *check_ok = 0;
+      fsm_hf_time_add(&t, edge_id, fsm_hf_time()-ms);
+    }
+    fsm_hf_time_log(fsm, &t, cnt, 1);
+    return fsm_hf_ws_destroy(&ws), 1;
+  }
+  
+  if ( fsm_hf_th_open(&d, fsm, thread_cnt, cnt, 0) == 0 )
+    return 0;
+  d.is_self_transition = is_self_transition;
+  if ( b_th_Do(thread_cnt, cnt, fsm_check_hazard_free_edge_th, &d) == 0 )
+    return fsm_hf_th_close(&d, thread_cnt, cnt), 0;
+  for( i = 0; i < cnt; i++ )
+  {
+    for( j = 0; j < b_sl_GetCnt(d.sl_list[i]); j++ )
+      fsm_Log(fsm, "%s", b_sl_GetVal(d.sl_list[i], j));
+    if ( d.result[i] == 0 )
+      *check_ok = 0;
+    *error_cnt += d.error_cnt[i];
+    fsm_hf_time_add(&t, d.edge[i], d.ms[i]);
+  }
+  fsm_hf_time_log(fsm, &t, cnt, thread_cnt);
+  fsm_hf_th_close(&d, thread_cnt, cnt);
+  return 1;
+}
+
 int fsm_CheckHazardfreeMachine(fsm_type fsm, int is_self_transition)
 {
-  int edge_id;
   int check_ok = 1;
   int error_cnt = 0;
 
   fsm_Log(fsm, "FSM: Checking hazardfree control function (HCF).");
 
-  edge_id = -1;
-  while( fsm_LoopEdges(fsm, &edge_id) != 0 )
-    if ( fsm_check_hazard_free_edge(fsm, edge_id, is_self_transition, &error_cnt) == 0 )
-      check_ok = 0;
+  if ( fsm_check_hazard_free_edges(fsm, is_self_transition, &check_ok, &error_cnt) == 0 )
+    return 0;
 
   if ( check_ok == 0 ) 
     fsm_Log(fsm, "FSM: Check finished, %d error%s found.", error_cnt, error_cnt==1?"":"s");
@@ -526,6 +526,7 @@ int fsm_BuildRobustBurstModeTransferFunction(fsm_type fsm)
   int use_in_code = 1;
   dclRealClear(fsm->cl_machine);
   dclRealClear(fsm->cl_machine_dc);
+  fsm_SetMachineInvalid(fsm);
   if ( dclAdd(fsm->pi_machine, fsm->cl_machine_dc, 
     &(fsm->pi_machine->tmp[0])) < 0 )
   {
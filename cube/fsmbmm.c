@@ -376,7 +376,7 @@ int fsm_BuildSmallBurstModeTransferFunction(fsm_type fsm, int enc_option)
   fsm_Log(fsm, "FSM: Minimizing 'small' hazardfree control function.");
 
   
-  if ( hfp_Minimize(hfp, 0, 1) == 0 )
+  if ( hfp_MinimizeDHF(hfp, 0, 1) == 0 )
   {
     fsm_Log(fsm, "FSM: Error (Minimizing hazardfree transfer function).");
     return hfp_Close(hfp), 0;
@@ -384,6 +384,7 @@ int fsm_BuildSmallBurstModeTransferFunction(fsm_type fsm, int enc_option)
 
   dclCopy(pim, fsm->cl_machine, hfp->cl_on);
   dclClear(fsm->cl_machine_dc);
+  fsm_SetMachineInvalid(fsm);
 
 
   fsm_Log(fsm, "FSM: Control function finished, %d implicants.", dclCnt(fsm->cl_machine));
@@ -528,6 +528,7 @@ static int fsm_bms_copy(fsm_type fsm, pinfo *pi)
       return fsm_Log(fsm, "BMS read: Illegal specification (output, open loop and/or unused variables)."), 0;
     }
 
+    fsm_SetEdgeDirty(fsm, edge_id);
     dclRealClear(fsm_GetEdgeOutput(fsm, edge_id));
     if ( dclAdd(fsm_GetOutputPINFO(fsm), fsm_GetEdgeOutput(fsm, edge_id), oc) < 0 )
       return fsm_Log(fsm, "BMS read: Out of memory (dclAdd)."), 0;
@@ -612,6 +613,7 @@ int fsm_bms_full_stable(fsm_type fsm)
       return dclDestroy(cl_self), dclDestroy(cl_self_o), 0;
     }
     
+    fsm_SetEdgeDirty(fsm, edge_id);
     dclRealClear(fsm_GetEdgeCondition(fsm, edge_id));
     if ( dclCopy(fsm_GetConditionPINFO(fsm), fsm_GetEdgeCondition(fsm, edge_id), cl_self) == 0 )
     {
@@ -770,6 +772,7 @@ int fsm_bms_io_stable(fsm_type fsm)
       return dclDestroy(cl_self), dclDestroy(cl_self_o), 0;
     }
 
+    fsm_SetEdgeDirty(fsm, edge_id);
     dclRealClear(fsm_GetEdgeCondition(fsm, edge_id));
     if ( dclCopy(fsm_GetConditionPINFO(fsm), fsm_GetEdgeCondition(fsm, edge_id), cl_self) == 0 )
     {
@@ -0,0 +1,280 @@
+/*
+
+  fsminc.c
+
+  incremental update of the transfer function (cl_machine)
+
+  Copyright (C) 2001 Oliver Kraus (olikraus@yahoo.com)
+
+  This file is part of DGC.
+
+  DGC is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 2 of the License, or
+  (at your option) any later version.
+
+  DGC is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with DGC; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+
+  fsm_BuildMachine, fsm_BuildMachineToggleFF and fsm_BuildTransferfunction
+  keep the rows of each edge (cl_m_on, cl_m_off). An edge is marked
+  as dirty, if the condition, the output or the destination is changed
+  (fsm_SetEdgeConditionStr, fsm_AddEdgeOutputCube, fsm_ConnectEdge, ...).
+  Code, which changes the lists of an edge directly, must call 
+  fsm_SetEdgeDirty.
+  Rows of deleted edges are collected in cl_m_del_on and cl_m_del_off.
+
+  fsm_UpdateMachine:
+    1. The rows of the dirty edges are calculated again.
+    2. An output of cl_machine is affected, if the rows of one of
+       the dirty or deleted edges differ for this output.
+    3. The affected outputs are removed from cl_machine, a new
+       minimized cover for these outputs is calculated from the rows
+       of all edges and added to cl_machine.
+
+  Changes of the state codes are not detected, use the full build.
+  The hazardfree machines (fsmasync.c, fsmbm.c) are not supported.
+
+*/
+
+#include <stdlib.h>
+#include "fsm.h"
+#include "mwc.h"
+
+void fsm_SetMachineInvalid(fsm_type fsm)
+{
+  fsm->machine_type = FSM_MACHINE_NONE;
+  dclRealClear(fsm->cl_m_del_on);
+  dclRealClear(fsm->cl_m_del_off);
+}
+
+/* also invalidates the cached covers of both nodes (fsm_GetNodeCachedCover) */
+void fsm_SetEdgeDirty(fsm_type fsm, int edge_id)
+{
+  fsmedge_type e = fsm_GetEdge(fsm, edge_id);
+  e->is_dirty = 1;
+  if ( e->source_node >= 0 )
+    fsm_SetNodeCoverInvalid(fsm, e->source_node);
+  if ( e->dest_node >= 0 )
+    fsm_SetNodeCoverInvalid(fsm, e->dest_node);
+}
+
+/* returns 1 if both lists have the same rows for output 'pos' */
+static int fsm_inc_is_equal_out(pinfo *pi, dclist a, dclist b, int pos)
+{
+  int i = 0, j = 0;
+  int a_cnt = dclCnt(a), b_cnt = dclCnt(b);
+  for(;;)
+  {
+    while( i < a_cnt && dcGetOut(dclGet(a, i), pos) == 0 )
+      i++;
+    while( j < b_cnt && dcGetOut(dclGet(b, j), pos) == 0 )
+      j++;
+    if ( i >= a_cnt || j >= b_cnt )
+      break;
+    if ( dcIsEqualIn(pi, dclGet(a, i), dclGet(b, j)) == 0 )
+      return 0;
+    i++;
+    j++;
+  }
+  return i >= a_cnt && j >= b_cnt ? 1 : 0;
+}
+
+static void fsm_inc_mark_changed(pinfo *pi, dclist a, dclist b, char *affected)
+{
+  int pos;
+  for( pos = 0; pos < pi->out_cnt; pos++ )
+    if ( affected[pos] == 0 )
+      if ( fsm_inc_is_equal_out(pi, a, b, pos) == 0 )
+        affected[pos] = 1;
+}
+
+static void fsm_inc_mark_used(pinfo *pi, dclist a, char *affected)
+{
+  int i, pos;
+  for( i = 0; i < dclCnt(a); i++ )
+    for( pos = 0; pos < pi->out_cnt; pos++ )
+      if ( dcGetOut(dclGet(a, i), pos) != 0 )
+        affected[pos] = 1;
+}
+
+/* copy the affected outputs of 'src' into 'dest' (pi_sub) */
+static int fsm_inc_project(fsm_type fsm, pinfo *pi_sub, dclist dest, dclist src, int *sub_to_pos)
+{
+  dcube *c = &(pi_sub->tmp[9]);
+  dcube *s;
+  int i, k;
+  for( i = 0; i < dclCnt(src); i++ )
+  {
+    s = dclGet(src, i);
+    dcCopyInToIn(pi_sub, c, 0, fsm->pi_machine, s);
+    dcOutSetAll(pi_sub, c, 0);
+    for( k = 0; k < pi_sub->out_cnt; k++ )
+      if ( dcGetOut(s, sub_to_pos[k]) != 0 )
+        dcSetOut(c, k, 1);
+    if ( dcIsOutIllegal(pi_sub, c) == 0 )
+      if ( dclAdd(pi_sub, dest, c) < 0 )
+        return 0;
+  }
+  return 1;
+}
+
+/* remove the affected outputs from 'cl' and add the cubes of 'sub' */
+static int fsm_inc_replace(fsm_type fsm, dclist cl, pinfo *pi_sub, dclist sub, char *affected, int *sub_to_pos)
+{
+  pinfo *pi = fsm->pi_machine;
+  dcube *c = &(pi->tmp[9]);
+  int i, k, pos;
+
+  dclClearFlags(cl);
+  for( i = 0; i < dclCnt(cl); i++ )
+  {
+    for( pos = 0; pos < pi->out_cnt; pos++ )
+      if ( affected[pos] != 0 )
+        dcSetOut(dclGet(cl, i), pos, 0);
+    if ( dcIsOutIllegal(pi, dclGet(cl, i)) != 0 )
+      dclSetFlag(cl, i);
+  }
+  dclDeleteCubesWithFlag(pi, cl);
+
+  for( i = 0; i < dclCnt(sub); i++ )
+  {
+    dcCopyInToIn(pi, c, 0, pi_sub, dclGet(sub, i));
+    dcOutSetAll(pi, c, 0);
+    for( k = 0; k < pi_sub->out_cnt; k++ )
+      if ( dcGetOut(dclGet(sub, i), k) != 0 )
+        dcSetOut(c, sub_to_pos[k], 1);
+    if ( dclAdd(pi, cl, c) < 0 )
+      return 0;
+  }
+  return 1;
+}
+
+static int fsm_inc_minimize(fsm_type fsm, char *affected, int cnt)
+{
+  pinfo *pi_sub;
+  dclist cl_on, cl_off, cl_dc;
+  int *sub_to_pos;
+  int pos, k, node_id, edge_id, loop;
+  fsmedge_type e;
+
+  sub_to_pos = (int *)malloc(sizeof(int)*cnt);
+  if ( sub_to_pos == NULL )
+    return 0;
+  k = 0;
+  for( pos = 0; pos < fsm->pi_machine->out_cnt; pos++ )
+    if ( affected[pos] != 0 )
+      sub_to_pos[k++] = pos;
+
+  pi_sub = pinfoOpenInOut(fsm->pi_machine->in_cnt, cnt);
+  if ( pi_sub == NULL )
+    return free(sub_to_pos), 0;
+  if ( dclInitVA(3, &cl_on, &cl_off, &cl_dc) == 0 )
+    return pinfoClose(pi_sub), free(sub_to_pos), 0;
+
+  /* same order as the full build */
+  node_id = -1;
+  while( fsm_LoopNodes(fsm, &node_id) != 0 )
+  {
+    loop = -1;
+    while( fsm_LoopNodeInEdges(fsm, node_id, &loop, &edge_id) != 0 )
+    {
+      e = fsm_GetEdge(fsm, edge_id);
+      if ( fsm_inc_project(fsm, pi_sub, cl_on, e->cl_m_on, sub_to_pos) == 0 ||
+           fsm_inc_project(fsm, pi_sub, cl_off, e->cl_m_off, sub_to_pos) == 0 )
+        return dclDestroyVA(3, cl_on, cl_off, cl_dc), pinfoClose(pi_sub), free(sub_to_pos), 0;
+    }
+  }
+
+  if ( fsm->machine_type == FSM_MACHINE_TRANSFER )
+  {
+    /* see fsm_BuildTransferfunction and fsm_BuildMinimizedTransferfunction */
+    dcSetTautology(pi_sub, &(pi_sub->tmp[9]));
+    if ( dclAdd(pi_sub, cl_dc, &(pi_sub->tmp[9])) < 0 ||
+         dclSubtract(pi_sub, cl_dc, cl_on) == 0 ||
+         dclSubtract(pi_sub, cl_dc, cl_off) == 0 ||
+         fsm_inc_replace(fsm, fsm->cl_machine_dc, pi_sub, cl_dc, affected, sub_to_pos) == 0 ||
+         dclMinimizeDC(pi_sub, cl_on, cl_dc, 0, 1) == 0 )
+      return dclDestroyVA(3, cl_on, cl_off, cl_dc), pinfoClose(pi_sub), free(sub_to_pos), 0;
+  }
+  else
+  {
+    if ( dclMinimize(pi_sub, cl_on) == 0 )
+      return dclDestroyVA(3, cl_on, cl_off, cl_dc), pinfoClose(pi_sub), free(sub_to_pos), 0;
+  }
+
+  if ( fsm_inc_replace(fsm, fsm->cl_machine, pi_sub, cl_on, affected, sub_to_pos) == 0 )
+    return dclDestroyVA(3, cl_on, cl_off, cl_dc), pinfoClose(pi_sub), free(sub_to_pos), 0;
+
+  dclDestroyVA(3, cl_on, cl_off, cl_dc);
+  pinfoClose(pi_sub);
+  free(sub_to_pos);
+  return 1;
+}
+
+/*
+  Updates cl_machine after changes of edges. Only the affected outputs
+  are minimized again. Returns 0 if there is no machine (call
+  one of the build functions) or for a memory error.
+*/
+int fsm_UpdateMachine(fsm_type fsm)
+{
+  pinfo *pi = fsm->pi_machine;
+  dclist cl_on, cl_off;
+  char *affected;
+  int edge_id, pos, cnt, edge_cnt;
+  fsmedge_type e;
+
+  if ( fsm->machine_type == FSM_MACHINE_NONE )
+    return 0;
+
+  affected = (char *)calloc(pi->out_cnt+1, 1);
+  if ( affected == NULL )
+    return 0;
+  if ( dclInitVA(2, &cl_on, &cl_off) == 0 )
+    return free(affected), 0;
+
+  fsm_inc_mark_used(pi, fsm->cl_m_del_on, affected);
+  fsm_inc_mark_used(pi, fsm->cl_m_del_off, affected);
+  dclRealClear(fsm->cl_m_del_on);
+  dclRealClear(fsm->cl_m_del_off);
+
+  edge_cnt = 0;
+  edge_id = -1;
+  while( fsm_LoopEdges(fsm, &edge_id) != 0 )
+  {
+    e = fsm_GetEdge(fsm, edge_id);
+    if ( e->is_dirty == 0 )
+      continue;
+    if ( fsm_BuildEdgeMachine(fsm, edge_id, fsm->machine_type, cl_on, cl_off) == 0 )
+      return dclDestroyVA(2, cl_on, cl_off), free(affected), 0;
+    fsm_inc_mark_changed(pi, e->cl_m_on, cl_on, affected);
+    fsm_inc_mark_changed(pi, e->cl_m_off, cl_off, affected);
+    if ( dclCopy(pi, e->cl_m_on, cl_on) == 0 || dclCopy(pi, e->cl_m_off, cl_off) == 0 )
+      return dclDestroyVA(2, cl_on, cl_off), free(affected), 0;
+    edge_cnt++;
+  }
+  dclDestroyVA(2, cl_on, cl_off);
+
+  cnt = 0;
+  for( pos = 0; pos < pi->out_cnt; pos++ )
+    if ( affected[pos] != 0 )
+      cnt++;
+
+  fsm_Log(fsm, "FSM: Incremental update: %d changed edge(s), %d of %d output(s) affected.",
+    edge_cnt, cnt, pi->out_cnt);
+
+  if ( cnt > 0 )
+    if ( fsm_inc_minimize(fsm, affected, cnt) == 0 )
+      return free(affected), 0;
+
+  free(affected);
+  return 1;
+}
@@ -31,6 +31,7 @@
 */
 
 #include "b_il.h"
+#include "b_mc.h"
 #include "fsm.h"
 
 static int dcl_is_fbo_compatible(pinfo *pi, dclist c1, dclist c2)
@@ -116,15 +117,18 @@ int dcl_is_output_compatible(pinfo *pi, dclist c1, dclist c2)
 }
 
 
-static int hm_xy_to_pos(int x, int y)
+static long hm_xy_to_pos(int x, int y)
 {
   if ( x == y ) 
     return -1;
   if ( x > y )
-    return (x-1)*x/2 + y;
-  return (y-1)*y/2 + x;
+    return (long)(x-1)*(long)x/2 + y;
+  return (long)(y-1)*(long)y/2 + x;
 }
 
+/* the half matrix stores one bit for each pair of states */
+#define HM_BITS 32
+
 
 
 /*---------------------------------------------------------------------------*/
@@ -133,8 +137,8 @@ struct _hm_struct
 {
   fsm_type fsm;
   int n;
-  int *m;
-  int m_size;
+  unsigned *m;    /* packed bits */
+  long m_size;    /* number of bits */
   int *flag_list;
   b_pl_type pl;   /* list of compatible sets */
 };
@@ -154,11 +158,10 @@ hm_type hm_Open(fsm_type fsm, int n)
   {
     hm->fsm = fsm;
     hm->n = n;
-    hm->m_size = (n-1)*n/2;
-    hm->m = (int *)malloc(sizeof(int)*hm->m_size);
+    hm->m_size = n > 0 ? (long)(n-1)*(long)n/2 : 0;
+    hm->m = (unsigned *)calloc(hm->m_size/HM_BITS+1, sizeof(unsigned));
     if ( hm->m != NULL )
     {
-      memset(hm->m, 0, sizeof(int)*hm->m_size);
       assert(hm_xy_to_pos(0, 0) == -1 );
       assert(hm_xy_to_pos(0, 1) == 0 );
       assert(hm_xy_to_pos(1, 0) == 0 );
@@ -175,10 +178,10 @@ hm_type hm_Open(fsm_type fsm, int n)
       hm->pl = b_pl_Open();
       if ( hm->pl != NULL )
       {
-        hm->flag_list = (int *)malloc(sizeof(int)*hm->n);
+        hm->flag_list = (int *)malloc(sizeof(int)*(hm->n+1));
         if ( hm->flag_list != NULL )
         {
-          memset(hm->flag_list, 0, sizeof(int)*hm->n);
+          memset(hm->flag_list, 0, sizeof(int)*(hm->n+1));
           return hm;
           /*
           hm->pi_imply = pinfoOpenInOut(b_set_Cnt(fsm->nodes), b_set_Cnt(fsm->nodes))
@@ -219,25 +222,19 @@ void hm_Close(hm_type hm)
 
 void hm_Set(hm_type hm, int x, int y, int v)
 {
-  int pos = hm_xy_to_pos(x, y);
+  long pos = hm_xy_to_pos(x, y);
   assert(pos >= 0 && pos < hm->m_size);
-  hm->m[pos] = v;
+  if ( v != 0 )
+    hm->m[pos/HM_BITS] |= 1U << (pos%HM_BITS);
+  else
+    hm->m[pos/HM_BITS] &= ~(1U << (pos%HM_BITS));
 }
 
 int hm_Get(hm_type hm, int x, int y)
 {
-  int pos = hm_xy_to_pos(x, y);
+  long pos = hm_xy_to_pos(x, y);
   assert(pos >= 0 && pos < hm->m_size);
-  return hm->m[pos];
-}
-
-int hm_IsSetCompatible(hm_type hm, b_il_type il, int s)
-{
-  int i;
-  for( i = 0; i < b_il_GetCnt(il); i++ )
-    if ( hm_Get(hm, b_il_GetVal(il, i), s) == 0 )
-      return 0;
-  return 1;
+  return (hm->m[pos/HM_BITS] >> (pos%HM_BITS)) & 1U;
 }
 
 /* returns position */
@@ -256,11 +253,34 @@ int hm_AddEmptySet(hm_type hm)
   return -1;
 }
 
+/* greedy partition: each set is extended with the next compatible states */
 int hm_BuildCompatibleSets(hm_type hm)
 {
   int n1, n2;
-  int pos;
-  memset(hm->flag_list, 0, sizeof(int)*hm->n);
+  int pos, i, cnt;
+  int *v;
+  b_mc_type mc;
+
+  mc = b_mc_Open(hm->n);
+  if ( mc == NULL )
+    return 0;
+  v = (int *)malloc(sizeof(int)*(hm->n+1));
+  if ( v == NULL )
+    return b_mc_Close(mc), 0;
+
+  /* states, which are not used, are excluded by the flag list */
+  for( n1 = 0; n1 < hm->n; n1++ )
+    hm->flag_list[n1] = 1;
+  n1 = -1;
+  while( fsm_LoopNodes(hm->fsm, &n1) != 0 )
+  {
+    hm->flag_list[n1] = 0;
+    n2 = -1;
+    while( fsm_LoopNodes(hm->fsm, &n2) != 0 )
+      if ( n2 < n1 && hm_Get(hm, n1, n2) != 0 )
+        b_mc_SetEdge(mc, n1, n2);
+  }
+
   n1 = -1;
   while( fsm_LoopNodes(hm->fsm, &n1) != 0 )
   {
@@ -268,29 +288,22 @@ int hm_BuildCompatibleSets(hm_type hm)
     {
       pos = hm_AddEmptySet(hm);
       if ( pos < 0 )
-        return 0;
-      if ( b_il_Add(hm_GetSet(hm, pos), n1) < 0 )
-        return 0;
+        return free(v), b_mc_Close(mc), 0;
+      v[0] = n1;
       hm->flag_list[n1] = 1;
-      if ( fsm_SetNodeGroup(hm->fsm, n1, pos) == 0 )
-        return 0;
-      n2 = -1;
-      while( fsm_LoopNodes(hm->fsm, &n2) != 0 )
+      cnt = b_mc_Extend(mc, v, 1, hm->flag_list);
+      for( i = 0; i < cnt; i++ )
       {
-        if ( hm->flag_list[n2] == 0 )
-        {
-          if ( hm_IsSetCompatible(hm, hm_GetSet(hm, pos), n2) != 0 )
-          {
-            hm->flag_list[n2] = 1;
-            if ( fsm_SetNodeGroup(hm->fsm, n2, pos) == 0 )
-              return 0;
-            if ( b_il_Add(hm_GetSet(hm, pos), n2) < 0 )
-              return 0;
-          }
-        }
+        hm->flag_list[v[i]] = 1;
+        if ( fsm_SetNodeGroup(hm->fsm, v[i], pos) == 0 )
+          return free(v), b_mc_Close(mc), 0;
+        if ( b_il_Add(hm_GetSet(hm, pos), v[i]) < 0 )
+          return free(v), b_mc_Close(mc), 0;
       }
     }
   }
+  free(v);
+  b_mc_Close(mc);
   return 1;
 }
 
@@ -110,11 +110,13 @@ int fsm_DupMoore(fsm_type fsm, int node_id)
   
   edge_id = fsm_FindEdge(fsm, node_id, node_id);
   assert(edge_id >= 0);
+  fsm_SetEdgeDirty(fsm, edge_id);
   if ( dclCopy(pi, fsm_GetEdgeOutput(fsm, edge_id), cl_eq ) == 0 )
     return dclDestroyVA(3, cl_eq, cl_r, cl_i), 0;
 
   edge_id = fsm_FindEdge(fsm, new_node_id, new_node_id);
   assert(edge_id >= 0);
+  fsm_SetEdgeDirty(fsm, edge_id);
   if ( dclCopy(pi, fsm_GetEdgeOutput(fsm, edge_id), cl_r) == 0 )
     return dclDestroyVA(3, cl_eq, cl_r, cl_i), 0;
 
@@ -134,15 +136,21 @@ int fsm_DupMoore(fsm_type fsm, int node_id)
   edge_id = -1;
   while( fsm_LoopNodeInEdges(fsm, node_id, &loop, &edge_id) != 0 )
     if ( fsm_GetEdgeSrcNode(fsm,edge_id) != fsm_GetEdgeDestNode(fsm,edge_id) )
+    {
+      fsm_SetEdgeDirty(fsm, edge_id);
       if ( dclSubtract(pi, fsm_GetEdgeOutput(fsm, edge_id), cl_r ) == 0 )
         return dclDestroyVA(3, cl_eq, cl_r, cl_i), 0;
+    }
 
   loop = -1;
   edge_id = -1;
   while( fsm_LoopNodeInEdges(fsm, new_node_id, &loop, &edge_id) != 0 )
     if ( fsm_GetEdgeSrcNode(fsm,edge_id) != fsm_GetEdgeDestNode(fsm,edge_id) )
+    {
+      fsm_SetEdgeDirty(fsm, edge_id);
       if ( dclSubtract(pi, fsm_GetEdgeOutput(fsm, edge_id), cl_eq ) == 0 )
         return dclDestroyVA(3, cl_eq, cl_r, cl_i), 0;
+    }
 
   fsm_GetNode(fsm, node_id)->user_val = 1;
   return dclDestroyVA(3, cl_eq, cl_r, cl_i), 1;
@@ -26,6 +26,7 @@
 
 #include "fsm.h"
 #include <assert.h>
+#include <stdlib.h>
 #include "mwc.h"
 
 
@@ -148,7 +149,108 @@ int fsm_RequiredCubes(fsm_type fsm, dclist cl_rc)
 
 #endif
 
-static int fsm_required_cubes_self_loop(fsm_type fsm, dclist cl_rc, int edge_id, dcube *c )
+/*
+  The required cubes are indexed by a hash of the cube bits, so that
+  the (frequent) exact duplicates are found without a scan of the list.
+  The 'n' member of a required cube stores the stamp of its latest 
+  insertion, fsm_RequiredCubes() sorts the list by this stamp.
+*/
+struct _fsm_rc_struct
+{
+  pinfo *pi_m;
+  dclist cl_rc;
+  b_ih_type ih;
+  int stamp;
+};
+typedef struct _fsm_rc_struct fsm_rc_struct;
+
+static unsigned fsm_rc_hash(pinfo *pi_m, dcube *c)
+{
+  int i;
+  unsigned h = 0;
+  for( i = 0; i < pi_m->in_words; i++ )
+    h = b_ih_IntHash((int)h, (int)c->in[i]);
+  for( i = 0; i < pi_m->out_words; i++ )
+    h = b_ih_IntHash((int)h, (int)c->out[i]);
+  return h;
+}
+
+static int fsm_rc_cmp(void *data, int el, const void *key)
+{
+  fsm_rc_struct *rc = (fsm_rc_struct *)data;
+  if ( dcIsEqual(rc->pi_m, dclGet(rc->cl_rc, el), (dcube *)key) != 0 )
+    return 0;
+  return 1;
+}
+
+static int fsm_rc_compare_stamp(const void *ap, const void *bp)
+{
+  if ( ((dcube *)ap)->n < ((dcube *)bp)->n )
+    return -1;
+  if ( ((dcube *)ap)->n > ((dcube *)bp)->n )
+    return 1;
+  return 0;
+}
+
+/* removes the flagged cubes and rebuilds the hash index */
+static int fsm_rc_delete_flagged(fsm_rc_struct *rc)
+{
+  int i, cnt;
+  
+  dclDeleteCubesWithFlag(rc->pi_m, rc->cl_rc);
+  
+  cnt = dclCnt(rc->cl_rc);
+  b_ih_Clear(rc->ih);
+  for( i = 0; i < cnt; i++ )
+    if ( b_ih_Ins(rc->ih, i, fsm_rc_hash(rc->pi_m, dclGet(rc->cl_rc, i))) == 0 )
+      return 0;
+  return 1;
+}
+
+/*
+  Adds 'c' to the required cubes 'rc->cl_rc' and keeps the list free of
+  single cube containment: 'c' is ignored if it is a subset of
+  a required cube, required cubes which are covered by 'c' are removed.
+  After sorting by the stamps, the order of the cubes is the same as 
+  after a final dclSCC().
+*/
+static int fsm_required_cubes_add(fsm_rc_struct *rc, dcube *c)
+{
+  pinfo *pi_m = rc->pi_m;
+  dclist cl_rc = rc->cl_rc;
+  int i, cnt = dclCnt(cl_rc);
+  int flags = 0;
+  int pos;
+  unsigned hash = fsm_rc_hash(pi_m, c);
+  
+  pos = b_ih_Find(rc->ih, c, hash);
+  if ( pos >= 0 )
+  {
+    dclGet(cl_rc, pos)->n = rc->stamp++;
+    return 1;
+  }
+  
+  for( i = 0; i < cnt; i++ )
+  {
+    if ( dcIsSubSet(pi_m, dclGet(cl_rc, i), c) != 0 )
+      return 1;
+    if ( dcIsSubSet(pi_m, c, dclGet(cl_rc, i)) != 0 )
+    {
+      dclSetFlag(cl_rc, i);
+      flags++;
+    }
+  }
+  
+  pos = dclAdd(pi_m, cl_rc, c);
+  if ( pos < 0 )
+    return 0;
+  dclGet(cl_rc, pos)->n = rc->stamp++;
+  if ( flags > 0 )
+    return fsm_rc_delete_flagged(rc);
+  return b_ih_Ins(rc->ih, pos, hash);
+}
+
+static int fsm_required_cubes_self_loop(fsm_type fsm, fsm_rc_struct *rc, int edge_id, dcube *c )
 {
   int src_node = fsm_GetEdgeSrcNode(fsm, edge_id);
   int dest_node = fsm_GetEdgeDestNode(fsm, edge_id);
@@ -165,12 +267,12 @@ static int fsm_required_cubes_self_loop(fsm_type fsm, dclist cl_rc, int edge_id,
   dcCopyInToIn(pi_m, r, 0, pi_o, c);
   dcCopyOutToIn(pi_m, r, pi_o->in_cnt, fsm->pi_code, fsm_GetNodeCode(fsm, src_node));
   
-  if ( dclAdd(pi_m, cl_rc, r) < 0 )
+  if ( fsm_required_cubes_add(rc, r) == 0 )
     return 0;
   return 1;
 }
 
-static int fsm_required_cubes_transition(fsm_type fsm, dclist cl_rc, int edge_id, dcube *c)
+static int fsm_required_cubes_transition(fsm_type fsm, fsm_rc_struct *rc, int edge_id, dcube *c)
 {
   int src_node = fsm_GetEdgeSrcNode(fsm, edge_id);
   int dest_node = fsm_GetEdgeDestNode(fsm, edge_id);
@@ -195,7 +297,7 @@ static int fsm_required_cubes_transition(fsm_type fsm, dclist cl_rc, int edge_id
 
   dcOr(pi_m, r, r, s);
   
-  if ( dclAdd(pi_m, cl_rc, r) < 0 )
+  if ( fsm_required_cubes_add(rc, r) == 0 )
     return 0;
   return 1;
 }
@@ -204,7 +306,7 @@ static int fsm_required_cubes_transition(fsm_type fsm, dclist cl_rc, int edge_id
   D1(T(s_i, s_j)) cap T(s_i, s_i)
   
 */
-static int fsm_required_cubes_input_stable_change(fsm_type fsm, dclist cl_rc, int edge_id)
+static int fsm_required_cubes_input_stable_change(fsm_type fsm, fsm_rc_struct *rc, int edge_id)
 {
   int src_node = fsm_GetEdgeSrcNode(fsm, edge_id);
   /* int dest_node = fsm_GetEdgeDestNode(fsm, edge_id); */
@@ -255,7 +357,7 @@ static int fsm_required_cubes_input_stable_change(fsm_type fsm, dclist cl_rc, in
 
       dcOr(pi_m, r, r, s);
 
-      if ( dclAdd(pi_m, cl_rc, r) < 0 )
+      if ( fsm_required_cubes_add(rc, r) == 0 )
         return dclDestroyCachedVA(pi, 3, cl_dt, cl_t, cl_i), 0;
     }
   
@@ -268,19 +370,30 @@ int fsm_RequiredCubes(fsm_type fsm, dclist cl_rc)
   int edge_id, src_node, dest_node;
   dclist cl_primes;
   pinfo *pi = fsm_GetOutputPINFO(fsm);
+  fsm_rc_struct rc;
   int i, cnt;
   
-  if ( dclInit(&cl_primes) == 0 )
+  rc.pi_m = fsm->pi_machine;
+  rc.cl_rc = cl_rc;
+  rc.stamp = 0;
+  rc.ih = b_ih_Open();
+  if ( rc.ih == NULL )
     return 0;
+  b_ih_SetCmpFn(rc.ih, fsm_rc_cmp, &rc);
+  
+  if ( dclInit(&cl_primes) == 0 )
+    return b_ih_Close(rc.ih), 0;
   
   edge_id = -1;  
   dclClear(cl_rc);
+  if ( dclClearFlags(cl_rc) == 0 )
+    return b_ih_Close(rc.ih), dclDestroy(cl_primes), 0;
   while( fsm_LoopEdges(fsm, &edge_id) != 0 )
   {
     if ( dclCopy(pi, cl_primes, fsm_GetEdgeOutput(fsm, edge_id)) == 0 )
-      return dclDestroy(cl_primes), 0;
+      return b_ih_Close(rc.ih), dclDestroy(cl_primes), 0;
     if ( dclPrimes(pi, cl_primes) == 0 )
-      return dclDestroy(cl_primes), 0;
+      return b_ih_Close(rc.ih), dclDestroy(cl_primes), 0;
     cnt = dclCnt(cl_primes);
     
     src_node = fsm_GetEdgeSrcNode(fsm, edge_id);
@@ -288,21 +401,21 @@ int fsm_RequiredCubes(fsm_type fsm, dclist cl_rc)
     if ( src_node == dest_node )
     {
       for( i = 0; i < cnt; i++ )
-        if ( fsm_required_cubes_self_loop(fsm, cl_rc, edge_id, dclGet(cl_primes, i)) == 0 )
-          return dclDestroy(cl_primes), 0;
+        if ( fsm_required_cubes_self_loop(fsm, &rc, edge_id, dclGet(cl_primes, i)) == 0 )
+          return b_ih_Close(rc.ih), dclDestroy(cl_primes), 0;
     }
     else
     {
       for( i = 0; i < cnt; i++ )
-        if ( fsm_required_cubes_transition(fsm, cl_rc, edge_id, dclGet(cl_primes, i)) == 0 )
-          return dclDestroy(cl_primes), 0;
-      if ( fsm_required_cubes_input_stable_change(fsm, cl_rc, edge_id) == 0 )
-        return dclDestroy(cl_primes), 0;
+        if ( fsm_required_cubes_transition(fsm, &rc, edge_id, dclGet(cl_primes, i)) == 0 )
+          return b_ih_Close(rc.ih), dclDestroy(cl_primes), 0;
+      if ( fsm_required_cubes_input_stable_change(fsm, &rc, edge_id) == 0 )
+        return b_ih_Close(rc.ih), dclDestroy(cl_primes), 0;
     }
   }
   
-  dclSCC(fsm->pi_machine, cl_rc);
+  if ( dclCnt(cl_rc) > 1 )
+    qsort(dclGet(cl_rc, 0), dclCnt(cl_rc), sizeof(dcube), fsm_rc_compare_stamp);
   
-  return dclDestroy(cl_primes), 1;
+  return b_ih_Close(rc.ih), dclDestroy(cl_primes), 1;
 }
-
@@ -220,6 +220,7 @@ static int fsm_RestrictSICOutEdge(fsm_type fsm, dclist d1_stable, int edge_id, i
       if ( do_change != 0 )
       {
         fsm_WarningSICOutputRestricted(fsm, edge_id);
+        fsm_SetEdgeDirty(fsm, edge_id);
         if ( dclCopy(fsm->pi_cond, fsm_GetEdgeCondition(fsm, edge_id), cl) == 0 )
           return dclDestroy(cl), 0;
       }
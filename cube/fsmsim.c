@@ -0,0 +1,357 @@
+/*
+
+  fsmsim.c
+
+  compiled simulation of a clocked fsm (cl_machine)
+
+  Copyright (C) 2001 Oliver Kraus (olikraus@yahoo.com)
+
+  This file is part of DGC.
+
+  DGC is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 2 of the License, or
+  (at your option) any later version.
+
+  DGC is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with DGC; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+*/
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include "fsmsim.h"
+#include "mwc.h"
+
+void fsmsim_Close(fsmsim_type fs)
+{
+  free(fs->lit_start);
+  free(fs->lit);
+  free(fs->out_start);
+  free(fs->out);
+  free(fs->var);
+  free(fs->res);
+  free(fs->reset_code);
+  free(fs);
+}
+
+fsmsim_type fsmsim_Open(fsm_type fsm)
+{
+  fsmsim_type fs;
+  pinfo *pi = fsm->pi_machine;
+  dclist cl = fsm->cl_machine;
+  dcube *c;
+  int i, j, lit_cnt, out_cnt;
+
+  fs = (fsmsim_type)calloc(1, sizeof(struct _fsmsim_struct));
+  if ( fs == NULL )
+    return NULL;
+  fs->fsm = fsm;
+  fs->code_width = fsm_GetCodeWidth(fsm);
+  fs->in_cnt = pi->in_cnt - fs->code_width;
+  fs->out_cnt = pi->out_cnt - fs->code_width;
+  fs->cube_cnt = dclCnt(cl);
+  if ( fs->in_cnt < 0 || fs->out_cnt < 0 )
+    return fsmsim_Close(fs), (fsmsim_type)NULL;
+
+  lit_cnt = 0;
+  out_cnt = 0;
+  for( i = 0; i < fs->cube_cnt; i++ )
+  {
+    c = dclGet(cl, i);
+    for( j = 0; j < pi->in_cnt; j++ )
+      if ( dcGetIn(c, j) != 3 )
+        lit_cnt++;
+    for( j = 0; j < pi->out_cnt; j++ )
+      if ( dcGetOut(c, j) != 0 )
+        out_cnt++;
+  }
+
+  fs->lit_start = (int *)malloc(sizeof(int)*(fs->cube_cnt+1));
+  fs->lit = (int *)malloc(sizeof(int)*(lit_cnt+1));
+  fs->out_start = (int *)malloc(sizeof(int)*(fs->cube_cnt+1));
+  fs->out = (int *)malloc(sizeof(int)*(out_cnt+1));
+  fs->var = (fsmsim_word *)calloc(pi->in_cnt+1, sizeof(fsmsim_word));
+  fs->res = (fsmsim_word *)calloc(pi->out_cnt+1, sizeof(fsmsim_word));
+  fs->reset_code = (unsigned char *)calloc(fs->code_width+1, 1);
+  if ( fs->lit_start == NULL || fs->lit == NULL || fs->out_start == NULL ||
+       fs->out == NULL || fs->var == NULL || fs->res == NULL ||
+       fs->reset_code == NULL )
+    return fsmsim_Close(fs), (fsmsim_type)NULL;
+
+  /* dcGetIn: 1 = zero, 2 = one, 3 = don't care */
+  lit_cnt = 0;
+  out_cnt = 0;
+  for( i = 0; i < fs->cube_cnt; i++ )
+  {
+    c = dclGet(cl, i);
+    fs->lit_start[i] = lit_cnt;
+    fs->out_start[i] = out_cnt;
+    for( j = 0; j < pi->in_cnt; j++ )
+      switch(dcGetIn(c, j))
+      {
+        case 1: fs->lit[lit_cnt++] = 2*j+1; break;
+        case 2: fs->lit[lit_cnt++] = 2*j; break;
+        case 0: fs->lit[lit_cnt++] = 2*j; fs->lit[lit_cnt++] = 2*j+1; break;
+      }
+    for( j = 0; j < pi->out_cnt; j++ )
+      if ( dcGetOut(c, j) != 0 )
+        fs->out[out_cnt++] = j;
+  }
+  fs->lit_start[fs->cube_cnt] = lit_cnt;
+  fs->out_start[fs->cube_cnt] = out_cnt;
+
+  if ( fsm->reset_node_id >= 0 )
+    for( j = 0; j < fs->code_width; j++ )
+      fs->reset_code[j] = dcGetOut(fsm_GetNodeCode(fsm, fsm->reset_node_id), j);
+
+  return fs;
+}
+
+void fsmsim_Reset(fsmsim_type fs, fsmsim_word mask)
+{
+  int j;
+  fsmsim_word *s = fs->var + fs->in_cnt;
+  for( j = 0; j < fs->code_width; j++ )
+    if ( fs->reset_code[j] != 0 )
+      s[j] |= mask;
+    else
+      s[j] &= ~mask;
+}
+
+void fsmsim_Step(fsmsim_type fs, fsmsim_word mask)
+{
+  fsmsim_word p;
+  fsmsim_word *var = fs->var;
+  fsmsim_word *res = fs->res;
+  int i, j, l;
+  int res_cnt = fs->code_width + fs->out_cnt;
+
+  for( j = 0; j < res_cnt; j++ )
+    res[j] = 0;
+
+  for( i = 0; i < fs->cube_cnt; i++ )
+  {
+    p = ~(fsmsim_word)0;
+    for( j = fs->lit_start[i]; j < fs->lit_start[i+1] && p != 0; j++ )
+    {
+      l = fs->lit[j];
+      if ( (l & 1) != 0 )
+        p &= ~var[l>>1];
+      else
+        p &= var[l>>1];
+    }
+    if ( p == 0 )
+      continue;
+    for( j = fs->out_start[i]; j < fs->out_start[i+1]; j++ )
+      res[fs->out[j]] |= p;
+  }
+
+  var += fs->in_cnt;
+  for( j = 0; j < fs->code_width; j++ )
+    var[j] = (var[j] & ~mask) | (res[j] & mask);
+}
+
+/*---------------------------------------------------------------------------*/
+
+static char *fsmsim_read_file(const char *name)
+{
+  FILE *fp;
+  char *buf;
+  long len;
+
+  fp = fopen(name, "rb");
+  if ( fp == NULL )
+    return NULL;
+  if ( fseek(fp, 0L, SEEK_END) != 0 || (len = ftell(fp)) < 0 || fseek(fp, 0L, SEEK_SET) != 0 )
+    return fclose(fp), (char *)NULL;
+  buf = (char *)malloc(len+1);
+  if ( buf == NULL )
+    return fclose(fp), (char *)NULL;
+  if ( (long)fread(buf, 1, len, fp) != len )
+    return free(buf), fclose(fp), (char *)NULL;
+  buf[len] = '\0';
+  fclose(fp);
+  return buf;
+}
+
+/*
+  splits the buffer into lines, empty lines separate the sequences.
+  line[seq[s]..seq[s+1]-1] are the vectors of sequence s.
+  returns the number of sequences or -1
+*/
+static int fsmsim_split(char *buf, char ***line_ptr, long **seq_ptr)
+{
+  char **line;
+  long *seq;
+  long line_cnt, cnt, i;
+  int seq_cnt;
+  char *s;
+
+  line_cnt = 1;
+  for( s = buf; *s != '\0'; s++ )
+    if ( *s == '\n' )
+      line_cnt++;
+
+  line = (char **)malloc(sizeof(char *)*(line_cnt+1));
+  seq = (long *)malloc(sizeof(long)*(line_cnt+2));
+  if ( line == NULL || seq == NULL )
+    return free(line), free(seq), -1;
+
+  cnt = 0;
+  seq_cnt = 0;
+  seq[0] = 0;
+  s = buf;
+  for( i = 0; i < line_cnt; i++ )
+  {
+    char *l = s;
+    while( *s != '\0' && *s != '\n' )
+      s++;
+    if ( *s == '\n' )
+      *s++ = '\0';
+    if ( l[0] == '#' )
+      continue;
+    if ( l[strspn(l, " \t\r")] == '\0' )
+    {
+      if ( cnt > seq[seq_cnt] )
+        seq[++seq_cnt] = cnt;
+      continue;
+    }
+    line[cnt++] = l;
+  }
+  if ( cnt > seq[seq_cnt] )
+    seq[++seq_cnt] = cnt;
+
+  *line_ptr = line;
+  *seq_ptr = seq;
+  return seq_cnt;
+}
+
+/* assigns 'bit' of the input words, returns 0 for an illegal vector */
+static int fsmsim_set_vector(fsmsim_type fs, const char *l, fsmsim_word bit)
+{
+  int i = 0;
+  for( ; *l != '\0'; l++ )
+  {
+    if ( *l == '0' || *l == '1' )
+    {
+      if ( i >= fs->in_cnt )
+        return 0;
+      if ( *l == '1' )
+        fs->var[i] |= bit;
+      i++;
+    }
+    else if ( *l != ' ' && *l != '\t' && *l != '\r' )
+      return 0;
+  }
+  return i == fs->in_cnt ? 1 : 0;
+}
+
+long fsmsim_DoFile(fsmsim_type fs, const char *stim_name, const char *out_name)
+{
+  char *buf;
+  char **line;
+  long *seq;
+  int seq_cnt, first, k, i, width;
+  long t, len, max_len, vec_cnt;
+  fsmsim_word mask, bit;
+  fsmsim_word *res_buf = NULL;
+  FILE *out_fp = NULL;
+
+  buf = fsmsim_read_file(stim_name);
+  if ( buf == NULL )
+    return -1;
+  seq_cnt = fsmsim_split(buf, &line, &seq);
+  if ( seq_cnt < 0 )
+    return free(buf), -1L;
+
+  if ( out_name != NULL )
+  {
+    out_fp = fopen(out_name, "w");
+    if ( out_fp == NULL )
+      return free(line), free(seq), free(buf), -1L;
+  }
+
+  vec_cnt = 0;
+  for( first = 0; first < seq_cnt; first += FSMSIM_WORD_BITS )
+  {
+    width = seq_cnt - first;
+    if ( width > FSMSIM_WORD_BITS )
+      width = FSMSIM_WORD_BITS;
+
+    max_len = 0;
+    for( k = 0; k < width; k++ )
+    {
+      len = seq[first+k+1]-seq[first+k];
+      if ( max_len < len )
+        max_len = len;
+    }
+
+    if ( out_fp != NULL )
+    {
+      free(res_buf);
+      res_buf = (fsmsim_word *)malloc(sizeof(fsmsim_word)*(max_len*fs->out_cnt+1));
+      if ( res_buf == NULL )
+        break;
+    }
+
+    fsmsim_Reset(fs, ~(fsmsim_word)0);
+    for( t = 0; t < max_len; t++ )
+    {
+      mask = 0;
+      for( i = 0; i < fs->in_cnt; i++ )
+        fs->var[i] = 0;
+      for( k = 0; k < width; k++ )
+      {
+        if ( t >= seq[first+k+1]-seq[first+k] )
+          continue;
+        bit = (fsmsim_word)1 << k;
+        if ( fsmsim_set_vector(fs, line[seq[first+k]+t], bit) == 0 )
+          break;
+        mask |= bit;
+        vec_cnt++;
+      }
+      if ( k < width )
+        break;
+      fsmsim_Step(fs, mask);
+      if ( res_buf != NULL )
+        for( i = 0; i < fs->out_cnt; i++ )
+          res_buf[t*fs->out_cnt+i] = fsmsim_GetOutput(fs, i);
+    }
+    if ( t < max_len )
+      break;
+
+    if ( out_fp != NULL )
+    {
+      for( k = 0; k < width; k++ )
+      {
+        if ( first+k > 0 )
+          fputc('\n', out_fp);
+        len = seq[first+k+1]-seq[first+k];
+        for( t = 0; t < len; t++ )
+        {
+          for( i = 0; i < fs->out_cnt; i++ )
+            fputc((res_buf[t*fs->out_cnt+i]>>k)&1 ? '1' : '0', out_fp);
+          fputc('\n', out_fp);
+        }
+      }
+    }
+  }
+
+  if ( out_fp != NULL )
+    fclose(out_fp);
+  free(res_buf);
+  free(line);
+  free(seq);
+  free(buf);
+  if ( first < seq_cnt )
+    return -1;
+  return vec_cnt;
+}
@@ -0,0 +1,85 @@
+/*
+
+  fsmsim.h
+
+  compiled simulation of a clocked fsm (cl_machine)
+
+  Copyright (C) 2001 Oliver Kraus (olikraus@yahoo.com)
+
+  This file is part of DGC.
+
+  DGC is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 2 of the License, or
+  (at your option) any later version.
+
+  DGC is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with DGC; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+  The cubes of cl_machine are converted into flat literal lists.
+  Each signal is a word, bit k of the word belongs to the
+  k-th sequence, so FSMSIM_WORD_BITS sequences are simulated
+  with one evaluation of the cubes.
+
+*/
+
+#ifndef _FSMSIM_H
+#define _FSMSIM_H
+
+#include "fsm.h"
+
+typedef unsigned long long fsmsim_word;
+#define FSMSIM_WORD_BITS 64
+
+struct _fsmsim_struct
+{
+  fsm_type fsm;
+  int in_cnt;             /* inputs of the fsm */
+  int code_width;
+  int out_cnt;            /* outputs of the fsm */
+
+  int cube_cnt;
+  int *lit_start;         /* literals of cube i: lit[lit_start[i]..lit_start[i+1]-1] */
+  int *lit;               /* 2*variable + 1 for a negated variable */
+  int *out_start;         /* outputs of cube i: out[out_start[i]..out_start[i+1]-1] */
+  int *out;
+
+  fsmsim_word *var;       /* inputs, followed by the state */
+  fsmsim_word *res;       /* next state, followed by the outputs */
+  unsigned char *reset_code;
+};
+typedef struct _fsmsim_struct *fsmsim_type;
+
+/* requires fsm_BuildClockedMachine() */
+fsmsim_type fsmsim_Open(fsm_type fsm);
+void fsmsim_Close(fsmsim_type fs);
+
+/* all sequences with a bit in 'mask' go to the reset state */
+void fsmsim_Reset(fsmsim_type fs, fsmsim_word mask);
+
+#define fsmsim_SetInput(fs,i,w) ((fs)->var[(i)] = (w))
+#define fsmsim_GetOutput(fs,o) ((fs)->res[(fs)->code_width+(o)])
+#define fsmsim_GetState(fs,b) ((fs)->var[(fs)->in_cnt+(b)])
+
+/*
+  calculates the outputs for the current inputs and state, the sequences
+  with a bit in 'mask' go to the next state
+*/
+void fsmsim_Step(fsmsim_type fs, fsmsim_word mask);
+
+/*
+  Stimulus file: one input vector ('0' and '1') per line and clock cycle,
+  an empty line starts a new sequence, which begins with the reset state.
+  Lines starting with '#' are ignored.
+  The output file (may be NULL) has the same structure with the
+  output vectors. Returns the number of simulated vectors or -1.
+*/
+long fsmsim_DoFile(fsmsim_type fs, const char *stim_name, const char *out_name);
+
+#endif /* _FSMSIM_H */
@@ -30,10 +30,12 @@
 */
 
 #include <limits.h>
+#include <stdlib.h>
 #include <assert.h>
 #include "fsm.h"
 #include "b_iq.h"
 #include "b_rdic.h"
+#include "b_th.h"
 #include "mwc.h"
 
 #define SP_INT_MAX INT_MAX
@@ -165,7 +167,7 @@ int fsm_spss_bfs(fsm_type fsm, int node_id)
         }
       }
     }
-    fsm_GetNode(fsm, n)->g_color = SP_BLACK;
+    fsm_GetNode(fsm, node_id)->g_color = SP_BLACK;
   }
   return b_iq_Close(q), 1;
 }
@@ -202,6 +204,211 @@ int fsm_DoShortestPath(fsm_type fsm, int src_id, int dest_id, int fn(void *data,
   return cnt;
 }
 
+/*---------------------------------------------------------------------------*/
+/* all pairs next hop table */
+
+/*
+  One BFS for each destination node (same as fsm_spss_bfs), the
+  destinations are distributed over several threads. For each pair the
+  table only stores the position of the first edge of the path in the out
+  edge list of the source node, so the table requires 2*n*n bytes.
+*/
+
+struct fsmsp_bfs_struct
+{
+  fsmsp_type sp;
+  int *queue;             /* n entries for each thread */
+};
+
+void fsmsp_Close(fsmsp_type sp)
+{
+  free(sp->node_idx);
+  free(sp->idx_node);
+  free(sp->out_start);
+  free(sp->out_edge);
+  free(sp->out_dest);
+  free(sp->in_start);
+  free(sp->in_src);
+  free(sp->in_pos);
+  free(sp->hop);
+  free(sp);
+}
+
+static int fsmsp_bfs_cb(void *data, int th, int d)
+{
+  struct fsmsp_bfs_struct *bfs = (struct fsmsp_bfs_struct *)data;
+  fsmsp_type sp = bfs->sp;
+  int n = sp->n;
+  int *q = bfs->queue + th*n;
+  unsigned short *row = sp->hop + (size_t)d*n;
+  int head, tail, w, u, k;
+
+  for( u = 0; u < n; u++ )
+    row[u] = FSMSP_NONE;
+  head = 0;
+  tail = 0;
+  q[tail++] = d;
+  while( head < tail )
+  {
+    w = q[head++];
+    for( k = sp->in_start[w]; k < sp->in_start[w+1]; k++ )
+    {
+      u = sp->in_src[k];
+      if ( u != w && u != d && row[u] == FSMSP_NONE )
+      {
+        row[u] = sp->in_pos[k];
+        q[tail++] = u;
+      }
+    }
+  }
+  return 1;
+}
+
+static int fsmsp_build_graph(fsmsp_type sp)
+{
+  fsm_type fsm = sp->fsm;
+  int n, node_id, edge_id, loop, i, k, e_cnt;
+  int *edge_pos;
+
+  n = 0;
+  node_id = -1;
+  while( fsm_LoopNodes(fsm, &node_id) != 0 )
+  {
+    sp->node_idx[node_id] = n;
+    sp->idx_node[n] = node_id;
+    n++;
+  }
+  
+  edge_pos = (int *)malloc(sizeof(int)*(b_set_Max(fsm->edges)+1));
+  if ( edge_pos == NULL )
+    return 0;
+  
+  e_cnt = 0;
+  for( i = 0; i < n; i++ )
+  {
+    sp->out_start[i] = e_cnt;
+    k = 0;
+    loop = -1;
+    while( fsm_LoopNodeOutEdges(fsm, sp->idx_node[i], &loop, &edge_id) != 0 )
+    {
+      if ( k >= FSMSP_NONE )
+        return free(edge_pos), 0;
+      edge_pos[edge_id] = k++;
+      sp->out_edge[e_cnt] = edge_id;
+      sp->out_dest[e_cnt] = sp->node_idx[fsm_GetEdgeDestNode(fsm, edge_id)];
+      e_cnt++;
+    }
+  }
+  sp->out_start[n] = e_cnt;
+
+  e_cnt = 0;
+  for( i = 0; i < n; i++ )
+  {
+    sp->in_start[i] = e_cnt;
+    loop = -1;
+    while( fsm_LoopNodeInNodes(fsm, sp->idx_node[i], &loop, &node_id) != 0 )
+    {
+      sp->in_src[e_cnt] = sp->node_idx[node_id];
+      sp->in_pos[e_cnt] = edge_pos[fsm_FindEdge(fsm, node_id, sp->idx_node[i])];
+      e_cnt++;
+    }
+  }
+  sp->in_start[n] = e_cnt;
+  
+  free(edge_pos);
+  return 1;
+}
+
+fsmsp_type fsmsp_Open(fsm_type fsm, int thread_cnt)
+{
+  fsmsp_type sp;
+  struct fsmsp_bfs_struct bfs;
+  int n = fsm_GetNodeCnt(fsm);
+  int e_cnt = b_set_Cnt(fsm->edges);
+  int th_cnt;
+  
+  if ( (long)n*(long)n > FSMSP_MAX_TABLE )
+  {
+    fsm_Log(fsm, "FSM: Too many states (%d) for the next hop table.", n);
+    return NULL;
+  }
+  
+  sp = (fsmsp_type)calloc(1, sizeof(struct _fsmsp_struct));
+  if ( sp == NULL )
+    return NULL;
+  sp->fsm = fsm;
+  sp->n = n;
+  sp->node_idx = (int *)malloc(sizeof(int)*(b_set_Max(fsm->nodes)+1));
+  sp->idx_node = (int *)malloc(sizeof(int)*(n+1));
+  sp->out_start = (int *)malloc(sizeof(int)*(n+1));
+  sp->out_edge = (int *)malloc(sizeof(int)*(e_cnt+1));
+  sp->out_dest = (int *)malloc(sizeof(int)*(e_cnt+1));
+  sp->in_start = (int *)malloc(sizeof(int)*(n+1));
+  sp->in_src = (int *)malloc(sizeof(int)*(e_cnt+1));
+  sp->in_pos = (unsigned short *)malloc(sizeof(unsigned short)*(e_cnt+1));
+  sp->hop = (unsigned short *)malloc(sizeof(unsigned short)*((size_t)n*n+1));
+  if ( sp->node_idx == NULL || sp->idx_node == NULL || 
+       sp->out_start == NULL || sp->out_edge == NULL || sp->out_dest == NULL ||
+       sp->in_start == NULL || sp->in_src == NULL || sp->in_pos == NULL || 
+       sp->hop == NULL )
+    return fsmsp_Close(sp), (fsmsp_type)NULL;
+
+  if ( fsmsp_build_graph(sp) == 0 )
+    return fsmsp_Close(sp), (fsmsp_type)NULL;
+  
+  th_cnt = b_th_GetCnt(thread_cnt, n);
+  bfs.sp = sp;
+  bfs.queue = (int *)malloc(sizeof(int)*((size_t)th_cnt*n+1));
+  if ( bfs.queue == NULL )
+    return fsmsp_Close(sp), (fsmsp_type)NULL;
+  if ( b_th_Do(thread_cnt, n, fsmsp_bfs_cb, &bfs) == 0 )
+    return free(bfs.queue), fsmsp_Close(sp), (fsmsp_type)NULL;
+  free(bfs.queue);
+  
+  fsm_Log(fsm, "FSM: Next hop table for %d states (%d thread(s)).", n, th_cnt);
+  return sp;
+}
+
+int fsmsp_GetDist(fsmsp_type sp, int src_id, int dest_id)
+{
+  int s = sp->node_idx[src_id];
+  int d = sp->node_idx[dest_id];
+  unsigned short *row = sp->hop + (size_t)d*sp->n;
+  int cnt = 0;
+  while( s != d )
+  {
+    if ( row[s] == FSMSP_NONE )
+      return -1;
+    s = sp->out_dest[sp->out_start[s]+row[s]];
+    cnt++;
+  }
+  return cnt;
+}
+
+/* returns the distance*/
+/* -1 for error */
+int fsmsp_DoPath(fsmsp_type sp, int src_id, int dest_id, int fn(void *data, fsm_type fsm, int edge_id, int i, int cnt), void *data)
+{
+  int s = sp->node_idx[src_id];
+  int d = sp->node_idx[dest_id];
+  unsigned short *row = sp->hop + (size_t)d*sp->n;
+  int i, cnt, k;
+  
+  cnt = fsmsp_GetDist(sp, src_id, dest_id);
+  if ( cnt <= 0 )
+    return cnt;
+  for( i = 0; i < cnt; i++ )
+  {
+    k = sp->out_start[s]+row[s];
+    if ( fn(data, sp->fsm, sp->out_edge[k], i, cnt) == 0 )
+      return -1;
+    s = sp->out_dest[k];
+  }
+  return cnt;
+}
+
+/*---------------------------------------------------------------------------*/
+
 int fsm_ShowAllShortestPath_cn(void *data, fsm_type fsm, int edge_id, int i, int cnt)
 {
   printf(" -> %s", fsm_GetNodeName(fsm, fsm_GetEdgeDestNode(fsm, edge_id)));
@@ -211,6 +418,8 @@ int fsm_ShowAllShortestPath_cn(void *data, fsm_type fsm, int edge_id, int i, int
 void fsm_ShowAllShortestPath(fsm_type fsm)
 {
   int src_id, dest_id;
+  int d;
+  fsmsp_type sp = fsmsp_Open(fsm, 0);
   
   src_id = -1;
   while( fsm_LoopNodes(fsm, &src_id) != 0 )
@@ -222,10 +431,15 @@ void fsm_ShowAllShortestPath(fsm_type fsm)
       printf("%s: ", fsm_GetNodeName(fsm, dest_id));
       
       printf("%s", fsm_GetNodeName(fsm, src_id));
-      if ( fsm_DoShortestPath(fsm, src_id, dest_id, fsm_ShowAllShortestPath_cn, NULL) < 0 )
+      if ( sp != NULL )
+        d = fsmsp_DoPath(sp, src_id, dest_id, fsm_ShowAllShortestPath_cn, NULL);
+      else
+        d = fsm_DoShortestPath(fsm, src_id, dest_id, fsm_ShowAllShortestPath_cn, NULL);
+      if ( d < 0 && sp == NULL )
         return;
       printf("\n");
     }
   }
+  if ( sp != NULL )
+    fsmsp_Close(sp);
 }
-
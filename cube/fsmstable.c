@@ -34,14 +34,158 @@
   fsm_DoMinimalStable
     forces minimum stable condition
     
-  
+  The pre and post covers of the states are taken from the cache of
+  the fsm (fsm_GetNodeCachedCover), so they are only calculated again
+  after an edge of the state has been changed.
+  The stabilization of a state only changes the self transition of 
+  this state, which is not part of the pre and post covers of any 
+  state. So the states are independent and are evaluated on separate
+  threads (b_th_Do, DGC_THREADS) if no log is requested. Each thread 
+  uses its own copy of pi_cond and pi_output and only accesses the 
+  cache entries of its own states.
+  fsm_DoMinimalStable stops at the first state with a violation. The
+  threads check all states first and expand only the states before
+  this violation, so the result is the same as with one thread.
   
 
 */
 
+#include <stdlib.h>
 #include "fsm.h"
+#include "b_th.h"
 #include "mwc.h"
 
+/* minimum number of states for each thread */
+#define FSM_ST_TH_NODES 16
+
+/* passes of fsm_do_minimal_stable_state */
+#define FSM_ST_CHECK 1
+#define FSM_ST_EXPAND 2
+
+/* result of one state */
+struct fsm_st_node_struct
+{
+  int node_id;
+  int result;
+  char *msg;          /* error message, logged by the caller */
+};
+
+/* one for each thread */
+struct fsm_st_ws_struct
+{
+  pinfo *pi_c;        /* fsm->pi_cond or a thread local copy */
+  pinfo *pi_o;        /* fsm_GetOutputPINFO(fsm) or a thread local copy */
+  pinfo pi_c_copy;
+  pinfo pi_o_copy;
+};
+
+struct fsm_st_struct
+{
+  fsm_type fsm;
+  int st;
+  int pass;
+  int is_log;
+  int cnt;
+  struct fsm_st_node_struct *node;
+  int ws_cnt;
+  struct fsm_st_ws_struct *ws;
+};
+
+static void fsm_st_node_init(struct fsm_st_node_struct *e, int node_id)
+{
+  e->node_id = node_id;
+  e->result = 1;
+  e->msg = NULL;
+}
+
+static int fsm_st_error(struct fsm_st_node_struct *e, char *msg)
+{
+  e->msg = msg;
+  return 0;
+}
+
+static void fsm_st_ws_destroy(struct fsm_st_ws_struct *ws)
+{
+  if ( ws->pi_c == &(ws->pi_c_copy) )
+    pinfoDestroy(ws->pi_c);
+  if ( ws->pi_o == &(ws->pi_o_copy) )
+    pinfoDestroy(ws->pi_o);
+}
+
+/* is_copy == 0: use the pinfo structures of the fsm */
+static int fsm_st_ws_init(struct fsm_st_ws_struct *ws, fsm_type fsm, int is_copy)
+{
+  pinfo *pi_o = fsm_GetOutputPINFO(fsm);
+  ws->pi_c = fsm_GetConditionPINFO(fsm);
+  ws->pi_o = pi_o;
+  if ( is_copy == 0 )
+    return 1;
+  if ( pinfoInitInOut(&(ws->pi_c_copy), ws->pi_c->in_cnt, ws->pi_c->out_cnt) == 0 )
+    return 0;
+  ws->pi_c = &(ws->pi_c_copy);
+  if ( pinfoInitInOut(&(ws->pi_o_copy), pi_o->in_cnt, pi_o->out_cnt) == 0 )
+    return fsm_st_ws_destroy(ws), 0;
+  ws->pi_o = &(ws->pi_o_copy);
+  return 1;
+}
+
+static void fsm_st_close(struct fsm_st_struct *d)
+{
+  while( d->ws_cnt > 0 )
+    fsm_st_ws_destroy(d->ws + (--d->ws_cnt));
+  free(d->ws);
+  free(d->node);
+}
+
+/* threads are only used, if no log is requested */
+static int fsm_st_open(struct fsm_st_struct *d, fsm_type fsm, int st, int is_log)
+{
+  int node_id, thread_cnt, cnt = b_set_Cnt(fsm->nodes);
+  
+  d->fsm = fsm;
+  d->st = st;
+  d->pass = FSM_ST_CHECK|FSM_ST_EXPAND;
+  d->is_log = is_log;
+  d->cnt = 0;
+  d->ws_cnt = 0;
+  thread_cnt = is_log != 0 ? 1 : b_th_GetCnt(0, cnt/FSM_ST_TH_NODES);
+  if ( thread_cnt < 1 )
+    thread_cnt = 1;
+  d->node = (struct fsm_st_node_struct *)malloc(sizeof(struct fsm_st_node_struct)*(cnt+1));
+  d->ws = (struct fsm_st_ws_struct *)malloc(sizeof(struct fsm_st_ws_struct)*thread_cnt);
+  if ( d->node == NULL || d->ws == NULL )
+    return fsm_st_close(d), 0;
+  
+  node_id = -1;
+  while( fsm_LoopNodes(fsm, &node_id) != 0 )
+  {
+    fsm_st_node_init(d->node+d->cnt, node_id);
+    d->cnt++;
+  }
+  
+  while( d->ws_cnt < thread_cnt )
+  {
+    if ( fsm_st_ws_init(d->ws+d->ws_cnt, fsm, thread_cnt > 1) == 0 )
+      return fsm_st_close(d), 0;
+    d->ws_cnt++;
+  }
+  return 1;
+}
+
+/* creates the missing self transitions of the first 'cnt' states, */
+/* before the threads are started */
+static int fsm_st_connect_self(struct fsm_st_struct *d, int cnt)
+{
+  int i;
+  for( i = 0; i < cnt; i++ )
+    if ( fsm_FindEdge(d->fsm, d->node[i].node_id, d->node[i].node_id) < 0 )
+      if ( fsm_Connect(d->fsm, d->node[i].node_id, d->node[i].node_id) < 0 )
+        return 0;
+  return 1;
+}
+
+/*-------------------------------------------------------------------------*/
+
 void fsm_LogStableState(fsm_type fsm, int node_id, int st, int is_log, 
   char *msg)
 {
@@ -62,53 +206,45 @@ void fsm_LogStableState(fsm_type fsm, int node_id, int st, int is_log,
 }
 
 
-int fsm_IsStateStable(fsm_type fsm, int node_id, int st, int is_log)
+static int fsm_is_state_stable(fsm_type fsm, struct fsm_st_ws_struct *ws, 
+  struct fsm_st_node_struct *e, int st, int is_log)
 {
+  int node_id = e->node_id;
   dclist Tnn;
   int is_stable;
   int loop, edge_id;
   int i, cnt;
   dclist cl_pre, cl_post, cl_tmp;
-  pinfo *pi_cond = fsm_GetConditionPINFO(fsm);
+  pinfo *pi_cond = ws->pi_c;
   dcube *r = &(pi_cond->tmp[9]);
   dcube *super_post = &(pi_cond->tmp[10]);
 
 
-  if ( dclInitVA(3, &cl_pre, &cl_post, &cl_tmp) == 0 )
-  {
-    fsm_LogStableState(fsm, node_id, st, 1, "memory error.");
-    return 0;
-  }
-  if ( fsm_GetNodePreCover(fsm, node_id, cl_pre) == 0 )
-  {
-    fsm_LogStableState(fsm, node_id, st, 1, "Can not create input cover (memory error?).");
-    return dclDestroyVA(3, cl_pre, cl_post, cl_tmp), 0;
-  }
-  if ( fsm_GetNodePostCover(fsm, node_id, cl_post) == 0 )
-  {
-    fsm_LogStableState(fsm, node_id, st, 1, "Can not create output cover (memory error?).");
-    return dclDestroyVA(3, cl_pre, cl_post, cl_tmp), 0;
-  }
+  cl_pre = fsm_GetNodeCachedCover(fsm, pi_cond, node_id, FSM_COVER_PRE);
+  if ( cl_pre == NULL )
+    return fsm_st_error(e, "Can not create input cover (memory error?).");
+  cl_post = fsm_GetNodeCachedCover(fsm, pi_cond, node_id, FSM_COVER_POST);
+  if ( cl_post == NULL )
+    return fsm_st_error(e, "Can not create output cover (memory error?).");
+  if ( dclInit(&cl_tmp) == 0 )
+    return fsm_st_error(e, "memory error.");
   
   if ( dclIntersectionList(pi_cond, cl_tmp, cl_pre, cl_post) == 0 )
-  {
-    fsm_LogStableState(fsm, node_id, st, 1, "Can not create in/out intersection (memory error?).");
-    return dclDestroyVA(3, cl_pre, cl_post, cl_tmp), 0;
-  }
+    return dclDestroy(cl_tmp), fsm_st_error(e, "Can not create in/out intersection (memory error?).");
   
   if ( dclCnt(cl_tmp) != 0 )
   {
     fsm_LogStableState(fsm, node_id, st, is_log, "Same condition for input and output cover exist.");
     if ( is_log != 0 )
       fsm_LogDCL(fsm, "", 3, "pre", pi_cond, cl_pre, "post", pi_cond, cl_post, "intersect", pi_cond, cl_tmp);
-    return dclDestroyVA(3, cl_pre, cl_post, cl_tmp), 0;
+    return dclDestroy(cl_tmp), 0;
   }
 
   Tnn = fsm_GetNodeSelfCondtion( fsm,  node_id);
   if ( Tnn == NULL )
   {
     fsm_LogStableState(fsm, node_id, st, is_log, "Self condition does not exist.");
-    return dclDestroyVA(3, cl_pre, cl_post, cl_tmp), 0;
+    return dclDestroy(cl_tmp), 0;
   }
   
   
@@ -127,34 +263,19 @@ int fsm_IsStateStable(fsm_type fsm, int node_id, int st, int is_log)
       break;
     case FSM_STABLE_CONTINOUS:
       if ( dclCopy(pi_cond, cl_tmp, cl_pre) == 0 )
-      {
-        fsm_LogStableState(fsm, node_id, st, 1, "memory error?");
-        return dclDestroyVA(3, cl_pre, cl_post, cl_tmp), 0;
-      }
+        return dclDestroy(cl_tmp), fsm_st_error(e, "memory error?");
       dclSuper(pi_cond, r, cl_tmp);
       if ( dclCopy(pi_cond, cl_tmp, cl_post) == 0 )
-      {
-        fsm_LogStableState(fsm, node_id, st, 1, "memory error?");
-        return dclDestroyVA(3, cl_pre, cl_post, cl_tmp), 0;
-      }
+        return dclDestroy(cl_tmp), fsm_st_error(e, "memory error?");
       if ( dclAdd(pi_cond, cl_tmp, r) < 0 )
-      {
-        fsm_LogStableState(fsm, node_id, st, 1, "memory error?");
-        return dclDestroyVA(3, cl_pre, cl_post, cl_tmp), 0;
-      }
+        return dclDestroy(cl_tmp), fsm_st_error(e, "memory error?");
       dclSuper(pi_cond, r, cl_tmp);
       dclClear(cl_tmp);
       if ( dclAdd(pi_cond, cl_tmp, r) < 0 )
-      {
-        fsm_LogStableState(fsm, node_id, st, 1, "memory error?");
-        return dclDestroyVA(3, cl_pre, cl_post, cl_tmp), 0;
-      }
+        return dclDestroy(cl_tmp), fsm_st_error(e, "memory error?");
       
       if ( dclSubtract(pi_cond, cl_tmp, cl_post) == 0 )
-      {
-        fsm_LogStableState(fsm, node_id, st, 1, "memory error?");
-        return dclDestroyVA(3, cl_pre, cl_post, cl_tmp), 0;
-      }
+        return dclDestroy(cl_tmp), fsm_st_error(e, "memory error?");
       if ( dclIsSubsetList(pi_cond, Tnn, cl_tmp) != 0 )
       {
         is_stable = 1;
@@ -179,18 +300,12 @@ int fsm_IsStateStable(fsm_type fsm, int node_id, int st, int is_log)
         {
           dcOr(pi_cond, r, dclGet(cl_cond, i), super_post);
           if ( dclAdd(pi_cond, cl_tmp, r) < 0 )
-          {
-            fsm_LogStableState(fsm, node_id, st, 1, "memory error?");
-            return dclDestroyVA(3, cl_pre, cl_post, cl_tmp), 0;
-          }
+            return dclDestroy(cl_tmp), fsm_st_error(e, "memory error?");
         }
       }
       dclSCC(pi_cond, cl_tmp);
       if ( dclSubtract(pi_cond, cl_tmp, cl_post) == 0 )
-      {
-        fsm_LogStableState(fsm, node_id, st, 1, "memory error?");
-        return dclDestroyVA(3, cl_pre, cl_post, cl_tmp), 0;
-      }
+        return dclDestroy(cl_tmp), fsm_st_error(e, "memory error?");
       if ( dclIsSubsetList(pi_cond, Tnn, cl_tmp) != 0 )
       {
         is_stable = 1;
@@ -204,15 +319,9 @@ int fsm_IsStateStable(fsm_type fsm, int node_id, int st, int is_log)
       break;
     case FSM_STABLE_FULL:
       if ( dclCopy(pi_cond, cl_tmp, cl_post) == 0 )
-      {
-        fsm_LogStableState(fsm, node_id, st, 1, "memory error?");
-        return dclDestroyVA(3, cl_pre, cl_post, cl_tmp), 0;
-      }
+        return dclDestroy(cl_tmp), fsm_st_error(e, "memory error?");
       if ( dclComplement(pi_cond, cl_tmp) == 0 )
-      {
-        fsm_LogStableState(fsm, node_id, st, 1, "Complement failed (memory error?).");
-        return dclDestroyVA(3, cl_pre, cl_post, cl_tmp), 0;
-      }
+        return dclDestroy(cl_tmp), fsm_st_error(e, "Complement failed (memory error?).");
       if ( dclIsEquivalent(pi_cond, Tnn, cl_tmp) != 0 )
       {
         is_stable = 1;
@@ -225,26 +334,60 @@ int fsm_IsStateStable(fsm_type fsm, int node_id, int st, int is_log)
       }
       break;
     default:
-      fsm_LogStableState(fsm, node_id, st, 1, "Unknown stable type.");
-      return dclDestroyVA(3, cl_pre, cl_post, cl_tmp), 0;
+      return dclDestroy(cl_tmp), fsm_st_error(e, "Unknown stable type.");
       
   }
   
   
-  return dclDestroyVA(3, cl_pre, cl_post, cl_tmp), is_stable;
+  return dclDestroy(cl_tmp), is_stable;
 }
 
+int fsm_IsStateStable(fsm_type fsm, int node_id, int st, int is_log)
+{
+  struct fsm_st_ws_struct ws;
+  struct fsm_st_node_struct e;
+  int is_stable;
+  
+  fsm_st_ws_init(&ws, fsm, 0);
+  fsm_st_node_init(&e, node_id);
+  is_stable = fsm_is_state_stable(fsm, &ws, &e, st, is_log);
+  if ( e.msg != NULL )
+    fsm_LogStableState(fsm, node_id, st, 1, e.msg);
+  return is_stable;
+}
+
+static int fsm_is_state_stable_th(void *data, int th, int pos)
+{
+  struct fsm_st_struct *d = (struct fsm_st_struct *)data;
+  d->node[pos].result = fsm_is_state_stable(d->fsm, d->ws+th, d->node+pos, d->st, d->is_log);
+  return 1;
+}
 
 int fsm_IsStable(fsm_type fsm, int st, int is_log)
 {
-  int node_id = -1;
+  struct fsm_st_struct d;
+  int i;
   int is_stable = 1;
-  while( fsm_LoopNodes(fsm, &node_id) != 0 )
+  
+  if ( fsm_st_open(&d, fsm, st, is_log) == 0 )
   {
-    if ( fsm_IsStateStable(fsm, node_id, st, is_log) == 0 )
+    fsm_Log(fsm, "FSM: Stable state analysis failed (memory error?).");
+    return 0;
+  }
+  
+  if ( d.ws_cnt > 1 )
+    b_th_Do(d.ws_cnt, d.cnt, fsm_is_state_stable_th, &d);
+  
+  for( i = 0; i < d.cnt; i++ )
+  {
+    if ( d.ws_cnt <= 1 )
+      fsm_is_state_stable_th(&d, 0, i);
+    if ( d.node[i].msg != NULL )
+      fsm_LogStableState(fsm, d.node[i].node_id, st, 1, d.node[i].msg);
+    if ( d.node[i].result == 0 )
       is_stable = 0;
   }
-  return is_stable;
+  return fsm_st_close(&d), is_stable;
 }
 
 /*-------------------------------------------------------------------------*/
@@ -261,51 +404,50 @@ void fsm_LogMinimalStableState(fsm_type fsm, int node_id, int is_log,
 }
 
 
-int fsm_DoMinimalStableState(fsm_type fsm, int node_id, int is_log)
+/* pass: FSM_ST_CHECK and/or FSM_ST_EXPAND */
+static int fsm_do_minimal_stable_state(fsm_type fsm, struct fsm_st_ws_struct *ws, 
+  struct fsm_st_node_struct *e, int pass, int is_log)
 {
+  int node_id = e->node_id;
   dclist Tnn, o_Tnn;
   int loop, edge_id;
   int i, cnt;
   dclist cl_pre, cl_post, cl_req, cl_tmp, cl_o_req, cl_o_tmp;
-  pinfo *pi_cond = fsm_GetConditionPINFO(fsm);
-  pinfo *pi_out = fsm_GetOutputPINFO(fsm);
+  pinfo *pi_cond = ws->pi_c;
+  pinfo *pi_out = ws->pi_o;
   dcube *c;
 
-  if ( dclInitVA(4, &cl_pre, &cl_post, &cl_req, &cl_tmp) == 0 )
-  {
-    fsm_LogMinimalStableState(fsm, node_id, 1, "memory error.");
-    return 0;
-  }
-  if ( dclInitVA(2, &cl_o_req, &cl_o_tmp) == 0 )
-  {
-    fsm_LogMinimalStableState(fsm, node_id, 1, "memory error.");
-    return dclDestroyVA(4, cl_pre, cl_post, cl_req, cl_tmp), 0;
-  }
+  cl_pre = fsm_GetNodeCachedCover(fsm, pi_cond, node_id, FSM_COVER_PRE);
+  if ( cl_pre == NULL )
+    return fsm_st_error(e, "Can not create input cover (memory error?).");
   
-  if ( fsm_GetNodePreCover(fsm, node_id, cl_pre) == 0 )
-  {
-    fsm_LogMinimalStableState(fsm, node_id, 1, "Can not create input cover (memory error?).");
-    return dclDestroyVA(4, cl_pre, cl_post, cl_req, cl_tmp), dclDestroyVA(2, cl_o_req, cl_o_tmp), 0;
-  }
-  if ( fsm_GetNodePostCover(fsm, node_id, cl_post) == 0 )
-  {
-    fsm_LogMinimalStableState(fsm, node_id, 1, "Can not create output cover (memory error?).");
-    return dclDestroyVA(4, cl_pre, cl_post, cl_req, cl_tmp), dclDestroyVA(2, cl_o_req, cl_o_tmp), 0;
-  }
+  if ( dclInitVA(2, &cl_req, &cl_tmp) == 0 )
+    return fsm_st_error(e, "memory error.");
+  if ( dclInitVA(2, &cl_o_req, &cl_o_tmp) == 0 )
+    return dclDestroyVA(2, cl_req, cl_tmp), fsm_st_error(e, "memory error.");
   
-  if ( dclIntersectionList(pi_cond, cl_tmp, cl_pre, cl_post) == 0 )
+  if ( (pass & FSM_ST_CHECK) != 0 )
   {
-    fsm_LogMinimalStableState(fsm, node_id, 1, "Can not create in/out intersection (memory error?).");
-    return dclDestroyVA(4, cl_pre, cl_post, cl_req, cl_tmp), dclDestroyVA(2, cl_o_req, cl_o_tmp), 0;
+    cl_post = fsm_GetNodeCachedCover(fsm, pi_cond, node_id, FSM_COVER_POST);
+    if ( cl_post == NULL )
+      return dclDestroyVA(2, cl_req, cl_tmp), dclDestroyVA(2, cl_o_req, cl_o_tmp), 
+        fsm_st_error(e, "Can not create output cover (memory error?).");
+    
+    if ( dclIntersectionList(pi_cond, cl_tmp, cl_pre, cl_post) == 0 )
+      return dclDestroyVA(2, cl_req, cl_tmp), dclDestroyVA(2, cl_o_req, cl_o_tmp), 
+        fsm_st_error(e, "Can not create in/out intersection (memory error?).");
+    
+    if ( dclCnt(cl_tmp) != 0 )
+    {
+      fsm_LogMinimalStableState(fsm, node_id, is_log, "Same condition for input and output cover exist.");
+      if ( is_log != 0 )
+        fsm_LogDCL(fsm, "", 3, "pre", pi_cond, cl_pre, "post", pi_cond, cl_post, "intersect", pi_cond, cl_tmp);
+      return dclDestroyVA(2, cl_req, cl_tmp), dclDestroyVA(2, cl_o_req, cl_o_tmp), 0;
+    }
   }
   
-  if ( dclCnt(cl_tmp) != 0 )
-  {
-    fsm_LogMinimalStableState(fsm, node_id, is_log, "Same condition for input and output cover exist.");
-    if ( is_log != 0 )
-      fsm_LogDCL(fsm, "", 3, "pre", pi_cond, cl_pre, "post", pi_cond, cl_post, "intersect", pi_cond, cl_tmp);
-    return dclDestroyVA(4, cl_pre, cl_post, cl_req, cl_tmp), dclDestroyVA(2, cl_o_req, cl_o_tmp), 0;
-  }
+  if ( (pass & FSM_ST_EXPAND) == 0 )
+    return dclDestroyVA(2, cl_req, cl_tmp), dclDestroyVA(2, cl_o_req, cl_o_tmp), 1;
 
   Tnn = fsm_GetNodeSelfCondtion(fsm,  node_id);
   if ( Tnn == NULL )
@@ -313,13 +455,13 @@ int fsm_DoMinimalStableState(fsm_type fsm, int node_id, int is_log)
     if ( fsm_Connect(fsm, node_id, node_id) < 0 )
     {
       fsm_LogMinimalStableState(fsm, node_id, is_log, "Can not create self condition (memory error?).");
-      return dclDestroyVA(4, cl_pre, cl_post, cl_req, cl_tmp), dclDestroyVA(2, cl_o_req, cl_o_tmp), 0;
+      return dclDestroyVA(2, cl_req, cl_tmp), dclDestroyVA(2, cl_o_req, cl_o_tmp), 0;
     }
     Tnn = fsm_GetNodeSelfCondtion(fsm,  node_id);
     if ( Tnn == NULL )
     {
       fsm_LogMinimalStableState(fsm, node_id, is_log, "Internal error.");
-      return dclDestroyVA(4, cl_pre, cl_post, cl_req, cl_tmp), dclDestroyVA(2, cl_o_req, cl_o_tmp), 0;
+      return dclDestroyVA(2, cl_req, cl_tmp), dclDestroyVA(2, cl_o_req, cl_o_tmp), 0;
     }
   }
   
@@ -327,25 +469,21 @@ int fsm_DoMinimalStableState(fsm_type fsm, int node_id, int is_log)
   if ( o_Tnn == NULL )
   {
     fsm_LogMinimalStableState(fsm, node_id, is_log, "Internal error.");
-    return dclDestroyVA(4, cl_pre, cl_post, cl_req, cl_tmp), dclDestroyVA(2, cl_o_req, cl_o_tmp), 0;
+    return dclDestroyVA(2, cl_req, cl_tmp), dclDestroyVA(2, cl_o_req, cl_o_tmp), 0;
   }
   
   if ( dclCopy(pi_cond, cl_req, cl_pre) == 0 )
-  {
-    fsm_LogMinimalStableState(fsm, node_id, 1, "Copy operation failed (memory error?).");
-    return dclDestroyVA(4, cl_pre, cl_post, cl_req, cl_tmp), dclDestroyVA(2, cl_o_req, cl_o_tmp), 0;
-  }
+    return dclDestroyVA(2, cl_req, cl_tmp), dclDestroyVA(2, cl_o_req, cl_o_tmp), 
+      fsm_st_error(e, "Copy operation failed (memory error?).");
 
   if ( dclSubtract(pi_cond, cl_req, Tnn) == 0 )
-  {
-    fsm_LogMinimalStableState(fsm, node_id, 1, "Cover subtraction failed (memory error?).");
-    return dclDestroyVA(4, cl_pre, cl_post, cl_req, cl_tmp), dclDestroyVA(2, cl_o_req, cl_o_tmp), 0;
-  }
+    return dclDestroyVA(2, cl_req, cl_tmp), dclDestroyVA(2, cl_o_req, cl_o_tmp), 
+      fsm_st_error(e, "Cover subtraction failed (memory error?).");
   
   if ( dclCnt(cl_req) == 0 )
   {
     /* this state is minimal stable */
-    return dclDestroyVA(4, cl_pre, cl_post, cl_req, cl_tmp), dclDestroyVA(2, cl_o_req, cl_o_tmp), 1;
+    return dclDestroyVA(2, cl_req, cl_tmp), dclDestroyVA(2, cl_o_req, cl_o_tmp), 1;
   }
   
   cnt = dclCnt(cl_req);
@@ -353,10 +491,8 @@ int fsm_DoMinimalStableState(fsm_type fsm, int node_id, int is_log)
   {
     c = dclAddEmptyCube(pi_out, cl_o_req);
     if ( c == NULL )
-    {
-      fsm_LogMinimalStableState(fsm, node_id, 1, "Add operation failed (memory error?).");
-      return dclDestroyVA(4, cl_pre, cl_post, cl_req, cl_tmp), dclDestroyVA(2, cl_o_req, cl_o_tmp), 0;
-    }
+      return dclDestroyVA(2, cl_req, cl_tmp), dclDestroyVA(2, cl_o_req, cl_o_tmp), 
+        fsm_st_error(e, "Add operation failed (memory error?).");
     dcCopyInToIn(pi_out, c, 0, pi_cond, dclGet(cl_req, i));
     dcOutSetAll(pi_out, c, CUBE_OUT_MASK);
   }
@@ -367,43 +503,31 @@ int fsm_DoMinimalStableState(fsm_type fsm, int node_id, int is_log)
   while( fsm_LoopNodeInEdges(fsm, node_id, &loop, &edge_id) != 0 && dclCnt(cl_req) != 0 )
   {
     if ( dclIntersectionList(pi_cond, cl_tmp, fsm_GetEdgeCondition(fsm, edge_id), cl_req) == 0 )
-    {
-      fsm_LogMinimalStableState(fsm, node_id, 1, "Intersection operation failed (memory error?).");
-      return dclDestroyVA(4, cl_pre, cl_post, cl_req, cl_tmp), dclDestroyVA(2, cl_o_req, cl_o_tmp), 0;
-    }
+      return dclDestroyVA(2, cl_req, cl_tmp), dclDestroyVA(2, cl_o_req, cl_o_tmp), 
+        fsm_st_error(e, "Intersection operation failed (memory error?).");
     if ( dclIntersectionList(pi_out, cl_o_tmp, fsm_GetEdgeOutput(fsm, edge_id), cl_o_req) == 0 )
-    {
-      fsm_LogMinimalStableState(fsm, node_id, 1, "Intersection operation failed (memory error?).");
-      return dclDestroyVA(4, cl_pre, cl_post, cl_req, cl_tmp), dclDestroyVA(2, cl_o_req, cl_o_tmp), 0;
-    }
+      return dclDestroyVA(2, cl_req, cl_tmp), dclDestroyVA(2, cl_o_req, cl_o_tmp), 
+        fsm_st_error(e, "Intersection operation failed (memory error?).");
     if ( dclCnt(cl_tmp) != 0 )
     {
       fsm_LogMinimalStableState(fsm, node_id, is_log, "Stable condition expanded");
       if ( is_log != 0 )
         fsm_LogDCL(fsm, "", 3, "in cond", pi_cond, fsm_GetEdgeCondition(fsm, edge_id), " curr self", pi_cond, Tnn, " expand", pi_cond, cl_tmp);
       if ( dclSCCUnion(pi_cond, Tnn, cl_tmp) == 0 )
-      {
-        fsm_LogMinimalStableState(fsm, node_id, 1, "Union operation failed (memory error?).");
-        return dclDestroyVA(4, cl_pre, cl_post, cl_req, cl_tmp), dclDestroyVA(2, cl_o_req, cl_o_tmp), 0;
-      }
+        return dclDestroyVA(2, cl_req, cl_tmp), dclDestroyVA(2, cl_o_req, cl_o_tmp), 
+          fsm_st_error(e, "Union operation failed (memory error?).");
 
       if ( dclSCCUnion(pi_out, o_Tnn, cl_o_tmp) == 0 )
-      {
-        fsm_LogMinimalStableState(fsm, node_id, 1, "Union operation failed (memory error?).");
-        return dclDestroyVA(4, cl_pre, cl_post, cl_req, cl_tmp), dclDestroyVA(2, cl_o_req, cl_o_tmp), 0;
-      }
+        return dclDestroyVA(2, cl_req, cl_tmp), dclDestroyVA(2, cl_o_req, cl_o_tmp), 
+          fsm_st_error(e, "Union operation failed (memory error?).");
 
       if ( dclSubtract(pi_cond, cl_req, cl_tmp) == 0 )
-      {
-        fsm_LogMinimalStableState(fsm, node_id, 1, "Cover subtraction failed (memory error?).");
-        return dclDestroyVA(4, cl_pre, cl_post, cl_req, cl_tmp), dclDestroyVA(2, cl_o_req, cl_o_tmp), 0;
-      }
+        return dclDestroyVA(2, cl_req, cl_tmp), dclDestroyVA(2, cl_o_req, cl_o_tmp), 
+          fsm_st_error(e, "Cover subtraction failed (memory error?).");
 
       if ( dclSubtract(pi_out, cl_o_req, cl_o_tmp) == 0 )
-      {
-        fsm_LogMinimalStableState(fsm, node_id, 1, "Cover subtraction failed (memory error?).");
-        return dclDestroyVA(4, cl_pre, cl_post, cl_req, cl_tmp), dclDestroyVA(2, cl_o_req, cl_o_tmp), 0;
-      }
+        return dclDestroyVA(2, cl_req, cl_tmp), dclDestroyVA(2, cl_o_req, cl_o_tmp), 
+          fsm_st_error(e, "Cover subtraction failed (memory error?).");
       
     }
   }
@@ -411,25 +535,73 @@ int fsm_DoMinimalStableState(fsm_type fsm, int node_id, int is_log)
   if ( dclCnt(cl_req) != 0 )
   {
     fsm_LogMinimalStableState(fsm, node_id, is_log, "Internal error.");
-    return dclDestroyVA(4, cl_pre, cl_post, cl_req, cl_tmp), dclDestroyVA(2, cl_o_req, cl_o_tmp), 0;
+    return dclDestroyVA(2, cl_req, cl_tmp), dclDestroyVA(2, cl_o_req, cl_o_tmp), 0;
   }
 
   fsm_LogMinimalStableState(fsm, node_id, is_log, "Stable condition has been expanded to minimal stable condition");
   if ( is_log != 0 )
     fsm_LogDCL(fsm, "", 3, "pre", pi_cond, cl_pre, "self", pi_cond, Tnn, "output", pi_out, o_Tnn);
   
-  return dclDestroyVA(4, cl_pre, cl_post, cl_req, cl_tmp), dclDestroyVA(2, cl_o_req, cl_o_tmp), 1;
+  return dclDestroyVA(2, cl_req, cl_tmp), dclDestroyVA(2, cl_o_req, cl_o_tmp), 1;
+}
+
+int fsm_DoMinimalStableState(fsm_type fsm, int node_id, int is_log)
+{
+  struct fsm_st_ws_struct ws;
+  struct fsm_st_node_struct e;
+  int result;
+  
+  fsm_st_ws_init(&ws, fsm, 0);
+  fsm_st_node_init(&e, node_id);
+  result = fsm_do_minimal_stable_state(fsm, &ws, &e, FSM_ST_CHECK|FSM_ST_EXPAND, is_log);
+  if ( e.msg != NULL )
+    fsm_LogMinimalStableState(fsm, node_id, 1, e.msg);
+  return result;
+}
+
+static int fsm_do_minimal_stable_state_th(void *data, int th, int pos)
+{
+  struct fsm_st_struct *d = (struct fsm_st_struct *)data;
+  d->node[pos].result = fsm_do_minimal_stable_state(d->fsm, d->ws+th, d->node+pos, d->pass, d->is_log);
+  return 1;
 }
 
 int fsm_DoMinimalStable(fsm_type fsm, int is_log)
 {
-  int node_id = -1;
-  while( fsm_LoopNodes(fsm, &node_id) != 0 )
+  struct fsm_st_struct d;
+  int i, cnt;
+  
+  if ( fsm_st_open(&d, fsm, FSM_STABLE_MINIMAL, is_log) == 0 )
   {
-    if ( fsm_DoMinimalStableState(fsm, node_id, is_log) == 0 )
-      return 0;
+    fsm_Log(fsm, "FSM: Minimal stable generator failed (memory error?).");
+    return 0;
   }
-  return 1;
+  
+  if ( d.ws_cnt > 1 )
+  {
+    d.pass = FSM_ST_CHECK;
+    b_th_Do(d.ws_cnt, d.cnt, fsm_do_minimal_stable_state_th, &d);
+    
+    /* expand the states before the first violation */
+    for( cnt = 0; cnt < d.cnt; cnt++ )
+      if ( d.node[cnt].result == 0 )
+        break;
+    if ( fsm_st_connect_self(&d, cnt) == 0 )
+      return fsm_st_close(&d), 0;
+    d.pass = FSM_ST_EXPAND;
+    b_th_Do(d.ws_cnt, cnt, fsm_do_minimal_stable_state_th, &d);
+  }
+  
+  for( i = 0; i < d.cnt; i++ )
+  {
+    if ( d.ws_cnt <= 1 )
+      fsm_do_minimal_stable_state_th(&d, 0, i);
+    if ( d.node[i].msg != NULL )
+      fsm_LogMinimalStableState(fsm, d.node[i].node_id, 1, d.node[i].msg);
+    if ( d.node[i].result == 0 )
+      return fsm_st_close(&d), 0;
+  }
+  return fsm_st_close(&d), 1;
 }
 
 /*-------------------------------------------------------------------------*/
@@ -445,22 +617,26 @@ void fsm_LogInOutStableState(fsm_type fsm, int node_id, int is_log,
       node_name, msg);
 }
 
-int fsm_DoInOutStableState(fsm_type fsm, int node_id, int is_log)
+static int fsm_do_in_out_stable_state(fsm_type fsm, struct fsm_st_ws_struct *ws, 
+  struct fsm_st_node_struct *e, int is_log)
 {
+  int node_id = e->node_id;
   dclist cl_post, cl_new, cl_t, Tnn;
-  pinfo *pi_out = fsm_GetOutputPINFO(fsm);
+  pinfo *pi_out = ws->pi_o;
   int loop, edge_id, i, cnt;
   dcube *s_post = &(pi_out->tmp[9]);
   dcube *s_all = &(pi_out->tmp[10]);
   
+  cl_t = fsm_GetNodeCachedCover(fsm, pi_out, node_id, FSM_COVER_POST_OUTPUT);
+  if ( cl_t == NULL )
+    return fsm_st_error(e, "Can not create output cover (memory error?).");
+  
   if ( dclInitVA(2, &cl_post, &cl_new) == 0 )
-    return 0;
+    return fsm_st_error(e, "memory error.");
   
-  if ( fsm_GetNodePostOutput(fsm, node_id, cl_post) == 0 )
-  {
-    fsm_LogInOutStableState(fsm, node_id, 1, "Can not create output cover (memory error?).");
-    return dclDestroyVA(2, cl_post, cl_new), 0;
-  }
+  /* cl_post is changed below */
+  if ( dclCopy(pi_out, cl_post, cl_t) == 0 )
+    return dclDestroyVA(2, cl_post, cl_new), fsm_st_error(e, "memory error.");
   
   dclSuper(pi_out, s_post, cl_post);
   dclClear(cl_new);
@@ -479,10 +655,7 @@ int fsm_DoInOutStableState(fsm_type fsm, int node_id, int is_log)
         dcOr(pi_out, s_all, dclGet(cl_t, i), s_post);
         dcCopyOut(pi_out, s_all, dclGet(cl_t, i));
         if ( dclSCCAddAndSetFlag(pi_out, cl_new, s_all) == 0 )
-        {
-          fsm_LogInOutStableState(fsm, node_id, 1, "Add operation failed (memory error?).");
-          return dclDestroyVA(2, cl_post, cl_new), 0;
-        }
+          return dclDestroyVA(2, cl_post, cl_new), fsm_st_error(e, "Add operation failed (memory error?).");
       }
     }
   }
@@ -521,24 +694,59 @@ int fsm_DoInOutStableState(fsm_type fsm, int node_id, int is_log)
   fsm_LogInOutStableState(fsm, node_id, is_log, "Stable condition has been expanded to input output stability");
   if ( is_log != 0 )
   {
-    if ( fsm_GetNodePostOutput(fsm, node_id, cl_post) == 0 )
-    {
-      fsm_LogInOutStableState(fsm, node_id, 1, "Can not create output cover (memory error?).");
-      return dclDestroyVA(2, cl_post, cl_new), 0;
-    }
-    fsm_LogDCL(fsm, "", 2, "self", pi_out, Tnn, " output", pi_out, cl_post);
+    cl_t = fsm_GetNodeCachedCover(fsm, pi_out, node_id, FSM_COVER_POST_OUTPUT);
+    if ( cl_t == NULL )
+      return dclDestroyVA(2, cl_post, cl_new), fsm_st_error(e, "Can not create output cover (memory error?).");
+    fsm_LogDCL(fsm, "", 2, "self", pi_out, Tnn, " output", pi_out, cl_t);
   }
     
   return dclDestroyVA(2, cl_post, cl_new), 1;
 }
 
+int fsm_DoInOutStableState(fsm_type fsm, int node_id, int is_log)
+{
+  struct fsm_st_ws_struct ws;
+  struct fsm_st_node_struct e;
+  int result;
+  
+  fsm_st_ws_init(&ws, fsm, 0);
+  fsm_st_node_init(&e, node_id);
+  result = fsm_do_in_out_stable_state(fsm, &ws, &e, is_log);
+  if ( e.msg != NULL )
+    fsm_LogInOutStableState(fsm, node_id, 1, e.msg);
+  return result;
+}
+
+static int fsm_do_in_out_stable_state_th(void *data, int th, int pos)
+{
+  struct fsm_st_struct *d = (struct fsm_st_struct *)data;
+  d->node[pos].result = fsm_do_in_out_stable_state(d->fsm, d->ws+th, d->node+pos, d->is_log);
+  return 1;
+}
+
 int fsm_DoInOutStable(fsm_type fsm, int is_log)
 {
-  int node_id = -1;
-  while( fsm_LoopNodes(fsm, &node_id) != 0 )
+  struct fsm_st_struct d;
+  int i;
+  
+  if ( fsm_st_open(&d, fsm, FSM_STABLE_IN_OUT, is_log) == 0 )
+    return 0;
+  
+  if ( d.ws_cnt > 1 )
   {
-    if ( fsm_DoInOutStableState(fsm, node_id, is_log) == 0 )
-      return 0;
+    if ( fsm_st_connect_self(&d, d.cnt) == 0 )
+      return fsm_st_close(&d), 0;
+    b_th_Do(d.ws_cnt, d.cnt, fsm_do_in_out_stable_state_th, &d);
   }
-  return 1;
+  
+  for( i = 0; i < d.cnt; i++ )
+  {
+    if ( d.ws_cnt <= 1 )
+      fsm_do_in_out_stable_state_th(&d, 0, i);
+    if ( d.node[i].msg != NULL )
+      fsm_LogInOutStableState(fsm, d.node[i].node_id, 1, d.node[i].msg);
+    if ( d.node[i].result == 0 )
+      return fsm_st_close(&d), 0;
+  }
+  return fsm_st_close(&d), 1;
 }
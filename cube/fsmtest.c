@@ -62,6 +62,7 @@ fsmtl_type fsmtl_Open(fsm_type fsm)
     if ( tl->l != NULL )
     {
       tl->fsm = fsm;
+      tl->sp = NULL;
       if ( dcInit(fsm_GetConditionPINFO(fsm), &(tl->curr_input)) != 0 )
       {
         return tl;
@@ -79,6 +80,9 @@ void fsmtl_Clear(fsmtl_type tl)
   for( i = 0; i < cnt; i++ )
     fsmtt_Close((fsmtt_type)b_pl_GetVal(tl->l, i));
   b_pl_Clear(tl->l);
+  if ( tl->sp != NULL )
+    fsmsp_Close(tl->sp);
+  tl->sp = NULL;
 }
 
 void fsmtl_Close(fsmtl_type tl)
@@ -217,12 +221,17 @@ int fsmtl_GoNode_cb(void *data, fsm_type fsm, int edge_id, int i, int cnt)
 int fsmtl_GoNode(fsmtl_type tl, int src_id, int dest_id)
 {
   int edge_id;
+  int d;
   if ( src_id == dest_id )
     return 1;
   edge_id = fsm_FindEdge(tl->fsm, src_id, dest_id);
   if ( edge_id > 0 )
     return fsmtl_GoEdge(tl, edge_id);
-  if ( fsm_DoShortestPath(tl->fsm, src_id, dest_id, fsmtl_GoNode_cb, tl) == 0 )
+  if ( tl->sp != NULL )
+    d = fsmsp_DoPath(tl->sp, src_id, dest_id, fsmtl_GoNode_cb, tl);
+  else
+    d = fsm_DoShortestPath(tl->fsm, src_id, dest_id, fsmtl_GoNode_cb, tl);
+  if ( d == 0 )
   {
     return fsm_Log(tl->fsm, "FSM TL: Memory error within shortest path calculation (abort)."), 0;
   }
@@ -245,6 +254,10 @@ int fsmtl_Do(fsmtl_type tl)
   if ( edge_id < 0 )
     return fsm_Log(tl->fsm, "FSM TL: Reset node is not stable (warning)"), 0;
     
+  /* NULL is ok: fsmtl_GoNode uses fsm_DoShortestPath */
+  if ( tl->sp == NULL )
+    tl->sp = fsmsp_Open(tl->fsm, 0);
+
   fsm_Log(tl->fsm, "FSM TL: Transition walk started (no of tests: %d).", cnt);
 
 
@@ -369,3 +382,223 @@ int fsmtl_AddAllEdgeSequence(fsmtl_type tl)
   return 1;
 }
 
+
+/*---------------------------------------------------------------------------*/
+
+/*
+  chinese postman tour, all edges are indices into sp->out_edge
+  1. edges, which can not be reached from the reset node, are ignored
+  2. a node with more incoming than outgoing edges is connected to the
+     nearest nodes with more outgoing than incoming edges (greedy).
+     The edges of these shortest paths are used more than once.
+  3. Hierholzer's algorithm: closed walk over all edges, starting at
+     the reset node.
+*/
+
+struct fsmtl_tour_struct
+{
+  fsmsp_type sp;
+  int *cnt;       /* how often is the edge used */
+  int *bal;       /* incoming minus outgoing edges */
+  int *queue;
+  int *mark;
+  int *st_node;
+  int *st_edge;
+  int *tour;
+};
+
+static void fsmtl_tour_close(struct fsmtl_tour_struct *t)
+{
+  free(t->cnt);
+  free(t->bal);
+  free(t->queue);
+  free(t->mark);
+  free(t->st_node);
+  free(t->st_edge);
+  free(t->tour);
+}
+
+/* BFS from 'start', marks reachable nodes with 'stamp', returns number of nodes */
+static int fsmtl_tour_bfs(struct fsmtl_tour_struct *t, int start, int stamp)
+{
+  fsmsp_type sp = t->sp;
+  int head = 0, tail = 0, u, k;
+  t->mark[start] = stamp;
+  t->queue[tail++] = start;
+  while( head < tail )
+  {
+    u = t->queue[head++];
+    for( k = sp->out_start[u]; k < sp->out_start[u+1]; k++ )
+      if ( t->mark[sp->out_dest[k]] != stamp )
+      {
+        t->mark[sp->out_dest[k]] = stamp;
+        t->queue[tail++] = sp->out_dest[k];
+      }
+  }
+  return tail;
+}
+
+static void fsmtl_tour_add_path(struct fsmtl_tour_struct *t, int s, int d, int m)
+{
+  fsmsp_type sp = t->sp;
+  unsigned short *row = sp->hop + (size_t)d*sp->n;
+  int k;
+  while( s != d )
+  {
+    k = sp->out_start[s]+row[s];
+    t->cnt[k] += m;
+    s = sp->out_dest[k];
+  }
+}
+
+/* returns 0 if some nodes can not be balanced */
+static int fsmtl_tour_balance(struct fsmtl_tour_struct *t)
+{
+  fsmsp_type sp = t->sp;
+  int i, j, w, m, cnt;
+  for( i = 0; i < sp->n; i++ )
+  {
+    if ( t->bal[i] <= 0 )
+      continue;
+    /* the queue contains the nodes in the order of their distance */
+    cnt = fsmtl_tour_bfs(t, i, -2-i);
+    for( j = 1; j < cnt && t->bal[i] > 0; j++ )
+    {
+      w = t->queue[j];
+      if ( t->bal[w] >= 0 )
+        continue;
+      m = t->bal[i] < -t->bal[w] ? t->bal[i] : -t->bal[w];
+      fsmtl_tour_add_path(t, i, w, m);
+      t->bal[i] -= m;
+      t->bal[w] += m;
+    }
+    if ( t->bal[i] > 0 )
+      return 0;
+  }
+  return 1;
+}
+
+/* returns the length of the tour */
+static int fsmtl_tour_euler(struct fsmtl_tour_struct *t, int start)
+{
+  fsmsp_type sp = t->sp;
+  int *pos = t->queue;
+  int top, len, u, k;
+  
+  for( u = 0; u < sp->n; u++ )
+    pos[u] = sp->out_start[u];
+  
+  len = 0;
+  top = 0;
+  t->st_node[top] = start;
+  t->st_edge[top] = -1;
+  top++;
+  while( top > 0 )
+  {
+    u = t->st_node[top-1];
+    while( pos[u] < sp->out_start[u+1] && t->cnt[pos[u]] == 0 )
+      pos[u]++;
+    if ( pos[u] < sp->out_start[u+1] )
+    {
+      k = pos[u];
+      t->cnt[k]--;
+      t->st_node[top] = sp->out_dest[k];
+      t->st_edge[top] = k;
+      top++;
+    }
+    else
+    {
+      top--;
+      if ( t->st_edge[top] >= 0 )
+        t->tour[len++] = t->st_edge[top];
+    }
+  }
+  return len;
+}
+
+int fsmtl_AddEdgeTour(fsmtl_type tl)
+{
+  struct fsmtl_tour_struct t;
+  fsmsp_type sp;
+  int n, e_cnt, i, k, total, len, last;
+  int start;
+  
+  if ( tl->fsm->reset_node_id < 0 )
+  {
+    fsm_Log(tl->fsm, "FSM TL: Edge tour requires a reset node, using edge sequences.");
+    return fsmtl_AddAllEdgeSequence(tl);
+  }
+  
+  if ( tl->sp == NULL )
+    tl->sp = fsmsp_Open(tl->fsm, 0);
+  if ( tl->sp == NULL )
+  {
+    fsm_Log(tl->fsm, "FSM TL: No next hop table, using edge sequences.");
+    return fsmtl_AddAllEdgeSequence(tl);
+  }
+  sp = tl->sp;
+  n = sp->n;
+  e_cnt = sp->out_start[n];
+  start = sp->node_idx[tl->fsm->reset_node_id];
+
+  t.sp = sp;
+  t.cnt = (int *)calloc(e_cnt+1, sizeof(int));
+  t.bal = (int *)calloc(n+1, sizeof(int));
+  t.queue = (int *)malloc(sizeof(int)*(n+1));
+  t.mark = (int *)malloc(sizeof(int)*(n+1));
+  t.st_node = NULL;
+  t.st_edge = NULL;
+  t.tour = NULL;
+  if ( t.cnt == NULL || t.bal == NULL || t.queue == NULL || t.mark == NULL )
+    return fsmtl_tour_close(&t), 0;
+  
+  for( i = 0; i < n; i++ )
+    t.mark[i] = -1;
+  fsmtl_tour_bfs(&t, start, 0);
+  for( i = 0; i < n; i++ )
+    if ( t.mark[i] == 0 )
+      for( k = sp->out_start[i]; k < sp->out_start[i+1]; k++ )
+      {
+        t.cnt[k] = 1;
+        t.bal[sp->out_dest[k]]++;
+        t.bal[i]--;
+      }
+  
+  if ( fsmtl_tour_balance(&t) == 0 )
+  {
+    fsm_Log(tl->fsm, "FSM TL: No closed edge tour, using edge sequences.");
+    return fsmtl_tour_close(&t), fsmtl_AddAllEdgeSequence(tl);
+  }
+  
+  total = 0;
+  for( k = 0; k < e_cnt; k++ )
+    total += t.cnt[k];
+  t.st_node = (int *)malloc(sizeof(int)*(total+1));
+  t.st_edge = (int *)malloc(sizeof(int)*(total+1));
+  t.tour = (int *)malloc(sizeof(int)*(total+1));
+  if ( t.st_node == NULL || t.st_edge == NULL || t.tour == NULL )
+    return fsmtl_tour_close(&t), 0;
+  
+  len = fsmtl_tour_euler(&t, start);
+  if ( len != total )
+  {
+    fsm_Log(tl->fsm, "FSM TL: No closed edge tour, using edge sequences.");
+    return fsmtl_tour_close(&t), fsmtl_AddAllEdgeSequence(tl);
+  }
+  
+  /* the tour is reversed, remove the final path back to the reset node */
+  for( k = 0; k < e_cnt; k++ )
+    t.cnt[k] = 0;
+  last = len;
+  for( i = len-1; i >= 0; i-- )
+    if ( t.cnt[t.tour[i]]++ == 0 )
+      last = i;
+  
+  for( i = len-1; i >= last; i-- )
+    if ( fsmtl_AddEdgeCondition(tl, sp->out_edge[t.tour[i]], FSM_TEST_CS_RAND) == 0 )
+      return fsmtl_tour_close(&t), 0;
+  
+  fsm_Log(tl->fsm, "FSM TL: Edge tour with %d transitions.", len-last);
+  fsmtl_tour_close(&t);
+  return 1;
+}
@@ -47,6 +47,7 @@ struct _fsmtl_struct
   int (*outfn)(void *data, fsm_type fsm, int msg, int arg, dcube *c);
   void *data;
   dcube curr_input;
+  fsmsp_type sp;      /* next hop table, created by fsmtl_Do */
 };
 typedef struct _fsmtl_struct *fsmtl_type;
 
@@ -71,6 +72,8 @@ void fsmtl_SetDevice(fsmtl_type tl, int (*outfn)(void *data, fsm_type fsm, int m
 int fsmtl_Do(fsmtl_type tl);
 int fsmtl_Show(fsmtl_type tl);
 int fsmtl_AddAllEdgeSequence(fsmtl_type tl);
+/* closed walk from the reset node over all reachable edges (chinese postman) */
+int fsmtl_AddEdgeTour(fsmtl_type tl);
 
 /* options for fsm_WriteVHDLTB are defined in fsm.h! */
 
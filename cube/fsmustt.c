@@ -51,6 +51,7 @@
 #include <assert.h>
 #include <stdlib.h>
 #include "fsm.h"
+#include "dich.h"
 #include "mwc.h"
 
 /* #define FSMUSTT_VERBOSE */
@@ -81,7 +82,7 @@ int fsm_InitAsync(fsm_type fsm)
 
 /*---------------------------------------------------------------------------*/
 
-static void fsm_set_all_group_value(fsm_type fsm, dcube *c, int g, int v)
+static void fsm_set_all_group_value(fsm_type fsm, dich_type d, int i, int g, int v)
 {
   int n;
   if ( g < 0 )
@@ -91,17 +92,15 @@ static void fsm_set_all_group_value(fsm_type fsm, dcube *c, int g, int v)
   {
     if ( g == fsm_GetNode(fsm, n)->group_index )
     {
-      dcSetIn(c, fsm_GetNode(fsm, n)->user_val, v);
+      dich_SetState(d, i, fsm_GetNode(fsm, n)->user_val, v);
     }
   }
 }
 
-static int fsm_insert_partition(fsm_type fsm, int n1, int nn1, int n2, int nn2)
+static int fsm_insert_partition(fsm_type fsm, dich_type d, int n1, int nn1, int n2, int nn2)
 {
-  dcube *c;
+  int i;
   int g1, gg1, g2, gg2;
-  c = &(fsm->pi_async->tmp[11]);
-  dcInSetAll(fsm->pi_async, c, CUBE_IN_MASK_DC);
 
   /*
   printf("%s %s - %s %s\n",
@@ -121,32 +120,32 @@ static int fsm_insert_partition(fsm_type fsm, int n1, int nn1, int n2, int nn2)
   g2 = fsm_GetNode(fsm, n2)->group_index;
   gg2 = fsm_GetNode(fsm, nn2)->group_index;
   
-  dcSetIn(c, n1, 1);
-  dcSetIn(c, nn1, 1);
-  dcSetIn(c, n2, 2);
-  dcSetIn(c, nn2, 2);
-  
-  fsm_set_all_group_value(fsm, c, g1, 1);
-  fsm_set_all_group_value(fsm, c, gg1, 1);
-  fsm_set_all_group_value(fsm, c, g2, 2);
-  fsm_set_all_group_value(fsm, c, gg2, 2);
-  
-  /*puts(dcToStr(fsm->pi_async, c, " ", ""));*/
-  /* if ( dcIsTautology(fsm->pi_async, c ) == 0 ) */
-  if ( dcInOneCnt(fsm->pi_async, c) != 0 && dcInZeroCnt(fsm->pi_async, c) != 0 )
+  i = dich_AddEmpty(d);
+  if ( i < 0 )
   {
-    if ( dclAdd(fsm->pi_async, fsm->cl_async, c) < 0 )
-    {
-      fsm_Log(fsm, "fsm_insert_partition: Out of Memory (dclAdd).");
-      return 0;
-    }
+    fsm_Log(fsm, "fsm_insert_partition: Out of Memory (dich_AddEmpty).");
+    return 0;
   }
+
+  dich_SetState(d, i, n1, 1);
+  dich_SetState(d, i, nn1, 1);
+  dich_SetState(d, i, n2, 2);
+  dich_SetState(d, i, nn2, 2);
+  
+  fsm_set_all_group_value(fsm, d, i, g1, 1);
+  fsm_set_all_group_value(fsm, d, i, gg1, 1);
+  fsm_set_all_group_value(fsm, d, i, g2, 2);
+  fsm_set_all_group_value(fsm, d, i, gg2, 2);
+  
+  /* both blocks must contain a state */
+  if ( dich_IsValid(d, i) == 0 )
+    dich_DelLast(d);
   return 1;
 }
 
 /*---------------------------------------------------------------------------*/
 
-static int fsm_partition_stable_states(fsm_type fsm, dcube *input, int n1, int n2)
+static int fsm_partition_stable_states(fsm_type fsm, dich_type d, dcube *input, int n1, int n2)
 {
   int e1, l1;
   int e2, l2;
@@ -160,7 +159,7 @@ static int fsm_partition_stable_states(fsm_type fsm, dcube *input, int n1, int n
       {
         if ( dclIsSubSet(fsm->pi_cond, fsm_GetEdgeCondition(fsm, e2), input) != 0 )
         {
-          if ( fsm_insert_partition(fsm, n1, fsm_GetEdgeSrcNode(fsm, e1), n2, fsm_GetEdgeSrcNode(fsm, e2)) == 0 )
+          if ( fsm_insert_partition(fsm, d, n1, fsm_GetEdgeSrcNode(fsm, e1), n2, fsm_GetEdgeSrcNode(fsm, e2)) == 0 )
           {
             return 0;
           }
@@ -196,7 +195,7 @@ static int fsm_is_stable_node(fsm_type fsm, dcube *input, int node_id)
   return dclIsSubSet(fsm->pi_cond, fsm_GetEdgeCondition(fsm, edge_id), input);
 }
 
-static int fsm_partition_input(fsm_type fsm, dcube *input)
+static int fsm_partition_input(fsm_type fsm, dich_type d, dcube *input)
 {
   int node_id_1;
   int node_id_2;
@@ -219,7 +218,7 @@ static int fsm_partition_input(fsm_type fsm, dcube *input)
       {
         if ( fsm_is_stable_node(fsm, input, node_id_2) != 0 )
         {
-          fsm_partition_stable_states(fsm, input, node_id_1, node_id_2);
+          fsm_partition_stable_states(fsm, d, input, node_id_1, node_id_2);
         }
       }
     }
@@ -230,9 +229,13 @@ static int fsm_partition_input(fsm_type fsm, dcube *input)
 int fsm_BuildPartitionTable(fsm_type fsm)
 {
   dcube *input;
+  dich_type d;
   
   if ( fsm_InitAsync(fsm) == 0 )
     return 0;
+  d = dich_Open(fsm->pi_async->in_cnt);
+  if ( d == NULL )
+    return 0;
     
   input = &(fsm->pi_cond->tmp[10]);
   
@@ -240,13 +243,16 @@ int fsm_BuildPartitionTable(fsm_type fsm)
   
   do
   {
-    if ( fsm_partition_input(fsm, input) == 0 )
-      return 0;
+    if ( fsm_partition_input(fsm, d, input) == 0 )
+      return dich_Close(d), 0;
   } while( dcInc(fsm->pi_cond, input) != 0 );
   
-  dclSCCInv(fsm->pi_async, fsm->cl_async);
+  if ( dich_SCC(d) == 0 )
+    return dich_Close(d), 0;
+  if ( dich_ToDCL(d, fsm->pi_async, fsm->cl_async) == 0 )
+    return dich_Close(d), 0;
   /* dclShow(fsm->pi_async, fsm->cl_async); */
-  return 1;
+  return dich_Close(d), 1;
 }
 
 /* this function does not separate states of the same group */
@@ -254,11 +260,8 @@ int fsm_SeparateStates(fsm_type fsm)
 {
   int node_id_1;
   int node_id_2;
-  dcube *e1;
-  dcube *e2;
-  int i, cnt = dclCnt(fsm->cl_async);
-  e1 = &(fsm->pi_async->tmp[3]);
-  e2 = &(fsm->pi_async->tmp[4]);
+  dich_type d;
+  int cnt = dclCnt(fsm->cl_async);
 
   node_id_1 = -1;
   node_id_2 = 0;
@@ -268,6 +271,12 @@ int fsm_SeparateStates(fsm_type fsm)
     node_id_2++;
   }
 
+  d = dich_Open(fsm->pi_async->in_cnt);
+  if ( d == NULL )
+    return 0;
+  if ( dich_AddDCL(d, fsm->pi_async, fsm->cl_async) == 0 )
+    return dich_Close(d), 0;
+
   node_id_1 = -1;
   while( fsm_LoopNodes(fsm, &node_id_1) != 0 )
   {
@@ -278,14 +287,6 @@ int fsm_SeparateStates(fsm_type fsm)
           fsm_GetNodeGroupIndex(fsm,node_id_2) < 0 ||
           fsm_GetNodeGroupIndex(fsm,node_id_1) != fsm_GetNodeGroupIndex(fsm,node_id_2) )
       {
-        dcInSetAll(fsm->pi_async, e1, CUBE_IN_MASK_DC);
-        dcOutSetAll(fsm->pi_async, e1, CUBE_OUT_MASK);
-        dcInSetAll(fsm->pi_async, e2, CUBE_IN_MASK_DC);
-        dcOutSetAll(fsm->pi_async, e2, CUBE_OUT_MASK);
-        dcSetIn(e1, fsm_GetNode(fsm, node_id_1)->user_val, 1);
-        dcSetIn(e1, fsm_GetNode(fsm, node_id_2)->user_val, 2);
-        dcSetIn(e2, fsm_GetNode(fsm, node_id_1)->user_val, 2);
-        dcSetIn(e2, fsm_GetNode(fsm, node_id_2)->user_val, 1);
         {
 #ifdef FSMUSTT_VERBOSE
           char *n1 = fsm_GetNodeName(fsm, node_id_1);
@@ -294,19 +295,17 @@ int fsm_SeparateStates(fsm_type fsm)
             n1, n2);
 #endif /* FSMUSTT_VERBOSE */
         }
-        for( i = 0; i < cnt; i++ )
-        {
-          if ( dcIsSubSet(fsm->pi_async, e1, dclGet(fsm->cl_async, i)) != 0 )
-            break;
-          if ( dcIsSubSet(fsm->pi_async, e2, dclGet(fsm->cl_async, i)) != 0 )
-            break;
-        }
-        if ( i == cnt )
-          if ( fsm_insert_partition(fsm, node_id_1, node_id_1, node_id_2, node_id_2) == 0 )
-            return 0;
+        /* only the partitions of the partition table are checked */
+        if ( dich_IsSeparated(d, cnt, 
+              fsm_GetNode(fsm, node_id_1)->user_val, 
+              fsm_GetNode(fsm, node_id_2)->user_val) == 0 )
+          if ( fsm_insert_partition(fsm, d, node_id_1, node_id_1, node_id_2, node_id_2) == 0 )
+            return dich_Close(d), 0;
       }
     }
   }
+  if ( dich_ToDCL(d, fsm->pi_async, fsm->cl_async) == 0 )
+    return dich_Close(d), 0;
   /*
   printf("Separate States %d\n", dclCnt(fsm->cl_async)-cnt);
   puts("-- pre ---");
@@ -315,7 +314,7 @@ int fsm_SeparateStates(fsm_type fsm)
   puts("-- post ---");
   dclShow(fsm->pi_async, fsm->cl_async);
   */
-  return 1;
+  return dich_Close(d), 1;
 }
 
 
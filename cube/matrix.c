@@ -29,6 +29,7 @@
 /* #include <sys/resource.h> */
 #include "dcube.h"
 #include "matrix.h"
+#include "b_stat.h"
 
 /* not always allowed... */
 /* FILE *fp_out = stderr; */
@@ -710,8 +711,9 @@ int maMatrixCoverInit (ma_ptr2matrix sparse, ma_ptr2solution result, int *weight
   ma_ptr2solution sol_forchild;
   ma_ptr2col f_col;
   ma_ptr2field f_field;
+  b_stat_type stat;
   
-  int rtc = 0, cost_max = 0;
+  int rtc = 0, cost_max = 0, cost;
 
   if (sparse->row_cnt < 1)
     return (1);
@@ -719,6 +721,11 @@ int maMatrixCoverInit (ma_ptr2matrix sparse, ma_ptr2solution result, int *weight
   if (result->row->cnt > 0)
     return (0);
   
+  stat = b_stat_Start("cover");
+  b_stat_Add(stat, "rows", sparse->row_cnt);
+  b_stat_Add(stat, "cols", sparse->col_cnt);
+  b_stat_Add(stat, "fields", maMatrixCountFields(sparse));
+  
   /*  Initialisieren der Statistik-Struktur */
   statistic->gimpel_reduction_cnt = 0;  
   statistic->gimpels_above = 0;         
@@ -776,6 +783,21 @@ int maMatrixCoverInit (ma_ptr2matrix sparse, ma_ptr2solution result, int *weight
       */
       rtc = 0;
     }
+  
+  if (stat != NULL)
+  {
+    cost = 0;
+    for (f_field = result->row->fieldptr_firstcol; f_field != NULL; f_field = f_field->fieldptr_nextcol)
+      cost += ((weight == NULL) ? 1 : weight[sparse->cols[f_field->col_no]->no] );
+    b_stat_Add(stat, "recursion_cnt", statistic->recursion_cnt);
+    b_stat_Add(stat, "recursion_depth_max", statistic->recursion_depth_max);
+    b_stat_Add(stat, "gimpel_reduction_cnt", statistic->gimpel_reduction_cnt);
+    b_stat_Add(stat, "partition_build_cnt", statistic->partition_build_cnt);
+    b_stat_Add(stat, "cost_upper", cost_max);
+    b_stat_Add(stat, "cost", cost);
+    b_stat_Add(stat, "result", rtc);
+    b_stat_Finish(stat);
+  }
       
   if (debug)
   {
@@ -1712,7 +1734,13 @@ int maMatrixIrredundant (pinfo *pi, dclist cl_es, dclist cl_pr, dclist cl_dc, dc
           dclDeleteCubesWithFlag(pi, cl_pr);
           dclDeleteCubesWithFlag(&local_pi, cl_array);
 
-          if (maMatrixInitSized(&ma_matrix, dclCnt(cl_array), local_pi.out_cnt) && maSolutionInit(&ma_solution))
+          if ( local_pi.out_cnt == 0 )
+          {
+            /* the essential cubes already cover everything */
+            dclClear(cl_pr);
+            rtc = 1;
+          }
+          else if (maMatrixInitSized(&ma_matrix, dclCnt(cl_array), local_pi.out_cnt) && maSolutionInit(&ma_solution))
           {
             /* Ueberdeckungsmatrix aufbauen und part. red. cubes den einzelnen Spalten zuweisen ... */
             if ( is_literal != 0 )
@@ -2173,8 +2201,8 @@ void maMatrixReduceCoudert (ma_ptr2matrix sparse, int *weight, int cost_curr, in
   }
 }
 
-/* ----- maMatrixReduceDominatedCols ---------------- */
-int maMatrixReduceDominatedCols (ma_ptr2matrix sparse, int *weight)
+/* ----- maMatrixReduceDominatedColsList ------------ */
+static int maMatrixReduceDominatedColsList (ma_ptr2matrix sparse, int *weight)
 {
   ma_ptr2col f_col, f_nextcol, f_compcol;
   ma_ptr2row f_row, f_smallestrow;
@@ -2193,7 +2221,8 @@ int maMatrixReduceDominatedCols (ma_ptr2matrix sparse, int *weight)
     for (field = f_col->fieldptr_firstrow->fieldptr_nextrow; field != NULL; field = field->fieldptr_nextrow)
     {
       f_row = sparse->rows[field->row_no];
-      if (f_row->cnt > f_smallestrow->cnt)
+      /* each dominating column is an element of all rows of f_col, the smallest row is sufficient */
+      if (f_row->cnt < f_smallestrow->cnt)
         f_smallestrow = f_row;
     }
 
@@ -2231,6 +2260,157 @@ int maMatrixReduceDominatedCols (ma_ptr2matrix sparse, int *weight)
   return rtc;
 }
 
+/* ----- maMatrixReduceDominatedCols ---------------- */
+/* 
+  Same result as maMatrixReduceDominatedColsList(): A column is deleted, 
+  if it is dominated by another column. Dominance is transitive, so the 
+  deleted columns do not depend on the order of the checks. The columns
+  are sorted (more rows first, equal count: higher column number first)
+  and each column is compared with the remaining columns only. 
+  Rows are stored as bitsets, the remaining columns are indexed by 
+  their rows.
+*/
+
+struct ma_col_key
+{
+  int cnt;
+  int col;
+};
+
+static int maColCmp (const void *ap, const void *bp)
+{
+  const struct ma_col_key *a = (const struct ma_col_key *)ap;
+  const struct ma_col_key *b = (const struct ma_col_key *)bp;
+  if (a->cnt != b->cnt)
+    return ((a->cnt > b->cnt) ? -1 : 1);
+  if (a->col != b->col)
+    return ((a->col > b->col) ? -1 : 1);
+  return (0);
+}
+
+int maMatrixReduceDominatedCols (ma_ptr2matrix sparse, int *weight)
+{
+  ma_ptr2col f_col;
+  ma_ptr2field field;
+  unsigned *bits, *b, *c;
+  struct ma_col_key *order;
+  int *row_cnt, *row_pos, *row_cols;
+  char *is_del;
+  int words, col_init, row_init, i, j, k, r, r_min, n, w, rtc = 0;
+  
+  col_init = sparse->col_init;
+  row_init = sparse->row_init;
+  words = (row_init + 31) / 32;
+  if (sparse->col_cnt == 0)
+    return (0);
+  
+  n = 0;
+  for (f_col = sparse->colptr_first; f_col != NULL; f_col = f_col->colptr_next)
+    n += f_col->cnt;
+  
+  bits = (unsigned *)calloc((size_t)col_init * (size_t)words + 1, sizeof(unsigned));
+  order = (struct ma_col_key *)malloc(sizeof(struct ma_col_key) * ((size_t)col_init + 1));
+  row_cnt = (int *)malloc(sizeof(int) * ((size_t)2 * row_init + n + 1));
+  is_del = (char *)calloc(col_init + 1, 1);
+  if (bits == NULL || order == NULL || row_cnt == NULL || is_del == NULL)
+  {
+    if (bits != NULL) free(bits);
+    if (order != NULL) free(order);
+    if (row_cnt != NULL) free(row_cnt);
+    if (is_del != NULL) free(is_del);
+    return maMatrixReduceDominatedColsList(sparse, weight);
+  }
+  row_pos = row_cnt + row_init;
+  row_cols = row_pos + row_init;
+  
+  /* bitsets of the columns, number of fields of each row */
+  for (r = 0; r < row_init; r++)
+    row_cnt[r] = 0;
+  n = 0;
+  for (f_col = sparse->colptr_first; f_col != NULL; f_col = f_col->colptr_next)
+  {
+    b = bits + (size_t)f_col->no * (size_t)words;
+    for (field = f_col->fieldptr_firstrow; field != NULL; field = field->fieldptr_nextrow)
+    {
+      b[field->row_no / 32] |= 1U << (field->row_no % 32);
+      row_cnt[field->row_no]++;
+    }
+    order[n].cnt = f_col->cnt;
+    order[n].col = f_col->no;
+    n++;
+  }
+  
+  /* remaining columns of row r: row_cols[row_pos[r]...row_pos[r]+row_cnt[r]-1] */
+  k = 0;
+  for (r = 0; r < row_init; r++)
+  {
+    row_pos[r] = k;
+    k += row_cnt[r];
+    row_cnt[r] = 0;
+  }
+  
+  qsort(order, n, sizeof(struct ma_col_key), maColCmp);
+  
+  for (i = 0; i < n; i++)
+  {
+    j = order[i].col;
+    f_col = sparse->cols[j];
+    b = bits + (size_t)j * (size_t)words;
+    
+    /* a dominating column contains all rows of f_col, check the row with the fewest columns */
+    r_min = -1;
+    for (field = f_col->fieldptr_firstrow; field != NULL; field = field->fieldptr_nextrow)
+      if (r_min < 0 || row_cnt[field->row_no] < row_cnt[r_min])
+        r_min = field->row_no;
+    
+    if (r_min >= 0)
+    {
+      for (k = row_pos[r_min]; k < row_pos[r_min] + row_cnt[r_min]; k++)
+      {
+        c = bits + (size_t)row_cols[k] * (size_t)words;
+        for (w = 0; w < words; w++)
+          if ((b[w] & ~c[w]) != 0)
+            break;
+        if (w >= words)
+          if (weight == NULL || weight[row_cols[k]] <= weight[j])
+            break;
+      }
+      if (k < row_pos[r_min] + row_cnt[r_min])
+        is_del[j] = 1;
+    }
+    else
+    {
+      /* column without rows */
+      for (k = 0; k < i; k++)
+        if (is_del[order[k].col] == 0)
+          if (weight == NULL || weight[order[k].col] <= weight[j])
+            break;
+      if (k < i)
+        is_del[j] = 1;
+    }
+    
+    if (is_del[j] == 0)
+      for (field = f_col->fieldptr_firstrow; field != NULL; field = field->fieldptr_nextrow)
+      {
+        row_cols[row_pos[field->row_no] + row_cnt[field->row_no]] = j;
+        row_cnt[field->row_no]++;
+      }
+  }
+  
+  for (j = 0; j < col_init; j++)
+    if (is_del[j] != 0)
+    {
+      (void) maMatrixDeleteCol(sparse, j);
+      rtc++;
+    }
+  
+  free(bits);
+  free(order);
+  free(row_cnt);
+  free(is_del);
+  return rtc;
+}
+
 /* ----- maMatrixReduceDominatingRows --------------- */
 int maMatrixReduceDominatingRows (ma_ptr2matrix sparse)
 {
@@ -24,6 +24,7 @@
 #include "mcov.h"
 #include <stdlib.h>
 #include <assert.h>
+#include "b_stat.h"
 #include "mwc.h"
 
 int mcovInit(mcov *mc, pinfo *pi)
@@ -41,6 +42,7 @@ int mcovInit(mcov *mc, pinfo *pi)
           (*mc)->is_select_init = 0;
           (*mc)->is_matrix_init = 0;
           (*mc)->cost_curr = 0;
+          (*mc)->search_mode = MCOV_SEARCH_BB;
           return 1;
         }
         pinfoDestroy(&((*mc)->pi_matrix));
@@ -290,13 +292,426 @@ int mcovExactStart(mcov mc)
 }
 
 
+/*-- packed exact search ---------------------------------------------------*/
+
+/*
+  mcovExactStart() tries all selections of columns in lexicographic order.
+  The following search works on a row/column copy of the matrix with
+  64 bit words:
+    - col_rows: rows covered by a column (columns are the primes)
+    - row_cols: columns, which cover a row
+  The number of selected columns, which cover a row, is maintained 
+  incrementally in 'cover_cnt', the bitset 'covered' contains all
+  rows with cover_cnt > 0.
+  
+  The search branches on the uncovered row with the fewest columns.
+  A lower bound is calculated from a set of uncovered rows, which 
+  do not share any column. Partial coverages, which have already been 
+  expanded with lower or equal cost, are not expanded again (memo). 
+  
+  MCOV_SEARCH_BB: branch and bound, starting with a greedy solution
+  MCOV_SEARCH_ID: iterative deepening on the cost limit
+*/
+
+typedef unsigned long long mcb_word;
+#define MCB_BITS 64
+#define MCB_WORDS(n) (((n)+MCB_BITS-1)/MCB_BITS)
+#define MCB_BIT(pos) (((mcb_word)1)<<((pos)%MCB_BITS))
+#define MCB_IS(set,pos) (((set)[(pos)/MCB_BITS] & MCB_BIT(pos)) != 0)
+#define MCB_SET(set,pos) ((set)[(pos)/MCB_BITS] |= MCB_BIT(pos))
+#define MCB_CLR(set,pos) ((set)[(pos)/MCB_BITS] &= ~MCB_BIT(pos))
+
+#if defined(__GNUC__)
+#define mcb_lowest(w) (__builtin_ctzll(w))
+#else
+static int mcb_lowest(mcb_word w)
+{
+  int pos = 0;
+  while( (w & 1) == 0 )
+  {
+    w >>= 1;
+    pos++;
+  }
+  return pos;
+}
+#endif
+
+#define MCB_COST_MAX (~(unsigned)0)
+
+/* upper limits for the size of the memo table */
+#define MCB_MEMO_WORDS (1<<20)
+#define MCB_MEMO_CNT (1<<16)
+
+struct _mcb_struct
+{
+  int mode;
+  int row_cnt, col_cnt;
+  int row_words, col_words;
+  mcb_word *col_rows;   /* col_cnt*row_words */
+  mcb_word *row_cols;   /* row_cnt*col_words */
+  unsigned *cost;       /* col_cnt */
+  unsigned *row_min_cost;
+  int *row_col_cnt;
+  
+  int *cover_cnt;       /* row_cnt */
+  mcb_word *covered;    /* row_words */
+  mcb_word *used;       /* col_words, used by the lower bound */
+  mcb_word *select;     /* col_words */
+  unsigned cost_curr;
+  mcb_word *select_opt; /* col_words */
+  unsigned cost_opt;
+  unsigned limit;       /* MCOV_SEARCH_ID */
+  unsigned next_limit;
+  
+  int memo_cnt;         /* power of two */
+  mcb_word *memo_key;   /* memo_cnt*row_words */
+  unsigned *memo_cost;
+  
+  long search_cnt;      /* statistics */
+};
+typedef struct _mcb_struct *mcb_type;
+
+static void mcb_Close(mcb_type b)
+{
+  free(b->col_rows);
+  free(b->row_cols);
+  free(b->cost);
+  free(b->row_min_cost);
+  free(b->row_col_cnt);
+  free(b->cover_cnt);
+  free(b->covered);
+  free(b->used);
+  free(b->select);
+  free(b->select_opt);
+  free(b->memo_key);
+  free(b->memo_cost);
+  free(b);
+}
+
+static mcb_type mcb_Open(mcov mc)
+{
+  mcb_type b;
+  int r, c;
+  
+  b = (mcb_type)calloc(1, sizeof(struct _mcb_struct));
+  if ( b == NULL )
+    return NULL;
+  b->mode = mc->search_mode;
+  b->row_cnt = mc->pi_matrix.out_cnt;
+  b->col_cnt = mc->pi_select.out_cnt;
+  b->row_words = MCB_WORDS(b->row_cnt)+1;
+  b->col_words = MCB_WORDS(b->col_cnt)+1;
+  
+  b->col_rows = (mcb_word *)calloc(b->col_cnt*b->row_words, sizeof(mcb_word));
+  b->row_cols = (mcb_word *)calloc(b->row_cnt*b->col_words+1, sizeof(mcb_word));
+  b->cost = (unsigned *)calloc(b->col_cnt+1, sizeof(unsigned));
+  b->row_min_cost = (unsigned *)calloc(b->row_cnt+1, sizeof(unsigned));
+  b->row_col_cnt = (int *)calloc(b->row_cnt+1, sizeof(int));
+  b->cover_cnt = (int *)calloc(b->row_cnt+1, sizeof(int));
+  b->covered = (mcb_word *)calloc(b->row_words, sizeof(mcb_word));
+  b->used = (mcb_word *)calloc(b->col_words, sizeof(mcb_word));
+  b->select = (mcb_word *)calloc(b->col_words, sizeof(mcb_word));
+  b->select_opt = (mcb_word *)calloc(b->col_words, sizeof(mcb_word));
+  
+  b->memo_cnt = 1;
+  while( b->memo_cnt < MCB_MEMO_CNT && b->memo_cnt*2*b->row_words <= MCB_MEMO_WORDS )
+    b->memo_cnt *= 2;
+  b->memo_key = (mcb_word *)malloc(b->memo_cnt*b->row_words*sizeof(mcb_word));
+  b->memo_cost = (unsigned *)malloc(b->memo_cnt*sizeof(unsigned));
+  
+  if ( b->col_rows == NULL || b->row_cols == NULL || b->cost == NULL || 
+       b->row_min_cost == NULL || b->row_col_cnt == NULL || b->cover_cnt == NULL || 
+       b->covered == NULL || b->used == NULL || b->select == NULL || 
+       b->select_opt == NULL || b->memo_key == NULL || b->memo_cost == NULL )
+    return mcb_Close(b), NULL;
+  
+  for( c = 0; c < b->col_cnt; c++ )
+  {
+    b->cost[c] = dclGet(mc->cl_pr, c)->n;
+    for( r = 0; r < b->row_cnt; r++ )
+      if ( dcGetOut(dclGet(mc->cl_matrix, c), r) != 0 )
+      {
+        MCB_SET(b->col_rows+c*b->row_words, r);
+        MCB_SET(b->row_cols+r*b->col_words, c);
+        if ( b->row_col_cnt[r] == 0 || b->row_min_cost[r] > b->cost[c] )
+          b->row_min_cost[r] = b->cost[c];
+        b->row_col_cnt[r]++;
+      }
+  }
+  return b;
+}
+
+static void mcb_ClearMemo(mcb_type b)
+{
+  int i;
+  for( i = 0; i < b->memo_cnt; i++ )
+    b->memo_cost[i] = MCB_COST_MAX;
+}
+
+/* returns 1, if the current coverage has been expanded with lower or equal cost */
+static int mcb_IsMemo(mcb_type b)
+{
+  int w;
+  unsigned h = 0;
+  mcb_word *key;
+  for( w = 0; w < b->row_words; w++ )
+    h = h*16777619U ^ (unsigned)(b->covered[w] ^ (b->covered[w]>>29));
+  h ^= h >> 13;
+  h &= (unsigned)(b->memo_cnt-1);
+  key = b->memo_key + h*b->row_words;
+  if ( b->memo_cost[h] != MCB_COST_MAX )
+  {
+    for( w = 0; w < b->row_words; w++ )
+      if ( key[w] != b->covered[w] )
+        break;
+    if ( w == b->row_words && b->memo_cost[h] <= b->cost_curr )
+      return 1;
+  }
+  for( w = 0; w < b->row_words; w++ )
+    key[w] = b->covered[w];
+  b->memo_cost[h] = b->cost_curr;
+  return 0;
+}
+
+static void mcb_Select(mcb_type b, int c)
+{
+  int w, r;
+  mcb_word m, *rows = b->col_rows+c*b->row_words;
+  MCB_SET(b->select, c);
+  b->cost_curr += b->cost[c];
+  for( w = 0; w < b->row_words; w++ )
+    for( m = rows[w]; m != 0; m &= m-1 )
+    {
+      r = w*MCB_BITS + mcb_lowest(m);
+      if ( b->cover_cnt[r]++ == 0 )
+        MCB_SET(b->covered, r);
+    }
+}
+
+static void mcb_Unselect(mcb_type b, int c)
+{
+  int w, r;
+  mcb_word m, *rows = b->col_rows+c*b->row_words;
+  MCB_CLR(b->select, c);
+  b->cost_curr -= b->cost[c];
+  for( w = 0; w < b->row_words; w++ )
+    for( m = rows[w]; m != 0; m &= m-1 )
+    {
+      r = w*MCB_BITS + mcb_lowest(m);
+      if ( --b->cover_cnt[r] == 0 )
+        MCB_CLR(b->covered, r);
+    }
+}
+
+/* number of rows, which would be covered additionally by column c */
+static int mcb_GetNewCnt(mcb_type b, int c)
+{
+  int w, cnt = 0;
+  mcb_word m, *rows = b->col_rows+c*b->row_words;
+  for( w = 0; w < b->row_words; w++ )
+    for( m = rows[w] & ~b->covered[w]; m != 0; m &= m-1 )
+      cnt++;
+  return cnt;
+}
+
+/* 
+  returns the uncovered row with the fewest columns or -1 if all rows 
+  are covered, 'lb' is set to the lower bound for the remaining cost 
+*/
+static int mcb_GetBranchRow(mcb_type b, unsigned *lb)
+{
+  int w, r, i, best = -1;
+  mcb_word m, *cols;
+  *lb = 0;
+  for( i = 0; i < b->col_words; i++ )
+    b->used[i] = 0;
+  for( w = 0; w*MCB_BITS < b->row_cnt; w++ )
+  {
+    m = ~b->covered[w];
+    if ( (w+1)*MCB_BITS > b->row_cnt )
+      m &= (((mcb_word)1)<<(b->row_cnt%MCB_BITS))-1;
+    for( ; m != 0; m &= m-1 )
+    {
+      r = w*MCB_BITS + mcb_lowest(m);
+      if ( best < 0 || b->row_col_cnt[best] > b->row_col_cnt[r] )
+        best = r;
+      cols = b->row_cols+r*b->col_words;
+      for( i = 0; i < b->col_words; i++ )
+        if ( (cols[i] & b->used[i]) != 0 )
+          break;
+      if ( i >= b->col_words )
+      {
+        for( i = 0; i < b->col_words; i++ )
+          b->used[i] |= cols[i];
+        *lb += b->row_min_cost[r];
+      }
+    }
+  }
+  return best;
+}
+
+static void mcb_CopyCurrToOpt(mcb_type b)
+{
+  int i;
+  for( i = 0; i < b->col_words; i++ )
+    b->select_opt[i] = b->select[i];
+  b->cost_opt = b->cost_curr;
+}
+
+/* cost_opt remains MCB_COST_MAX, if there is no cover */
+static void mcb_Greedy(mcb_type b)
+{
+  int c, c_opt, n;
+  unsigned lb;
+  double v, v_opt;
+  for(;;)
+  {
+    c_opt = -1;
+    v_opt = 0.0;
+    for( c = 0; c < b->col_cnt; c++ )
+      if ( MCB_IS(b->select, c) == 0 )
+      {
+        n = mcb_GetNewCnt(b, c);
+        if ( n > 0 )
+        {
+          v = (double)n/(double)(b->cost[c]+1);
+          if ( c_opt < 0 || v > v_opt )
+          {
+            c_opt = c;
+            v_opt = v;
+          }
+        }
+      }
+    if ( c_opt < 0 )
+      break;
+    mcb_Select(b, c_opt);
+  }
+  if ( mcb_GetBranchRow(b, &lb) < 0 )
+    mcb_CopyCurrToOpt(b);
+  for( c = 0; c < b->col_cnt; c++ )
+    if ( MCB_IS(b->select, c) != 0 )
+      mcb_Unselect(b, c);
+}
+
+/* returns 1 if the search should be stopped */
+static int mcb_Search(mcb_type b)
+{
+  unsigned lb;
+  int r, w, c;
+  mcb_word m, *cols;
+  
+  b->search_cnt++;
+  r = mcb_GetBranchRow(b, &lb);
+  
+  if ( b->mode == MCOV_SEARCH_ID )
+  {
+    if ( b->cost_curr+lb > b->limit )
+    {
+      if ( b->next_limit > b->cost_curr+lb )
+        b->next_limit = b->cost_curr+lb;
+      return 0;
+    }
+  }
+  else
+  {
+    if ( b->cost_curr+lb >= b->cost_opt )
+      return 0;
+  }
+
+  if ( r < 0 )
+  {
+    mcb_CopyCurrToOpt(b);
+    return b->mode == MCOV_SEARCH_ID ? 1 : 0;
+  }
+
+  if ( b->row_col_cnt[r] == 0 )
+    return 0;   /* row can not be covered */
+  
+  if ( mcb_IsMemo(b) != 0 )
+    return 0;
+  
+  cols = b->row_cols+r*b->col_words;
+  for( w = 0; w < b->col_words; w++ )
+    for( m = cols[w]; m != 0; m &= m-1 )
+    {
+      c = w*MCB_BITS + mcb_lowest(m);
+      mcb_Select(b, c);
+      if ( mcb_Search(b) != 0 )
+      {
+        mcb_Unselect(b, c);
+        return 1;
+      }
+      mcb_Unselect(b, c);
+    }
+  return 0;
+}
+
+static int mcovExactBits(mcov mc)
+{
+  mcb_type b;
+  unsigned lb;
+  int i, c;
+  b_stat_type stat;
+  
+  for( i = 0; i < dclCnt(mc->cl_pr); i++ )
+    dclGet(mc->cl_pr, i)->n = mc->pi_pr->in_cnt-dcInDCCnt(mc->pi_pr, dclGet(mc->cl_pr, i));
+  
+  b = mcb_Open(mc);
+  if ( b == NULL )
+    return 0;
+    
+  b->cost_opt = MCB_COST_MAX;
+  mcb_ClearMemo(b);
+  mcb_GetBranchRow(b, &lb);
+  stat = b_stat_Start("mcov");
+  b_stat_Add(stat, "rows", b->row_cnt);
+  b_stat_Add(stat, "cols", b->col_cnt);
+  b_stat_Add(stat, "cost_lower", lb);
+  if ( b->mode == MCOV_SEARCH_ID )
+  {
+    b->limit = lb;
+    for(;;)
+    {
+      b->next_limit = MCB_COST_MAX;
+      mcb_Search(b);
+      if ( b->cost_opt != MCB_COST_MAX || b->next_limit == MCB_COST_MAX )
+        break;
+      b->limit = b->next_limit;
+      mcb_ClearMemo(b);
+    }
+  }
+  else
+  {
+    mcb_Greedy(b);
+    b_stat_Add(stat, "cost_upper", b->cost_opt == MCB_COST_MAX ? -1 : (long)b->cost_opt);
+    if ( b->cost_opt != MCB_COST_MAX )
+      mcb_Search(b);
+  }
+  
+  b_stat_Add(stat, "search_cnt", b->search_cnt);
+  b_stat_Add(stat, "cost", b->cost_opt == MCB_COST_MAX ? -1 : (long)b->cost_opt);
+  b_stat_Finish(stat);
+  
+  if ( b->cost_opt == MCB_COST_MAX )
+    return mcb_Close(b), 0;
+  
+  dcInSetAll(&(mc->pi_select), &(mc->select_opt), CUBE_IN_MASK_DC);
+  dcOutSetAll(&(mc->pi_select), &(mc->select_opt), 0);
+  for( c = 0; c < b->col_cnt; c++ )
+    if ( MCB_IS(b->select_opt, c) != 0 )
+      dcSetOut(&(mc->select_opt), c, 1);
+  mc->cost_opt = b->cost_opt;
+  
+  return mcb_Close(b), 1;
+}
+
 int mcovExact(mcov mc, dclist cl_es, dclist cl_pr, dclist cl_dc, dclist cl_rc)
 {
   if ( dclCnt(cl_pr) <= 1 )
     return 1; /* es gibt nix zu tun */
   if ( mcovIrredundantMatrix(mc, cl_es, cl_pr, cl_dc, cl_rc) == 0 )
     return 0;
-  if ( mcovExactStart(mc) == 0 )
+  if ( mcovExactBits(mc) == 0 )
     return 0;
   return mcovReducePartialRedundantList(mc, cl_pr, &(mc->select_opt));
 }
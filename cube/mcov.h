@@ -43,9 +43,15 @@ struct _mcov_struct
   dcube    select_opt;
   unsigned cost_opt;
   int is_select_init;
+  
+  int search_mode;        /* MCOV_SEARCH_BB or MCOV_SEARCH_ID */
 };
 typedef struct _mcov_struct *mcov;
 
+/* search strategy of mcovExact */
+#define MCOV_SEARCH_BB 0
+#define MCOV_SEARCH_ID 1
+
 int mcovInit(mcov *mc, pinfo *pi);
 void mcovDestroy(mcov mc);
 int mcovExact(mcov mc, dclist cl_es, dclist cl_pr, dclist cl_dc, dclist cl_rc);
@@ -28,6 +28,7 @@
 */
 
 #include <stdlib.h>
+#include <string.h>
 #include <assert.h>
 #include "mis.h"
 
@@ -44,15 +45,21 @@ static void hm_normal(int *x, int *y)
   }
 }
 
-static int hm_xy_to_pos(int x, int y)
+/* x != y */
+static size_t hm_xy_to_pos(int x, int y)
 {
-  if ( x == y ) 
-    return -1;
+  assert( x != y );
   if ( x > y )
-    return (x-1)*x/2 + y;
-  return (y-1)*y/2 + x;
+    return (size_t)(x-1)*(size_t)x/2 + (size_t)y;
+  return (size_t)(y-1)*(size_t)y/2 + (size_t)x;
 }
 
+#define HM_BITS 32
+#define hm_words(size) ((size)/HM_BITS+1)
+#define hm_get_bit(hm, pos) (((hm)[(pos)/HM_BITS] >> ((pos)%HM_BITS)) & 1U)
+#define hm_set_bit(hm, pos) ((hm)[(pos)/HM_BITS] |= 1U << ((pos)%HM_BITS))
+#define hm_clr_bit(hm, pos) ((hm)[(pos)/HM_BITS] &= ~(1U << ((pos)%HM_BITS)))
+
 
 /*-- fsm helper function ----------------------------------------------------*/
 
@@ -359,7 +366,7 @@ static int xbm_IsUncoditionalCompatible(xbm_type x, int n1, int n2)
 }
 
 
-/*-- pair functions ---------------------------------------------------------*/
+/*-- pair functions (c_list) ------------------------------------------------*/
 
 
 static pair_type pair_Open(mis_type m)
@@ -422,15 +429,6 @@ static int pair_AddRef(pair_type p, int s1, int s2)
   return 1;
 }
 
-static int pair_AddUniqueRef(pair_type p, int s1, int s2)
-{
-  if ( pair_FindRef(p, s1, s2) >= 0 )
-    return 1;
-  if ( pair_AddRef(p, s1, s2) != 0 )
-    return 1;
-  return 0;
-}
-
 static int pair_AddUniqueCRef(pair_type p, int s1, int s2)
 {
   if ( dcGetOut(&(p->compatible), s1) != 0 && dcGetOut(&(p->compatible), s2) != 0 )
@@ -443,15 +441,6 @@ static int pair_AddUniqueCRef(pair_type p, int s1, int s2)
 }
 
 
-static int pair_AppendUniqueCRefs(pair_type dest, pair_type src)
-{
-  int i;
-  for( i = 0; i < src->pr_cnt; i++ )
-    if ( pair_AddUniqueCRef(dest, src->pr_ptr[i].s1, src->pr_ptr[i].s2) == 0 )
-      return 0;
-  return 1;
-}
-
 /* Is b subset of a? */
 static int pair_IsSubsetRefs(pair_type a, pair_type b)
 {
@@ -507,7 +496,6 @@ static int mis_InitRefs(mis_type m)
 
 mis_type mis_Open(fsm_type fsm, xbm_type xbm)
 {
-  int i;
   int inputs;
   mis_type m;
   m = (mis_type)malloc(sizeof(struct _mis_struct));
@@ -532,60 +520,54 @@ mis_type mis_Open(fsm_type fsm, xbm_type xbm)
       free(m);
       return NULL;
     }
-    m->pair_list_size = (m->state_cnt-1)*m->state_cnt/2;
-    m->state_to_node = (int *)malloc(sizeof(int)*m->state_cnt);
+    m->pair_list_size = m->state_cnt > 0 ? (size_t)(m->state_cnt-1)*(size_t)m->state_cnt/2 : 0;
+    m->imply_ptr = NULL;
+    m->imply_cnt = 0;
+    m->imply_max = 0;
+    m->mcl_limit = MIS_MCL_LIMIT;
+    m->mcl_thread_cnt = 0;
+    m->state_to_node = (int *)malloc(sizeof(int)*(m->state_cnt+1));
     if ( m->state_to_node != NULL )
     {
-      m->node_to_state = (int *)malloc(sizeof(int)*m->node_cnt);
+      m->node_to_state = (int *)malloc(sizeof(int)*(m->node_cnt+1));
       if ( m->node_to_state != NULL )
       {
         m->pi_cl = pinfoOpenInOut(0, m->state_cnt);
         if ( m->pi_cl != NULL )
         {
-          m->pair_list_ptr = (pair_type *)malloc(sizeof(pair_type)*m->pair_list_size);
-          if ( m->pair_list_ptr != NULL )
+          m->pair_nc = (unsigned *)calloc(hm_words(m->pair_list_size), sizeof(unsigned));
+          m->pair_known = (unsigned *)calloc(hm_words(m->pair_list_size), sizeof(unsigned));
+          if ( m->pair_nc != NULL && m->pair_known != NULL )
           {
-            for( i = 0; i < m->pair_list_size; i++ )
-              m->pair_list_ptr[i] = NULL;
-            for( i = 0; i < m->pair_list_size; i++ )
-            {
-              m->pair_list_ptr[i] = pair_Open(m);
-              if ( m->pair_list_ptr[i] == NULL )
-                break;
-            }
-            if ( i == m->pair_list_size )
-            {
-              mis_InitRefs(m);
+            mis_InitRefs(m);
 
-              m->pi_imply = pinfoOpenInOut(inputs, m->state_cnt);
-              if ( m->pi_imply != NULL )
+            m->pi_imply = pinfoOpenInOut(inputs, m->state_cnt);
+            if ( m->pi_imply != NULL )
+            {
+              m->pi_mcl = pinfoOpenInOut(m->state_cnt, 0);
+              if ( m->pi_mcl != NULL )
               {
-                m->pi_mcl = pinfoOpenInOut(m->state_cnt, 0);
-                if ( m->pi_imply != NULL )
+                if ( dclInit(&(m->cl_mcl)) != 0 )
                 {
-                  if ( dclInit(&(m->cl_mcl)) != 0 )
+                  m->bcp = b_bcp_Open();
+                  if ( m->bcp != NULL )
                   {
-                    m->bcp = b_bcp_Open();
-                    if ( m->bcp != NULL )
+                    m->c_list = b_pl_Open();
+                    if ( m->c_list != NULL )
                     {
-                      m->c_list = b_pl_Open();
-                      if ( m->c_list != NULL )
-                      {
-                        return m;
-                      }
-                      b_bcp_Close(m->bcp);
+                      return m;
                     }
-                    dclDestroy(m->cl_mcl);
+                    b_bcp_Close(m->bcp);
                   }
-                  pinfoClose(m->pi_mcl);
+                  dclDestroy(m->cl_mcl);
                 }
-                pinfoClose(m->pi_imply);
+                pinfoClose(m->pi_mcl);
               }
+              pinfoClose(m->pi_imply);
             }
-            for( i = 0; i < m->pair_list_size; i++ )
-              if ( m->pair_list_ptr[i] != NULL )
-                pair_Close(m->pair_list_ptr[i]);
           }
+          free(m->pair_nc);
+          free(m->pair_known);
           pinfoClose(m->pi_cl);
         }
         free(m->node_to_state);
@@ -612,10 +594,9 @@ void mis_Close(mis_type m)
 
   pinfoClose(m->pi_cl);
   pinfoClose(m->pi_imply);
-  for( i = 0; i < m->pair_list_size; i++ )
-    if ( m->pair_list_ptr[i] != NULL )
-      pair_Close(m->pair_list_ptr[i]);
-  free(m->pair_list_ptr);
+  free(m->imply_ptr);
+  free(m->pair_nc);
+  free(m->pair_known);
   free(m->node_to_state);
   free(m->state_to_node);
   free(m);
@@ -623,19 +604,64 @@ void mis_Close(mis_type m)
 
 /*-- minimize states (access) -----------------------------------------------*/
 
-static pair_type mis_GetPair(mis_type m, int s1, int s2)
+/* returns the index of the first implication of (s1,s2) */
+static size_t mis_FindImply(mis_type m, int s1, int s2)
 {
-  return m->pair_list_ptr[hm_xy_to_pos(s1, s2)];
+  size_t pos = hm_xy_to_pos(s1, s2);
+  size_t l = 0, u = m->imply_cnt, mid;
+  while( l < u )
+  {
+    mid = (l+u)/2;
+    if ( hm_xy_to_pos(m->imply_ptr[mid].s1, m->imply_ptr[mid].s2) < pos )
+      l = mid+1;
+    else
+      u = mid;
+  }
+  return l;
+}
+
+/* number of implications of (s1,s2), 'start' is the first implication */
+static int mis_GetImplyRange(mis_type m, int s1, int s2, size_t *start)
+{
+  size_t i;
+  hm_normal(&s1, &s2);
+  i = mis_FindImply(m, s1, s2);
+  *start = i;
+  while( i < m->imply_cnt && m->imply_ptr[i].s1 == s1 && m->imply_ptr[i].s2 == s2 )
+    i++;
+  return (int)(i - *start);
 }
 
 static void mis_SetPairT(mis_type m, int s1, int s2, int t)
 {
-  mis_GetPair(m, s1, s2)->t = t;
+  size_t pos = hm_xy_to_pos(s1, s2);
+  if ( t == PAIR_T_UNKNOWN )
+    hm_clr_bit(m->pair_known, pos);
+  else
+    hm_set_bit(m->pair_known, pos);
+  if ( t == PAIR_T_NOT_COMPATIBLE )
+    hm_set_bit(m->pair_nc, pos);
+  else
+    hm_clr_bit(m->pair_nc, pos);
+}
+
+static int mis_IsPairNC(mis_type m, int s1, int s2)
+{
+  return hm_get_bit(m->pair_nc, hm_xy_to_pos(s1, s2));
 }
 
+/* conditional compatible pairs have implications */
 static int mis_GetPairT(mis_type m, int s1, int s2)
 {
-  return mis_GetPair(m, s1, s2)->t;
+  size_t pos = hm_xy_to_pos(s1, s2);
+  size_t start;
+  if ( hm_get_bit(m->pair_nc, pos) != 0 )
+    return PAIR_T_NOT_COMPATIBLE;
+  if ( hm_get_bit(m->pair_known, pos) == 0 )
+    return PAIR_T_UNKNOWN;
+  if ( mis_GetImplyRange(m, s1, s2, &start) > 0 )
+    return PAIR_T_CONDITIONAL_COMPATIBLE;
+  return PAIR_T_ALWAYS_COMPATIBLE;
 }
 
 static int mis_ToN(mis_type m, int s)
@@ -648,9 +674,46 @@ static int mis_ToS(mis_type m, int n)
   return m->node_to_state[n];
 }
 
+/* 
+  implications must be added in the order of the half matrix 
+  position of (s1,s2) 
+*/
 static int mis_AddUniqueReference(mis_type m, int s1, int s2, int t1, int t2)
 {
-  return pair_AddUniqueRef(mis_GetPair(m, s1, s2), t1, t2);
+  size_t i;
+  mis_imply_struct *ptr;
+  hm_normal(&s1, &s2);
+  hm_normal(&t1, &t2);
+  
+  i = m->imply_cnt;
+  while( i > 0 && m->imply_ptr[i-1].s1 == s1 && m->imply_ptr[i-1].s2 == s2 )
+  {
+    i--;
+    if ( m->imply_ptr[i].t1 == t1 && m->imply_ptr[i].t2 == t2 )
+      return 1;
+  }
+  assert( m->imply_cnt == 0 || 
+    hm_xy_to_pos(m->imply_ptr[m->imply_cnt-1].s1, m->imply_ptr[m->imply_cnt-1].s2) 
+      <= hm_xy_to_pos(s1, s2) );
+  
+  if ( m->imply_cnt >= m->imply_max )
+  {
+    if ( m->imply_ptr == NULL )
+      ptr = (mis_imply_struct *)malloc(sizeof(mis_imply_struct)*64);
+    else
+      ptr = (mis_imply_struct *)realloc(m->imply_ptr, sizeof(mis_imply_struct)*m->imply_max*2);
+    if ( ptr == NULL )
+      return 0;
+    m->imply_max = m->imply_ptr == NULL ? 64 : m->imply_max*2;
+    m->imply_ptr = ptr;
+  }
+  ptr = m->imply_ptr + m->imply_cnt;
+  ptr->s1 = s1;
+  ptr->s2 = s2;
+  ptr->t1 = t1;
+  ptr->t2 = t2;
+  m->imply_cnt++;
+  return 1;
 }
 
 static const char *mis_GetStateStr(mis_type m, int s)
@@ -662,11 +725,6 @@ static const char *mis_GetStateStr(mis_type m, int s)
   return "";
 }
 
-static int mis_GetPairCnt(mis_type m, int s1, int s2)
-{
-  return mis_GetPair(m, s1, s2)->pr_cnt;
-}
-
 static pair_type mis_AddNewCListElement(mis_type m)
 {
   pair_type p;
@@ -840,20 +898,24 @@ static int mis_AddCondition(mis_type m, int s1, int s2, int t1, int t2)
   return mis_AddUniqueReference(m, s1, s2, t1, t2);
 }
 
-static int mis_ApplyConditions(mis_type m, int s1, int s2, dclist cl)
+/* 'zero' is a temporary array with state_cnt elements */
+static int mis_ApplyConditions(mis_type m, int s1, int s2, dclist cl, int *zero)
 {
   int i, cnt = dclCnt(cl);
-  int t1, t2;
+  int t, zero_cnt;
+  int j, k;
   dcube *c;
   for( i = 0; i < cnt; i++ )
   {
     c = dclGet(cl, i);
-    for( t1 = 0; t1 < m->state_cnt; t1++ )
-      if ( dcGetOut(c, t1) == 0 )
-        for( t2 = t1+1; t2 < m->state_cnt; t2++ )
-          if ( dcGetOut(c, t2) == 0 )
-            if ( mis_AddCondition(m, s1, s2, t1, t2) == 0 )
-              return 0;
+    zero_cnt = 0;
+    for( t = 0; t < m->state_cnt; t++ )
+      if ( dcGetOut(c, t) == 0 )
+        zero[zero_cnt++] = t;
+    for( j = 0; j < zero_cnt; j++ )
+      for( k = j+1; k < zero_cnt; k++ )
+        if ( mis_AddCondition(m, s1, s2, zero[j], zero[k]) == 0 )
+          return 0;
   }
   return 1;
 }
@@ -869,8 +931,8 @@ static int mis_ApplyXBMOutOutConditions(mis_type m, int state1, int state2)
   dcube *e1;
   dcube *s2;
   dcube *e2;
-  dcube *trc1 = &(xbm_GetPiIn(x)->tmp[8]);
-  dcube *trc2 = &(xbm_GetPiIn(x)->tmp[9]);
+  dcube *trc1;
+  dcube *trc2;
   int l1, tr1, l2, tr2;
   int n1 = mis_ToN(m, state1);
   int n2 = mis_ToN(m, state2);
@@ -881,8 +943,7 @@ static int mis_ApplyXBMOutOutConditions(mis_type m, int state1, int state2)
   {
     s1 = &(xbm_GetTr(x, tr1)->in_start_cond);
     e1 = &(xbm_GetTr(x, tr1)->in_end_cond);
-    
-    dcCopy(xbm_GetPiIn(x), trc1, xbm_GetTrSuper(x, tr1));
+    trc1 = xbm_GetTrSuper(x, tr1);
     
     l2 = -1;
     tr2 = -1;
@@ -890,8 +951,7 @@ static int mis_ApplyXBMOutOutConditions(mis_type m, int state1, int state2)
     {
       s2 = &(xbm_GetTr(x, tr2)->in_start_cond);
       e2 = &(xbm_GetTr(x, tr2)->in_end_cond);
-
-      dcCopy(xbm_GetPiIn(x), trc2, xbm_GetTrSuper(x, tr2));
+      trc2 = xbm_GetTrSuper(x, tr2);
       
       if ( tr1 != tr2 )
       {
@@ -962,31 +1022,18 @@ static int mis_ApplyXBMInOutConditions(mis_type m, int state1, int state2)
   int n2 = mis_ToN(m, state2);
   
   dclist cl;
-  dcube *s1;
-  dcube *e1;
-  dcube *s2;
   dcube *e2;
   int l1, tr1, l2, tr2;
 
-  if ( dclInit(&cl) == 0 )
-    return 0;
-    
   l1 = -1;
   tr1 = -1;
   while( xbm_LoopStOutTr(x, n1, &l1, &tr1 ) != 0 )
   {
-    s1 = &(xbm_GetTr(x, tr1)->in_ddc_start_cond);
-    e1 = &(xbm_GetTr(x, tr1)->in_end_cond);
-    dclClear(cl);
-    if ( dclAdd(xbm_GetPiIn(x), cl, xbm_GetTrSuper(x, tr1)) < 0 )
-      return dclDestroy(cl), 0;
-      
-    if ( dclSubtractCube(xbm_GetPiIn(x), cl, s1) == 0 )
-      return dclDestroy(cl), 0;
-    /* FIXME
-    if ( dclSubtractCube(xbm_GetPiIn(x), cl, e1) == 0 )
-      return dclDestroy(cl), 0;
-    */
+    /* super cube # in_ddc_start_cond */
+    cl = xbm_GetTrTCList(x, tr1);
+    if ( cl == NULL )
+      return 0;
+    /* FIXME: also subtract in_end_cond? */
 
     l2 = -1;
     tr2 = -1;
@@ -1020,108 +1067,214 @@ static int mis_ApplyXBMInOutConditions(mis_type m, int state1, int state2)
             mis_ToS(m, xbm_GetTrSrcStPos(x, tr2)), 
             mis_ToS(m, xbm_GetTrSrcStPos(x, tr1)), 
             mis_ToS(m, xbm_GetTrDestStPos(x, tr2))) == 0 )
-          return dclDestroy(cl), 0;
+          return 0;
         if ( mis_AddCondition(m, 
             mis_ToS(m, xbm_GetTrDestStPos(x, tr1)), 
             mis_ToS(m, xbm_GetTrSrcStPos(x, tr2)), 
             mis_ToS(m, xbm_GetTrDestStPos(x, tr1)), 
             mis_ToS(m, xbm_GetTrDestStPos(x, tr2))) == 0 )
-          return dclDestroy(cl), 0;
+          return 0;
         if ( mis_AddCondition(m, 
             mis_ToS(m, xbm_GetTrDestStPos(x, tr1)), 
             mis_ToS(m, xbm_GetTrSrcStPos(x, tr2)), 
             mis_ToS(m, xbm_GetTrSrcStPos(x, tr1)), 
             mis_ToS(m, xbm_GetTrSrcStPos(x, tr2))) == 0 )
-          return dclDestroy(cl), 0;
+          return 0;
       }
     }
   }
 
-  return dclDestroy(cl), 1;
+  return 1;
 }
 
+static void mis_DestroyImplyCLList(mis_type m, dclist *cl_list)
+{
+  int s;
+  for( s = 0; s < m->state_cnt; s++ )
+    if ( cl_list[s] != NULL )
+      dclDestroy(cl_list[s]);
+  free(cl_list);
+}
+
+/* the imply list of each state, NULL for memory error */
+static dclist *mis_GetImplyCLList(mis_type m)
+{
+  dclist *cl_list;
+  int s;
+  cl_list = (dclist *)malloc(sizeof(dclist)*(m->state_cnt+1));
+  if ( cl_list == NULL )
+    return NULL;
+  for( s = 0; s < m->state_cnt; s++ )
+    cl_list[s] = NULL;
+  for( s = 0; s < m->state_cnt; s++ )
+  {
+    if ( dclInit(cl_list+s) == 0 )
+      return mis_DestroyImplyCLList(m, cl_list), (dclist *)NULL;
+    if ( mis_GetStateImplyCL(m, s, cl_list[s]) == 0 )
+      return mis_DestroyImplyCLList(m, cl_list), (dclist *)NULL;
+  }
+  return cl_list;
+}
+
+/*
+  The implications of the pairs are added in the order of
+  the half matrix position (see mis_AddUniqueReference()).
+*/
 int mis_MarkConditionalCompatible(mis_type m)
 {
-  dclist cl1, cl2, cli;
+  dclist cli;
+  dclist *cl_list;
+  int *zero;
   int s1, s2;
   
-  if ( dclInitVA(3, &cl1, &cl2, &cli) == 0 )
+  m->imply_cnt = 0;
+  
+  if ( dclInit(&cli) == 0 )
     return 0;
+  zero = (int *)malloc(sizeof(int)*(m->state_cnt+1));
+  if ( zero == NULL )
+    return dclDestroy(cli), 0;
+  cl_list = mis_GetImplyCLList(m);
+  if ( cl_list == NULL )
+    return free(zero), dclDestroy(cli), 0;
   
   for( s1 = 0; s1 < m->state_cnt; s1++ )
   {
-    if ( mis_GetStateImplyCL(m, s1, cl1) == 0 )
-      return dclDestroyVA(3, cl1, cl2, cli), 0;
     for( s2 = 0; s2 < s1; s2++ )
     {
       if ( mis_GetPairT(m, s1, s2) == PAIR_T_UNKNOWN )
       {
-        if ( mis_GetStateImplyCL(m, s2, cl2) == 0 )
-          return dclDestroyVA(3, cl1, cl2, cli), 0;
-
         dclClear(cli);
-        if ( dclIntersectionList(m->pi_imply, cli, cl1, cl2) == 0 )
-          return dclDestroyVA(3, cl1, cl2, cli), 0;
-        if ( mis_ApplyConditions(m, s1, s2, cli) == 0 )
-          return dclDestroyVA(3, cl1, cl2, cli), 0;
+        if ( dclIntersectionList(m->pi_imply, cli, cl_list[s1], cl_list[s2]) == 0 )
+          return mis_DestroyImplyCLList(m, cl_list), free(zero), dclDestroy(cli), 0;
+        if ( mis_ApplyConditions(m, s1, s2, cli, zero) == 0 )
+          return mis_DestroyImplyCLList(m, cl_list), free(zero), dclDestroy(cli), 0;
 
         if ( m->xbm != NULL )
         {
           if ( m->xbm->is_safe_opt != 0 ) 
             if ( mis_ApplyXBMOutOutConditions(m, s1, s2) == 0 )
-              return 0;
+              return mis_DestroyImplyCLList(m, cl_list), free(zero), dclDestroy(cli), 0;
         }
 
-        if ( mis_GetPairCnt(m, s1, s2) == 0 )
-          mis_SetPairT(m, s1, s2, PAIR_T_ALWAYS_COMPATIBLE);
-        else
-          mis_SetPairT(m, s1, s2, PAIR_T_CONDITIONAL_COMPATIBLE);
-          
-        
+        /* mis_GetPairT() returns conditional compatible, if there are implications */
+        mis_SetPairT(m, s1, s2, PAIR_T_ALWAYS_COMPATIBLE);
       }
     }
   }
   
-  dclDestroyVA(3, cl1, cl2, cli);
+  mis_DestroyImplyCLList(m, cl_list);
+  free(zero);
+  dclDestroy(cli);
   return 1;
 }
 
 /*- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -*/
 
+struct _mis_rev_struct
+{
+  size_t t_pos;     /* position of the implied pair */
+  size_t s_pos;     /* position of the pair with the implication */
+};
+
+static int mis_rev_cmp(const void *a, const void *b)
+{
+  const struct _mis_rev_struct *ra = (const struct _mis_rev_struct *)a;
+  const struct _mis_rev_struct *rb = (const struct _mis_rev_struct *)b;
+  if ( ra->t_pos < rb->t_pos ) return -1;
+  if ( ra->t_pos > rb->t_pos ) return 1;
+  if ( ra->s_pos < rb->s_pos ) return -1;
+  if ( ra->s_pos > rb->s_pos ) return 1;
+  return 0;
+}
+
+/*
+  Propagate incompatibility backwards along the implications: If 
+  a pair is not compatible, all pairs, which imply this pair, are
+  not compatible. Each pair enters the work list only once.
+  returns 0 for memory error
+*/
+static int mis_UnmarkWorkList(mis_type m)
+{
+  struct _mis_rev_struct *rev;
+  size_t *stack;
+  size_t stack_cnt = 0;
+  size_t i, l, u, mid, t_pos, s_pos;
+  mis_imply_struct *ip;
+  
+  if ( m->imply_cnt == 0 )
+    return 1;
+  
+  rev = (struct _mis_rev_struct *)malloc(sizeof(struct _mis_rev_struct)*m->imply_cnt);
+  if ( rev == NULL )
+    return 0;
+  stack = (size_t *)malloc(sizeof(size_t)*(m->imply_cnt*2+1));
+  if ( stack == NULL )
+    return free(rev), 0;
+  
+  for( i = 0; i < m->imply_cnt; i++ )
+  {
+    ip = m->imply_ptr+i;
+    rev[i].t_pos = hm_xy_to_pos(ip->t1, ip->t2);
+    rev[i].s_pos = hm_xy_to_pos(ip->s1, ip->s2);
+  }
+  qsort(rev, m->imply_cnt, sizeof(struct _mis_rev_struct), mis_rev_cmp);
+  
+  for( i = 0; i < m->imply_cnt; i++ )
+    if ( i == 0 || rev[i].t_pos != rev[i-1].t_pos )
+      if ( hm_get_bit(m->pair_nc, rev[i].t_pos) != 0 )
+        stack[stack_cnt++] = rev[i].t_pos;
+  
+  while( stack_cnt > 0 )
+  {
+    t_pos = stack[--stack_cnt];
+    l = 0;
+    u = m->imply_cnt;
+    while( l < u )
+    {
+      mid = (l+u)/2;
+      if ( rev[mid].t_pos < t_pos )
+        l = mid+1;
+      else
+        u = mid;
+    }
+    for( i = l; i < m->imply_cnt && rev[i].t_pos == t_pos; i++ )
+    {
+      s_pos = rev[i].s_pos;
+      if ( hm_get_bit(m->pair_nc, s_pos) == 0 )
+      {
+        hm_set_bit(m->pair_nc, s_pos);
+        hm_set_bit(m->pair_known, s_pos);
+        stack[stack_cnt++] = s_pos;
+      }
+    }
+  }
+  
+  free(stack);
+  free(rev);
+  return 1;
+}
+
 void mis_UnmarkCondictionalCompatible(mis_type m)
 {
-  int s1, s2;
-  int t1, t2;
-  int i, cnt;
+  size_t i;
   int is_changed = 1;
+  mis_imply_struct *ip;
+
+  if ( mis_UnmarkWorkList(m) != 0 )
+    return;
   
+  /* not enough memory for the work list */
   while( is_changed != 0 )
   {
     is_changed = 0;
-    for( s1 = 0; s1 < m->state_cnt; s1++ )
+    for( i = 0; i < m->imply_cnt; i++ )
     {
-      for( s2 = 0; s2 < s1; s2++ )
+      ip = m->imply_ptr+i;
+      if ( mis_IsPairNC(m, ip->t1, ip->t2) != 0 && mis_IsPairNC(m, ip->s1, ip->s2) == 0 )
       {
-        if ( mis_GetPairT(m, s1, s2) == PAIR_T_CONDITIONAL_COMPATIBLE )
-        {
-          cnt = mis_GetPairCnt(m, s1, s2);
-          for( i = 0; i < cnt; i++ )
-          {
-            t1 = mis_GetPair(m, s1, s2)->pr_ptr[i].s1;
-            t2 = mis_GetPair(m, s1, s2)->pr_ptr[i].s2;
-            if ( mis_GetPairT(m, t1, t2) == PAIR_T_NOT_COMPATIBLE )
-            {
-              mis_SetPairT(m, s1, s2, PAIR_T_NOT_COMPATIBLE);
-              /*
-              printf("{%s,%s}: reference to incompatible pair {%s,%s}.\n",
-                mis_GetStateStr(m, s1), mis_GetStateStr(m, s2),
-                mis_GetStateStr(m, t1), mis_GetStateStr(m, t2)
-              );
-              */
-              is_changed = 1;
-            }
-          }
-        }
+        mis_SetPairT(m, ip->s1, ip->s2, PAIR_T_NOT_COMPATIBLE);
+        is_changed = 1;
       }
     }
   }
@@ -1130,34 +1283,138 @@ void mis_UnmarkCondictionalCompatible(mis_type m)
 /*- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -*/
 
 /* calculate maximum compatibles */
-/* second approach of myers' book (p144) */
+/* the maximum compatibles are the maximal cliques of the compatibility graph */
 /* assigns the maximum compatibles to m->cl_mcl */
 
-int mis_CalculateMCL(mis_type m)
+static int mis_mcl_add(mis_type m, int *v, int cnt)
 {
-  int s1, s2;
   dcube *c;
+  int i;
+  c = dclAddEmptyCube(m->pi_mcl, m->cl_mcl);
+  if ( c == NULL )
+    return 0;
+  dcInSetAll(m->pi_mcl, c, CUBE_IN_MASK_DC);
+  for( i = 0; i < m->state_cnt; i++ )
+    dcSetIn(c, i, 1);
+  for( i = 0; i < cnt; i++ )
+    dcSetIn(c, v[i], 3);
+  return 1;
+}
+
+static int mis_mcl_cb(void *data, int *v, int cnt)
+{
+  return mis_mcl_add((mis_type)data, v, cnt);
+}
+
+struct mis_mcl_rec
+{
+  pinfo *pi;
+  dcube *c;
+};
+
+static int mis_mcl_cmp(const void *ap, const void *bp)
+{
+  const struct mis_mcl_rec *a = (const struct mis_mcl_rec *)ap;
+  const struct mis_mcl_rec *b = (const struct mis_mcl_rec *)bp;
+  int i;
+  for( i = 0; i < a->pi->in_words; i++ )
+  {
+    if ( a->c->in[i] < b->c->in[i] )
+      return -1;
+    if ( a->c->in[i] > b->c->in[i] )
+      return 1;
+  }
+  return 0;
+}
+
+/* the order of the cliques depends on the threads */
+static int mis_mcl_sort(mis_type m)
+{
+  int i, cnt = dclCnt(m->cl_mcl);
+  struct mis_mcl_rec *rec;
+  dclist cl;
+  
+  rec = (struct mis_mcl_rec *)malloc(sizeof(struct mis_mcl_rec)*(cnt+1));
+  if ( rec == NULL )
+    return 0;
+  if ( dclInit(&cl) == 0 )
+    return free(rec), 0;
+  for( i = 0; i < cnt; i++ )
+  {
+    rec[i].pi = m->pi_mcl;
+    rec[i].c = dclGet(m->cl_mcl, i);
+  }
+  qsort(rec, cnt, sizeof(struct mis_mcl_rec), mis_mcl_cmp);
+  for( i = 0; i < cnt; i++ )
+    if ( dclAdd(m->pi_mcl, cl, rec[i].c) < 0 )
+      return dclDestroy(cl), free(rec), 0;
+  free(rec);
+  if ( dclCopy(m->pi_mcl, m->cl_mcl, cl) == 0 )
+    return dclDestroy(cl), 0;
+  return dclDestroy(cl), 1;
+}
+
+int mis_CalculateMCL(mis_type m)
+{
+  int s1, s2, r, i, cnt;
+  int *v;
+  b_mc_type mc;
 
   dclClear(m->cl_mcl);
 
+  /*
+    same as the product of sums of the incompatible pairs (second
+    approach of myers' book): without incompatible pairs, the list of
+    maximum compatibles is empty
+  */
+  cnt = 0;
   for( s1 = 0; s1 < m->state_cnt; s1++ )
-  {
     for( s2 = 0; s2 < s1; s2++ )
+      if ( mis_IsPairNC(m, s1, s2) != 0 )
+        cnt++;
+  if ( cnt == 0 )
+    return 1;
+
+  mc = b_mc_Open(m->state_cnt);
+  if ( mc == NULL )
+    return 0;
+
+  for( s1 = 0; s1 < m->state_cnt; s1++ )
+    for( s2 = 0; s2 < s1; s2++ )
+      if ( mis_IsPairNC(m, s1, s2) == 0 )
+        b_mc_SetEdge(mc, s1, s2);
+
+  b_mc_SetLimit(mc, m->mcl_limit);
+  r = b_mc_Do(mc, m->mcl_thread_cnt, mis_mcl_cb, m);
+  if ( r == 0 )
+    return b_mc_Close(mc), 0;
+
+  if ( r == 2 )
+  {
+    /* too many maximum compatibles: each state must be covered */
+    if ( m->fsm != NULL )
+      fsm_Log(m->fsm, "FSM mis: Limit of %ld maximum compatibles reached.", m->mcl_limit);
+    v = (int *)malloc(sizeof(int)*(m->state_cnt+1));
+    if ( v == NULL )
+      return b_mc_Close(mc), 0;
+    for( s1 = 0; s1 < m->state_cnt; s1++ )
     {
-      if ( mis_GetPairT(m, s1, s2) == PAIR_T_NOT_COMPATIBLE )
+      cnt = dclCnt(m->cl_mcl);
+      for( i = 0; i < cnt; i++ )
+        if ( dcGetIn(dclGet(m->cl_mcl, i), s1) == 3 )
+          break;
+      if ( i >= cnt )
       {
-        c = dclAddEmptyCube(m->pi_mcl, m->cl_mcl);
-        if ( c == NULL )
-          return 0;
-        dcInSetAll(m->pi_mcl, c, CUBE_IN_MASK_DC);
-        dcSetIn(c, s1, 1);
-        dcSetIn(c, s2, 1);
+        v[0] = s1;
+        if ( mis_mcl_add(m, v, b_mc_Extend(mc, v, 1, NULL)) == 0 )
+          return free(v), b_mc_Close(mc), 0;
       }
     }
+    free(v);
   }
-  if ( dclConvertFromPOS(m->pi_mcl, m->cl_mcl) == 0 )
-    return 0;
-  if ( dclPrimes(m->pi_mcl, m->cl_mcl) == 0 )
+  b_mc_Close(mc);
+
+  if ( mis_mcl_sort(m) == 0 )
     return 0;
   /* dclShow(m->pi_mcl, m->cl_mcl); */
   return 1;
@@ -1189,13 +1446,19 @@ int mis_CopyMCLtoCList(mis_type m)
 int mis_CalculateClassSet(mis_type m, pair_type p)
 {
   int s1, s2;
+  size_t i, start;
+  int cnt;
   pair_ClearRefs(p);  
   for( s1 = 0; s1 < m->state_cnt; s1++ )
     if ( dcGetOut(&(p->compatible), s1) != 0 )
       for( s2 = s1+1; s2 < m->state_cnt; s2++ )
         if ( dcGetOut(&(p->compatible), s2) != 0 )
-          if ( pair_AppendUniqueCRefs(p, mis_GetPair(m, s1, s2)) == 0 )
-            return 0;
+        {
+          cnt = mis_GetImplyRange(m, s1, s2, &start);
+          for( i = start; i < start+cnt; i++ )
+            if ( pair_AddUniqueCRef(p, m->imply_ptr[i].t1, m->imply_ptr[i].t2) == 0 )
+              return 0;
+        }
   return 1;
 }
 
@@ -1652,7 +1915,8 @@ int mis_CalculateGroups(mis_type m)
 void mis_ShowStates(mis_type m)
 {
   int s1, s2;
-  int i;
+  size_t i, start;
+  int cnt;
   for( s1 = 0; s1 < m->state_cnt; s1++ )
   {
     for( s2 = 0; s2 < s1; s2++ )
@@ -1667,11 +1931,12 @@ void mis_ShowStates(mis_type m)
           printf("always compatible\n");
           break;
         case PAIR_T_CONDITIONAL_COMPATIBLE:
-          printf("--> %dx ", mis_GetPair(m, s1, s2)->pr_cnt);
-          for( i = 0; i < mis_GetPair(m, s1, s2)->pr_cnt; i++ )
+          cnt = mis_GetImplyRange(m, s1, s2, &start);
+          printf("--> %dx ", cnt);
+          for( i = start; i < start+cnt; i++ )
             printf("{%s,%s} ",
-              mis_GetStateStr(m, mis_GetPair(m, s1, s2)->pr_ptr[i].s1),
-              mis_GetStateStr(m, mis_GetPair(m, s1, s2)->pr_ptr[i].s2));
+              mis_GetStateStr(m, m->imply_ptr[i].t1),
+              mis_GetStateStr(m, m->imply_ptr[i].t2));
           printf("\n");
           break;
         case PAIR_T_NOT_COMPATIBLE:
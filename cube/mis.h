@@ -33,6 +33,7 @@
 #include "xbm.h"
 #include "fsm.h"
 #include "b_bcp.h"
+#include "b_mc.h"
 
 struct _pr_struct
 {
@@ -46,16 +47,16 @@ typedef struct _pr_struct pr_struct;
 #define PAIR_T_CONDITIONAL_COMPATIBLE 2
 #define PAIR_T_NOT_COMPATIBLE 3
 
+/* default limit for the number of maximum compatibles */
+#define MIS_MCL_LIMIT 200000L
+
 #define PAIR_T_NOT_DONE 4
 #define PAIR_T_DONE 5
 
 
 /*  
-  pair_type has different meaning in each context...
-  as part of the half-matrix:
-    t, pr_ptr and pr_cnt are used
-  as part of the c_list:
-    compatibles, pr_ptr and pr_cnt are used
+  pair_type is used as element of the c_list:
+    t, compatibles, pr_ptr and pr_cnt are used
 */
 
 struct _pair_struct
@@ -67,6 +68,19 @@ struct _pair_struct
 };
 typedef struct _pair_struct *pair_type;
 
+/*
+  implication: the pair (s1,s2) is compatible only if (t1,t2) is
+  compatible. s1 < s2 and t1 < t2.
+*/
+struct _mis_imply_struct
+{
+  int s1;
+  int s2;
+  int t1;
+  int t2;
+};
+typedef struct _mis_imply_struct mis_imply_struct;
+
 struct _mis_struct
 {
   fsm_type fsm;
@@ -79,8 +93,15 @@ struct _mis_struct
   int *node_to_state;
   
   
-  pair_type *pair_list_ptr;   /* a half matrix */
+  /* half matrix, one bit for each pair of states */
   size_t pair_list_size;      /* (state_cnt-1)*state_cnt/2; */
+  unsigned *pair_nc;          /* not compatible */
+  unsigned *pair_known;       /* compatible or not compatible (not unknown) */
+  
+  /* implications, sorted by the half matrix position of (s1,s2) */
+  mis_imply_struct *imply_ptr;
+  size_t imply_cnt;
+  size_t imply_max;
   
   
   b_pl_type c_list;           /* a list of pair_type objects */
@@ -91,6 +112,8 @@ struct _mis_struct
   
   pinfo *pi_mcl;              /* maximum compatible list (problem info) */
   dclist cl_mcl;              /* maximum compatible list */
+  long mcl_limit;             /* max. number of maximum compatibles, <= 0: no limit */
+  int mcl_thread_cnt;         /* <= 0: use b_th_GetDefaultCnt() */
   
   b_bcp_type bcp;             /* binate cover problem */
   
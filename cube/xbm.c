@@ -30,6 +30,7 @@
 #include <assert.h>
 
 #include "xbm.h"
+#include "b_th.h"
 
 
 int internal_xbm_set_str(char **s, const char *name)
@@ -154,8 +155,6 @@ static xbm_transition_type xbm_transition_Open(xbm_type x)
   {
     t->src_state_pos = -1;
     t->dest_state_pos = -1;
-    t->visit_cnt = 0;
-    t->visit_max = 0;
     if ( dcInitVA( xbm_GetPiCond(x), XBM_TRANS_VA_LIST(t) ) != 0 )
     {
       dcInSetAll(xbm_GetPiCond(x),  &(t->level_cond), 0);
@@ -166,14 +165,18 @@ static xbm_transition_type xbm_transition_Open(xbm_type x)
       dcOutSetAll(xbm_GetPiCond(x), &(t->start_cond), 0);
       dcInSetAll(xbm_GetPiCond(x),  &(t->end_cond), 0);
       dcOutSetAll(xbm_GetPiCond(x), &(t->end_cond), 0);
-      if ( dcInitVA(xbm_GetPiIn(x), 4, &(t->in_start_cond), &(t->in_end_cond), 
-                  &(t->in_ddc_start_cond), &(t->in_ddc_end_cond)) != 0 )
+      if ( dcInitVA(xbm_GetPiIn(x), 5, &(t->in_start_cond), &(t->in_end_cond), 
+                  &(t->in_ddc_start_cond), &(t->in_ddc_end_cond), &(t->in_super)) != 0 )
       {
         dcInSetAll(xbm_GetPiIn(x),    &(t->in_start_cond), CUBE_IN_MASK_DC);
         dcInSetAll(xbm_GetPiIn(x),    &(t->in_end_cond), CUBE_IN_MASK_DC);
         dcInSetAll(xbm_GetPiIn(x),    &(t->in_ddc_start_cond), CUBE_IN_MASK_DC);
         dcInSetAll(xbm_GetPiIn(x),    &(t->in_ddc_end_cond), CUBE_IN_MASK_DC);
-        return t;
+        t->is_cache_valid = 0;
+        if ( dclInit(&(t->in_tc_cl)) != 0 )
+          return t;
+        dcDestroyVA( 5, &(t->in_start_cond), &(t->in_end_cond), 
+            &(t->in_ddc_start_cond), &(t->in_ddc_end_cond), &(t->in_super) );
       }
       dcDestroyVA( XBM_TRANS_VA_LIST(t) );
     }
@@ -184,8 +187,9 @@ static xbm_transition_type xbm_transition_Open(xbm_type x)
 
 void xbm_transition_Close(xbm_transition_type t)
 {
-  dcDestroyVA( 4, &(t->in_start_cond), &(t->in_end_cond), 
-      &(t->in_ddc_start_cond), &(t->in_ddc_end_cond) );
+  dclDestroy(t->in_tc_cl);
+  dcDestroyVA( 5, &(t->in_start_cond), &(t->in_end_cond), 
+      &(t->in_ddc_start_cond), &(t->in_ddc_end_cond), &(t->in_super) );
   dcDestroyVA( XBM_TRANS_VA_LIST(t) );
   free(t);
 }
@@ -291,6 +295,7 @@ xbm_type xbm_Open()
     x->outputs = 0;
     x->is_fbo = 0;
     x->is_sync = 0;
+    x->is_split_out = 0;
     x->is_log_cb = 0;
     x->is_all_dc_change = 1;
     x->is_safe_opt = 0;       /* allow unsafe minimization */
@@ -869,7 +874,7 @@ int xbm_FindVar(xbm_type x, int direction, const char *name)
 
 const char *xbm_GetVarNameStr(xbm_type x, int pos)
 {
-  static char s[32];
+  static B_TH_LOCAL char s[32];
   if ( xbm_GetVar(x, pos)->name == NULL )
   {
     sprintf(s, "%d", pos);
@@ -880,7 +885,7 @@ const char *xbm_GetVarNameStr(xbm_type x, int pos)
 
 const char *xbm_GetVarName2Str(xbm_type x, int pos)
 {
-  static char s[32];
+  static B_TH_LOCAL char s[32];
   if ( xbm_GetVar(x, pos)->name2 == NULL )
   {
     sprintf(s, "%d", pos);
@@ -927,7 +932,7 @@ const char *xbm_GetVarName2StrByIndex(xbm_type x, int direction, int index)
 
 const char *xbm_GetStNameStr(xbm_type x, int pos)
 {
-  static char s[32];
+  static B_TH_LOCAL char s[32];
   if ( pos < 0 || pos >= b_set_Max(x->states) )
     return "???";
   if ( xbm_GetSt(x, pos)->name == NULL )
@@ -959,14 +964,51 @@ xbm_var_type xbm_GetVarByIndex(xbm_type x, int direction, int index)
 
 /*---------------------------------------------------------------------------*/
 
-dcube *xbm_GetTrSuper(xbm_type x, int tr_pos)
+/* returns 0 for memory error, in_super is always valid */
+static int xbm_tr_cache_update(xbm_type x, xbm_transition_type t)
 {
   pinfo *pi = xbm_GetPiIn(x);
-  dcube *c = &(pi->tmp[2]);
-  dcOrIn( pi, c, 
-    &(xbm_GetTr(x, tr_pos)->in_start_cond), 
-    &(xbm_GetTr(x, tr_pos)->in_end_cond) );
-  return c;
+  
+  dcOrIn(pi, &(t->in_super), &(t->in_start_cond), &(t->in_end_cond));
+  
+  dclClear(t->in_tc_cl);
+  if ( dclAdd(pi, t->in_tc_cl, &(t->in_super)) < 0 )
+    return 0;
+  if ( dclSubtractCube(pi, t->in_tc_cl, &(t->in_ddc_start_cond)) == 0 )
+    return 0;
+    
+  t->is_cache_valid = 1;
+  return 1;
+}
+
+void xbm_InvalidateTrCache(xbm_type x, int tr_pos)
+{
+  xbm_GetTr(x, tr_pos)->is_cache_valid = 0;
+}
+
+void xbm_InvalidateAllTrCache(xbm_type x)
+{
+  int tr_pos = -1;
+  while( xbm_LoopTr(x, &tr_pos) != 0 )
+    xbm_InvalidateTrCache(x, tr_pos);
+}
+
+int xbm_UpdateTrCache(xbm_type x)
+{
+  int tr_pos = -1;
+  while( xbm_LoopTr(x, &tr_pos) != 0 )
+    if ( xbm_GetTr(x, tr_pos)->is_cache_valid == 0 )
+      if ( xbm_tr_cache_update(x, xbm_GetTr(x, tr_pos)) == 0 )
+        return 0;
+  return 1;
+}
+
+dcube *xbm_GetTrSuper(xbm_type x, int tr_pos)
+{
+  xbm_transition_type t = xbm_GetTr(x, tr_pos);
+  if ( t->is_cache_valid == 0 )
+    xbm_tr_cache_update(x, t);
+  return &(t->in_super);
 }
 
 int xbm_GetTrCond(xbm_type x, int tr_pos, dclist in_cond_cl)
@@ -976,6 +1018,15 @@ int xbm_GetTrCond(xbm_type x, int tr_pos, dclist in_cond_cl)
     &(xbm_GetTr(x, tr_pos)->in_end_cond));
 }
 
+dclist xbm_GetTrTCList(xbm_type x, int tr_pos)
+{
+  xbm_transition_type t = xbm_GetTr(x, tr_pos);
+  if ( t->is_cache_valid == 0 )
+    if ( xbm_tr_cache_update(x, t) == 0 )
+      return NULL;
+  return t->in_tc_cl;
+}
+
 int xbm_SetCodeWidth(xbm_type x, int code_width)
 {
   int st_pos = -1;
@@ -1159,6 +1210,7 @@ int xbm_GetNextStateCode(xbm_type x, int st_pos, dcube *c, int *dest_st_pos, dcu
   XBM_BUILD_OPT_MIS   do state minimization
   XBM_BUILD_OPT_FBO   apply feedback optimization
   XBM_BUILD_OPT_SYNC  create synchronous machine
+  XBM_BUILD_OPT_SPLIT one hazardfree problem per output
 */
 
 int xbm_Build(xbm_type x, int opt)
@@ -1174,6 +1226,10 @@ int xbm_Build(xbm_type x, int opt)
   x->is_sync = 0;
   if ( (opt & XBM_BUILD_OPT_SYNC) != 0 )
     x->is_sync = 1;
+
+  x->is_split_out = 0;
+  if ( (opt & XBM_BUILD_OPT_SPLIT) != 0 )
+    x->is_split_out = 1;
     
   x->is_safe_opt = 0;
   
@@ -56,8 +56,10 @@ struct _xbm_transition_struct
   dcube in_ddc_start_cond;    /* directed don't care start cube */
   dcube in_ddc_end_cond;      /* directed don't care end cube */
   
-  int visit_cnt;              /* walk algorithm */
-  int visit_max;              /* walk algorithm */
+  /* derived cubes, see xbm_UpdateTrCache() */
+  int is_cache_valid;
+  dcube in_super;       /* in_start_cond | in_end_cond */
+  dclist in_tc_cl;      /* in_super # in_ddc_start_cond */
 };
 typedef struct _xbm_transition_struct *xbm_transition_type;
 
@@ -72,8 +74,8 @@ struct _xbm_state_struct
   dcube out;
   int gr_pos;
   
-  int d;      /* Bellman-Ford */
-  int p;      /* Bellman-Ford */
+  int d;      /* xbmwalk.c: distance from the reset state, -1: unreachable */
+  int p;      /* xbmwalk.c: predecessor on the shortest path */
 };
 typedef struct _xbm_state_struct *xbm_state_type;
 
@@ -139,6 +141,9 @@ struct _xbm_struct
                       
   int is_sync;        /* 0: asynchronous state machine */
                       /* 1: synchronous state machine */
+
+  int is_split_out;   /* 0: one problem for all outputs */
+                      /* 1: one problem per output, minimized in parallel */
                 
   char *pla_file_xbm_partitions;
   char *pla_file_prime_partitions;
@@ -166,8 +171,6 @@ struct _xbm_struct
   void *tr_data;
 
   /* xbmwalk.c */
-  int (*walk_cb)(xbm_type x, void *data, int tr_pos, dcube *cs, dcube *ct, int is_reset, int is_unique);
-  void *walk_data;
   int is_all_dc_change;
   
   /* xbmvhdl.c */
@@ -183,6 +186,27 @@ struct _xbm_struct
   
 };
 
+/* xbmwalk.c */
+struct _xbm_walk_struct
+{
+  xbm_type x;
+  int st_max;
+  int tr_cnt;
+  int *out_idx;       /* out transitions of st: out_tr[out_idx[st]..out_idx[st+1]-1] */
+  int *out_tr;
+  int *in_idx;        /* in transitions of st: in_tr[in_idx[st]..in_idx[st+1]-1] */
+  int *in_tr;
+  int *p_tr;          /* transition from the predecessor (p) to the state */
+  int *order;         /* states, sorted by the distance from the reset state */
+  int order_cnt;
+  int *part;          /* part of each state */
+  int *visit_max;     /* number of different input vectors of a transition */
+  int *hop;           /* hop[dest*st_max+src]: first transition from src to dest or -1 */
+  int part_cnt;
+  b_il_type *steps;   /* steps of each part: tr_pos, n, flags */
+};
+typedef struct _xbm_walk_struct *xbm_walk_type;
+
 #define xbm_GetPiCond(xbm) ((xbm)->pi_cond)
 #define xbm_GetPiCode(xbm) ((xbm)->pi_code)
 #define xbm_GetPiIn(xbm) ((xbm)->pi_in)
@@ -268,8 +292,18 @@ const char *xbm_GetVarName2Str(xbm_type x, int pos);
 const char *xbm_GetStNameStr(xbm_type x, int pos);
 xbm_var_type xbm_GetVarByIndex(xbm_type x, int direction, int index);
 
+/* 
+  Derived cubes of a transition are cached. Invalidate the cache after 
+  a change of the in_... cubes. The getter functions update an invalid
+  cache, call xbm_UpdateTrCache() before they are used by several threads.
+*/
+void xbm_InvalidateTrCache(xbm_type x, int tr_pos);
+void xbm_InvalidateAllTrCache(xbm_type x);
+int xbm_UpdateTrCache(xbm_type x);
 dcube *xbm_GetTrSuper(xbm_type x, int tr_pos);
 int xbm_GetTrCond(xbm_type x, int tr_pos, dclist in_cond_cl);
+/* in_super # in_ddc_start_cond or NULL (memory error) */
+dclist xbm_GetTrTCList(xbm_type x, int tr_pos);
 
 int xbm_SetCodeWidth(xbm_type x, int code_with);
 
@@ -287,11 +321,13 @@ int xbm_GetNextStateCode(xbm_type x, int st_pos, dcube *c,
   XBM_BUILD_OPT_MIS   do state minimization
   XBM_BUILD_OPT_FBO   apply feedback optimization
   XBM_BUILD_OPT_SYNC  create a synchronous state machine
+  XBM_BUILD_OPT_SPLIT minimize each output separately (in parallel)
 */
 
-#define XBM_BUILD_OPT_MIS  0x01
-#define XBM_BUILD_OPT_FBO  0x02
-#define XBM_BUILD_OPT_SYNC 0x04
+#define XBM_BUILD_OPT_MIS   0x01
+#define XBM_BUILD_OPT_FBO   0x02
+#define XBM_BUILD_OPT_SYNC  0x04
+#define XBM_BUILD_OPT_SPLIT 0x08
 
 int xbm_Build(xbm_type x, int opt);
 int xbm_GetFeedbackWidth(xbm_type x);
@@ -358,6 +394,12 @@ int xbm_DoTransitions(xbm_type x,
 
 /* xbmwalk.c */
 
+xbm_walk_type xbm_OpenWalk(xbm_type x, int part_cnt, int is_hop, int thread_cnt);
+void xbm_CloseWalk(xbm_walk_type w);
+#define xbm_GetWalkPartCnt(w) ((w)->part_cnt)
+int xbm_DoWalkPart(xbm_walk_type w, int part, 
+  int (*walk_cb)(xbm_type x, void *data, int tr_pos, dcube *cs, dcube *ct, int is_reset, int is_unique), 
+  void *data);
 int xbm_DoWalk(xbm_type x, 
   int (*walk_cb)(xbm_type x, void *data, int tr_pos, dcube *cs, dcube *ct, int is_reset, int is_unique), 
   void *data);
@@ -368,6 +410,7 @@ int xbm_ShowWalk(xbm_type x);
 int xbm_vhdl_init(xbm_type x);
 void xbm_vhdl_destroy(xbm_type x);
 int xbm_WriteTestbenchVHDL(xbm_type x, const char *name);
+int xbm_WriteTestbenchVHDLParts(xbm_type x, const char *name, int part_cnt);
 
 
 #endif /* _XBM_H */
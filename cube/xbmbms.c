@@ -66,31 +66,18 @@
 int xbm_IsHFInOutTransitionPossible(xbm_type x, int n1, int n2)
 {
   dclist cl;
-  dcube *s1;
-  dcube *e1;
-  dcube *s2;
   dcube *e2;
   int l1, tr1, l2, tr2;
 
-  if ( dclInit(&cl) == 0 )
-    return 0;
-    
   l1 = -1;
   tr1 = -1;
   while( xbm_LoopStOutTr(x, n1, &l1, &tr1 ) != 0 )
   {
-    s1 = &(xbm_GetTr(x, tr1)->in_ddc_start_cond);
-    e1 = &(xbm_GetTr(x, tr1)->in_end_cond);
-    dclClear(cl);
-    if ( dclAdd(xbm_GetPiIn(x), cl, xbm_GetTrSuper(x, tr1)) < 0 )
-      return dclDestroy(cl), 0;
-      
-    if ( dclSubtractCube(xbm_GetPiIn(x), cl, s1) == 0 )
-      return dclDestroy(cl), 0;
-    /* FIXME
-    if ( dclSubtractCube(xbm_GetPiIn(x), cl, e1) == 0 )
-      return dclDestroy(cl), 0;
-    */
+    /* super cube # in_ddc_start_cond */
+    cl = xbm_GetTrTCList(x, tr1);
+    if ( cl == NULL )
+      return 0;
+    /* FIXME: also subtract in_end_cond? */
 
     l2 = -1;
     tr2 = -1;
@@ -119,7 +106,7 @@ int xbm_IsHFInOutTransitionPossible(xbm_type x, int n1, int n2)
             xbm_GetStNameStr(x, xbm_GetTrSrcStPos(x, tr2)),
             xbm_GetStNameStr(x, xbm_GetTrDestStPos(x, tr2))
             );
-          return dclDestroy(cl), 0;
+          return 0;
         }
         else
         {
@@ -132,13 +119,13 @@ int xbm_IsHFInOutTransitionPossible(xbm_type x, int n1, int n2)
             xbm_GetStNameStr(x, xbm_GetTrSrcStPos(x, tr2)),
             xbm_GetStNameStr(x, xbm_GetTrDestStPos(x, tr2))
             );
-          return dclDestroy(cl), 0;
+          return 0;
         }
       }
     }
   }
 
-  return dclDestroy(cl), 1;
+  return 1;
 }
 
 int xbm_IsHFOutOutTransitionPossible(xbm_type x, int n1, int n2)
@@ -147,8 +134,8 @@ int xbm_IsHFOutOutTransitionPossible(xbm_type x, int n1, int n2)
   dcube *e1;
   dcube *s2;
   dcube *e2;
-  dcube *trc1 = &(xbm_GetPiIn(x)->tmp[8]);
-  dcube *trc2 = &(xbm_GetPiIn(x)->tmp[9]);
+  dcube *trc1;
+  dcube *trc2;
   int l1, tr1, l2, tr2;
 
   l1 = -1;
@@ -157,8 +144,7 @@ int xbm_IsHFOutOutTransitionPossible(xbm_type x, int n1, int n2)
   {
     s1 = &(xbm_GetTr(x, tr1)->in_start_cond);
     e1 = &(xbm_GetTr(x, tr1)->in_end_cond);
-    
-    dcCopy(xbm_GetPiIn(x), trc1, xbm_GetTrSuper(x, tr1));
+    trc1 = xbm_GetTrSuper(x, tr1);
     
     l2 = -1;
     tr2 = -1;
@@ -166,8 +152,7 @@ int xbm_IsHFOutOutTransitionPossible(xbm_type x, int n1, int n2)
     {
       s2 = &(xbm_GetTr(x, tr2)->in_start_cond);
       e2 = &(xbm_GetTr(x, tr2)->in_end_cond);
-
-      dcCopy(xbm_GetPiIn(x), trc2, xbm_GetTrSuper(x, tr2));
+      trc2 = xbm_GetTrSuper(x, tr2);
       
       if ( tr1 != tr2 )
       {
@@ -848,6 +833,8 @@ static int xbm_in_out_copy(xbm_type x)
         dcSetIn(&(xbm_GetTr(x, tr_pos)->in_ddc_end_cond), i, 3);
       }
     }
+    
+    xbm_InvalidateTrCache(x, tr_pos);
         
     xbm_Log(x, 0, "XBM bms: '%s' -> '%s'      start %s,     end %s.",
       xbm_GetStNameStr(x, xbm_GetTrSrcStPos(x, tr_pos)),
@@ -1039,6 +1026,8 @@ static int xbm_post_processing(xbm_type x)
     return 0;
   if ( xbm_in_out_copy(x) == 0 )
     return 0;
+  if ( xbm_UpdateTrCache(x) == 0 )
+    return 0;
   if ( xbm_calc_self_condition(x) == 0 )
     return 0;
   if ( xbm_check_in_out_transitions(x) == 0 )
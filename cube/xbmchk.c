@@ -24,9 +24,69 @@
 
 */
 #include <stdio.h>
+#include <stdlib.h>
 #include <assert.h>
 #include "xbm.h"
 
+/*---------------------------------------------------------------------------*/
+/* 
+  The transitions are collected first and checked together with 
+  dclIsHazardfreeTransitionList(). il contains the transition 
+  (or state) of each entry of cl_s/cl_e.
+*/
+
+struct _xbm_chk_struct
+{
+  xbm_type x;
+  dclist cl_s;
+  dclist cl_e;
+  b_il_type il;
+  char *is_hf;
+};
+typedef struct _xbm_chk_struct xbm_chk;
+
+static int xbm_chk_init(xbm_chk *chk, xbm_type x)
+{
+  chk->x = x;
+  chk->is_hf = NULL;
+  if ( dclInitVA(2, &(chk->cl_s), &(chk->cl_e)) == 0 )
+    return 0;
+  chk->il = b_il_Open();
+  if ( chk->il == NULL )
+    return dclDestroyVA(2, chk->cl_s, chk->cl_e), 0;
+  return 1;
+}
+
+static void xbm_chk_destroy(xbm_chk *chk)
+{
+  dclDestroyVA(2, chk->cl_s, chk->cl_e);
+  b_il_Close(chk->il);
+  if ( chk->is_hf != NULL )
+    free(chk->is_hf);
+}
+
+static int xbm_chk_add(xbm_chk *chk, dcube *s, dcube *e, int val)
+{
+  if ( dclAdd(xbm_GetPiMachine(chk->x), chk->cl_s, s) < 0 )
+    return 0;
+  if ( dclAdd(xbm_GetPiMachine(chk->x), chk->cl_e, e) < 0 )
+    return 0;
+  if ( b_il_Add(chk->il, val) < 0 )
+    return 0;
+  return 1;
+}
+
+static int xbm_chk_do(xbm_chk *chk)
+{
+  chk->is_hf = (char *)malloc(dclCnt(chk->cl_s)+1);
+  if ( chk->is_hf == NULL )
+    return 0;
+  return dclIsHazardfreeTransitionList(xbm_GetPiMachine(chk->x), 
+    chk->x->cl_machine, chk->cl_s, chk->cl_e, 0, chk->is_hf);
+}
+
+/*---------------------------------------------------------------------------*/
+
 int xbm_CheckStrongStateStateTransfers(xbm_type x)
 {
   int tr_pos;
@@ -36,9 +96,15 @@ int xbm_CheckStrongStateStateTransfers(xbm_type x)
   int out_cnt = x->outputs;
   int code_cnt = xbm_GetPiCode(x)->out_cnt;
   int st_src_pos, st_dest_pos;
+  int i, cnt;
+  xbm_chk chk;
   
   assert(in_cnt == xbm_GetPiIn(x)->in_cnt);
   
+  if ( xbm_chk_init(&chk, x) == 0 )
+    return 0;
+  
+  /* entry 2*k: input change, entry 2*k+1: code change */
   tr_pos = -1;
   while( xbm_LoopTr(x, &tr_pos) != 0 )
   {
@@ -68,17 +134,8 @@ int xbm_CheckStrongStateStateTransfers(xbm_type x)
       xbm_GetPiCode(x), &(xbm_GetSt(x, st_dest_pos)->code));
     dcCopyOutToOut( xbm_GetPiMachine(x), e, code_cnt, 
       xbm_GetPiOut(x), &(xbm_GetSt(x, st_dest_pos)->out));
-
-    xbm_Log(x, 0, "XBM:         input change  %s -> %s.", 
-      dcToStr(xbm_GetPiMachine(x), s, " ", ""), 
-      dcToStr2(xbm_GetPiMachine(x), e, " ", ""));
-    if ( dclIsHazardfreeTransition(xbm_GetPiMachine(x), x->cl_machine, s, e) == 0 )
-    {
-      xbm_Log(x, 3, "XBM warning: input change  %s -> %s (state '%s' -> '%s') might contain a hazard with a non-directed don't care.", 
-        dcToStr(xbm_GetPiMachine(x), s, " ", ""), 
-        dcToStr2(xbm_GetPiMachine(x), e, " ", ""),
-        xbm_GetStNameStr(x, st_src_pos),xbm_GetStNameStr(x, st_dest_pos));
-    }
+    if ( xbm_chk_add(&chk, s, e, tr_pos) == 0 )
+      return xbm_chk_destroy(&chk), 0;
 
     dcCopyInToIn( xbm_GetPiMachine(x), s, 0, 
       xbm_GetPiIn(x), &(xbm_GetTr(x, tr_pos)->in_end_cond));
@@ -103,26 +160,57 @@ int xbm_CheckStrongStateStateTransfers(xbm_type x)
       xbm_GetPiCode(x), &(xbm_GetSt(x, st_dest_pos)->code));
     dcCopyOutToOut( xbm_GetPiMachine(x), e, code_cnt, 
       xbm_GetPiOut(x), &(xbm_GetSt(x, st_dest_pos)->out));
-    
-    xbm_Log(x, 0, "XBM:         code change   %s -> %s.", 
-      dcToStr(xbm_GetPiMachine(x), s, " ", ""), 
-      dcToStr2(xbm_GetPiMachine(x), e, " ", ""));
-    if ( dclIsHazardfreeTransition(xbm_GetPiMachine(x), x->cl_machine, s, e) == 0 )
+    if ( xbm_chk_add(&chk, s, e, tr_pos) == 0 )
+      return xbm_chk_destroy(&chk), 0;
+  }
+  
+  if ( xbm_chk_do(&chk) == 0 )
+    return xbm_chk_destroy(&chk), 0;
+  
+  cnt = dclCnt(chk.cl_s);
+  for( i = 0; i < cnt; i++ )
+  {
+    tr_pos = b_il_GetVal(chk.il, i);
+    st_src_pos = xbm_GetTrSrcStPos(x, tr_pos);
+    st_dest_pos = xbm_GetTrDestStPos(x, tr_pos);
+    s = dclGet(chk.cl_s, i);
+    e = dclGet(chk.cl_e, i);
+    if ( (i & 1) == 0 )
     {
-      xbm_Log(x, 3, "XBM warning: code change   %s -> %s (state '%s' -> '%s') might contain a hazard with a non-directed don't care.", 
+      xbm_Log(x, 0, "XBM:         input change  %s -> %s.", 
         dcToStr(xbm_GetPiMachine(x), s, " ", ""), 
-        dcToStr2(xbm_GetPiMachine(x), e, " ", ""),
-        xbm_GetStNameStr(x, st_src_pos),xbm_GetStNameStr(x, st_dest_pos));
+        dcToStr2(xbm_GetPiMachine(x), e, " ", ""));
+      if ( chk.is_hf[i] == 0 )
       {
-        int i;
-        for( i = 0; i < xbm_GetPiMachine(x)->out_cnt; i++ )
-          if ( dclIsHazardfreeFunction(xbm_GetPiMachine(x), x->cl_machine, s, e, i) == 0 )
-          {
-            xbm_Log(x, 3, "XBM warning: hazard on output %d.", i);
-          }
+        xbm_Log(x, 3, "XBM warning: input change  %s -> %s (state '%s' -> '%s') might contain a hazard with a non-directed don't care.", 
+          dcToStr(xbm_GetPiMachine(x), s, " ", ""), 
+          dcToStr2(xbm_GetPiMachine(x), e, " ", ""),
+          xbm_GetStNameStr(x, st_src_pos),xbm_GetStNameStr(x, st_dest_pos));
+      }
+    }
+    else
+    {
+      xbm_Log(x, 0, "XBM:         code change   %s -> %s.", 
+        dcToStr(xbm_GetPiMachine(x), s, " ", ""), 
+        dcToStr2(xbm_GetPiMachine(x), e, " ", ""));
+      if ( chk.is_hf[i] == 0 )
+      {
+        xbm_Log(x, 3, "XBM warning: code change   %s -> %s (state '%s' -> '%s') might contain a hazard with a non-directed don't care.", 
+          dcToStr(xbm_GetPiMachine(x), s, " ", ""), 
+          dcToStr2(xbm_GetPiMachine(x), e, " ", ""),
+          xbm_GetStNameStr(x, st_src_pos),xbm_GetStNameStr(x, st_dest_pos));
+        {
+          int j;
+          for( j = 0; j < xbm_GetPiMachine(x)->out_cnt; j++ )
+            if ( dclIsHazardfreeFunction(xbm_GetPiMachine(x), x->cl_machine, s, e, j) == 0 )
+            {
+              xbm_Log(x, 3, "XBM warning: hazard on output %d.", j);
+            }
+        }
       }
     }
   }
+  xbm_chk_destroy(&chk);
   return 1;
 }
 
@@ -136,6 +224,11 @@ int xbm_CheckStrongStateSelfTransfers(xbm_type x)
   int in_cnt = x->inputs;
   int out_cnt = x->outputs;
   int code_cnt = xbm_GetPiCode(x)->out_cnt;
+  int i, cnt;
+  xbm_chk chk;
+  
+  if ( xbm_chk_init(&chk, x) == 0 )
+    return 0;
   
   st_pos = -1;
   while( xbm_LoopSt(x, &st_pos) != 0 )
@@ -171,48 +264,89 @@ int xbm_CheckStrongStateSelfTransfers(xbm_type x)
           xbm_GetPiCode(x), &(xbm_GetSt(x, st_pos)->code));
         dcCopyOutToOut( xbm_GetPiMachine(x), e, code_cnt, 
           xbm_GetPiOut(x), &(xbm_GetSt(x, st_pos)->out));
-        
-        xbm_Log(x, 0, "XBM:         self loop     %s -> %s.", 
-          dcToStr(xbm_GetPiMachine(x), s, " ", ""), 
-          dcToStr2(xbm_GetPiMachine(x), e, " ", ""));
-        if ( dclIsHazardfreeTransition(xbm_GetPiMachine(x), x->cl_machine, s, e) == 0 )
-        {
-          xbm_Log(x, 4, "XBM warning: self loop     %s -> %s (state '%s') might contain a hazard.", 
-            dcToStr(xbm_GetPiMachine(x), s, " ", ""), 
-            dcToStr2(xbm_GetPiMachine(x), e, " ", ""),
-            xbm_GetStNameStr(x, st_pos));
-        }        
+        if ( xbm_chk_add(&chk, s, e, st_pos) == 0 )
+          return xbm_chk_destroy(&chk), 0;
       }
     }
   }
+  
+  if ( xbm_chk_do(&chk) == 0 )
+    return xbm_chk_destroy(&chk), 0;
+
+  cnt = dclCnt(chk.cl_s);
+  for( i = 0; i < cnt; i++ )
+  {
+    st_pos = b_il_GetVal(chk.il, i);
+    s = dclGet(chk.cl_s, i);
+    e = dclGet(chk.cl_e, i);
+    xbm_Log(x, 0, "XBM:         self loop     %s -> %s.", 
+      dcToStr(xbm_GetPiMachine(x), s, " ", ""), 
+      dcToStr2(xbm_GetPiMachine(x), e, " ", ""));
+    if ( chk.is_hf[i] == 0 )
+    {
+      xbm_Log(x, 4, "XBM warning: self loop     %s -> %s (state '%s') might contain a hazard.", 
+        dcToStr(xbm_GetPiMachine(x), s, " ", ""), 
+        dcToStr2(xbm_GetPiMachine(x), e, " ", ""),
+        xbm_GetStNameStr(x, st_pos));
+    }        
+  }
+  xbm_chk_destroy(&chk);
   return 1;
 }
 
 /*---------------------------------------------------------------------------*/
 
-static int check_cb(void *data, dcube *s, dcube *e)
+static int add_cb(void *data, dcube *s, dcube *e)
 {
-  xbm_type x = (xbm_type)data;
-  if ( dclIsHazardfreeTransition(xbm_GetPiMachine(x), x->cl_machine, s, e) == 0 )
-  {
-    xbm_Error(x, "XBM: Transition %s -> %s contains hazard.", 
-      dcToStr(xbm_GetPiMachine(x), s, " ", ""), 
-      dcToStr(xbm_GetPiMachine(x), s, " ", ""));
+  return xbm_chk_add((xbm_chk *)data, s, e, 0);
+}
+
+static int xbm_check_transfers(xbm_type x, int is_self)
+{
+  xbm_chk chk;
+  int i, cnt;
+  
+  if ( xbm_chk_init(&chk, x) == 0 )
     return 0;
+  
+  /* xbmfn.c */
+  if ( is_self != 0 )
+  {
+    if ( xbm_DoStateSelfTransfers(x, add_cb, &chk) == 0 )
+      return xbm_chk_destroy(&chk), 0;
+  }
+  else
+  {
+    if ( xbm_DoStateStateTransfers(x, add_cb, &chk) == 0 )
+      return xbm_chk_destroy(&chk), 0;
   }
+  
+  if ( xbm_chk_do(&chk) == 0 )
+    return xbm_chk_destroy(&chk), 0;
+
+  cnt = dclCnt(chk.cl_s);
+  for( i = 0; i < cnt; i++ )
+  {
+    if ( chk.is_hf[i] == 0 )
+    {
+      xbm_Error(x, "XBM: Transition %s -> %s contains hazard.", 
+        dcToStr(xbm_GetPiMachine(x), dclGet(chk.cl_s, i), " ", ""), 
+        dcToStr2(xbm_GetPiMachine(x), dclGet(chk.cl_e, i), " ", ""));
+      return xbm_chk_destroy(&chk), 0;
+    }
+  }
+  xbm_chk_destroy(&chk);
   return 1;
 }
 
 int xbm_CheckStateStateTransfers(xbm_type x)
 {
-  /* xbmfn.c */
-  return xbm_DoStateStateTransfers(x, check_cb, x);
+  return xbm_check_transfers(x, 0);
 }
 
 int xbm_CheckStateSelfTransfers(xbm_type x)
 {
-  /* xbmfn.c */
-  return xbm_DoStateSelfTransfers(x, check_cb, x);
+  return xbm_check_transfers(x, 1);
 }
 
 /*---------------------------------------------------------------------------*/
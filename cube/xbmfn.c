@@ -25,10 +25,12 @@
 */
 
 #include <stdio.h>
+#include <stdlib.h>
 #include <stdarg.h>
 #include <assert.h>
 #include "xbm.h"
 #include "dcubehf.h"
+#include "b_th.h"
 
 /*
   directed don't care     transitions   
@@ -376,6 +378,264 @@ static void xbm_hfp_err_cb(void *data, const char *fmt, va_list va)
 }
 
 
+/*---------------------------------------------------------------------------*/
+/*
+  Output partitioned transfer function (XBM_BUILD_OPT_SPLIT).
+  Each output of pi_machine gets its own problem with one output only.
+  The problems are filled and minimized on separate threads (b_th_Do)
+  and the results are merged into cl_machine. Implicants of different
+  outputs are only shared if their input parts are equal.
+  The minimization (hfp_MinimizeDHF, dclMinimize and the covering 
+  solver in matrix.c) must not use static data, the threads only
+  share the XBM, which is not modified.
+*/
+
+struct _xbm_split_struct
+{
+  xbm_type x;
+  dclist cl_a;        /* async: start cubes, sync: on-set */
+  dclist cl_b;        /* async: end cubes, sync: dc-set */
+  hfp_type *hfp;      /* async: problem of each output */
+  pinfo **pi;         /* sync: pinfo of each output */
+  dclist *cl;         /* result of each output */
+};
+typedef struct _xbm_split_struct xbm_split;
+
+static void xbm_split_log_cb(void *data, const char *fmt, va_list va)
+{
+  b_th_Lock();
+  xbm_LogVA((xbm_type)data, 0, fmt, va);
+  b_th_Unlock();
+}
+
+static void xbm_split_err_cb(void *data, const char *fmt, va_list va)
+{
+  b_th_Lock();
+  xbm_ErrorVA((xbm_type)data, fmt, va);
+  b_th_Unlock();
+}
+
+static int xbm_split_init(xbm_split *xs, xbm_type x)
+{
+  int i, out_cnt = x->pi_machine->out_cnt;
+  xs->x = x;
+  if ( dclInitVA(2, &(xs->cl_a), &(xs->cl_b)) == 0 )
+    return 0;
+  xs->hfp = (hfp_type *)malloc(sizeof(hfp_type)*(out_cnt+1));
+  xs->pi = (pinfo **)malloc(sizeof(pinfo *)*(out_cnt+1));
+  xs->cl = (dclist *)malloc(sizeof(dclist)*(out_cnt+1));
+  if ( xs->hfp == NULL || xs->pi == NULL || xs->cl == NULL )
+  {
+    if ( xs->hfp != NULL ) free(xs->hfp);
+    if ( xs->pi != NULL ) free(xs->pi);
+    if ( xs->cl != NULL ) free(xs->cl);
+    return dclDestroyVA(2, xs->cl_a, xs->cl_b), 0;
+  }
+  for( i = 0; i < out_cnt; i++ )
+  {
+    xs->hfp[i] = NULL;
+    xs->pi[i] = NULL;
+    xs->cl[i] = NULL;
+  }
+  return 1;
+}
+
+static void xbm_split_destroy(xbm_split *xs)
+{
+  int i, out_cnt = xs->x->pi_machine->out_cnt;
+  for( i = 0; i < out_cnt; i++ )
+  {
+    if ( xs->hfp[i] != NULL )
+      hfp_Close(xs->hfp[i]);
+    else if ( xs->cl[i] != NULL )
+      dclDestroy(xs->cl[i]);
+    if ( xs->pi[i] != NULL )
+      pinfoClose(xs->pi[i]);
+  }
+  free(xs->hfp);
+  free(xs->pi);
+  free(xs->cl);
+  dclDestroyVA(2, xs->cl_a, xs->cl_b);
+}
+
+/* copies the cubes of src, which contain output 'out' */
+static int xbm_split_copy_out(pinfo *pi, dclist dest, pinfo *pi_src, dclist src, int out, dcube *c)
+{
+  int i, cnt = dclCnt(src);
+  for( i = 0; i < cnt; i++ )
+  {
+    if ( dcGetOut(dclGet(src, i), out) == 0 )
+      continue;
+    dcCopyInToIn(pi, c, 0, pi_src, dclGet(src, i));
+    dcOutSetAll(pi, c, 0);
+    dcSetOut(c, 0, 1);
+    if ( dclAdd(pi, dest, c) < 0 )
+      return 0;
+  }
+  return 1;
+}
+
+/* merges the results of all outputs into cl_machine */
+static int xbm_split_merge(xbm_split *xs)
+{
+  pinfo *pi = xs->x->pi_machine;
+  dclist cl = xs->x->cl_machine;
+  pinfo *pi_out;
+  dcube *c = &(pi->tmp[3]);
+  int out, i, j, cnt;
+  
+  dclClear(cl);
+  for( out = 0; out < pi->out_cnt; out++ )
+  {
+    pi_out = xs->hfp[out] != NULL ? xs->hfp[out]->pi : xs->pi[out];
+    cnt = dclCnt(xs->cl[out]);
+    for( i = 0; i < cnt; i++ )
+    {
+      dcCopyInToIn(pi, c, 0, pi_out, dclGet(xs->cl[out], i));
+      for( j = 0; j < dclCnt(cl); j++ )
+        if ( dcIsEqualIn(pi, dclGet(cl, j), c) != 0 )
+          break;
+      if ( j >= dclCnt(cl) )
+      {
+        dcOutSetAll(pi, c, 0);
+        j = dclAdd(pi, cl, c);
+        if ( j < 0 )
+          return 0;
+      }
+      dcSetOut(dclGet(cl, j), out, 1);
+    }
+  }
+  return 1;
+}
+
+static int xbm_split_collect_cb(void *data, dcube *s, dcube *e)
+{
+  xbm_split *xs = (xbm_split *)data;
+  if ( dclAdd(xs->x->pi_machine, xs->cl_a, s) < 0 )
+    return 0;
+  if ( dclAdd(xs->x->pi_machine, xs->cl_b, e) < 0 )
+    return 0;
+  return 1;
+}
+
+static int xbm_split_async_th(void *data, int th, int out)
+{
+  xbm_split *xs = (xbm_split *)data;
+  pinfo *pi_m = xs->x->pi_machine;
+  hfp_type hfp;
+  dcube *s, *e;
+  int i, cnt = dclCnt(xs->cl_a);
+  
+  hfp = hfp_Open(pi_m->in_cnt, 1);
+  if ( hfp == NULL )
+    return 0;
+  xs->hfp[out] = hfp;
+  xs->pi[out] = NULL;
+  hfp_SetLogCB(hfp, xbm_split_log_cb, (void *)xs->x);
+  hfp_SetErrorCB(hfp, xbm_split_err_cb, (void *)xs->x);
+  
+  s = &(hfp->pi->tmp[3]);
+  e = &(hfp->pi->tmp[4]);
+  for( i = 0; i < cnt; i++ )
+  {
+    dcCopyInToIn(hfp->pi, s, 0, pi_m, dclGet(xs->cl_a, i));
+    dcOutSetAll(hfp->pi, s, 0);
+    dcSetOut(s, 0, dcGetOut(dclGet(xs->cl_a, i), out));
+    dcCopyInToIn(hfp->pi, e, 0, pi_m, dclGet(xs->cl_b, i));
+    dcOutSetAll(hfp->pi, e, 0);
+    dcSetOut(e, 0, dcGetOut(dclGet(xs->cl_b, i), out));
+    if ( hfp_AddFromToTransition(hfp, s, e) == 0 )
+      return 0;
+  }
+  
+  if ( hfp_MinimizeDHF(hfp, 0, 1) == 0 )
+    return 0;
+  xs->cl[out] = hfp->cl_on;
+  return 1;
+}
+
+static int xbm_split_sync_th(void *data, int th, int out)
+{
+  xbm_split *xs = (xbm_split *)data;
+  pinfo *pi_m = xs->x->pi_machine;
+  pinfo *pi;
+  dclist cl_on, cl_dc;
+  dcube c;
+  
+  pi = pinfoOpenInOut(pi_m->in_cnt, 1);
+  if ( pi == NULL )
+    return 0;
+  if ( dclInit(&cl_on) == 0 )
+    return pinfoClose(pi), 0;
+  if ( dclInit(&cl_dc) == 0 )
+    return dclDestroy(cl_on), pinfoClose(pi), 0;
+  if ( dcInit(pi, &c) == 0 )
+    return dclDestroyVA(2, cl_on, cl_dc), pinfoClose(pi), 0;
+  if ( xbm_split_copy_out(pi, cl_on, pi_m, xs->cl_a, out, &c) == 0 )
+    return dcDestroy(&c), dclDestroyVA(2, cl_on, cl_dc), pinfoClose(pi), 0;
+  if ( xbm_split_copy_out(pi, cl_dc, pi_m, xs->cl_b, out, &c) == 0 )
+    return dcDestroy(&c), dclDestroyVA(2, cl_on, cl_dc), pinfoClose(pi), 0;
+  dcDestroy(&c);
+  if ( dclMinimizeDCWithBCP(pi, cl_on, cl_dc) == 0 )
+    return dclDestroyVA(2, cl_on, cl_dc), pinfoClose(pi), 0;
+  dclDestroy(cl_dc);
+  
+  /* xbm_split_destroy() releases the result */
+  xs->pi[out] = pi;
+  xs->cl[out] = cl_on;
+  return 1;
+}
+
+static int xbm_BuildSplitAsynchronousTransferFunction(xbm_type x)
+{
+  xbm_split xs;
+  int out_cnt = x->pi_machine->out_cnt;
+  
+  if ( xbm_split_init(&xs, x) == 0 )
+    return 0;
+  
+  xbm_Log(x, 2, "XBM: State-state transfers (fn).");
+  if ( xbm_DoStateStateTransfers(x, xbm_split_collect_cb, &xs) == 0 )
+    return xbm_split_destroy(&xs), 0;
+
+  xbm_Log(x, 2, "XBM: Self-state transfers (fn).");
+  if ( xbm_DoStateSelfTransfers(x, xbm_split_collect_cb, &xs) == 0 )
+    return xbm_split_destroy(&xs), 0;
+
+  xbm_Log(x, 2, "XBM: Minimize %d output(s) with %d thread(s).", 
+    out_cnt, b_th_GetCnt(0, out_cnt));
+  if ( b_th_Do(0, out_cnt, xbm_split_async_th, &xs) == 0 )
+    return xbm_split_destroy(&xs), 0;
+    
+  if ( xbm_split_merge(&xs) == 0 )
+    return xbm_split_destroy(&xs), 0;
+
+  xbm_Log(x, 2, "XBM: Transfer function finished.");
+  return xbm_split_destroy(&xs), 1;
+}
+
+static int xbm_BuildSplitSynchronousTransferFunction(xbm_type x, dclist cl_on, dclist cl_dc)
+{
+  xbm_split xs;
+  int out_cnt = x->pi_machine->out_cnt;
+  
+  if ( xbm_split_init(&xs, x) == 0 )
+    return 0;
+  if ( dclCopy(x->pi_machine, xs.cl_a, cl_on) == 0 )
+    return xbm_split_destroy(&xs), 0;
+  if ( dclCopy(x->pi_machine, xs.cl_b, cl_dc) == 0 )
+    return xbm_split_destroy(&xs), 0;
+
+  xbm_Log(x, 2, "XBM: Minimize %d output(s) with %d thread(s).", 
+    out_cnt, b_th_GetCnt(0, out_cnt));
+  if ( b_th_Do(0, out_cnt, xbm_split_sync_th, &xs) == 0 )
+    return xbm_split_destroy(&xs), 0;
+
+  if ( xbm_split_merge(&xs) == 0 )
+    return xbm_split_destroy(&xs), 0;
+  return xbm_split_destroy(&xs), 1;
+}
+
 int xbm_BuildAsynchronousTransferFunction(xbm_type x)
 {
   hfp_type hfp;
@@ -392,6 +652,9 @@ int xbm_BuildAsynchronousTransferFunction(xbm_type x)
 
   /* calculate transfer function */
 
+  if ( x->is_split_out != 0 )
+    return xbm_BuildSplitAsynchronousTransferFunction(x);
+
   hfp = hfp_Open(x->pi_machine->in_cnt, x->pi_machine->out_cnt);
   if ( hfp == NULL )
     return 0;
@@ -408,7 +671,7 @@ int xbm_BuildAsynchronousTransferFunction(xbm_type x)
     return hfp_Close(hfp), 0;
     
   xbm_Log(x, 2, "XBM: Minimize.");
-  if ( hfp_Minimize(hfp, 0, 1) == 0 )
+  if ( hfp_MinimizeDHF(hfp, 0, 1) == 0 )
     return hfp_Close(hfp), 0;
     
   xbm_Log(x, 2, "XBM: Transfer function finished.");
@@ -549,6 +812,13 @@ int xbm_BuildSynchronousTransferFunction(xbm_type x)
 
   xbm_Log(x, 2, "XBM: Minimize synchronous transfer function.");
 
+  if ( x->is_split_out != 0 )
+  {
+    if ( xbm_BuildSplitSynchronousTransferFunction(x, cl_on, cl_dc) == 0 )
+      return dclDestroyVA(3, cl_on, cl_off, cl_dc), 0;
+    return dclDestroyVA(3, cl_on, cl_off, cl_dc), 1;
+  }
+
   /* using minimize tobias' functions would be preferable, but it seems, 
      that there are some strange behaviours....
   if ( dclMinimizeDC(xbm_GetPiMachine(x), cl_on, cl_dc, 0, 1) == 0 )
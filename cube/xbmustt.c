@@ -43,6 +43,7 @@
 #include <stdio.h>
 #include <assert.h>
 #include "xbm.h"
+#include "dich.h"
 #include "b_sp.h"
 
 void xbm_DestroyAsync(xbm_type x)
@@ -307,7 +308,8 @@ int xbm_BuildPartitionTable(xbm_type x)
   
   xbm_Log(x, 2, "XBM: Partitions: %d.", dclCnt(x->cl_async));
 
-  dclSCCInv(x->pi_async, x->cl_async);
+  if ( dclSCCInvDich(x->pi_async, x->cl_async) == 0 )
+    return 0;
 
   xbm_Log(x, 2, "XBM: Partitions after SCCInv operation: %d.", dclCnt(x->cl_async));
 
@@ -27,6 +27,9 @@
 */
 
 #include "xbm.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
 #include <assert.h>
 
 int internal_xbm_set_str(char **s, const char *name);
@@ -820,7 +823,7 @@ static int xbm_vhdltb_walk_sync_cb(xbm_type x, void *data, int tr_pos, dcube *cs
   return 1;
 }
 
-static int xbm_vhdltb_walk(xbm_type x, FILE *fp)
+static int xbm_vhdltb_walk(xbm_type x, FILE *fp, xbm_walk_type w, int part)
 {
   int r = 0;
 
@@ -834,12 +837,12 @@ static int xbm_vhdltb_walk(xbm_type x, FILE *fp)
 
   if ( x->is_sync != 0 )
   {
-    if ( xbm_DoWalk(x, xbm_vhdltb_walk_sync_cb, (void *)fp) == 0 )
+    if ( xbm_DoWalkPart(w, part, xbm_vhdltb_walk_sync_cb, (void *)fp) == 0 )
       return 0;
   }
   else
   {
-    if ( xbm_DoWalk(x, xbm_vhdltb_walk_async_cb, (void *)fp) == 0 )
+    if ( xbm_DoWalkPart(w, part, xbm_vhdltb_walk_async_cb, (void *)fp) == 0 )
       return 0;
   }
 
@@ -854,7 +857,7 @@ static int xbm_vhdltb_walk(xbm_type x, FILE *fp)
   return 1;
 }
 
-static int xbm_vhdltb_architecture(xbm_type x, FILE *fp)
+static int xbm_vhdltb_architecture(xbm_type x, FILE *fp, xbm_walk_type w, int part)
 {
   int r;
   int is_clr = (x->tb_reset_type != XBM_RESET_NONE)?1:0;
@@ -871,14 +874,14 @@ static int xbm_vhdltb_architecture(xbm_type x, FILE *fp)
   if ( xbm_vhdltb_arch_dut(x, fp, is_clr, is_clk) == 0 ) return 0;
   if ( xbm_vhdltb_arch_glitch_processes(x, fp) == 0 ) return 0;
 
-  if ( xbm_vhdltb_walk(x, fp) == 0 ) return 0;
+  if ( xbm_vhdltb_walk(x, fp, w, part) == 0 ) return 0;
 
   if ( xbm_vhdltb_arch_end(x, fp) == 0 ) return 0;
 
   return 1;  
 }
 
-static int xbm_vhdltb_all(xbm_type x, FILE *fp, const char *name)
+static int xbm_vhdltb_all(xbm_type x, FILE *fp, const char *name, xbm_walk_type w, int part)
 {
   int r;
   if ( xbm_vhdl_indent(x, fp, 0) == 0 ) return 0;
@@ -895,13 +898,13 @@ static int xbm_vhdltb_all(xbm_type x, FILE *fp, const char *name)
 
   if ( xbm_vhdltb_library(x, fp) == 0 ) return 0;
   if ( xbm_vhdltb_entity(x, fp) == 0 ) return 0;
-  if ( xbm_vhdltb_architecture(x, fp) == 0 ) return 0;
+  if ( xbm_vhdltb_architecture(x, fp, w, part) == 0 ) return 0;
   if ( xbm_vhdltb_configuration(x, fp) == 0 ) return 0;
   return 1;
 }
 
 
-int xbm_WriteTestbenchVHDL(xbm_type x, const char *name)
+static int xbm_vhdltb_write(xbm_type x, const char *name, xbm_walk_type w, int part)
 {
   FILE *fp;
   int r;
@@ -911,7 +914,7 @@ int xbm_WriteTestbenchVHDL(xbm_type x, const char *name)
     xbm_Error(x, "XBM: Can not create testbench '%s'.", name);
     return 0;
   }
-  r = xbm_vhdltb_all(x, fp, name);
+  r = xbm_vhdltb_all(x, fp, name, w, part);
   if ( r == 0 )
     xbm_Error(x, "XBM: Error with testbench '%s'.", name);
   fclose(fp);
@@ -919,3 +922,86 @@ int xbm_WriteTestbenchVHDL(xbm_type x, const char *name)
   return r;
 }
 
+int xbm_WriteTestbenchVHDL(xbm_type x, const char *name)
+{
+  xbm_walk_type w;
+  int r;
+  w = xbm_OpenWalk(x, 1, 0, 1);
+  if ( w == NULL )
+  {
+    xbm_Error(x, "XBM: Error with testbench '%s'.", name);
+    return 0;
+  }
+  r = xbm_vhdltb_write(x, name, w, 0);
+  xbm_CloseWalk(w);
+  return r;
+}
+
+/* appends "_<part>" to s, in front of the extension, if 'is_ext' is not 0 */
+static char *xbm_vhdltb_part_str(const char *s, int part, int is_ext)
+{
+  const char *ext = NULL;
+  char *t;
+  size_t len;
+  if ( is_ext != 0 )
+  {
+    ext = strrchr(s, '.');
+    if ( ext != NULL && strchr(ext, '/') != NULL )
+      ext = NULL;
+  }
+  if ( ext == NULL )
+    ext = s + strlen(s);
+  len = (size_t)(ext - s);
+  t = (char *)malloc(strlen(s) + 16);
+  if ( t == NULL )
+    return NULL;
+  memcpy(t, s, len);
+  sprintf(t + len, "_%d%s", part, ext);
+  return t;
+}
+
+/*
+  Splits the walk through the machine into part_cnt independent testbenches.
+  The walks are calculated with DGC_THREADS threads. Part k is written to
+  'name' with "_k" in front of the extension, the entity and the configuration
+  of the testbench also get the suffix "_k".
+*/
+int xbm_WriteTestbenchVHDLParts(xbm_type x, const char *name, int part_cnt)
+{
+  xbm_walk_type w;
+  char *entity_name = x->tb_entity_name;
+  char *conf_name = x->tb_conf_name;
+  char *file_name;
+  int part;
+  int r = 1;
+  
+  if ( part_cnt <= 1 )
+    return xbm_WriteTestbenchVHDL(x, name);
+  
+  w = xbm_OpenWalk(x, part_cnt, 1, 0);
+  if ( w == NULL )
+  {
+    xbm_Error(x, "XBM: Error with testbench '%s'.", name);
+    return 0;
+  }
+  
+  for( part = 0; part < xbm_GetWalkPartCnt(w) && r != 0; part++ )
+  {
+    file_name = xbm_vhdltb_part_str(name, part, 1);
+    x->tb_entity_name = xbm_vhdltb_part_str(entity_name, part, 0);
+    x->tb_conf_name = xbm_vhdltb_part_str(conf_name, part, 0);
+    if ( file_name != NULL && x->tb_entity_name != NULL && x->tb_conf_name != NULL )
+      r = xbm_vhdltb_write(x, file_name, w, part);
+    else
+      r = 0;
+    if ( file_name != NULL ) free(file_name);
+    if ( x->tb_entity_name != NULL ) free(x->tb_entity_name);
+    if ( x->tb_conf_name != NULL ) free(x->tb_conf_name);
+  }
+  
+  x->tb_entity_name = entity_name;
+  x->tb_conf_name = conf_name;
+  xbm_CloseWalk(w);
+  return r;
+}
+
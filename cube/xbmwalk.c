@@ -27,71 +27,165 @@
 */
 
 #include "xbm.h"
+#include "b_th.h"
+#include <stdlib.h>
 #include <assert.h>
 
+/* upper limit for the number of entries of the next hop table */
+#define XBM_WALK_HOP_MAX (1L<<24)
+
+/* flags of a walk step */
+#define XBM_WALK_RESET  1
+#define XBM_WALK_UNIQUE 2
+
 /*---------------------------------------------------------------------------*/
 
-static void xbm_relax(xbm_type x, int st_src_pos, int st_dest_pos)
+/* counting sort of the transitions by their source (is_src) or destination state */
+static void xbm_walk_adj_sort(xbm_walk_type w, int *idx, int *tr, int is_src)
 {
-  if ( xbm_GetSt(x, st_dest_pos)->d > xbm_GetSt(x, st_src_pos)->d + 1)
+  xbm_type x = w->x;
+  int tr_pos, st_pos;
+  
+  tr_pos = -1;
+  while( xbm_LoopTr(x, &tr_pos) != 0 )
   {
-    xbm_GetSt(x, st_dest_pos)->d = xbm_GetSt(x, st_src_pos)->d + 1;
-    xbm_GetSt(x, st_dest_pos)->p = st_src_pos;
+    st_pos = is_src ? xbm_GetTrSrcStPos(x, tr_pos) : xbm_GetTrDestStPos(x, tr_pos);
+    idx[st_pos+1]++;
   }
+  for( st_pos = 0; st_pos < w->st_max; st_pos++ )
+    idx[st_pos+1] += idx[st_pos];
+  
+  tr_pos = -1;
+  while( xbm_LoopTr(x, &tr_pos) != 0 )
+  {
+    st_pos = is_src ? xbm_GetTrSrcStPos(x, tr_pos) : xbm_GetTrDestStPos(x, tr_pos);
+    tr[idx[st_pos]++] = tr_pos;
+  }
+  for( st_pos = w->st_max; st_pos > 0; st_pos-- )
+    idx[st_pos] = idx[st_pos-1];
+  idx[0] = 0;
 }
 
-static int xbm_check(xbm_type x, int st_src_pos, int st_dest_pos)
+/*
+  Adjacency lists of the states: the out transitions of state st are
+  out_tr[out_idx[st]] ... out_tr[out_idx[st+1]-1]. They are sorted by 
+  their position, so the order is the same as with xbm_LoopStOutTr().
+*/
+static int xbm_walk_adj(xbm_walk_type w)
 {
-  if ( xbm_GetSt(x, st_dest_pos)->d > xbm_GetSt(x, st_src_pos)->d + 1)
+  w->out_idx = (int *)calloc(w->st_max+1, sizeof(int));
+  w->in_idx = (int *)calloc(w->st_max+1, sizeof(int));
+  w->out_tr = (int *)malloc(sizeof(int)*(w->tr_cnt+1));
+  w->in_tr = (int *)malloc(sizeof(int)*(w->tr_cnt+1));
+  if ( w->out_idx == NULL || w->in_idx == NULL || 
+       w->out_tr == NULL || w->in_tr == NULL )
     return 0;
+  xbm_walk_adj_sort(w, w->out_idx, w->out_tr, 1);
+  xbm_walk_adj_sort(w, w->in_idx, w->in_tr, 0);
   return 1;
 }
 
-static void xbm_init_bellman_ford(xbm_type x, int st_start_pos)
+/*
+  Shortest paths from st_start_pos. All transitions have the weight 1,
+  so a breadth first search is sufficient: O(states+transitions).
+  Assigns d and p of the states, p_tr is the (first) transition from p to 
+  the state. The states are stored in 'order', unreachable states are 
+  appended at the end.
+*/
+static void xbm_walk_bfs(xbm_walk_type w, int st_start_pos)
 {
-  int st_pos;
+  xbm_type x = w->x;
+  int st_pos, st_dest_pos, tr_pos, i, head, tail;
+  
   st_pos = -1;
   while( xbm_LoopSt(x, &st_pos) != 0 )
   {
-    xbm_GetSt(x, st_pos)->d = (1<<((8*sizeof(int))-2));
+    xbm_GetSt(x, st_pos)->d = -1;
     xbm_GetSt(x, st_pos)->p = -1;
+    w->p_tr[st_pos] = -1;
   }
+  
+  head = 0;
+  tail = 0;
   xbm_GetSt(x, st_start_pos)->d = 0;
+  w->order[tail++] = st_start_pos;
+  while( head < tail )
+  {
+    st_pos = w->order[head++];
+    for( i = w->out_idx[st_pos]; i < w->out_idx[st_pos+1]; i++ )
+    {
+      tr_pos = w->out_tr[i];
+      st_dest_pos = xbm_GetTrDestStPos(x, tr_pos);
+      if ( xbm_GetSt(x, st_dest_pos)->d < 0 )
+      {
+        xbm_GetSt(x, st_dest_pos)->d = xbm_GetSt(x, st_pos)->d + 1;
+        xbm_GetSt(x, st_dest_pos)->p = st_pos;
+        w->p_tr[st_dest_pos] = tr_pos;
+        w->order[tail++] = st_dest_pos;
+      }
+    }
+  }
+  
+  st_pos = -1;
+  while( xbm_LoopSt(x, &st_pos) != 0 )
+    if ( xbm_GetSt(x, st_pos)->d < 0 )
+      w->order[tail++] = st_pos;
+  w->order_cnt = tail;
 }
 
 /*
-  The weight is '1' so I could also use Dijkstra's algorithm, but 
-  the Bellman-Ford algorithm seems to be a little bit easier to implement.
-  It doesn't require a priority queue...
-  well, yes, Bellman-Ford is slower..
-  
-  taken from CLR, Introduction to algorithms, p 520ff
+  Next hop table: hop[dest*st_max+src] is the first transition of a 
+  shortest path from src to dest (or -1). One backward breadth first 
+  search for each destination, the searches are independent.
 */
-
-static int xbm_do_bellman_ford(xbm_type x)
+static int xbm_walk_hop_th(void *data, int th, int st_dest_pos)
 {
-  int st_pos, tr_pos;
+  xbm_walk_type w = (xbm_walk_type)data;
+  xbm_type x = w->x;
+  int *row = w->hop + (size_t)st_dest_pos*(size_t)w->st_max;
+  int *queue;
+  int st_pos, st_src_pos, tr_pos, i, head, tail;
   
-  st_pos = -1;
-  while( xbm_LoopSt(x, &st_pos) != 0 )
+  for( st_pos = 0; st_pos < w->st_max; st_pos++ )
+    row[st_pos] = -1;
+  if ( b_set_Get(x->states, st_dest_pos) == NULL )
+    return 1;
+  
+  queue = (int *)malloc(sizeof(int)*w->st_max);
+  if ( queue == NULL )
+    return 0;
+  head = 0;
+  tail = 0;
+  queue[tail++] = st_dest_pos;
+  while( head < tail )
   {
-    tr_pos = -1;
-    while( xbm_LoopTr(x, &tr_pos) != 0 )
-      xbm_relax(x, xbm_GetTrSrcStPos(x, tr_pos), xbm_GetTrDestStPos(x, tr_pos));
+    st_pos = queue[head++];
+    for( i = w->in_idx[st_pos]; i < w->in_idx[st_pos+1]; i++ )
+    {
+      tr_pos = w->in_tr[i];
+      st_src_pos = xbm_GetTrSrcStPos(x, tr_pos);
+      if ( st_src_pos != st_dest_pos && row[st_src_pos] < 0 )
+      {
+        row[st_src_pos] = tr_pos;
+        queue[tail++] = st_src_pos;
+      }
+    }
   }
-  
-  tr_pos = -1;
-  while( xbm_LoopTr(x, &tr_pos) != 0 )
-    if ( xbm_check(x, xbm_GetTrSrcStPos(x, tr_pos), xbm_GetTrDestStPos(x, tr_pos)) == 0 )
-      return 0;
-    
+  free(queue);
   return 1;
 }
 
-int xbm_bellman_ford(xbm_type x, int st_start_pos)
+static int xbm_walk_hop(xbm_walk_type w, int thread_cnt)
 {
-  xbm_init_bellman_ford(x, st_start_pos);
-  return xbm_do_bellman_ford(x);
+  if ( (long)w->st_max*(long)w->st_max > XBM_WALK_HOP_MAX )
+  {
+    xbm_Log(w->x, 4, "XBM: Too many states (%d) for the next hop table.", w->st_max);
+    return 1;
+  }
+  w->hop = (int *)malloc(sizeof(int)*(size_t)w->st_max*(size_t)w->st_max+1);
+  if ( w->hop == NULL )
+    return 0;
+  return b_th_Do(thread_cnt, w->st_max, xbm_walk_hop_th, (void *)w);
 }
 
 /*---------------------------------------------------------------------------*/
@@ -176,170 +270,318 @@ int xbm_GetNthTrVec(xbm_type x, int tr_pos, dcube *cs, dcube *ct, int n)
   return 1;
 }
 
-static void xbm_init_walk(xbm_type x)
+
+/*---------------------------------------------------------------------------*/
+
+/* workspace for the walk of one part */
+struct _xbm_wp_struct
 {
-  int tr_pos = -1;
-  while( xbm_LoopTr(x, &tr_pos) != 0 )
-  {
-    xbm_GetTr(x, tr_pos)->visit_cnt = 0;    /* all is white */
-    xbm_GetTr(x, tr_pos)->visit_max = xbm_GetTrVisitMax(x, tr_pos);
-  }
-}
+  xbm_walk_type w;
+  int *visit_cnt;
+  b_il_type steps;
+};
+typedef struct _xbm_wp_struct xbm_wp_struct;
 
-static int xbm_exec_st_st(xbm_type x, int st1_pos, int st2_pos, int n)
+static int xbm_wp_add(xbm_wp_struct *wp, int tr_pos, int n, int flags)
 {
-  int tr_pos;
-  int loop;
-  int is_reset = 0;
-  dcube *cs;
-  dcube *ct;
-  
-  cs = &(x->pi_machine->tmp[3]);
-  ct = &(x->pi_machine->tmp[4]);
-  
-  if ( xbm_GetSt(x, st1_pos)->p < 0 )
-  {
-    assert(st1_pos == x->reset_st_pos);
-    is_reset = 1;
-  }
-  tr_pos = -1;
-  loop = -1;
-  while ( xbm_LoopStOutTr(x, st1_pos, &loop, &tr_pos) != 0 )
-    if ( xbm_GetTrDestStPos(x, tr_pos) == st2_pos )
-    {
-      xbm_GetNthTrVec(x, tr_pos, cs, ct, n);
-      if ( x->walk_cb(x, x->walk_data, tr_pos, cs, ct, is_reset, 0) == 0 )
-        return 0;
-      break;
-    }
-  
+  if ( b_il_Add(wp->steps, tr_pos) < 0 ) return 0;
+  if ( b_il_Add(wp->steps, n) < 0 ) return 0;
+  if ( b_il_Add(wp->steps, flags) < 0 ) return 0;
   return 1;
 }
 
-static int xbm_do_quick_walk(xbm_type x, int st_pos)
+/* go to st_pos along the shortest path from the reset state */
+static int xbm_wp_quick_walk(xbm_wp_struct *wp, int st_pos)
 {
-  if ( xbm_GetSt(x, st_pos)->p >= 0 )
+  xbm_type x = wp->w->x;
+  int p = xbm_GetSt(x, st_pos)->p;
+  if ( p >= 0 )
   {
-    xbm_do_quick_walk(x, xbm_GetSt(x, st_pos)->p);
-    if ( xbm_exec_st_st(x, xbm_GetSt(x, st_pos)->p, st_pos, 0) == 0 )
+    if ( xbm_wp_quick_walk(wp, p) == 0 )
+      return 0;
+    if ( xbm_wp_add(wp, wp->w->p_tr[st_pos], 0, 
+        xbm_GetSt(x, p)->p < 0 ? XBM_WALK_RESET : 0) == 0 )
       return 0;
   }
   return 1;
 }
 
-static int xbm_exec_tr(xbm_type x, int tr_pos, int n, int is_reset)
+/* go from st_curr_pos to st_pos with the next hop table, no reset */
+static int xbm_wp_hop_walk(xbm_wp_struct *wp, int st_curr_pos, int st_pos)
 {
-  dcube *cs;
-  dcube *ct;
-  
-  cs = &(x->pi_machine->tmp[3]);
-  ct = &(x->pi_machine->tmp[4]);
-
-  xbm_GetNthTrVec(x, tr_pos, cs, ct, n);
-
-  return x->walk_cb(x, x->walk_data, tr_pos, cs, ct, is_reset, 1) ;
+  xbm_walk_type w = wp->w;
+  int tr_pos;
+  while( st_curr_pos != st_pos )
+  {
+    tr_pos = w->hop[(size_t)st_pos*(size_t)w->st_max+st_curr_pos];
+    assert(tr_pos >= 0);
+    if ( xbm_wp_add(wp, tr_pos, 0, 0) == 0 )
+      return 0;
+    st_curr_pos = xbm_GetTrDestStPos(w->x, tr_pos);
+  }
+  return 1;
 }
 
-static int xbm_do_depth_walk(xbm_type x, int st_pos)
+/* try to go as far as possible, returns the last state or -1 */
+static int xbm_wp_depth_walk(xbm_wp_struct *wp, int st_pos)
 {
-  int tr_pos, loop;
+  xbm_walk_type w = wp->w;
+  xbm_type x = w->x;
+  int i, tr_pos;
   int st_curr_pos;
   int st_next_pos;
-  int is_reset = 0;
+  int flags = XBM_WALK_UNIQUE;
   if ( st_pos == x->reset_st_pos )
-    is_reset = 1;
+    flags |= XBM_WALK_RESET;
   
   st_curr_pos = st_pos;
   do
   {
-    tr_pos = -1;
-    loop = -1;
     st_next_pos = -1;
-    while ( xbm_LoopStOutTr(x, st_curr_pos, &loop, &tr_pos) != 0 )
+    for( i = w->out_idx[st_curr_pos]; i < w->out_idx[st_curr_pos+1]; i++ )
     {
-      if ( xbm_GetTr(x, tr_pos)->visit_cnt < xbm_GetTr(x, tr_pos)->visit_max )
+      tr_pos = w->out_tr[i];
+      if ( wp->visit_cnt[tr_pos] < w->visit_max[tr_pos] )
       {
-        if ( xbm_exec_tr( x, tr_pos, xbm_GetTr(x, tr_pos)->visit_cnt, is_reset) == 0 )
-          return 0;
-        is_reset = 0;
-        xbm_GetTr(x, tr_pos)->visit_cnt++;
+        if ( xbm_wp_add(wp, tr_pos, wp->visit_cnt[tr_pos], flags) == 0 )
+          return -1;
+        flags = XBM_WALK_UNIQUE;
+        wp->visit_cnt[tr_pos]++;
         st_next_pos = xbm_GetTrDestStPos(x, tr_pos);
         break;
       }
     }
-    st_curr_pos = st_next_pos;
+    if ( st_next_pos >= 0 )
+      st_curr_pos = st_next_pos;
   } while( st_next_pos >= 0 );
   
-  return 1;
+  return st_curr_pos;
 }
 
 /* check if there are still transition that are not visited */
-static int xbm_is_white(xbm_type x, int st_pos)
+static int xbm_wp_is_white(xbm_wp_struct *wp, int st_pos)
 {
-  int tr_pos, loop;
-  tr_pos = -1;
-  loop = -1;
-  while ( xbm_LoopStOutTr(x, st_pos, &loop, &tr_pos) != 0 )
-    if ( xbm_GetTr(x, tr_pos)->visit_cnt < xbm_GetTr(x, tr_pos)->visit_max )
+  xbm_walk_type w = wp->w;
+  int i, tr_pos;
+  for( i = w->out_idx[st_pos]; i < w->out_idx[st_pos+1]; i++ )
+  {
+    tr_pos = w->out_tr[i];
+    if ( wp->visit_cnt[tr_pos] < w->visit_max[tr_pos] )
       return 1;
+  }
   return 0;
 }
 
 /*
   idea: go to a state, try to go as far as possible
         loop as long as there are non-visited transitions
+  With the next hop table, the walk continues from the current state
+  instead of starting again at the reset state.
 */
-
-static int xbm_do_walk_loop(xbm_type x, int st_pos)
+static int xbm_wp_walk_loop(xbm_wp_struct *wp, int st_pos, int *st_curr_ptr)
 {
-  while( xbm_is_white(x, st_pos) != 0 )
+  xbm_walk_type w = wp->w;
+  while( xbm_wp_is_white(wp, st_pos) != 0 )
   {
-    if ( xbm_do_quick_walk(x, st_pos) == 0 )
-      return 0;
-    if ( xbm_do_depth_walk(x, st_pos) == 0 )
+    if ( w->hop != NULL && *st_curr_ptr >= 0 && ( *st_curr_ptr == st_pos ||
+         w->hop[(size_t)st_pos*(size_t)w->st_max+*st_curr_ptr] >= 0 ) )
+    {
+      /* no reset required: the machine is in a known state */
+      if ( xbm_wp_hop_walk(wp, *st_curr_ptr, st_pos) == 0 )
+        return 0;
+    }
+    else
+    {
+      if ( xbm_wp_quick_walk(wp, st_pos) == 0 )
+        return 0;
+    }
+    *st_curr_ptr = xbm_wp_depth_walk(wp, st_pos);
+    if ( *st_curr_ptr < 0 )
       return 0;
   }
   return 1;
 }
 
-static int xbm_do_walk(xbm_type x)
+static int xbm_walk_part_th(void *data, int th, int part)
 {
-  int st_pos;
+  xbm_walk_type w = (xbm_walk_type)data;
+  xbm_type x = w->x;
+  xbm_wp_struct wp;
+  int st_pos, tr_pos;
+  int st_curr_pos = -1;
+  int r = 1;
+  
+  wp.w = w;
+  wp.steps = w->steps[part];
+  wp.visit_cnt = (int *)malloc(sizeof(int)*(b_set_Max(x->transitions)+1));
+  if ( wp.visit_cnt == NULL )
+    return 0;
+  
+  /* transitions of other parts are already visited */
+  tr_pos = -1;
+  while( xbm_LoopTr(x, &tr_pos) != 0 )
+    if ( w->part[xbm_GetTrSrcStPos(x, tr_pos)] == part )
+      wp.visit_cnt[tr_pos] = 0;
+    else
+      wp.visit_cnt[tr_pos] = w->visit_max[tr_pos];
+  
+  /* start walking from the reset state first, then the remaining states */
+  if ( xbm_wp_walk_loop(&wp, x->reset_st_pos, &st_curr_pos) == 0 )
+    r = 0;
+  st_pos = -1;
+  while( r != 0 && xbm_LoopSt(x, &st_pos) != 0 )
+    if ( xbm_wp_walk_loop(&wp, st_pos, &st_curr_pos) == 0 )
+      r = 0;
+  
+  free(wp.visit_cnt);
+  return r;
+}
 
-  /* a reset state is really required */
-  if ( x->reset_st_pos < 0 )
+/*---------------------------------------------------------------------------*/
+
+void xbm_CloseWalk(xbm_walk_type w)
+{
+  int i;
+  if ( w->steps != NULL )
+  {
+    for( i = 0; i < w->part_cnt; i++ )
+      if ( w->steps[i] != NULL )
+        b_il_Close(w->steps[i]);
+    free(w->steps);
+  }
+  if ( w->out_idx != NULL ) free(w->out_idx);
+  if ( w->out_tr != NULL ) free(w->out_tr);
+  if ( w->in_idx != NULL ) free(w->in_idx);
+  if ( w->in_tr != NULL ) free(w->in_tr);
+  if ( w->p_tr != NULL ) free(w->p_tr);
+  if ( w->order != NULL ) free(w->order);
+  if ( w->part != NULL ) free(w->part);
+  if ( w->visit_max != NULL ) free(w->visit_max);
+  if ( w->hop != NULL ) free(w->hop);
+  free(w);
+}
+
+static int xbm_walk_init(xbm_walk_type w, int is_hop, int thread_cnt)
+{
+  xbm_type x = w->x;
+  int i, tr_pos;
+  
+  w->out_idx = NULL;
+  w->out_tr = NULL;
+  w->in_idx = NULL;
+  w->in_tr = NULL;
+  w->hop = NULL;
+  w->steps = NULL;
+  w->st_max = b_set_Max(x->states);
+  w->tr_cnt = b_set_Cnt(x->transitions);
+  w->p_tr = (int *)malloc(sizeof(int)*(w->st_max+1));
+  w->order = (int *)malloc(sizeof(int)*(w->st_max+1));
+  w->part = (int *)malloc(sizeof(int)*(w->st_max+1));
+  w->visit_max = (int *)malloc(sizeof(int)*(b_set_Max(x->transitions)+1));
+  if ( w->p_tr == NULL || w->order == NULL || w->part == NULL || w->visit_max == NULL )
+    return 0;
+  
+  if ( xbm_walk_adj(w) == 0 )
     return 0;
 
   /* our quick walk follows the shortest path, so calculate it first */
-  if ( xbm_bellman_ford(x, x->reset_st_pos) == 0 )
+  xbm_walk_bfs(w, x->reset_st_pos);
+  
+  tr_pos = -1;
+  while( xbm_LoopTr(x, &tr_pos) != 0 )
+    w->visit_max[tr_pos] = xbm_GetTrVisitMax(x, tr_pos);
+
+  /* each part gets a block of states in the order of the distance */
+  if ( w->part_cnt > w->order_cnt )
+    w->part_cnt = w->order_cnt;
+  if ( w->part_cnt < 1 )
+    w->part_cnt = 1;
+  for( i = 0; i < w->order_cnt; i++ )
+    w->part[w->order[i]] = (int)(((long)i*(long)w->part_cnt)/(long)w->order_cnt);
+
+  w->steps = (b_il_type *)calloc(w->part_cnt, sizeof(b_il_type));
+  if ( w->steps == NULL )
     return 0;
-    
-  /* reset all transitions */
-  xbm_init_walk(x);
+  for( i = 0; i < w->part_cnt; i++ )
+    if ( (w->steps[i] = b_il_Open()) == NULL )
+      return 0;
+  
+  if ( is_hop != 0 )
+    if ( xbm_walk_hop(w, thread_cnt) == 0 )
+      return 0;
 
   /* setup has finished, walk starts here */    
+  return b_th_Do(thread_cnt, w->part_cnt, xbm_walk_part_th, (void *)w);
+}
 
-  /* start walking from the reset state first */
-  if ( xbm_do_walk_loop(x, x->reset_st_pos) == 0 )
-    return 0;
+/*
+  Calculates a walk through all transitions, the states are split into 
+  part_cnt parts, which are walked independently (thread_cnt: see b_th_Do).
+  is_hop: continue the walk along shortest paths instead of a reset,
+  if possible (requires a table with states*states entries).
+  xbm_BuildTransferFunction() must have been called before.
+*/
+xbm_walk_type xbm_OpenWalk(xbm_type x, int part_cnt, int is_hop, int thread_cnt)
+{
+  xbm_walk_type w;
+  
+  /* a reset state is really required */
+  if ( x->pi_machine == NULL || x->cl_machine == NULL || x->reset_st_pos < 0 )
+    return NULL;
+  
+  w = (xbm_walk_type)malloc(sizeof(struct _xbm_walk_struct));
+  if ( w != NULL )
+  {
+    w->x = x;
+    w->part_cnt = part_cnt;
+    w->p_tr = NULL;
+    w->order = NULL;
+    w->part = NULL;
+    w->visit_max = NULL;
+    if ( xbm_walk_init(w, is_hop, thread_cnt) != 0 )
+    {
+      xbm_Log(x, 2, "XBM: Walk with %d part(s), %d step(s) in part 0.", 
+        w->part_cnt, b_il_GetCnt(w->steps[0])/3);
+      return w;
+    }
+    xbm_CloseWalk(w);
+  }
+  return NULL;
+}
 
-  /* start walking from the remaining states */  
-  st_pos = -1;
-  while( xbm_LoopSt(x, &st_pos) != 0 )
-    if ( xbm_do_walk_loop(x, st_pos) == 0 )
-      return 0;
+/* cs, ct: x->pi_machine */
+int xbm_DoWalkPart(xbm_walk_type w, int part, int (*walk_cb)(xbm_type x, void *data, int tr_pos, dcube *cs, dcube *ct, int is_reset, int is_unique), void *data)
+{
+  xbm_type x = w->x;
+  b_il_type steps = w->steps[part];
+  dcube *cs = &(x->pi_machine->tmp[3]);
+  dcube *ct = &(x->pi_machine->tmp[4]);
+  int i, tr_pos, flags;
   
+  for( i = 0; i < b_il_GetCnt(steps); i += 3 )
+  {
+    tr_pos = b_il_GetVal(steps, i);
+    flags = b_il_GetVal(steps, i+2);
+    xbm_GetNthTrVec(x, tr_pos, cs, ct, b_il_GetVal(steps, i+1));
+    if ( walk_cb(x, data, tr_pos, cs, ct, 
+        (flags & XBM_WALK_RESET) != 0 ? 1 : 0, 
+        (flags & XBM_WALK_UNIQUE) != 0 ? 1 : 0) == 0 )
+      return 0;
+  }
   return 1;
 }
 
 /* cs, ct: x->pi_machine */
 int xbm_DoWalk(xbm_type x, int (*walk_cb)(xbm_type x, void *data, int tr_pos, dcube *cs, dcube *ct, int is_reset, int is_unique), void *data)
 {
-  if ( x->pi_machine == NULL || x->cl_machine == NULL )
+  xbm_walk_type w;
+  int r;
+  w = xbm_OpenWalk(x, 1, 0, 1);
+  if ( w == NULL )
     return 0;
-  x->walk_cb = walk_cb;
-  x->walk_data = data;
-  return xbm_do_walk(x);
+  r = xbm_DoWalkPart(w, 0, walk_cb, data);
+  xbm_CloseWalk(w);
+  return r;
 }
 
 /*---------------------------------------------------------------------------*/
@@ -0,0 +1,691 @@
+/*
+
+  zdd.c
+
+  reduced ordered binary decision diagrams (BDD) and
+  zero-suppressed decision diagrams (ZDD)
+
+  Copyright (C) 2001 Oliver Kraus (olikraus@yahoo.com)
+
+  This file is part of DGC.
+
+  DGC is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 2 of the License, or
+  (at your option) any later version.
+
+  DGC is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with DGC; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+
+  [1] Shin-ichi Minato, "Zero-Suppressed BDDs for Set Manipulation in
+      Combinatorial Problems", 1993
+
+  [2] Olivier Coudert, Jean Christophe Madre, "Implicit and Incremental
+      Computation of Primes and Essential Primes of Boolean Functions", 1992
+
+*/
+
+#include <stdlib.h>
+#include <limits.h>
+#include <assert.h>
+#include "zdd.h"
+#include "mwc.h"
+
+#define ZDD_VAR_TERMINAL INT_MAX
+
+#define ZDD_HASH_INIT (1<<12)
+#define ZDD_CACHE_SIZE (1<<18)
+#define ZDD_NODE_EXPAND 4096
+
+#define ZDD_OP_BDD_NOT 1
+#define ZDD_OP_BDD_AND 2
+#define ZDD_OP_BDD_OR 3
+#define ZDD_OP_BDD_COF 4
+#define ZDD_OP_UNION 5
+#define ZDD_OP_DIFF 6
+#define ZDD_OP_PRIMES 7
+#define ZDD_OP_COVER 8
+#define ZDD_OP_COVER2 9
+#define ZDD_OP_INTERSECTING 10
+#define ZDD_OP_SUBSET0 11
+#define ZDD_OP_SUBSET1 12
+#define ZDD_OP_MINIMAL 13
+#define ZDD_OP_NOT_SUP 14
+#define ZDD_OP_JOIN 15
+#define ZDD_OP_MEET 16
+#define ZDD_OP_ELEMENTS 17
+#define ZDD_OP_COMMON 18
+/* ZDD_OP_ROW_SETS + 32*var_cnt */
+#define ZDD_OP_ROW_SETS 19
+
+/*---------------------------------------------------------------------------*/
+
+static int zdd_hash(zdd_type z, int var, int lo, int hi)
+{
+  unsigned h;
+  h = (unsigned)var*12582917U + (unsigned)lo*4256249U + (unsigned)hi*741457U;
+  h ^= h >> 15;
+  return (int)(h & (unsigned)z->hash_mask);
+}
+
+static int zdd_rehash(zdd_type z)
+{
+  int *hash;
+  int i, size, h;
+  size = (z->hash_mask+1)*2;
+  hash = (int *)malloc(size*sizeof(int));
+  if ( hash == NULL )
+    return 0;
+  free(z->hash);
+  z->hash = hash;
+  z->hash_mask = size-1;
+  for( i = 0; i < size; i++ )
+    z->hash[i] = -1;
+  for( i = 2; i < z->node_cnt; i++ )
+  {
+    h = zdd_hash(z, z->node[i].var, z->node[i].lo, z->node[i].hi);
+    z->node[i].next = z->hash[h];
+    z->hash[h] = i;
+  }
+  return 1;
+}
+
+/* find or create a node, no reduction */
+static int zdd_find_node(zdd_type z, int var, int lo, int hi)
+{
+  int h, n;
+  void *ptr;
+
+  if ( z->is_overflow != 0 )
+    return 0;
+
+  h = zdd_hash(z, var, lo, hi);
+  for( n = z->hash[h]; n >= 0; n = z->node[n].next )
+    if ( z->node[n].var == var && z->node[n].lo == lo && z->node[n].hi == hi )
+      return n;
+
+  if ( z->node_limit > 0 && z->node_cnt >= z->node_limit )
+  {
+    z->is_overflow = 1;
+    return 0;
+  }
+
+  if ( z->node_cnt >= z->node_max )
+  {
+    ptr = realloc(z->node, (z->node_max+ZDD_NODE_EXPAND)*sizeof(struct _zdd_node_struct));
+    if ( ptr == NULL )
+    {
+      z->is_overflow = 1;
+      return 0;
+    }
+    z->node = (struct _zdd_node_struct *)ptr;
+    z->node_max += ZDD_NODE_EXPAND;
+  }
+
+  n = z->node_cnt++;
+  z->node[n].var = var;
+  z->node[n].lo = lo;
+  z->node[n].hi = hi;
+  z->node[n].next = z->hash[h];
+  z->hash[h] = n;
+
+  if ( z->node_cnt > 2*(z->hash_mask+1) )
+    if ( zdd_rehash(z) == 0 )
+      z->is_overflow = 1;
+
+  return n;
+}
+
+static int bdd_mk(zdd_type z, int var, int lo, int hi)
+{
+  if ( lo == hi )
+    return lo;
+  return zdd_find_node(z, var, lo, hi);
+}
+
+static int zdd_mk(zdd_type z, int var, int lo, int hi)
+{
+  if ( hi == ZDD_EMPTY )
+    return lo;
+  return zdd_find_node(z, var, lo, hi);
+}
+
+static int zdd_cache_find(zdd_type z, int op, int a, int b, int *r)
+{
+  unsigned h = ((unsigned)op*2654435761U) ^ ((unsigned)a*40503U) ^ ((unsigned)b*9973U);
+  struct _zdd_cache_struct *c = z->cache + (h & (unsigned)z->cache_mask);
+  if ( c->op == op && c->a == a && c->b == b )
+  {
+    *r = c->r;
+    return 1;
+  }
+  return 0;
+}
+
+static int zdd_cache_store(zdd_type z, int op, int a, int b, int r)
+{
+  unsigned h = ((unsigned)op*2654435761U) ^ ((unsigned)a*40503U) ^ ((unsigned)b*9973U);
+  struct _zdd_cache_struct *c = z->cache + (h & (unsigned)z->cache_mask);
+  if ( z->is_overflow != 0 )
+    return 0;
+  c->op = op;
+  c->a = a;
+  c->b = b;
+  c->r = r;
+  return r;
+}
+
+/*---------------------------------------------------------------------------*/
+
+zdd_type zddOpen(int node_limit)
+{
+  zdd_type z;
+  int i;
+  z = (zdd_type)malloc(sizeof(struct _zdd_struct));
+  if ( z != NULL )
+  {
+    z->node_limit = node_limit;
+    z->is_overflow = 0;
+    z->node_max = ZDD_NODE_EXPAND;
+    z->node_cnt = 2;
+    z->node = (struct _zdd_node_struct *)malloc(z->node_max*sizeof(struct _zdd_node_struct));
+    if ( z->node != NULL )
+    {
+      for( i = 0; i < 2; i++ )
+      {
+        z->node[i].var = ZDD_VAR_TERMINAL;
+        z->node[i].lo = i;
+        z->node[i].hi = i;
+        z->node[i].next = -1;
+      }
+      z->hash_mask = ZDD_HASH_INIT-1;
+      z->hash = (int *)malloc(ZDD_HASH_INIT*sizeof(int));
+      if ( z->hash != NULL )
+      {
+        for( i = 0; i < ZDD_HASH_INIT; i++ )
+          z->hash[i] = -1;
+        z->cache_mask = ZDD_CACHE_SIZE-1;
+        z->cache = (struct _zdd_cache_struct *)malloc(ZDD_CACHE_SIZE*sizeof(struct _zdd_cache_struct));
+        if ( z->cache != NULL )
+        {
+          for( i = 0; i < ZDD_CACHE_SIZE; i++ )
+            z->cache[i].op = 0;
+          return z;
+        }
+        free(z->hash);
+      }
+      free(z->node);
+    }
+    free(z);
+  }
+  return NULL;
+}
+
+void zddClose(zdd_type z)
+{
+  free(z->cache);
+  free(z->hash);
+  free(z->node);
+  free(z);
+}
+
+/*--- BDD -------------------------------------------------------------------*/
+
+int bddVar(zdd_type z, int v)
+{
+  return bdd_mk(z, v, BDD_FALSE, BDD_TRUE);
+}
+
+int bddNot(zdd_type z, int a)
+{
+  int r;
+  if ( a == BDD_FALSE )
+    return BDD_TRUE;
+  if ( a == BDD_TRUE )
+    return BDD_FALSE;
+  if ( zdd_cache_find(z, ZDD_OP_BDD_NOT, a, 0, &r) != 0 )
+    return r;
+  r = bdd_mk(z, zddVar(z, a), bddNot(z, zddLo(z, a)), bddNot(z, zddHi(z, a)));
+  return zdd_cache_store(z, ZDD_OP_BDD_NOT, a, 0, r);
+}
+
+static int bdd_apply(zdd_type z, int op, int a, int b)
+{
+  int r, v, t;
+  int a0, a1, b0, b1;
+
+  if ( op == ZDD_OP_BDD_AND )
+  {
+    if ( a == BDD_FALSE || b == BDD_FALSE )
+      return BDD_FALSE;
+    if ( a == BDD_TRUE || a == b )
+      return b;
+    if ( b == BDD_TRUE )
+      return a;
+  }
+  else
+  {
+    if ( a == BDD_TRUE || b == BDD_TRUE )
+      return BDD_TRUE;
+    if ( a == BDD_FALSE || a == b )
+      return b;
+    if ( b == BDD_FALSE )
+      return a;
+  }
+
+  if ( a > b )
+  {
+    t = a; a = b; b = t;
+  }
+  if ( zdd_cache_find(z, op, a, b, &r) != 0 )
+    return r;
+
+  v = zddVar(z, a) < zddVar(z, b) ? zddVar(z, a) : zddVar(z, b);
+  a0 = zddVar(z, a) == v ? zddLo(z, a) : a;
+  a1 = zddVar(z, a) == v ? zddHi(z, a) : a;
+  b0 = zddVar(z, b) == v ? zddLo(z, b) : b;
+  b1 = zddVar(z, b) == v ? zddHi(z, b) : b;
+  r = bdd_mk(z, v, bdd_apply(z, op, a0, b0), bdd_apply(z, op, a1, b1));
+  return zdd_cache_store(z, op, a, b, r);
+}
+
+int bddAnd(zdd_type z, int a, int b)
+{
+  return bdd_apply(z, ZDD_OP_BDD_AND, a, b);
+}
+
+int bddOr(zdd_type z, int a, int b)
+{
+  return bdd_apply(z, ZDD_OP_BDD_OR, a, b);
+}
+
+/* restrict variable 'v' to 'val' (0 or 1) */
+int bddCofactor(zdd_type z, int a, int v, int val)
+{
+  int r;
+  if ( zddVar(z, a) > v )
+    return a;
+  if ( zddVar(z, a) == v )
+    return val != 0 ? zddHi(z, a) : zddLo(z, a);
+  if ( zdd_cache_find(z, ZDD_OP_BDD_COF, a, v*2+val, &r) != 0 )
+    return r;
+  r = bdd_mk(z, zddVar(z, a),
+    bddCofactor(z, zddLo(z, a), v, val),
+    bddCofactor(z, zddHi(z, a), v, val));
+  return zdd_cache_store(z, ZDD_OP_BDD_COF, a, v*2+val, r);
+}
+
+/*--- ZDD -------------------------------------------------------------------*/
+
+int zddUnion(zdd_type z, int a, int b)
+{
+  int r, t;
+  if ( a == ZDD_EMPTY )
+    return b;
+  if ( b == ZDD_EMPTY || a == b )
+    return a;
+  if ( a > b )
+  {
+    t = a; a = b; b = t;
+  }
+  if ( zdd_cache_find(z, ZDD_OP_UNION, a, b, &r) != 0 )
+    return r;
+  if ( zddVar(z, a) < zddVar(z, b) )
+    r = zdd_mk(z, zddVar(z, a), zddUnion(z, zddLo(z, a), b), zddHi(z, a));
+  else if ( zddVar(z, a) > zddVar(z, b) )
+    r = zdd_mk(z, zddVar(z, b), zddUnion(z, a, zddLo(z, b)), zddHi(z, b));
+  else
+    r = zdd_mk(z, zddVar(z, a),
+      zddUnion(z, zddLo(z, a), zddLo(z, b)),
+      zddUnion(z, zddHi(z, a), zddHi(z, b)));
+  return zdd_cache_store(z, ZDD_OP_UNION, a, b, r);
+}
+
+int zddDiff(zdd_type z, int a, int b)
+{
+  int r;
+  if ( a == ZDD_EMPTY || a == b )
+    return ZDD_EMPTY;
+  if ( b == ZDD_EMPTY )
+    return a;
+  if ( zdd_cache_find(z, ZDD_OP_DIFF, a, b, &r) != 0 )
+    return r;
+  if ( zddVar(z, a) < zddVar(z, b) )
+    r = zdd_mk(z, zddVar(z, a), zddDiff(z, zddLo(z, a), b), zddHi(z, a));
+  else if ( zddVar(z, a) > zddVar(z, b) )
+    r = zddDiff(z, a, zddLo(z, b));
+  else
+    r = zdd_mk(z, zddVar(z, a),
+      zddDiff(z, zddLo(z, a), zddLo(z, b)),
+      zddDiff(z, zddHi(z, a), zddHi(z, b)));
+  return zdd_cache_store(z, ZDD_OP_DIFF, a, b, r);
+}
+
+/* add literal 'lit' to all cubes of 'a', 'lit' must be above all literals of 'a' */
+int zddAddLiteral(zdd_type z, int lit, int a)
+{
+  assert( lit < zddVar(z, a) );
+  return zdd_mk(z, lit, ZDD_EMPTY, a);
+}
+
+static double zdd_count(zdd_type z, int a, double *cnt)
+{
+  if ( a == ZDD_EMPTY )
+    return 0.0;
+  if ( a == ZDD_BASE )
+    return 1.0;
+  if ( cnt[a] < 0.0 )
+    cnt[a] = zdd_count(z, zddLo(z, a), cnt) + zdd_count(z, zddHi(z, a), cnt);
+  return cnt[a];
+}
+
+/* number of cubes in 'a' */
+double zddCount(zdd_type z, int a)
+{
+  double *cnt;
+  double r;
+  int i;
+  cnt = (double *)malloc(z->node_cnt*sizeof(double));
+  if ( cnt == NULL )
+    return -1.0;
+  for( i = 0; i < z->node_cnt; i++ )
+    cnt[i] = -1.0;
+  r = zdd_count(z, a, cnt);
+  free(cnt);
+  return r;
+}
+
+/*--- BDD <--> ZDD ----------------------------------------------------------*/
+
+/*
+  prime implicants, reference [2]
+  f = !x f0 + x f1
+  P(f) = P(f0 f1) + !x (P(f0) - P(f0 f1)) + x (P(f1) - P(f0 f1))
+*/
+int zddPrimes(zdd_type z, int f)
+{
+  int r, v;
+  int pc, p0, p1;
+  if ( f == BDD_FALSE )
+    return ZDD_EMPTY;
+  if ( f == BDD_TRUE )
+    return ZDD_BASE;
+  if ( zdd_cache_find(z, ZDD_OP_PRIMES, f, 0, &r) != 0 )
+    return r;
+  v = zddVar(z, f);
+  pc = zddPrimes(z, bddAnd(z, zddLo(z, f), zddHi(z, f)));
+  p0 = zddDiff(z, zddPrimes(z, zddLo(z, f)), pc);
+  p1 = zddDiff(z, zddPrimes(z, zddHi(z, f)), pc);
+  r = zddUnion(z, pc, zddUnion(z,
+    zdd_mk(z, ZDD_POS(v), ZDD_EMPTY, p1),
+    zdd_mk(z, ZDD_NEG(v), ZDD_EMPTY, p0)));
+  return zdd_cache_store(z, ZDD_OP_PRIMES, f, 0, r);
+}
+
+static int zdd_literal_bdd(zdd_type z, int lit)
+{
+  if ( (lit & 1) == 0 )
+    return bdd_mk(z, lit/2, BDD_FALSE, BDD_TRUE);
+  return bdd_mk(z, lit/2, BDD_TRUE, BDD_FALSE);
+}
+
+int zddCover(zdd_type z, int a)
+{
+  int r;
+  if ( a == ZDD_EMPTY )
+    return BDD_FALSE;
+  if ( a == ZDD_BASE )
+    return BDD_TRUE;
+  if ( zdd_cache_find(z, ZDD_OP_COVER, a, 0, &r) != 0 )
+    return r;
+  r = bddOr(z, zddCover(z, zddLo(z, a)),
+    bddAnd(z, zdd_literal_bdd(z, zddVar(z, a)), zddCover(z, zddHi(z, a))));
+  return zdd_cache_store(z, ZDD_OP_COVER, a, 0, r);
+}
+
+/*
+  a = L + x H
+  C2(a) = C2(L) + x (C2(H) + C1(L) C1(H))
+*/
+int zddCoverTwice(zdd_type z, int a)
+{
+  int r, t;
+  if ( a == ZDD_EMPTY || a == ZDD_BASE )
+    return BDD_FALSE;
+  if ( zdd_cache_find(z, ZDD_OP_COVER2, a, 0, &r) != 0 )
+    return r;
+  t = bddAnd(z, zddCover(z, zddLo(z, a)), zddCover(z, zddHi(z, a)));
+  t = bddOr(z, zddCoverTwice(z, zddHi(z, a)), t);
+  t = bddAnd(z, zdd_literal_bdd(z, zddVar(z, a)), t);
+  r = bddOr(z, zddCoverTwice(z, zddLo(z, a)), t);
+  return zdd_cache_store(z, ZDD_OP_COVER2, a, 0, r);
+}
+
+int zddIntersecting(zdd_type z, int a, int f)
+{
+  int r, lit;
+  if ( a == ZDD_EMPTY || f == BDD_FALSE )
+    return ZDD_EMPTY;
+  if ( a == ZDD_BASE )
+    return ZDD_BASE;  /* f is not empty */
+  if ( zdd_cache_find(z, ZDD_OP_INTERSECTING, a, f, &r) != 0 )
+    return r;
+  lit = zddVar(z, a);
+  r = zdd_mk(z, lit,
+    zddIntersecting(z, zddLo(z, a), f),
+    zddIntersecting(z, zddHi(z, a), bddCofactor(z, f, lit/2, (lit&1)==0?1:0)));
+  return zdd_cache_store(z, ZDD_OP_INTERSECTING, a, f, r);
+}
+
+/*--- covering problems ------------------------------------------------------*/
+
+/* all sets of 'a', which do not contain 'v' */
+int zddSubset0(zdd_type z, int a, int v)
+{
+  int r;
+  if ( zddVar(z, a) > v )
+    return a;
+  if ( zddVar(z, a) == v )
+    return zddLo(z, a);
+  if ( zdd_cache_find(z, ZDD_OP_SUBSET0, a, v, &r) != 0 )
+    return r;
+  r = zdd_mk(z, zddVar(z, a),
+    zddSubset0(z, zddLo(z, a), v),
+    zddSubset0(z, zddHi(z, a), v));
+  return zdd_cache_store(z, ZDD_OP_SUBSET0, a, v, r);
+}
+
+/* all sets of 'a', which contain 'v', with 'v' removed */
+int zddSubset1(zdd_type z, int a, int v)
+{
+  int r;
+  if ( zddVar(z, a) > v )
+    return ZDD_EMPTY;
+  if ( zddVar(z, a) == v )
+    return zddHi(z, a);
+  if ( zdd_cache_find(z, ZDD_OP_SUBSET1, a, v, &r) != 0 )
+    return r;
+  r = zdd_mk(z, zddVar(z, a),
+    zddSubset1(z, zddLo(z, a), v),
+    zddSubset1(z, zddHi(z, a), v));
+  return zdd_cache_store(z, ZDD_OP_SUBSET1, a, v, r);
+}
+
+/* returns 1, if 'a' contains the empty set */
+int zddHasEmpty(zdd_type z, int a)
+{
+  while( a != ZDD_EMPTY && a != ZDD_BASE )
+    a = zddLo(z, a);
+  return a == ZDD_BASE ? 1 : 0;
+}
+
+/* all sets of 'a', which are not a superset of a set of 'b' */
+static int zdd_not_sup(zdd_type z, int a, int b)
+{
+  int r, v, a0, a1, b0, b1;
+  if ( a == ZDD_EMPTY || b == ZDD_EMPTY )
+    return a;
+  if ( zddHasEmpty(z, b) != 0 || a == b )
+    return ZDD_EMPTY;
+  if ( a == ZDD_BASE )
+    return ZDD_BASE;
+  if ( zdd_cache_find(z, ZDD_OP_NOT_SUP, a, b, &r) != 0 )
+    return r;
+  v = zddVar(z, a) < zddVar(z, b) ? zddVar(z, a) : zddVar(z, b);
+  a0 = zddSubset0(z, a, v);
+  a1 = zddSubset1(z, a, v);
+  b0 = zddSubset0(z, b, v);
+  b1 = zddSubset1(z, b, v);
+  r = zdd_mk(z, v, zdd_not_sup(z, a0, b0),
+    zdd_not_sup(z, a1, zddUnion(z, b0, b1)));
+  return zdd_cache_store(z, ZDD_OP_NOT_SUP, a, b, r);
+}
+
+/*
+  all sets of 'a', which do not contain another set of 'a'
+  a = L + x H
+  M(a) = M(L) + x (M(H) - supersets of M(L))
+*/
+int zddMinimal(zdd_type z, int a)
+{
+  int r, lo;
+  if ( a == ZDD_EMPTY || a == ZDD_BASE )
+    return a;
+  if ( zddHasEmpty(z, a) != 0 )
+    return ZDD_BASE;
+  if ( zdd_cache_find(z, ZDD_OP_MINIMAL, a, 0, &r) != 0 )
+    return r;
+  lo = zddMinimal(z, zddLo(z, a));
+  r = zdd_mk(z, zddVar(z, a), lo,
+    zdd_not_sup(z, zddMinimal(z, zddHi(z, a)), lo));
+  return zdd_cache_store(z, ZDD_OP_MINIMAL, a, 0, r);
+}
+
+/* union of the single sets 'a' and 'b' */
+static int zdd_join(zdd_type z, int a, int b)
+{
+  int r;
+  if ( a == ZDD_BASE || a == b )
+    return b;
+  if ( b == ZDD_BASE )
+    return a;
+  if ( zdd_cache_find(z, ZDD_OP_JOIN, a, b, &r) != 0 )
+    return r;
+  if ( zddVar(z, a) < zddVar(z, b) )
+    r = zdd_mk(z, zddVar(z, a), ZDD_EMPTY, zdd_join(z, zddHi(z, a), b));
+  else if ( zddVar(z, a) > zddVar(z, b) )
+    r = zdd_mk(z, zddVar(z, b), ZDD_EMPTY, zdd_join(z, a, zddHi(z, b)));
+  else
+    r = zdd_mk(z, zddVar(z, a), ZDD_EMPTY, zdd_join(z, zddHi(z, a), zddHi(z, b)));
+  return zdd_cache_store(z, ZDD_OP_JOIN, a, b, r);
+}
+
+/* intersection of the single sets 'a' and 'b' */
+static int zdd_meet(zdd_type z, int a, int b)
+{
+  int r;
+  if ( a == ZDD_BASE || b == ZDD_BASE )
+    return ZDD_BASE;
+  if ( a == b )
+    return a;
+  if ( zdd_cache_find(z, ZDD_OP_MEET, a, b, &r) != 0 )
+    return r;
+  if ( zddVar(z, a) < zddVar(z, b) )
+    r = zdd_meet(z, zddHi(z, a), b);
+  else if ( zddVar(z, a) > zddVar(z, b) )
+    r = zdd_meet(z, a, zddHi(z, b));
+  else
+    r = zdd_mk(z, zddVar(z, a), ZDD_EMPTY, zdd_meet(z, zddHi(z, a), zddHi(z, b)));
+  return zdd_cache_store(z, ZDD_OP_MEET, a, b, r);
+}
+
+/* single set with all elements of all sets of 'a' */
+static int zdd_elements(zdd_type z, int a)
+{
+  int r;
+  if ( a == ZDD_EMPTY || a == ZDD_BASE )
+    return ZDD_BASE;
+  if ( zdd_cache_find(z, ZDD_OP_ELEMENTS, a, 0, &r) != 0 )
+    return r;
+  r = zdd_join(z, zdd_elements(z, zddLo(z, a)),
+    zdd_mk(z, zddVar(z, a), ZDD_EMPTY, zdd_elements(z, zddHi(z, a))));
+  return zdd_cache_store(z, ZDD_OP_ELEMENTS, a, 0, r);
+}
+
+/* single set with the elements, which are part of all sets of 'a' */
+int zddCommon(zdd_type z, int a)
+{
+  int r;
+  if ( a == ZDD_EMPTY || a == ZDD_BASE )
+    return ZDD_BASE;
+  if ( zdd_cache_find(z, ZDD_OP_COMMON, a, 0, &r) != 0 )
+    return r;
+  if ( zddLo(z, a) == ZDD_EMPTY )
+    r = zdd_mk(z, zddVar(z, a), ZDD_EMPTY, zddCommon(z, zddHi(z, a)));
+  else
+    r = zdd_meet(z, zddCommon(z, zddLo(z, a)), zddCommon(z, zddHi(z, a)));
+  return zdd_cache_store(z, ZDD_OP_COMMON, a, 0, r);
+}
+
+/*
+  Each set of 'q' is a cube followed by one or more name variables,
+  the name variables must be >= ZDD_POS(var_cnt). For each minterm of
+  'f', the set of names of the cubes, which contain the minterm, is
+  a set of the result (the rows of the covering problem).
+*/
+int zddRowSets(zdd_type z, int f, int q, int var_cnt)
+{
+  int r, v, op, qp, qn, qd;
+  if ( f == BDD_FALSE )
+    return ZDD_EMPTY;
+  if ( zddVar(z, q) >= ZDD_POS(var_cnt) )
+    return zdd_elements(z, q);
+  op = ZDD_OP_ROW_SETS + 32*var_cnt;
+  if ( zdd_cache_find(z, op, f, q, &r) != 0 )
+    return r;
+  v = zddVar(z, q)/2;
+  if ( zddVar(z, f) < v )
+    v = zddVar(z, f);
+  qp = zddSubset1(z, q, ZDD_POS(v));
+  qn = zddSubset1(z, q, ZDD_NEG(v));
+  qd = zddSubset0(z, zddSubset0(z, q, ZDD_POS(v)), ZDD_NEG(v));
+  r = zddUnion(z,
+    zddRowSets(z, bddCofactor(z, f, v, 0), zddUnion(z, qd, qn), var_cnt),
+    zddRowSets(z, bddCofactor(z, f, v, 1), zddUnion(z, qd, qp), var_cnt));
+  return zdd_cache_store(z, op, f, q, r);
+}
+
+static int zdd_for_each_cube(zdd_type z, int a, int *lit, int cnt, zdd_cube_cb cb, void *data)
+{
+  if ( a == ZDD_EMPTY )
+    return 1;
+  if ( a == ZDD_BASE )
+    return cb(data, lit, cnt);
+  if ( zdd_for_each_cube(z, zddLo(z, a), lit, cnt, cb, data) == 0 )
+    return 0;
+  lit[cnt] = zddVar(z, a);
+  return zdd_for_each_cube(z, zddHi(z, a), lit, cnt+1, cb, data);
+}
+
+int zddForEachCube(zdd_type z, int a, zdd_cube_cb cb, void *data)
+{
+  int *lit;
+  int i, max = 1;
+  int r;
+  for( i = 2; i < z->node_cnt; i++ )
+    if ( max <= z->node[i].var )
+      max = z->node[i].var+1;
+  lit = (int *)malloc(max*sizeof(int));
+  if ( lit == NULL )
+    return 0;
+  r = zdd_for_each_cube(z, a, lit, 0, cb, data);
+  free(lit);
+  return r;
+}
@@ -0,0 +1,138 @@
+/*
+
+  zdd.h
+
+  reduced ordered binary decision diagrams (BDD) and
+  zero-suppressed decision diagrams (ZDD)
+
+  Copyright (C) 2001 Oliver Kraus (olikraus@yahoo.com)
+
+  This file is part of DGC.
+
+  DGC is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 2 of the License, or
+  (at your option) any later version.
+
+  DGC is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with DGC; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+*/
+
+#ifndef _ZDD_H
+#define _ZDD_H
+
+/*
+  BDD and ZDD nodes share one node table. A node is referenced by its
+  index. The meaning of a node depends on the function, which is
+  applied to it:
+
+    node    BDD         ZDD
+    0       false       empty set
+    1       true        set which contains only the empty set
+
+  A BDD variable 'v' corresponds to the ZDD literals ZDD_POS(v) and
+  ZDD_NEG(v). A set of cubes is stored as ZDD over these literals.
+  Variables with a lower number are closer to the root.
+
+  There is no garbage collection: all nodes are released with zddClose().
+  If the node limit is reached, 'is_overflow' is set and all further
+  results are invalid.
+*/
+
+#define ZDD_EMPTY 0
+#define ZDD_BASE 1
+#define BDD_FALSE 0
+#define BDD_TRUE 1
+
+#define ZDD_POS(v) ((v)*2)
+#define ZDD_NEG(v) ((v)*2+1)
+
+struct _zdd_node_struct
+{
+  int var;
+  int lo;
+  int hi;
+  int next;   /* unique table chain */
+};
+
+struct _zdd_cache_struct
+{
+  int op;
+  int a;
+  int b;
+  int r;
+};
+
+struct _zdd_struct
+{
+  struct _zdd_node_struct *node;
+  int node_cnt;
+  int node_max;
+  int node_limit;
+
+  int *hash;
+  int hash_mask;
+
+  struct _zdd_cache_struct *cache;
+  int cache_mask;
+
+  int is_overflow;
+};
+typedef struct _zdd_struct *zdd_type;
+
+/* node_limit <= 0: no limit */
+zdd_type zddOpen(int node_limit);
+void zddClose(zdd_type z);
+
+#define zddIsOverflow(z) ((z)->is_overflow)
+#define zddGetNodeCnt(z) ((z)->node_cnt)
+#define zddVar(z,n) ((z)->node[n].var)
+#define zddLo(z,n) ((z)->node[n].lo)
+#define zddHi(z,n) ((z)->node[n].hi)
+
+/* BDD */
+int bddVar(zdd_type z, int v);
+int bddNot(zdd_type z, int a);
+int bddAnd(zdd_type z, int a, int b);
+int bddOr(zdd_type z, int a, int b);
+int bddCofactor(zdd_type z, int a, int v, int val);
+
+/* ZDD */
+int zddUnion(zdd_type z, int a, int b);
+int zddDiff(zdd_type z, int a, int b);
+int zddAddLiteral(zdd_type z, int lit, int a);
+double zddCount(zdd_type z, int a);
+
+/* BDD --> ZDD: all prime implicants of 'f' */
+int zddPrimes(zdd_type z, int f);
+
+/* ZDD --> BDD: union of all cubes */
+int zddCover(zdd_type z, int a);
+
+/* BDD of all minterms, which are covered by more than one cube of 'a' */
+int zddCoverTwice(zdd_type z, int a);
+
+/* all cubes of 'a', which have a nonempty intersection with 'f' */
+int zddIntersecting(zdd_type z, int a, int f);
+
+/* set operations for covering problems */
+int zddSubset0(zdd_type z, int a, int v);
+int zddSubset1(zdd_type z, int a, int v);
+int zddHasEmpty(zdd_type z, int a);
+int zddMinimal(zdd_type z, int a);
+int zddCommon(zdd_type z, int a);
+int zddRowSets(zdd_type z, int f, int q, int var_cnt);
+
+/* call 'cb' for each cube of 'a', 'lit' contains the literals of the cube */
+/* returns 0, if 'cb' returned 0 */
+typedef int (*zdd_cube_cb)(void *data, int *lit, int cnt);
+int zddForEachCube(zdd_type z, int a, zdd_cube_cb cb, void *data);
+
+#endif /* _ZDD_H */
@@ -0,0 +1,717 @@
+/*
+
+  encanneal.c
+
+  state encoding by simulated annealing
+
+  Copyright (C) 2001 Oliver Kraus (olikraus@yahoo.com)
+
+  This file is part of DGC.
+
+  DGC is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 2 of the License, or
+  (at your option) any later version.
+
+  DGC is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with DGC; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+
+  The input constraints (IC_LIST, see encode_IC_All) are the groups of
+  states, which should be embedded into a face of the code space:
+  The face spanned by the codes of a group should not contain the
+  code of any other state ("intruder") and should not be larger
+  than required.
+
+    cost = sum weight * (SA_INTRUDER_COST * intruders + dim - min_dim)
+
+  A move exchanges the codes of two states or moves a state to an
+  unused code. Each constraint counts the members with a one at each
+  bit position, so the face of a constraint of a moved state is updated
+  with the changed bits only. Each code has a list of the constraints,
+  whose face contains the code: A move to an unused code changes the
+  intruders of the constraints in the lists of the old and the new code
+  only.
+
+  The states of one group (fsm_MinimizeStates) share one code, they
+  are handled as one state. The reset state keeps the zero code.
+  The number of bits is minimal.
+
+*/
+
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include "fsm.h"
+#include "fsmenc.h"
+#include "index_table.h"
+#include "min_symb_list.h"
+#include "ic_list.h"
+#include "mwc.h"
+
+/* weight of a state inside the face of a constraint */
+#define SA_INTRUDER_COST 4
+
+/* largest code width */
+#define SA_WIDTH_MAX 24
+
+/* moves for each temperature: SA_MOVE_FACTOR * number of states */
+#define SA_MOVE_FACTOR 20
+#define SA_COOLING 0.9
+#define SA_STAGE_MAX 200
+
+struct _sa_struct
+{
+  int n;                  /* number of classes (codes) */
+  int width;
+  unsigned long code_cnt; /* 1 << width */
+  int first;              /* first class, which can be moved */
+  unsigned long *code;    /* code of each class */
+  int *slot;              /* class of each code or -1 */
+
+  int c_cnt;              /* number of constraints */
+  int *c_weight;
+  int *c_min_dim;
+  int *c_start;           /* members of constraint c: */
+  int *c_len;             /*   c_member[c_start[c]..c_start[c]+c_len[c]-1] */
+  int *c_member;
+  unsigned long *c_and;   /* face of constraint c: bits which are */
+  unsigned long *c_or;    /*   equal in c_and and c_or */
+  int *c_intr;            /* number of intruders */
+  int *c_ones;            /* c_ones[c*width+b]: members with bit b set */
+
+  int *f_len;             /* constraints, whose face contains code y: */
+  int *f_list;            /*   f_list[y*c_cnt..y*c_cnt+f_len[y]-1] */
+  int *f_pos;             /* f_pos[c*code_cnt+y]: position in f_list or -1 */
+
+  int *n_start;           /* constraints of class k: */
+  int *n_len;             /*   n_list[n_start[k]..n_start[k]+n_len[k]-1] */
+  int *n_list;
+
+  /* move: class t_k from t_x to t_y, class t_l (or -1) from t_y to t_x */
+  int t_k;
+  int t_l;
+  unsigned long t_x;
+  unsigned long t_y;
+  /* move: changed constraints and their new values */
+  int t_cnt;
+  int *t_list;
+  int *t_mark;
+  int t_stamp;
+  unsigned long *t_and;
+  unsigned long *t_or;
+  int *t_intr;
+
+  long cost;
+  unsigned long seed;
+};
+typedef struct _sa_struct *sa_type;
+
+static unsigned long sa_rand(sa_type sa)
+{
+  /* 32 bit linear congruential generator (numerical recipes) */
+  sa->seed = (sa->seed * 1664525UL + 1013904223UL) & 0x0ffffffffUL;
+  return sa->seed >> 8;
+}
+
+static double sa_rand_double(sa_type sa)
+{
+  return (double)sa_rand(sa) / (double)(1UL<<24);
+}
+
+static int sa_bit_cnt(unsigned long x)
+{
+  int cnt = 0;
+  while( x != 0 )
+  {
+    x &= x-1;
+    cnt++;
+  }
+  return cnt;
+}
+
+static int sa_is_in_face(unsigned long x, unsigned long and_mask, unsigned long or_mask)
+{
+  return ((x ^ and_mask) & ~(and_mask ^ or_mask)) == 0 ? 1 : 0;
+}
+
+static long sa_cost(sa_type sa, int c, unsigned long and_mask, unsigned long or_mask, int intr)
+{
+  return (long)sa->c_weight[c] *
+    ((long)SA_INTRUDER_COST*intr + sa_bit_cnt(and_mask^or_mask) - sa->c_min_dim[c]);
+}
+
+/*---------------------------------------------------------------------------*/
+
+static void sa_close(sa_type sa)
+{
+  free(sa->code);
+  free(sa->slot);
+  free(sa->c_weight);
+  free(sa->c_min_dim);
+  free(sa->c_start);
+  free(sa->c_len);
+  free(sa->c_member);
+  free(sa->c_and);
+  free(sa->c_or);
+  free(sa->c_intr);
+  free(sa->c_ones);
+  free(sa->f_len);
+  free(sa->f_list);
+  free(sa->f_pos);
+  free(sa->n_start);
+  free(sa->n_len);
+  free(sa->n_list);
+  free(sa->t_list);
+  free(sa->t_mark);
+  free(sa->t_and);
+  free(sa->t_or);
+  free(sa->t_intr);
+  free(sa);
+}
+
+static sa_type sa_open(int n, int width, int c_cnt, int member_cnt)
+{
+  sa_type sa;
+  int cc = c_cnt > 0 ? c_cnt : 1;
+  sa = (sa_type)calloc(1, sizeof(struct _sa_struct));
+  if ( sa == NULL )
+    return NULL;
+  sa->n = n;
+  sa->width = width;
+  sa->code_cnt = 1UL << width;
+  sa->c_cnt = c_cnt;
+  sa->seed = 1;
+  sa->code = (unsigned long *)malloc(sizeof(unsigned long)*n);
+  sa->slot = (int *)malloc(sizeof(int)*sa->code_cnt);
+  sa->c_weight = (int *)malloc(sizeof(int)*cc);
+  sa->c_min_dim = (int *)malloc(sizeof(int)*cc);
+  sa->c_start = (int *)malloc(sizeof(int)*cc);
+  sa->c_len = (int *)malloc(sizeof(int)*cc);
+  sa->c_member = (int *)malloc(sizeof(int)*(member_cnt+1));
+  sa->c_and = (unsigned long *)malloc(sizeof(unsigned long)*cc);
+  sa->c_or = (unsigned long *)malloc(sizeof(unsigned long)*cc);
+  sa->c_intr = (int *)malloc(sizeof(int)*cc);
+  sa->c_ones = (int *)malloc(sizeof(int)*cc*width);
+  sa->f_len = (int *)calloc(sa->code_cnt, sizeof(int));
+  sa->f_list = (int *)malloc(sizeof(int)*sa->code_cnt*cc);
+  sa->f_pos = (int *)malloc(sizeof(int)*sa->code_cnt*cc);
+  sa->n_start = (int *)malloc(sizeof(int)*n);
+  sa->n_len = (int *)calloc(n, sizeof(int));
+  sa->n_list = (int *)malloc(sizeof(int)*(member_cnt+1));
+  sa->t_list = (int *)malloc(sizeof(int)*cc);
+  sa->t_mark = (int *)calloc(cc, sizeof(int));
+  sa->t_and = (unsigned long *)malloc(sizeof(unsigned long)*cc);
+  sa->t_or = (unsigned long *)malloc(sizeof(unsigned long)*cc);
+  sa->t_intr = (int *)malloc(sizeof(int)*cc);
+  if ( sa->code == NULL || sa->slot == NULL || sa->c_weight == NULL ||
+       sa->c_min_dim == NULL || sa->c_start == NULL || sa->c_len == NULL ||
+       sa->c_member == NULL || sa->c_and == NULL || sa->c_or == NULL ||
+       sa->c_intr == NULL || sa->c_ones == NULL || sa->f_len == NULL ||
+       sa->f_list == NULL || sa->f_pos == NULL || sa->n_start == NULL || sa->n_len == NULL ||
+       sa->n_list == NULL || sa->t_list == NULL || sa->t_mark == NULL ||
+       sa->t_and == NULL || sa->t_or == NULL || sa->t_intr == NULL )
+    return sa_close(sa), (sa_type)NULL;
+  return sa;
+}
+
+/*
+  builds the input constraints for the classes of the states,
+  constraints with less than two or with all classes are ignored
+*/
+static sa_type sa_open_by_fsm(fsm_type fsm, int *class, int class_cnt, int width)
+{
+  INDEX_TABLE tab;
+  MIN_SYMB_LIST constrList;
+  IC_LIST icList, ic;
+  pinfo pConstr;
+  sa_type sa;
+  int *mark;
+  int i, k, c, len, c_cnt, member_cnt, pos;
+
+  tab = index_CreateTable(fsm);
+  if ( tab == NULL )
+    return NULL;
+  pinfoInit(&pConstr);
+  constrList = min_BuildGroups(fsm, tab, &pConstr, "IC_INCLUDE");
+  icList = ic_CreateICList(constrList, &pConstr);
+  mark = (int *)malloc(sizeof(int)*class_cnt);
+
+  /* two passes: count, then fill */
+  sa = NULL;
+  c_cnt = 0;
+  member_cnt = 0;
+  while( mark != NULL )
+  {
+    c = 0;
+    pos = 0;
+    for( ic = icList; ic != NULL; ic = ic->next )
+    {
+      for( k = 0; k < class_cnt; k++ )
+        mark[k] = 0;
+      len = 0;
+      for( i = 0; i < pConstr.out_cnt && i < tab->nr_nodes; i++ )
+        if ( dcGetOut(ic->constraint, i) != 0 )
+        {
+          k = class[index_GetNodeId(tab, i)];
+          if ( mark[k] == 0 )
+          {
+            mark[k] = 1;
+            len++;
+          }
+        }
+      if ( len < 2 || len >= class_cnt )
+        continue;
+      if ( sa != NULL )
+      {
+        sa->c_weight[c] = ic->weight > 0 ? ic->weight : 1;
+        sa->c_min_dim[c] = 0;
+        while( (1<<sa->c_min_dim[c]) < len )
+          sa->c_min_dim[c]++;
+        sa->c_start[c] = pos;
+        sa->c_len[c] = len;
+        for( k = 0; k < class_cnt; k++ )
+          if ( mark[k] != 0 )
+          {
+            sa->c_member[pos++] = k;
+            sa->n_len[k]++;
+          }
+      }
+      else
+      {
+        member_cnt += len;
+      }
+      c++;
+    }
+    if ( sa != NULL )
+      break;
+    c_cnt = c;
+    sa = sa_open(class_cnt, width, c_cnt, member_cnt);
+    if ( sa == NULL )
+      break;
+  }
+
+  free(mark);
+  ic_CloseList(icList);
+  min_CloseList(constrList);
+  pinfoDestroy(&pConstr);
+  index_Close(tab);
+
+  if ( sa == NULL )
+    return NULL;
+
+  /* constraints of each class */
+  pos = 0;
+  for( k = 0; k < class_cnt; k++ )
+  {
+    sa->n_start[k] = pos;
+    pos += sa->n_len[k];
+    sa->n_len[k] = 0;
+  }
+  for( c = 0; c < sa->c_cnt; c++ )
+    for( i = 0; i < sa->c_len[c]; i++ )
+    {
+      k = sa->c_member[sa->c_start[c]+i];
+      sa->n_list[sa->n_start[k]+sa->n_len[k]] = c;
+      sa->n_len[k]++;
+    }
+  return sa;
+}
+
+/*---------------------------------------------------------------------------*/
+
+/* number of classes, which have a code inside the face */
+static int sa_face_cnt(sa_type sa, unsigned long and_mask, unsigned long or_mask)
+{
+  unsigned long d = and_mask ^ or_mask;
+  unsigned long s;
+  int k, cnt = 0;
+  if ( (1UL << sa_bit_cnt(d)) < (unsigned long)sa->n )
+  {
+    s = 0;
+    do
+    {
+      if ( sa->slot[and_mask | s] >= 0 )
+        cnt++;
+      s = (s - d) & d;
+    } while( s != 0 );
+  }
+  else
+  {
+    for( k = 0; k < sa->n; k++ )
+      cnt += sa_is_in_face(sa->code[k], and_mask, or_mask);
+  }
+  return cnt;
+}
+
+/* add constraint c to the lists of the codes of its face */
+static void sa_face_add(sa_type sa, int c)
+{
+  unsigned long d = sa->c_and[c] ^ sa->c_or[c];
+  unsigned long s = 0, y;
+  do
+  {
+    y = sa->c_and[c] | s;
+    sa->f_pos[(size_t)c*sa->code_cnt+y] = sa->f_len[y];
+    sa->f_list[(size_t)y*sa->c_cnt+sa->f_len[y]] = c;
+    sa->f_len[y]++;
+    s = (s - d) & d;
+  } while( s != 0 );
+}
+
+/* remove constraint c from the lists of the codes of its face */
+static void sa_face_remove(sa_type sa, int c)
+{
+  unsigned long d = sa->c_and[c] ^ sa->c_or[c];
+  unsigned long s = 0, y;
+  int pos, last;
+  do
+  {
+    y = sa->c_and[c] | s;
+    pos = sa->f_pos[(size_t)c*sa->code_cnt+y];
+    sa->f_len[y]--;
+    last = sa->f_list[(size_t)y*sa->c_cnt+sa->f_len[y]];
+    sa->f_list[(size_t)y*sa->c_cnt+pos] = last;
+    sa->f_pos[(size_t)last*sa->code_cnt+y] = pos;
+    s = (s - d) & d;
+  } while( s != 0 );
+}
+
+/* update the bit counts of constraint c, a member moves from code x to code y */
+static void sa_move_ones(sa_type sa, int c, unsigned long x, unsigned long y)
+{
+  int b;
+  for( b = 0; b < sa->width; b++ )
+    if ( ((x ^ y) & (1UL<<b)) != 0 )
+      sa->c_ones[c*sa->width+b] += (y & (1UL<<b)) != 0 ? 1 : -1;
+}
+
+static void sa_init_cost(sa_type sa)
+{
+  unsigned long y;
+  int c, i, b, k;
+  for( c = 0; c < sa->c_cnt; c++ )
+  {
+    for( b = 0; b < sa->width; b++ )
+      sa->c_ones[c*sa->width+b] = 0;
+    sa->c_and[c] = ~0UL;
+    sa->c_or[c] = 0UL;
+    for( i = 0; i < sa->c_len[c]; i++ )
+    {
+      k = sa->c_member[sa->c_start[c]+i];
+      sa_move_ones(sa, c, 0UL, sa->code[k]);
+      sa->c_and[c] &= sa->code[k];
+      sa->c_or[c] |= sa->code[k];
+    }
+  }
+  for( y = 0; y < sa->code_cnt*(unsigned long)sa->c_cnt; y++ )
+    sa->f_pos[y] = -1;
+  sa->cost = 0;
+  for( c = 0; c < sa->c_cnt; c++ )
+  {
+    sa->c_intr[c] = sa_face_cnt(sa, sa->c_and[c], sa->c_or[c]) - sa->c_len[c];
+    sa_face_add(sa, c);
+    sa->cost += sa_cost(sa, c, sa->c_and[c], sa->c_or[c], sa->c_intr[c]);
+  }
+}
+
+static void sa_touch(sa_type sa, int c, unsigned long and_mask, unsigned long or_mask, int intr)
+{
+  sa->t_mark[c] = sa->t_stamp;
+  sa->t_list[sa->t_cnt] = c;
+  sa->t_and[sa->t_cnt] = and_mask;
+  sa->t_or[sa->t_cnt] = or_mask;
+  sa->t_intr[sa->t_cnt] = intr;
+  sa->t_cnt++;
+}
+
+/* exchange the codes of class k and the class at code y (or the unused code y) */
+static void sa_exchange(sa_type sa, int k, unsigned long y)
+{
+  unsigned long x = sa->code[k];
+  int l = sa->slot[y];
+  sa->code[k] = y;
+  sa->slot[y] = k;
+  sa->slot[x] = l;
+  if ( l >= 0 )
+    sa->code[l] = x;
+}
+
+/*
+  a member of constraint c moves from code x to code y, the codes are
+  already exchanged: only the bits of x^y of the face are checked
+*/
+static void sa_try_member(sa_type sa, int c, unsigned long x, unsigned long y)
+{
+  unsigned long a = sa->c_and[c];
+  unsigned long o = sa->c_or[c];
+  int b, ones;
+  sa->t_mark[c] = sa->t_stamp;
+  for( b = 0; b < sa->width; b++ )
+    if ( ((x ^ y) & (1UL<<b)) != 0 )
+    {
+      ones = sa->c_ones[c*sa->width+b] + ((y & (1UL<<b)) != 0 ? 1 : -1);
+      if ( ones == sa->c_len[c] )
+        a |= 1UL<<b;
+      else
+        a &= ~(1UL<<b);
+      if ( ones > 0 )
+        o |= 1UL<<b;
+      else
+        o &= ~(1UL<<b);
+    }
+  /* same face: the number of codes inside the face is not changed */
+  if ( a != sa->c_and[c] || o != sa->c_or[c] )
+    sa_touch(sa, c, a, o, sa_face_cnt(sa, a, o) - sa->c_len[c]);
+}
+
+/*
+  moves class k to code y and returns the change of the cost,
+  the new values of the changed constraints are stored in t_list
+*/
+static long sa_try(sa_type sa, int k, unsigned long y)
+{
+  unsigned long x = sa->code[k];
+  int l = sa->slot[y];
+  int i, c, intr;
+  long delta = 0;
+
+  sa_exchange(sa, k, y);
+
+  sa->t_k = k;
+  sa->t_l = l;
+  sa->t_x = x;
+  sa->t_y = y;
+  sa->t_cnt = 0;
+  sa->t_stamp += 2;
+
+  /* t_stamp-1: constraint of l, t_stamp: done */
+  if ( l >= 0 )
+    for( i = 0; i < sa->n_len[l]; i++ )
+      sa->t_mark[sa->n_list[sa->n_start[l]+i]] = sa->t_stamp-1;
+  for( i = 0; i < sa->n_len[k]; i++ )
+  {
+    c = sa->n_list[sa->n_start[k]+i];
+    if ( sa->t_mark[c] == sa->t_stamp-1 )
+      sa->t_mark[c] = sa->t_stamp;  /* k and l: face is not changed */
+    else
+      sa_try_member(sa, c, x, y);
+  }
+  if ( l >= 0 )
+  {
+    for( i = 0; i < sa->n_len[l]; i++ )
+    {
+      c = sa->n_list[sa->n_start[l]+i];
+      if ( sa->t_mark[c] != sa->t_stamp )
+        sa_try_member(sa, c, y, x);
+    }
+  }
+  else
+  {
+    /* the face of the other constraints is not changed, but k may leave or enter */
+    for( i = 0; i < sa->f_len[y]; i++ )
+    {
+      c = sa->f_list[(size_t)y*sa->c_cnt+i];
+      if ( sa->t_mark[c] == sa->t_stamp )
+        continue;
+      intr = sa->c_intr[c] + 1 - sa_is_in_face(x, sa->c_and[c], sa->c_or[c]);
+      if ( intr != sa->c_intr[c] )
+        sa_touch(sa, c, sa->c_and[c], sa->c_or[c], intr);
+      else
+        sa->t_mark[c] = sa->t_stamp;
+    }
+    for( i = 0; i < sa->f_len[x]; i++ )
+    {
+      c = sa->f_list[(size_t)x*sa->c_cnt+i];
+      if ( sa->t_mark[c] != sa->t_stamp )
+        sa_touch(sa, c, sa->c_and[c], sa->c_or[c], sa->c_intr[c]-1);
+    }
+  }
+
+  for( i = 0; i < sa->t_cnt; i++ )
+  {
+    c = sa->t_list[i];
+    delta += sa_cost(sa, c, sa->t_and[i], sa->t_or[i], sa->t_intr[i]);
+    delta -= sa_cost(sa, c, sa->c_and[c], sa->c_or[c], sa->c_intr[c]);
+  }
+  return delta;
+}
+
+static void sa_accept(sa_type sa, long delta)
+{
+  int i, c;
+  for( i = 0; i < sa->n_len[sa->t_k]; i++ )
+    sa_move_ones(sa, sa->n_list[sa->n_start[sa->t_k]+i], sa->t_x, sa->t_y);
+  if ( sa->t_l >= 0 )
+    for( i = 0; i < sa->n_len[sa->t_l]; i++ )
+      sa_move_ones(sa, sa->n_list[sa->n_start[sa->t_l]+i], sa->t_y, sa->t_x);
+  for( i = 0; i < sa->t_cnt; i++ )
+  {
+    c = sa->t_list[i];
+    if ( sa->c_and[c] != sa->t_and[i] || sa->c_or[c] != sa->t_or[i] )
+    {
+      sa_face_remove(sa, c);
+      sa->c_and[c] = sa->t_and[i];
+      sa->c_or[c] = sa->t_or[i];
+      sa_face_add(sa, c);
+    }
+    sa->c_intr[c] = sa->t_intr[i];
+  }
+  sa->cost += delta;
+}
+
+/* random move: a class, which is not the reset class, and another code */
+static void sa_random_move(sa_type sa, int *k, unsigned long *y)
+{
+  *k = sa->first + (int)(sa_rand(sa) % (unsigned long)(sa->n - sa->first));
+  do
+  {
+    *y = (unsigned long)sa->first + sa_rand(sa) % (sa->code_cnt - (unsigned long)sa->first);
+  } while( *y == sa->code[*k] );
+}
+
+static int sa_anneal(sa_type sa)
+{
+  unsigned long *best;
+  long best_cost, delta, sum;
+  unsigned long y, x;
+  double t;
+  int k, i, moves, accepted, pos_cnt, stage, idle, is_improved;
+
+  best = (unsigned long *)malloc(sizeof(unsigned long)*sa->n);
+  if ( best == NULL )
+    return 0;
+  memcpy(best, sa->code, sizeof(unsigned long)*sa->n);
+  best_cost = sa->cost;
+
+  moves = SA_MOVE_FACTOR*sa->n;
+  if ( moves < 100 )
+    moves = 100;
+
+  /* start temperature: average increase of the cost */
+  sum = 0;
+  pos_cnt = 0;
+  for( i = 0; i < moves; i++ )
+  {
+    sa_random_move(sa, &k, &y);
+    x = sa->code[k];
+    delta = sa_try(sa, k, y);
+    sa_exchange(sa, k, x);
+    if ( delta > 0 )
+    {
+      sum += delta;
+      pos_cnt++;
+    }
+  }
+  t = pos_cnt > 0 ? 2.0*(double)sum/(double)pos_cnt : 1.0;
+
+  idle = 0;
+  for( stage = 0; stage < SA_STAGE_MAX && best_cost > 0 && idle < 3; stage++ )
+  {
+    accepted = 0;
+    is_improved = 0;
+    for( i = 0; i < moves; i++ )
+    {
+      sa_random_move(sa, &k, &y);
+      x = sa->code[k];
+      delta = sa_try(sa, k, y);
+      if ( delta <= 0 || sa_rand_double(sa) < exp(-(double)delta/t) )
+      {
+        sa_accept(sa, delta);
+        if ( delta != 0 )
+          accepted++;
+        if ( sa->cost < best_cost )
+        {
+          best_cost = sa->cost;
+          memcpy(best, sa->code, sizeof(unsigned long)*sa->n);
+          is_improved = 1;
+        }
+      }
+      else
+      {
+        sa_exchange(sa, k, x);
+      }
+    }
+    /* stop if the state is frozen */
+    if ( is_improved == 0 && accepted*50 < moves )
+      idle++;
+    else
+      idle = 0;
+    t *= SA_COOLING;
+  }
+
+  memcpy(sa->code, best, sizeof(unsigned long)*sa->n);
+  sa->cost = best_cost;
+  free(best);
+  return 1;
+}
+
+/*---------------------------------------------------------------------------*/
+
+int fsm_EncodeAnneal(fsm_type fsm)
+{
+  sa_type sa;
+  int *class;
+  unsigned long *code;
+  int class_cnt, width, node_id, k;
+  long start_cost;
+
+  if ( fsm_GetNodeCnt(fsm) <= 0 )
+    return fsm_EncodeSimple(fsm);
+
+  class = (int *)malloc(sizeof(int)*(b_set_Max(fsm->nodes)+1));
+  code = (unsigned long *)malloc(sizeof(unsigned long)*(b_set_Max(fsm->nodes)+1));
+  if ( class == NULL || code == NULL )
+    return free(class), free(code), 0;
+  class_cnt = fsm_EncodeGetClasses(fsm, class);
+
+  width = 0;
+  while( (1<<width) < class_cnt )
+    width++;
+  if ( width == 0 )
+    width = 1;
+  if ( width > SA_WIDTH_MAX )
+    return free(class), free(code), fsm_EncodeSimple(fsm);
+
+  sa = sa_open_by_fsm(fsm, class, class_cnt, width);
+  if ( sa == NULL )
+    return free(class), free(code), 0;
+
+  sa->first = fsm->reset_node_id >= 0 ? 1 : 0;
+  for( k = 0; k < (int)sa->code_cnt; k++ )
+    sa->slot[k] = -1;
+  for( k = 0; k < class_cnt; k++ )
+  {
+    sa->code[k] = (unsigned long)k;
+    sa->slot[k] = k;
+  }
+  sa_init_cost(sa);
+  start_cost = sa->cost;
+
+  if ( sa->c_cnt > 0 && class_cnt - sa->first >= 1 &&
+       sa->code_cnt - (unsigned long)sa->first >= 2 )
+  {
+    if ( sa_anneal(sa) == 0 )
+      return sa_close(sa), free(class), free(code), 0;
+  }
+
+  fsm_Log(fsm, "FSM: Annealing: %d constraints, cost %ld -> %ld (%d bits).",
+    sa->c_cnt, start_cost, sa->cost, width);
+
+  node_id = -1;
+  while( fsm_LoopNodes(fsm, &node_id) != 0 )
+    code[node_id] = sa->code[class[node_id]];
+  if ( fsm_EncodeSetCodes(fsm, width, code) == 0 )
+    return sa_close(sa), free(class), free(code), 0;
+
+  sa_close(sa);
+  free(class);
+  free(code);
+  return 1;
+}
@@ -51,7 +51,7 @@ int encode_Fan_In(fsm_type fsm )
   {
     cd_GetCodeFromOutCodeInfo(codeInfo, pi, &code);
     dcCopy(pi, fsm_GetNodeCode(fsm, current->node_id), &code);
-    cd_GetNextOutCodeInfo(codeInfo);
+    codeInfo = cd_GetNextOutCodeInfo(codeInfo);
   }
   
   node_CloseNodeList(nodes);
@@ -340,6 +340,8 @@ int encode_BuildMachine(fsm_type fsm, MIN_SYMB_LIST constrList,
  
   dclRealClear(fsm->cl_machine);
   fsm_BuildMachine(fsm);
+  /* the rows below do not belong to an edge */
+  fsm_SetMachineInvalid(fsm);
   
   for(tmp = constrList; tmp != NULL; tmp = tmp->next)
   {
@@ -0,0 +1,575 @@
+/*
+
+  encsearch.c
+
+  search for a state encoding with low cost
+
+  Copyright (C) 2001 Oliver Kraus (olikraus@yahoo.com)
+
+  This file is part of DGC.
+
+  DGC is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 2 of the License, or
+  (at your option) any later version.
+
+  DGC is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with DGC; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+
+  Each candidate is a code for each state. The candidates are:
+    - fsm_EncodeSimple, encode_Fan_In and encode_IC_Relaxe
+    - random encodings
+    - the best encoding with some codes exchanged or moved to an
+      unused code
+  The candidates are evaluated in batches: Each candidate gets its own
+  transfer function and problem info, so that the batch can be
+  distributed among several threads (b_th_Do). The cost of a candidate
+  is width*FSM_ENC_SEARCH_FF_COST + 2*extra_dclNrInpCost() of its
+  minimized transfer function, these are the weights of extra_CostTot()
+  for D flip flops. Inside the threads, the minimization uses only one
+  thread (see b_th_GetCnt).
+
+  The reset state always gets the all zero code. Codes of the
+  constructive encodings are inverted bitwise to achieve this.
+
+  The result does not depend on the number of threads, except if
+  the time limit is reached.
+
+*/
+
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+#include <sys/time.h>
+#include "fsm.h"
+#include "fsmenc.h"
+#include "encode_func.h"
+#include "extra.h"
+#include "b_th.h"
+#include "mwc.h"
+
+/* number of candidates, which are evaluated in parallel */
+#define FSM_ENC_SEARCH_BATCH 8
+
+/* see extra_CostSeq() */
+#define FSM_ENC_SEARCH_FF_COST 20
+
+/* the largest code width */
+#define FSM_ENC_SEARCH_WIDTH_MAX ((int)(sizeof(unsigned long)*8-1))
+
+struct _fsm_enc_cand_struct
+{
+  int width;
+  unsigned long *code;    /* one code for each node id */
+  int cost;               /* INT_MAX: not evaluated or error */
+  int is_valid;
+};
+typedef struct _fsm_enc_cand_struct fsm_enc_cand_struct;
+
+struct _fsm_enc_search_struct
+{
+  fsm_type fsm;
+  int node_max;           /* b_set_Max(fsm->nodes) */
+
+  fsm_enc_cand_struct cand[FSM_ENC_SEARCH_BATCH];
+  fsm_enc_cand_struct best;
+
+  double end_time;        /* <= 0.0: no time limit */
+};
+typedef struct _fsm_enc_search_struct *fsm_enc_search_type;
+
+static double fsm_enc_time(void)
+{
+  struct timeval tv;
+  gettimeofday(&tv, NULL);
+  return (double)tv.tv_sec*1000.0 + (double)tv.tv_usec/1000.0;
+}
+
+static unsigned long fsm_enc_rand(unsigned long *seed)
+{
+  /* 32 bit linear congruential generator (numerical recipes) */
+  *seed = (*seed * 1664525UL + 1013904223UL) & 0x0ffffffffUL;
+  return *seed >> 8;
+}
+
+/*---------------------------------------------------------------------------*/
+
+static int fsm_enc_cand_init(fsm_enc_search_type es, fsm_enc_cand_struct *cand)
+{
+  cand->width = 0;
+  cand->cost = INT_MAX;
+  cand->is_valid = 0;
+  cand->code = (unsigned long *)malloc(sizeof(unsigned long)*(es->node_max+1));
+  if ( cand->code == NULL )
+    return 0;
+  return 1;
+}
+
+static void fsm_enc_cand_destroy(fsm_enc_cand_struct *cand)
+{
+  free(cand->code);
+}
+
+static void fsm_enc_cand_copy(fsm_enc_search_type es, fsm_enc_cand_struct *dest, fsm_enc_cand_struct *src)
+{
+  dest->width = src->width;
+  dest->cost = src->cost;
+  dest->is_valid = src->is_valid;
+  memcpy(dest->code, src->code, sizeof(unsigned long)*(es->node_max+1));
+}
+
+/* read the current encoding of the fsm, the reset state gets the zero code */
+static void fsm_enc_cand_from_fsm(fsm_enc_search_type es, fsm_enc_cand_struct *cand)
+{
+  fsm_type fsm = es->fsm;
+  int node_id, i;
+  unsigned long c, reset_code = 0;
+
+  cand->cost = INT_MAX;
+  cand->is_valid = 0;
+  cand->width = fsm_GetCodeWidth(fsm);
+  if ( cand->width <= 0 || cand->width > FSM_ENC_SEARCH_WIDTH_MAX )
+    return;
+
+  node_id = -1;
+  while( fsm_LoopNodes(fsm, &node_id) != 0 )
+  {
+    c = 0;
+    for( i = 0; i < cand->width; i++ )
+      if ( dcGetOut(fsm_GetNodeCode(fsm, node_id), i) != 0 )
+        c |= 1UL << i;
+    cand->code[node_id] = c;
+  }
+  if ( fsm->reset_node_id >= 0 )
+    reset_code = cand->code[fsm->reset_node_id];
+  node_id = -1;
+  while( fsm_LoopNodes(fsm, &node_id) != 0 )
+    cand->code[node_id] ^= reset_code;
+  cand->is_valid = 1;
+}
+
+/*---------------------------------------------------------------------------*/
+
+/*
+  nodes of a group share the same code, all other nodes get
+  a code of their own (same as fsm_EncodeSimple).
+  returns the number of different codes, class[node_id] is the
+  index of the code. The reset state has class 0.
+*/
+int fsm_EncodeGetClasses(fsm_type fsm, int *class)
+{
+  int node_id, group_id, loop;
+  int is_new;
+  int cnt = 0;
+
+  node_id = -1;
+  while( fsm_LoopNodes(fsm, &node_id) != 0 )
+    class[node_id] = -1;
+
+  /* the reset state gets class 0 */
+  if ( fsm->reset_node_id >= 0 )
+  {
+    group_id = fsm_GetNodeGroupIndex(fsm, fsm->reset_node_id);
+    if ( group_id >= 0 )
+    {
+      loop = -1;
+      while( fsm_LoopGroupNodes(fsm, group_id, &loop, &node_id) != 0 )
+        class[node_id] = 0;
+    }
+    class[fsm->reset_node_id] = 0;
+    cnt++;
+  }
+
+  group_id = -1;
+  while( fsm_LoopGroups(fsm, &group_id) != 0 )
+  {
+    is_new = 0;
+    loop = -1;
+    while( fsm_LoopGroupNodes(fsm, group_id, &loop, &node_id) != 0 )
+      if ( class[node_id] < 0 )
+      {
+        class[node_id] = cnt;
+        is_new = 1;
+      }
+    if ( is_new != 0 )
+      cnt++;
+  }
+
+  node_id = -1;
+  while( fsm_LoopNodes(fsm, &node_id) != 0 )
+    if ( class[node_id] < 0 )
+      class[node_id] = cnt++;
+  return cnt;
+}
+
+/* assign code[node_id] with 'width' bits to the nodes of the fsm */
+int fsm_EncodeSetCodes(fsm_type fsm, int width, unsigned long *code)
+{
+  pinfo *pi;
+  dcube *c;
+  int node_id, i;
+
+  if ( fsm_SetCodeWidth(fsm, width, FSM_CODE_DFF_EXTRA_OUTPUT) == 0 )
+    return 0;
+  pi = fsm_GetCodePINFO(fsm);
+  node_id = -1;
+  while( fsm_LoopNodes(fsm, &node_id) != 0 )
+  {
+    c = fsm_GetNodeCode(fsm, node_id);
+    dcInSetAll(pi, c, CUBE_IN_MASK_DC);
+    dcOutSetAll(pi, c, 0);
+    for( i = 0; i < width; i++ )
+      if ( (code[node_id] & (1UL << i)) != 0 )
+        dcSetOut(c, i, 1);
+    dcCopyOutToIn(pi, c, 0, pi, c);
+  }
+  return 1;
+}
+
+/* random encoding with the minimal number of bits */
+static void fsm_enc_cand_random(fsm_enc_search_type es, fsm_enc_cand_struct *cand, int *class, int class_cnt, unsigned long seed)
+{
+  unsigned long *perm;
+  unsigned long code_cnt, i, j, t;
+  int node_id, width;
+  int is_reset = es->fsm->reset_node_id >= 0 ? 1 : 0;
+
+  cand->cost = INT_MAX;
+  cand->is_valid = 0;
+
+  width = 0;
+  while( (1UL << width) < (unsigned long)class_cnt )
+    width++;
+  if ( width == 0 )
+    width = 1;
+  if ( width > FSM_ENC_SEARCH_WIDTH_MAX || width > 24 )
+    return;
+  code_cnt = 1UL << width;
+
+  perm = (unsigned long *)malloc(sizeof(unsigned long)*code_cnt);
+  if ( perm == NULL )
+    return;
+  for( i = 0; i < code_cnt; i++ )
+    perm[i] = i;
+  /* the first class is the reset class, it keeps code zero */
+  for( i = is_reset; i+1 < code_cnt; i++ )
+  {
+    j = i + fsm_enc_rand(&seed) % (code_cnt-i);
+    t = perm[i];
+    perm[i] = perm[j];
+    perm[j] = t;
+  }
+
+  cand->width = width;
+  node_id = -1;
+  while( fsm_LoopNodes(es->fsm, &node_id) != 0 )
+    cand->code[node_id] = perm[class[node_id]];
+  cand->is_valid = 1;
+  free(perm);
+}
+
+/*
+  exchange two codes or replace a code with an unused code,
+  the code of the reset state is not changed
+*/
+static void fsm_enc_cand_perturb(fsm_enc_search_type es, fsm_enc_cand_struct *cand, unsigned long seed)
+{
+  fsm_type fsm = es->fsm;
+  int node_id, n1, n2, moves, m, pos, cnt;
+  unsigned long a, b;
+  unsigned long reset_code = 0;
+
+  cnt = fsm_GetNodeCnt(fsm);
+  if ( cnt < 2 )
+    return;
+  if ( fsm->reset_node_id >= 0 )
+    reset_code = cand->code[fsm->reset_node_id];
+
+  moves = 1 + (int)(fsm_enc_rand(&seed) % 3);
+  for( m = 0; m < moves; m++ )
+  {
+    /* select a code from the used codes */
+    pos = (int)(fsm_enc_rand(&seed) % (unsigned long)cnt);
+    node_id = -1;
+    n1 = -1;
+    while( fsm_LoopNodes(fsm, &node_id) != 0 )
+      if ( pos-- == 0 )
+        n1 = node_id;
+    a = cand->code[n1];
+
+    /* select another code, used or unused */
+    b = fsm_enc_rand(&seed) & ((1UL << cand->width)-1);
+    if ( (fsm_enc_rand(&seed) & 1) != 0 )
+    {
+      pos = (int)(fsm_enc_rand(&seed) % (unsigned long)cnt);
+      node_id = -1;
+      n2 = -1;
+      while( fsm_LoopNodes(fsm, &node_id) != 0 )
+        if ( pos-- == 0 )
+          n2 = node_id;
+      b = cand->code[n2];
+    }
+
+    if ( a == b )
+      continue;
+    if ( fsm->reset_node_id >= 0 && (a == reset_code || b == reset_code) )
+      continue;
+
+    node_id = -1;
+    while( fsm_LoopNodes(fsm, &node_id) != 0 )
+    {
+      if ( cand->code[node_id] == a )
+        cand->code[node_id] = b;
+      else if ( cand->code[node_id] == b )
+        cand->code[node_id] = a;
+    }
+  }
+  cand->cost = INT_MAX;
+}
+
+/*---------------------------------------------------------------------------*/
+
+/* same as fsm_BuildTransferfunction(), but codes are taken from 'cand' */
+static int fsm_enc_build(fsm_enc_search_type es, fsm_enc_cand_struct *cand,
+  pinfo *pi, dclist cl_on, dclist cl_dc, dcube *c)
+{
+  fsm_type fsm = es->fsm;
+  int node_id, src_node_id, edge_id, loop;
+  int in_cnt = fsm->pi_cond->in_cnt;
+  dclist cl, cl_off;
+  int i, b, cnt;
+
+  if ( dclInit(&cl_off) == 0 )
+    return 0;
+
+  node_id = -1;
+  while( fsm_LoopNodes(fsm, &node_id) != 0 )
+  {
+    loop = -1;
+    while( fsm_LoopNodeInEdges(fsm, node_id, &loop, &edge_id) != 0 )
+    {
+      src_node_id = fsm_GetEdgeSrcNode(fsm, edge_id);
+      cl = fsm_GetEdgeOutput(fsm, edge_id);
+      cnt = dclCnt(cl);
+      for( i = 0; i < cnt; i++ )
+      {
+        dcInSetAll(pi, c, CUBE_IN_MASK_DC);
+        dcOutSetAll(pi, c, 0);
+        dcCopyInToIn(pi, c, 0, fsm->pi_cond, dclGet(cl, i));
+        for( b = 0; b < cand->width; b++ )
+        {
+          dcSetIn(c, in_cnt+b, (cand->code[src_node_id] & (1UL << b)) != 0 ? 2 : 1);
+          dcSetOut(c, b, (cand->code[node_id] & (1UL << b)) != 0 ? 1 : 0);
+        }
+        dcCopyOutToOut(pi, c, cand->width, fsm->pi_output, dclGet(cl, i));
+
+        if ( dcIsIllegal(pi, c) == 0 )
+          if ( dclAdd(pi, cl_on, c) < 0 )
+            return dclDestroy(cl_off), 0;
+
+        dcInvOut(pi, c);
+        if ( dcIsIllegal(pi, c) == 0 )
+          if ( dclAdd(pi, cl_off, c) < 0 )
+            return dclDestroy(cl_off), 0;
+      }
+    }
+  }
+
+  dcSetTautology(pi, c);
+  if ( dclAdd(pi, cl_dc, c) < 0 )
+    return dclDestroy(cl_off), 0;
+  if ( dclSubtract(pi, cl_dc, cl_on) == 0 )
+    return dclDestroy(cl_off), 0;
+  if ( dclSubtract(pi, cl_dc, cl_off) == 0 )
+    return dclDestroy(cl_off), 0;
+
+  return dclDestroy(cl_off), 1;
+}
+
+/* calculates cand->cost, returns 0 for memory errors */
+static int fsm_enc_eval(fsm_enc_search_type es, fsm_enc_cand_struct *cand)
+{
+  fsm_type fsm = es->fsm;
+  pinfo *pi;
+  dclist cl_on, cl_dc;
+  dcube c;
+  int *tab;
+  int i;
+
+  cand->cost = INT_MAX;
+  if ( cand->is_valid == 0 )
+    return 1;
+  if ( es->end_time > 0.0 && fsm_enc_time() > es->end_time )
+    return 1;
+
+  pi = pinfoOpenInOut(fsm->pi_cond->in_cnt+cand->width, cand->width+fsm->out_cnt);
+  if ( pi == NULL )
+    return 0;
+  if ( dcInit(pi, &c) == 0 )
+    return pinfoClose(pi), 0;
+  if ( dclInitVA(2, &cl_on, &cl_dc) == 0 )
+    return dcDestroy(&c), pinfoClose(pi), 0;
+
+  if ( fsm_enc_build(es, cand, pi, cl_on, cl_dc, &c) == 0 )
+    return dclDestroyVA(2, cl_on, cl_dc), dcDestroy(&c), pinfoClose(pi), 0;
+  if ( dclMinimizeDC(pi, cl_on, cl_dc, 0, 1) == 0 )
+    return dclDestroyVA(2, cl_on, cl_dc), dcDestroy(&c), pinfoClose(pi), 0;
+
+  tab = (int *)malloc(sizeof(int)*(dclCnt(cl_on)+1));
+  if ( tab == NULL )
+    return dclDestroyVA(2, cl_on, cl_dc), dcDestroy(&c), pinfoClose(pi), 0;
+  for( i = 0; i < dclCnt(cl_on); i++ )
+    tab[i] = 0;
+  cand->cost = cand->width*FSM_ENC_SEARCH_FF_COST + 2*extra_dclNrInpCost(cl_on, pi, tab);
+  free(tab);
+
+  dclDestroyVA(2, cl_on, cl_dc);
+  dcDestroy(&c);
+  pinfoClose(pi);
+  return 1;
+}
+
+static int fsm_enc_eval_cb(void *data, int th, int pos)
+{
+  fsm_enc_search_type es = (fsm_enc_search_type)data;
+  return fsm_enc_eval(es, es->cand+pos);
+}
+
+/* evaluates all candidates and updates the best candidate */
+static int fsm_enc_eval_batch(fsm_enc_search_type es, int cnt)
+{
+  int i;
+  if ( b_th_Do(0, cnt, fsm_enc_eval_cb, es) == 0 )
+    return 0;
+  for( i = 0; i < cnt; i++ )
+    if ( es->cand[i].cost < es->best.cost )
+      fsm_enc_cand_copy(es, &(es->best), es->cand+i);
+  return 1;
+}
+
+/*---------------------------------------------------------------------------*/
+
+static void fsm_enc_search_close(fsm_enc_search_type es)
+{
+  int i;
+  for( i = 0; i < FSM_ENC_SEARCH_BATCH; i++ )
+    fsm_enc_cand_destroy(es->cand+i);
+  fsm_enc_cand_destroy(&(es->best));
+  free(es);
+}
+
+static fsm_enc_search_type fsm_enc_search_open(fsm_type fsm)
+{
+  fsm_enc_search_type es;
+  int i;
+  es = (fsm_enc_search_type)malloc(sizeof(struct _fsm_enc_search_struct));
+  if ( es == NULL )
+    return NULL;
+  es->fsm = fsm;
+  es->node_max = b_set_Max(fsm->nodes);
+  es->end_time = 0.0;
+  for( i = 0; i < FSM_ENC_SEARCH_BATCH; i++ )
+    es->cand[i].code = NULL;
+  es->best.code = NULL;
+  for( i = 0; i < FSM_ENC_SEARCH_BATCH; i++ )
+    if ( fsm_enc_cand_init(es, es->cand+i) == 0 )
+      return fsm_enc_search_close(es), (fsm_enc_search_type)NULL;
+  if ( fsm_enc_cand_init(es, &(es->best)) == 0 )
+    return fsm_enc_search_close(es), (fsm_enc_search_type)NULL;
+  return es;
+}
+
+/*
+  Evaluates up to 'cnt' encodings (at least the constructive encodings)
+  and assigns the encoding with the lowest cost to the fsm.
+  budget_ms > 0: stop after 'budget_ms' milliseconds.
+  The transfer function is not created.
+*/
+int fsm_EncodeSearch(fsm_type fsm, int cnt, long budget_ms)
+{
+  fsm_enc_search_type es;
+  int *class;
+  int class_cnt;
+  int k, i, n;
+
+  if ( fsm_GetNodeCnt(fsm) <= 0 )
+    return fsm_EncodeSimple(fsm);
+
+  es = fsm_enc_search_open(fsm);
+  if ( es == NULL )
+    return 0;
+  if ( budget_ms > 0 )
+    es->end_time = fsm_enc_time() + (double)budget_ms;
+  class = (int *)malloc(sizeof(int)*(es->node_max+1));
+  if ( class == NULL )
+    return fsm_enc_search_close(es), 0;
+  class_cnt = fsm_EncodeGetClasses(es->fsm, class);
+
+  /* constructive encodings */
+  if ( fsm_EncodeSimple(fsm) == 0 )
+    return free(class), fsm_enc_search_close(es), 0;
+  fsm_enc_cand_from_fsm(es, es->cand+0);
+  if ( encode_Fan_In(fsm) != 0 )
+    fsm_enc_cand_from_fsm(es, es->cand+1);
+  else
+    es->cand[1].is_valid = 0;
+  if ( encode_IC_Relaxe(fsm) != 0 )
+    fsm_enc_cand_from_fsm(es, es->cand+2);
+  else
+    es->cand[2].is_valid = 0;
+  n = 3;
+  for( k = n; k < FSM_ENC_SEARCH_BATCH; k++ )
+    fsm_enc_cand_random(es, es->cand+k, class, class_cnt, (unsigned long)k);
+  n = FSM_ENC_SEARCH_BATCH;
+
+  /* the first batch is always evaluated */
+  es->best.cost = INT_MAX;
+  if ( fsm_enc_eval_batch(es, FSM_ENC_SEARCH_BATCH) == 0 )
+    return free(class), fsm_enc_search_close(es), 0;
+
+  /* random encodings and variations of the best encoding */
+  while( n < cnt )
+  {
+    if ( es->end_time > 0.0 && fsm_enc_time() > es->end_time )
+      break;
+    for( i = 0; i < FSM_ENC_SEARCH_BATCH; i++ )
+    {
+      k = n + i;
+      if ( (k % 4) == 0 || es->best.cost == INT_MAX )
+      {
+        fsm_enc_cand_random(es, es->cand+i, class, class_cnt, (unsigned long)k);
+      }
+      else
+      {
+        fsm_enc_cand_copy(es, es->cand+i, &(es->best));
+        fsm_enc_cand_perturb(es, es->cand+i, (unsigned long)k);
+      }
+    }
+    if ( fsm_enc_eval_batch(es, FSM_ENC_SEARCH_BATCH) == 0 )
+      return free(class), fsm_enc_search_close(es), 0;
+    n += FSM_ENC_SEARCH_BATCH;
+  }
+  free(class);
+
+  if ( es->best.cost == INT_MAX )
+  {
+    fsm_Log(fsm, "FSM: Encoding search failed, using simple encoding.");
+    fsm_enc_search_close(es);
+    return fsm_EncodeSimple(fsm);
+  }
+
+  fsm_Log(fsm, "FSM: Encoding search: %d candidates, best cost %d (%d bits).",
+    n, es->best.cost, es->best.width);
+  if ( fsm_EncodeSetCodes(es->fsm, es->best.width, es->best.code) == 0 )
+    return fsm_enc_search_close(es), 0;
+
+  fsm_enc_search_close(es);
+  return 1;
+}
@@ -261,6 +261,7 @@ int extra_fsm_MakeCondPrimes (fsm_type fsm)
   edge = -1;
   while(fsm_LoopEdges(fsm, &edge))
   {
+    fsm_SetEdgeDirty(fsm, edge);
     if (dclPrimes(pCond, fsm_GetEdgeCondition(fsm, edge)) == 0)
       return 0;
   }
@@ -277,6 +278,7 @@ int extra_fsm_MakeCondMinimize (fsm_type fsm)
   edge = -1;
   while(fsm_LoopEdges(fsm, &edge))
   {
+    fsm_SetEdgeDirty(fsm, edge);
     if (dclMinimize(pCond, fsm_GetEdgeCondition(fsm, edge)) == 0)
       return 0;
   }
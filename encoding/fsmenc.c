@@ -40,6 +40,26 @@ int fsm_MinimizeClockedMachine(fsm_type fsm)
 
 /*---------------------------------------------------------------------------*/
 
+static int fsm_BuildMinimizedTransferfunction(fsm_type fsm)
+{
+  fsm_Log(fsm, "FSM: Building control function for clocked machines.");
+  if ( fsm_BuildTransferfunction(fsm) == 0 )
+    return 0;
+  fsm_Log(fsm, "FSM: Minimizing control function for clocked machines.");
+  /*
+  if ( fsm_MinimizeClockedMachine(fsm) == 0 )
+    return 0;
+  */
+  if ( dclMinimizeDC(fsm->pi_machine, fsm->cl_machine, fsm->cl_machine_dc, 0, 1) == 0 )
+  {
+    fsm_Log(fsm, "FSM: Minimizing failed.");
+    return 0;
+  }
+  return 1;
+}
+
+/*---------------------------------------------------------------------------*/
+
 int fsm_BuildClockedMachine(fsm_type fsm, int coding_type)
 {
   fsm_Log(fsm, "FSM: State encoding.");
@@ -93,20 +113,28 @@ int fsm_BuildClockedMachine(fsm_type fsm, int coding_type)
       if ( fsm_EncodeSimple(fsm) == 0 )			/* fsm.c */
         return 0;
       fsm_Log(fsm, "FSM: Encoded Simple.");
-      fsm_Log(fsm, "FSM: Building control function for clocked machines.");
-      if ( fsm_BuildTransferfunction(fsm) == 0 )
+      if ( fsm_BuildMinimizedTransferfunction(fsm) == 0 )
         return 0;
-      fsm_Log(fsm, "FSM: Minimizing control function for clocked machines.");
-      /*
-      if ( fsm_MinimizeClockedMachine(fsm) == 0 )
+      break;
+      
+    case FSM_ENCODE_ANNEAL:
+      if ( fsm_EncodeAnneal(fsm) == 0 )
         return 0;
-      */
-      if ( dclMinimizeDC(fsm->pi_machine, fsm->cl_machine, fsm->cl_machine_dc, 0, 1) == 0 )
-      {
-	fsm_Log(fsm, "FSM: Minimizing failed.");
+      fsm_Log(fsm, "FSM: Encoded by simulated annealing.");
+      if ( fsm_BuildMinimizedTransferfunction(fsm) == 0 )
         return 0;
-      }
       break;
+      
+    case FSM_ENCODE_SEARCH:
+      return fsm_BuildClockedMachineBySearch(fsm, FSM_ENC_SEARCH_CNT, FSM_ENC_SEARCH_MS);
   }
   return 1;
 }
+
+/* search the state encoding, see encsearch.c */
+int fsm_BuildClockedMachineBySearch(fsm_type fsm, int cnt, long budget_ms)
+{
+  if ( fsm_EncodeSearch(fsm, cnt, budget_ms) == 0 )
+    return 0;
+  return fsm_BuildMinimizedTransferfunction(fsm);
+}
@@ -31,11 +31,25 @@
 
 int fsm_MinimizeClockedMachine(fsm_type fsm);
 int fsm_BuildClockedMachine(fsm_type fsm, int coding_type);
+int fsm_BuildClockedMachineBySearch(fsm_type fsm, int cnt, long budget_ms);
 
 #define FSM_ENCODE_FAN_IN 0
 #define FSM_ENCODE_IC_ALL 1
 #define FSM_ENCODE_IC_PART 2
 #define FSM_ENCODE_SIMPLE 3
+#define FSM_ENCODE_SEARCH 4
+#define FSM_ENCODE_ANNEAL 5
+
+/* encsearch.c */
+/* default number of candidates and time limit (ms, 0: no limit) */
+#define FSM_ENC_SEARCH_CNT 64
+#define FSM_ENC_SEARCH_MS 0L
+int fsm_EncodeSearch(fsm_type fsm, int cnt, long budget_ms);
+int fsm_EncodeGetClasses(fsm_type fsm, int *class);
+int fsm_EncodeSetCodes(fsm_type fsm, int width, unsigned long *code);
+
+/* encanneal.c */
+int fsm_EncodeAnneal(fsm_type fsm);
  
 #endif /* _FSMENC_H */
 
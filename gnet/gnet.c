@@ -63,6 +63,7 @@
 #include "mwc.h"
 #include "b_io.h"
 #include "b_ff.h"
+#include "b_th.h"
 
 /*! \defgroup gncinit gnc Initalisation */
 /*! \defgroup gnccell gnc Cell Management */
@@ -231,6 +232,30 @@ int gportRead(gport p, FILE *fp)
   return 1;
 }
 
+static void *gport_copy_poti(void *el, void *ud)
+{
+  gpoti pt = gpotiOpen();
+  if ( pt == NULL )
+    return NULL;
+  if ( gpotiCopy(pt, (gpoti)el) == 0 )
+  {
+    gpotiClose(pt);
+    return NULL;
+  }
+  return pt;
+}
+
+int gportCopy(gport p, gport src)
+{
+  p->type = src->type;
+  p->fn = src->fn;
+  p->is_inverted = src->is_inverted;
+  if ( gportSetName(p, src->name) == 0 )                                  return 0;
+  p->input_load = src->input_load;
+  if ( b_set_Copy(p->poti_set, src->poti_set, gport_copy_poti, NULL) == 0 )  return 0;
+  return 1;
+}
+
 gpoti gportFindGPOTI(gport p, int port_ref)
 {
   int i = -1;
@@ -485,6 +510,18 @@ int gnetRead(gnet net, FILE *fp)
   return 1;
 }
 
+static void *gnet_copy_el(void *el, void *ud)
+{
+  return gjoinOpen(((gjoin)el)->node, ((gjoin)el)->port);
+}
+
+int gnetCopy(gnet net, gnet src)
+{
+  if ( gnetSetName(net, src->name) == 0 )                                  return 0;
+  if ( b_set_Copy(net->join_set, src->join_set, gnet_copy_el, NULL) == 0 )  return 0;
+  return 1;
+}
+
 
 /*----------------------------------------------------------------------------*/
 
@@ -556,6 +593,17 @@ int gnodeRead(gnode n, FILE *fp)
   return 1;
 }
 
+int gnodeCopy(gnode n, gnode src)
+{
+  n->cell_ref = src->cell_ref;
+  if ( gnodeSetName(n, src->name) == 0 )            return 0;
+  n->flag = src->flag;
+  n->is_do_not_touch = src->is_do_not_touch;
+  n->data = src->data;
+  if ( b_il_Copy(n->net_refs, src->net_refs) == 0 )  return 0;
+  return 1;
+}
+
 
 /*----------------------------------------------------------------------------*/
 
@@ -1148,6 +1196,59 @@ gnl gnlOpenRead(FILE *fp)
   return nl;
 }
 
+static void *gnl_copy_node_el(void *el, void *ud)
+{
+  gnode node = gnodeOpen();
+  if ( node == NULL )
+    return NULL;
+  if ( gnodeCopy(node, (gnode)el) == 0 )
+    return gnodeClose(node), (void *)NULL;  
+  return node;
+}
+
+static void *gnl_copy_net_el(void *el, void *ud)
+{
+  gnet net = gnetOpen();
+  if ( net == NULL )
+    return NULL;
+  if ( gnetCopy(net, (gnet)el) == 0 )
+    return gnetClose(net), (void *)NULL;
+  return net;
+}
+
+gnl gnlOpenCopy(gnl src)
+{
+  gnl nl;
+  int i;
+  
+  if ( src == NULL )
+    return NULL;
+  nl = gnlOpen();
+  if ( nl == NULL )
+    return NULL;
+    
+  if ( b_set_Copy(nl->node_set, src->node_set, gnl_copy_node_el, NULL) == 0 ) 
+    return gnlClose(nl), (gnl)NULL;
+  if ( b_set_Copy(nl->net_set, src->net_set, gnl_copy_net_el, NULL) == 0 )
+    return gnlClose(nl), (gnl)NULL;
+  if ( b_il_Copy(nl->net_refs, src->net_refs) == 0 )
+    return gnlClose(nl), (gnl)NULL;
+  
+  i = -1;
+  while( gnlLoopNodeRef(nl, &i) != 0 )
+    if ( gnlGetGNODE(nl,i)->name != NULL )
+      if ( b_rdic_Ins(nl->node_by_name, i, gnlGetGNODE(nl,i)->name) == 0 )
+        return gnlClose(nl), (gnl)NULL;
+
+  i = -1;
+  while( gnlLoopNetRef(nl, &i) != 0 )
+    if ( gnlGetGNET(nl,i)->name != NULL )
+      if ( b_rdic_Ins(nl->net_by_name, i, gnlGetGNET(nl,i)->name) == 0 )
+        return gnlClose(nl), (gnl)NULL;
+  
+  return nl;
+}
+
 /*----------------------------------------------------------------------------*/
 
 void gciomClear(gciom ciom)
@@ -1259,6 +1360,30 @@ int gciomRead(gciom *ciom, FILE *fp)
   return 1;
 }
 
+int gciomCopy(gciom *ciom, gciom src)
+{
+  int cnt;
+  
+  if ( *ciom != NULL )
+    gciomClose(*ciom);
+  *ciom = NULL;
+  
+  if ( src == NULL )
+    return 1;
+  
+  *ciom = gciomOpen(src->in_cnt, src->out_cnt);
+  if ( *ciom == NULL )
+    return 0;
+  
+  cnt = src->in_cnt*src->out_cnt;
+  memcpy((*ciom)->min_delay, src->min_delay, sizeof(double)*cnt);
+  memcpy((*ciom)->max_delay, src->max_delay, sizeof(double)*cnt);
+  memcpy((*ciom)->is_used, src->is_used, sizeof(char)*cnt);
+  (*ciom)->max = src->max;
+  (*ciom)->min = src->min;
+  return 1;
+}
+
 size_t gciomGetMemUsage(gciom ciom)
 {
   size_t m = sizeof(struct _gciom_struct);
@@ -1730,6 +1855,72 @@ int gcellRead(gcell cell, FILE *fp, const char *libname)
   return 1;
 }
 
+static void *gcell_copy_port_el(void *el, void *ud)
+{
+  gport port = gportOpen(GPORT_TYPE_BI, NULL);
+  if ( port == NULL )
+    return NULL;
+  if ( gportCopy(port, (gport)el) == 0 )
+    return gportClose(port), (void *)NULL;
+  return port;
+}
+
+static int gcell_copy_dcl(pinfo *pi, dclist *cl, dclist src)
+{
+  if ( *cl != NULL )
+    dclDestroy(*cl);
+  *cl = NULL;
+  if ( src == NULL )
+    return 1;
+  if ( dclInit(cl) == 0 )
+    return *cl = NULL, 0;
+  return dclCopy(pi, *cl, src);
+}
+
+/* copies everything except name and library into the empty cell */
+int gcellCopy(gcell cell, gcell src)
+{
+  if ( gcellSetDescription(cell, src->desc) == 0 )
+    return 0;
+  if ( b_set_Copy(cell->port_set, src->port_set, gcell_copy_port_el, NULL) == 0 ) 
+    return 0;
+  if ( cell->nl != NULL )
+    gnlClose(cell->nl);
+  cell->nl = gnlOpenCopy(src->nl);
+  if ( src->nl != NULL && cell->nl == NULL )
+    return 0;
+  cell->id = src->id;
+  cell->in_cnt = src->in_cnt;
+  cell->out_cnt = src->out_cnt;
+  cell->area = src->area;
+  cell->flag = src->flag;
+  cell->register_width = src->register_width;
+  
+  if ( cell->pi != NULL )
+    pinfoClose(cell->pi);
+  cell->pi = NULL;
+  if ( src->pi != NULL )
+  {
+    cell->pi = pinfoOpen();
+    if ( cell->pi == NULL )
+      return 0;
+    if ( pinfoCopy(cell->pi, src->pi) == 0 )
+      return 0;
+    if ( src->pi->progress != NULL )
+      pinfoInitProgress(cell->pi);
+  }
+  if ( gcell_copy_dcl(cell->pi, &(cell->cl_on), src->cl_on) == 0 )
+    return 0;
+  if ( gcell_copy_dcl(cell->pi, &(cell->cl_dc), src->cl_dc) == 0 )
+    return 0;
+  if ( gcell_copy_dcl(cell->pi, &(cell->cl_off), src->cl_off) == 0 )
+    return 0;
+  
+  if ( gciomCopy(&(cell->ciom), src->ciom) == 0 )
+    return 0;
+  return 1;
+}
+
 int gcellInitDelay(gcell cell)
 {
   if ( cell == NULL )
@@ -2493,6 +2684,40 @@ void gnc_DelCell(gnc nc, int cell_ref)
       nc->bbb_cell_ref[i] = -1;
 }
 
+/*!
+  \ingroup gnccell
+  Creates a copy of the cell \a cell_ref with the new name \a name.
+  All references (ports, nodes, nets and joins) of the copy are
+  identical to the original cell. A copy allows independent simulations
+  of the same netlist (see sydelay.c).
+  
+  \param nc A pointer to a gnc structure.
+  \param cell_ref A cell reference handle of the original cell.
+  \param name The unique name of the copy.
+  
+  \return A \a cell_ref handle to the copy or \c -1 if an error 
+    occured or a cell with the name \a name already exists.
+    
+  \see gnc_DelCell()
+*/
+int gnc_CopyCell(gnc nc, int cell_ref, const char *name)
+{
+  gcell cell = gnc_GetGCELL(nc, cell_ref);
+  int copy_ref;
+  
+  if ( gnc_FindCell(nc, name, cell->library) >= 0 )
+    return -1;
+  
+  copy_ref = gnc_AddCell(nc, name, cell->library);
+  if ( copy_ref < 0 )
+    return -1;
+  
+  if ( gcellCopy(gnc_GetGCELL(nc, copy_ref), cell) == 0 )
+    return gnc_DelCell(nc, copy_ref), -1;
+  
+  return copy_ref;
+}
+
 void gnc_ClearCell(gnc nc, int cell_ref)
 {
   gcell cell;
@@ -3006,7 +3231,7 @@ int gnc_GetCellNodeCnt(gnc nc, int cell_ref)
 
 char *gnc_GetCellNodeName(gnc nc, int cell_ref, int node_ref)
 {
-  static char s[16];
+  static B_TH_LOCAL char s[16];
   gnode node;
   node = gnc_GetCellGNODE(nc, cell_ref, node_ref);
   if ( node == NULL )
@@ -3215,7 +3440,7 @@ int gnc_GetCellNetCnt(gnc nc, int cell_ref)
 
 char *gnc_GetCellNetName(gnc nc, int cell_ref, int net_ref)
 {
-  static char s[16];
+  static B_TH_LOCAL char s[16];
   gnet net = gnc_GetCellGNET(nc, cell_ref, net_ref);
   if ( net == NULL )
     return NULL;
@@ -94,6 +94,7 @@ g1dv g1dvOpen(int cnt);
 void g1dvClose(g1dv g1);
 g1dv g1dvOpenByStr(const char *x, char *z);
 double g1dvCalc(g1dv g1, double x);
+int g1dvCopy(g1dv *g1, g1dv src);
 
 /* two dimensional values */
 struct _g2dv_struct
@@ -112,6 +113,7 @@ double g2dvGetVal(g2dv g2, int xpos, int ypos);
 void g2dvSetVal(g2dv g2, int xpos, int ypos, double val);
 g2dv g2dvOpenByStr(const char *x, const char *y, char *z);
 double g2dvCalc(g2dv g2, double x, double y);
+int g2dvCopy(g2dv *g2, g2dv src);
 
 
 /* rise delay is:                                                           */
@@ -142,6 +144,7 @@ void gpotiClose(gpoti pt);
 
 int gpotiWrite(gpoti pt, FILE *fp);
 int gpotiRead(gpoti pt, FILE *fp);
+int gpotiCopy(gpoti pt, gpoti src);
 size_t gpotiGetMemUsage(gpoti pt);
 
 /* gate logic value for gnetlv.c and gnetsim.c */
@@ -509,6 +512,7 @@ int gnc_LoopLibCell(gnc nc, int lib_ref, int *cell_ref);
 int gnc_AddCell(gnc nc, const char *cellname, const char *library);
 
 void gnc_DelCell(gnc nc, int cell_ref);
+int gnc_CopyCell(gnc nc, int cell_ref, const char *name);
 void gnc_ClearCell(gnc nc, int cell_ref);
 
 /* returns cell_ref */
@@ -929,6 +933,8 @@ int gnc_SynthGenericRegister(gnc nc, int cell_ref, int register_width);
 #define GNC_HL_OPT_ENC_IC_ALL  0x02000
 #define GNC_HL_OPT_ENC_IC_PART 0x03000
 #define GNC_HL_OPT_ENC_SIMPLE  0x04000
+#define GNC_HL_OPT_ENC_SEARCH  0x05000
+#define GNC_HL_OPT_ENC_ANNEAL  0x06000
 
 #define GNC_HL_OPT_USE_OLD_DLY    0x10000
 #define GNC_HL_OPT_OLD_MIN_STATE  0x20000
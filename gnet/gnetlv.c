@@ -27,6 +27,7 @@
 #include <assert.h>
 #include "gnet.h"
 #include "fsmtest.h"
+#include "b_th.h"
 
 
 /*---------------------------------------------------------------------------*/
@@ -153,7 +154,7 @@ glv_struct *gnc_GetCellPortLogicVal(gnc nc, int cell_ref, int port_ref)
   return &(gcellGetGPORT(cell, port_ref)->lv);
 }
 
-static char _gnc_input_values[1024];
+static B_TH_LOCAL char _gnc_input_values[1024];
 
 /* returns logical value GLV_.... */
 static int gnc_CalcLogicValOR(gnc nc, int cell_ref, int node_ref)
@@ -874,7 +875,7 @@ int gnc_CompareCellFSMStateForSimulation(gnc nc, int cell_ref, pinfo *pi, dcube
 
   if ( 0 >= nc->log_level )
   {
-    static char s[100];
+    static B_TH_LOCAL char s[100];
     int total = gnc_GetGCELL(nc, cell_ref)->pi->in_cnt
                  + gnc_GetGCELL(nc, cell_ref)->pi->out_cnt;
     for( i = 0; i < total && i < 100-1; i++ )
@@ -204,6 +204,22 @@ int g1dvRead(g1dv *g1, FILE *fp)
   return 1;
 }
 
+int g1dvCopy(g1dv *g1, g1dv src)
+{
+  if ( *g1 != NULL )
+    g1dvClose(*g1);
+  *g1 = NULL;
+  
+  if ( src == NULL )
+    return 1;
+  
+  *g1 = g1dvOpen(src->idx_cnt);
+  if ( *g1 == NULL )                                        return 0;
+  memcpy((*g1)->idx_vals, src->idx_vals, sizeof(double)*src->idx_cnt);
+  memcpy((*g1)->values, src->values, sizeof(double)*src->idx_cnt);
+  return 1;
+}
+
 size_t g1dvGetMemUsage(g1dv g1)
 {
   return sizeof(struct _g1dv_struct)+2*g1->idx_cnt*sizeof(double);
@@ -364,6 +380,23 @@ int g2dvRead(g2dv *g2, FILE *fp)
   return 1;
 }
 
+int g2dvCopy(g2dv *g2, g2dv src)
+{
+  if ( *g2 != NULL )
+    g2dvClose(*g2);
+  *g2 = NULL;
+  
+  if ( src == NULL )
+    return 1;
+  
+  *g2 = g2dvOpen(src->idx1_cnt, src->idx2_cnt);
+  if ( *g2 == NULL )                                           return 0;
+  memcpy((*g2)->idx1_vals, src->idx1_vals, sizeof(double)*src->idx1_cnt);
+  memcpy((*g2)->idx2_vals, src->idx2_vals, sizeof(double)*src->idx2_cnt);
+  memcpy((*g2)->values, src->values, sizeof(double)*src->idx1_cnt*src->idx2_cnt);
+  return 1;
+}
+
 size_t g2dvGetMemUsage(g2dv g2)
 {
   return sizeof(struct _g2dv_struct)+
@@ -451,6 +484,22 @@ int gpotiRead(gpoti pt, FILE *fp)
   return 1;
 }
 
+int gpotiCopy(gpoti pt, gpoti src)
+{
+  pt->related_port_ref = src->related_port_ref;
+  pt->rise_block_delay = src->rise_block_delay;
+  pt->rise_fanout_delay = src->rise_fanout_delay;
+  pt->fall_block_delay = src->fall_block_delay;
+  pt->fall_fanout_delay = src->fall_fanout_delay;
+  if ( g2dvCopy(&(pt->rise_cell), src->rise_cell) == 0 )                return 0;
+  if ( g1dvCopy(&(pt->rise_propagation), src->rise_propagation) == 0 )  return 0;
+  if ( g1dvCopy(&(pt->rise_transition), src->rise_transition) == 0 )    return 0;
+  if ( g2dvCopy(&(pt->fall_cell), src->fall_cell) == 0 )                return 0;
+  if ( g1dvCopy(&(pt->fall_propagation), src->fall_propagation) == 0 )  return 0;
+  if ( g1dvCopy(&(pt->fall_transition), src->fall_transition) == 0 )    return 0;
+  return 1;
+}
+
 size_t gpotiGetMemUsage(gpoti pt)
 {
   return sizeof(struct _gpoti_struct)+
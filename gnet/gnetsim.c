@@ -50,6 +50,7 @@
 #include <stdlib.h>
 #include <assert.h>
 #include "gnetsim.h"
+#include "b_th.h"
 
 
 
@@ -199,6 +200,19 @@ double gspq_GetMTime(gspq_type pq, int x, int y)
 }
 
 
+/* dest = max(dest, src) for all pools and the m matrix, both for the same cell size */
+void gspq_ApplyMaxAll(gspq_type dest, gspq_type src)
+{
+  int i, cnt = gnc_GetCellPortMax(dest->nc, dest->cell_ref);
+  assert( cnt == gnc_GetCellPortMax(src->nc, src->cell_ref) );
+  for( i = 0; i < GSPQ_T_POOL_CNT*cnt; i++ )
+    if ( dest->t_max[i] < src->t_max[i] )
+      dest->t_max[i] = src->t_max[i];
+  for( i = 0; i < cnt*cnt; i++ )
+    if ( dest->m_max[i] < src->m_max[i] )
+      dest->m_max[i] = src->m_max[i];
+}
+
 double gspq_GetMaxTime(gspq_type pq, int pool)
 {
   double max = 0.0;
@@ -931,7 +945,7 @@ int gspq_CompareCellFSMStateForSimulation(gspq_type pq, pinfo *pi, dcube *c)
 
   if ( 0 >= pq->nc->log_level )
   {
-    static char s[100];
+    static B_TH_LOCAL char s[100];
     int total = gnc_GetGCELL(pq->nc, pq->cell_ref)->pi->in_cnt
                  + gnc_GetGCELL(pq->nc, pq->cell_ref)->pi->out_cnt;
     for( i = 0; i < total && i < 100-1; i++ )
@@ -1002,7 +1016,7 @@ int gspq_CompareCellXBMStateForSimulation(gspq_type pq, dcube *c)
 
   if ( 0 >= pq->nc->log_level )
   {
-    static char s[100];
+    static B_TH_LOCAL char s[100];
     int total = gnc_GetGCELL(pq->nc, pq->cell_ref)->pi->in_cnt
                  + gnc_GetGCELL(pq->nc, pq->cell_ref)->pi->out_cnt;
     for( i = 0; i < total && i < 100-1; i++ )
@@ -76,12 +76,16 @@ gspq_type gspq_Open(gnc nc, int cell_ref);
 void gspq_Close(gspq_type pq);
 
 void gspq_ClearPool(gspq_type pq, int pool);
+void gspq_ClearTime(gspq_type pq);
 void gspq_ApplyMaxTime(gspq_type pq, int pool, int pos, double time);
 double gspq_GetTime(gspq_type pq, int pool, int pos);
 
 void gspq_ApplyMaxMTime(gspq_type pq, int x, int y, double time);
 double gspq_GetMTime(gspq_type pq, int x, int y);
 
+/* merge the results of another simulator (e.g. for a copy of the cell) */
+void gspq_ApplyMaxAll(gspq_type dest, gspq_type src);
+
 void gspq_CalculateUnknownValues(gspq_type pq);
 int gspq_ApplyCellFSMSimulationTransitionState(gspq_type pq, pinfo *pi_in, dcube *c_in, pinfo *pi_z, dcube *c_z);
 int gspq_ApplyCellFSMSimulationTransition(gspq_type pq, pinfo *pi_in, dcube *c_in);
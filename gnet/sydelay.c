@@ -28,6 +28,9 @@
 #include "gnet.h"
 #include "gnetsim.h"
 #include "b_dg.h"
+#include "b_th.h"
+#include "b_il.h"
+#include <stdio.h>
 #include <limits.h>
 #include <math.h>
 #include "mwc.h"
@@ -1309,6 +1312,157 @@ int gnc_AddDelayPath(gnc nc, int cell_ref, double min_dly, const char *in_delay_
 
 /*---------------------------------------------------------------------------*/
 
+/*
+  Parallel simulation of XBM transitions. The transitions are collected
+  first (n1, n2 pairs in 'cl'), then each worker thread simulates its
+  transitions with its own simulator and its own copy of the cell.
+  The results of the simulators are combined with gspq_ApplyMaxAll().
+  If the cell can not be copied (memory error in gnc_CopyCell()), the
+  transitions are simulated with the original simulator in one thread.
+*/
+
+struct _gspq_xbm_struct
+{
+  gspq_type pq;
+  xbm_type x;
+  int th_cnt;
+  int cell_ref[B_TH_MAX];
+  gspq_type th_pq[B_TH_MAX];
+  dclist cl;                  /* n1, n2 for each transition */
+  b_il_type il;               /* tr_pos, var_in_idx for each transition */
+  void (*log_fn)(void *data, const char *fmt, va_list va);
+  void *log_data;
+  void (*err_fn)(void *data, const char *fmt, va_list va);
+  void *err_data;
+};
+typedef struct _gspq_xbm_struct gspq_xbm_struct;
+
+static void gspq_xbm_log_fn(void *data, const char *fmt, va_list va)
+{
+  gspq_xbm_struct *gx = (gspq_xbm_struct *)data;
+  b_th_Lock();
+  gx->log_fn(gx->log_data, fmt, va);
+  b_th_Unlock();
+}
+
+static void gspq_xbm_err_fn(void *data, const char *fmt, va_list va)
+{
+  gspq_xbm_struct *gx = (gspq_xbm_struct *)data;
+  b_th_Lock();
+  gx->err_fn(gx->err_data, fmt, va);
+  b_th_Unlock();
+}
+
+static int gspq_xbm_init(gspq_xbm_struct *gx, gspq_type pq, xbm_type x)
+{
+  int i;
+  gx->pq = pq;
+  gx->x = x;
+  gx->th_cnt = 0;
+  gx->il = NULL;
+  if ( dclInit(&(gx->cl)) == 0 )
+    return 0;
+  gx->il = b_il_Open();
+  if ( gx->il == NULL )
+    return dclDestroy(gx->cl), 0;
+  for( i = 0; i < B_TH_MAX; i++ )
+  {
+    gx->cell_ref[i] = -1;
+    gx->th_pq[i] = NULL;
+  }
+  return 1;
+}
+
+static void gspq_xbm_close_th(gspq_xbm_struct *gx)
+{
+  int i;
+  for( i = 0; i < gx->th_cnt; i++ )
+  {
+    if ( gx->th_pq[i] != NULL )
+      gspq_Close(gx->th_pq[i]);
+    if ( gx->cell_ref[i] >= 0 )
+      gnc_DelCell(gx->pq->nc, gx->cell_ref[i]);
+    gx->th_pq[i] = NULL;
+    gx->cell_ref[i] = -1;
+  }
+  gx->th_cnt = 0;
+}
+
+static void gspq_xbm_destroy(gspq_xbm_struct *gx)
+{
+  gspq_xbm_close_th(gx);
+  b_il_Close(gx->il);
+  dclDestroy(gx->cl);
+}
+
+static int gspq_xbm_add(gspq_xbm_struct *gx, int tr_pos, int var_in_idx, dcube *n1, dcube *n2)
+{
+  if ( dclAdd(gx->x->pi_machine, gx->cl, n1) < 0 ) return 0;
+  if ( dclAdd(gx->x->pi_machine, gx->cl, n2) < 0 ) return 0;
+  if ( b_il_Add(gx->il, tr_pos) < 0 ) return 0;
+  if ( b_il_Add(gx->il, var_in_idx) < 0 ) return 0;
+  return 1;
+}
+
+/* create a copy of the cell and a simulator for each thread */
+static int gspq_xbm_open_th(gspq_xbm_struct *gx, int th_cnt)
+{
+  gnc nc = gx->pq->nc;
+  char name[32];
+  int i;
+  for( i = 0; i < th_cnt; i++ )
+  {
+    sprintf(name, "#sim%d", i);
+    gx->cell_ref[i] = gnc_CopyCell(nc, gx->pq->cell_ref, name);
+    gx->th_cnt = i+1;
+    if ( gx->cell_ref[i] < 0 )
+      return 0;
+    gx->th_pq[i] = gspq_Open(nc, gx->cell_ref[i]);
+    if ( gx->th_pq[i] == NULL )
+      return 0;
+    gx->th_pq[i]->is_stop_at_fsm_input = gx->pq->is_stop_at_fsm_input;
+  }
+  return 1;
+}
+
+/* simulate all collected transitions with fn, returns 0 for an error */
+static int gspq_xbm_do(gspq_xbm_struct *gx, int thread_cnt, b_th_fn_type fn)
+{
+  gnc nc = gx->pq->nc;
+  int i, r;
+  
+  if ( gspq_xbm_open_th(gx, thread_cnt) == 0 )
+  {
+    gspq_xbm_close_th(gx);
+    gnc_Log(nc, 3, "Simulation: Copy of the cell failed, continue with one thread.");
+    thread_cnt = 1;
+    gx->th_pq[0] = gx->pq;
+  }
+  
+  gx->log_fn = nc->log_fn;
+  gx->log_data = nc->log_data;
+  gx->err_fn = nc->err_fn;
+  gx->err_data = nc->err_data;
+  nc->log_fn = gspq_xbm_log_fn;
+  nc->log_data = gx;
+  nc->err_fn = gspq_xbm_err_fn;
+  nc->err_data = gx;
+  
+  r = b_th_Do(thread_cnt, dclCnt(gx->cl)/2, fn, gx);
+  
+  nc->log_fn = gx->log_fn;
+  nc->log_data = gx->log_data;
+  nc->err_fn = gx->err_fn;
+  nc->err_data = gx->err_data;
+  
+  if ( r == 0 )
+    return 0;
+  for( i = 0; i < gx->th_cnt; i++ )
+    gspq_ApplyMaxAll(gx->pq, gx->th_pq[i]);
+  return 1;
+}
+
+/*---------------------------------------------------------------------------*/
 
 static void gspq_ess_time(gspq_type pq, dcube *src_c, dcube *dest_c)
 {
@@ -1447,7 +1601,9 @@ static int xbm_ess_cb(xbm_type x, void *data, dcube *n1, dcube *n2, dcube *n3)
 {
   gspq_type pq = (gspq_type)data;
 
-
+  /* each transition starts with a new time line, the indexed time of */
+  /* the previous transition is not used as maximum delay any more */
+  gspq_ClearTime(pq);
   pq->is_calc_max_in_out_dly = 0;
 
   gnc_SetAllCellNetLogicVal(pq->nc, pq->cell_ref, GLV_UNKNOWN);
@@ -1502,6 +1658,40 @@ static int xbm_ess_cb(xbm_type x, void *data, dcube *n1, dcube *n2, dcube *n3)
 }
 
 
+static int xbm_ess_collect_cb(xbm_type x, void *data, dcube *n1, dcube *n2, dcube *n3)
+{
+  return gspq_xbm_add((gspq_xbm_struct *)data, -1, -1, n1, n2);
+}
+
+static int xbm_ess_th(void *data, int th, int pos)
+{
+  gspq_xbm_struct *gx = (gspq_xbm_struct *)data;
+  return xbm_ess_cb(gx->x, gx->th_pq[th], 
+    dclGet(gx->cl, 2*pos), dclGet(gx->cl, 2*pos+1), NULL);
+}
+
+static int gspq_calc_xbm_ess(gspq_type pq, xbm_type x)
+{
+  gspq_xbm_struct gx;
+  int thread_cnt;
+  int r;
+  
+  if ( b_th_GetCnt(0, 2) <= 1 )
+    return xbm_CalcEssentialHazards(x, xbm_ess_cb, pq);
+  
+  if ( gspq_xbm_init(&gx, pq, x) == 0 )
+    return 0;
+  r = xbm_CalcEssentialHazards(x, xbm_ess_collect_cb, &gx);
+  if ( r != 0 )
+  {
+    thread_cnt = b_th_GetCnt(0, dclCnt(gx.cl)/2);
+    gnc_Log(pq->nc, 3, "XBM: Essential hazard simulation with %d thread(s).", thread_cnt);
+    r = gspq_xbm_do(&gx, thread_cnt, xbm_ess_th);
+  }
+  gspq_xbm_destroy(&gx);
+  return r;
+}
+
 int gspq_InsertXBMFeedbackDelay(gspq_type pq, xbm_type x)
 {
   int inputs = gnc_GetGCELL(pq->nc, pq->cell_ref)->pi->in_cnt;
@@ -1519,7 +1709,7 @@ int gspq_InsertXBMFeedbackDelay(gspq_type pq, xbm_type x)
   logic_delay = gnc_GetCellTotalMaxDelay(pq->nc, pq->cell_ref);
   
 
-  if ( xbm_CalcEssentialHazards(x, xbm_ess_cb, pq) == 0 )
+  if ( gspq_calc_xbm_ess(pq, x) == 0 )
     return 0;
 
   if ( x->total_cnt > 0 )
@@ -1778,6 +1968,9 @@ static int xbm_fm_cb(xbm_type x, void *data, int tr_pos, int var_in_idx, dcube *
 {
   gspq_type pq = (gspq_type)data;
 
+  /* each transition starts with a new time line, the indexed time of */
+  /* the previous transition is not used as maximum delay any more */
+  gspq_ClearTime(pq);
   pq->is_stop_at_fsm_input = 0;
   pq->is_calc_max_in_out_dly = 0;
 
@@ -1800,6 +1993,41 @@ static int xbm_fm_cb(xbm_type x, void *data, int tr_pos, int var_in_idx, dcube *
   
 }
 
+static int xbm_fm_collect_cb(xbm_type x, void *data, int tr_pos, int var_in_idx, dcube *n1, dcube *n2)
+{
+  return gspq_xbm_add((gspq_xbm_struct *)data, tr_pos, var_in_idx, n1, n2);
+}
+
+static int xbm_fm_th(void *data, int th, int pos)
+{
+  gspq_xbm_struct *gx = (gspq_xbm_struct *)data;
+  return xbm_fm_cb(gx->x, gx->th_pq[th], 
+    b_il_GetVal(gx->il, 2*pos), b_il_GetVal(gx->il, 2*pos+1),
+    dclGet(gx->cl, 2*pos), dclGet(gx->cl, 2*pos+1));
+}
+
+static int gspq_do_xbm_fm(gspq_type pq, xbm_type x)
+{
+  gspq_xbm_struct gx;
+  int thread_cnt;
+  int r;
+  
+  if ( b_th_GetCnt(0, 2) <= 1 )
+    return xbm_DoTransitions(x, xbm_fm_cb, pq);
+  
+  if ( gspq_xbm_init(&gx, pq, x) == 0 )
+    return 0;
+  r = xbm_DoTransitions(x, xbm_fm_collect_cb, &gx);
+  if ( r != 0 )
+  {
+    thread_cnt = b_th_GetCnt(0, dclCnt(gx.cl)/2);
+    gnc_Log(pq->nc, 3, "Fundamental mode dly calc: Simulation with %d thread(s).", thread_cnt);
+    r = gspq_xbm_do(&gx, thread_cnt, xbm_fm_th);
+  }
+  gspq_xbm_destroy(&gx);
+  return r;
+}
+
 int gspq_GetFundamentalModeXBM(gspq_type pq, xbm_type x)
 {
   int fb_cnt = gnc_GetGCELL(pq->nc, pq->cell_ref)->register_width;
@@ -1810,7 +2038,7 @@ int gspq_GetFundamentalModeXBM(gspq_type pq, xbm_type x)
 
   gspq_ClearPool(pq, 2);
 
-  if ( xbm_DoTransitions(x, xbm_fm_cb, pq) == 0 )
+  if ( gspq_do_xbm_fm(pq, x) == 0 )
     return -1.0;
 
   for( i = 0; i < inputs-fb_cnt; i++ )
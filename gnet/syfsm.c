@@ -1003,6 +1003,8 @@ int gnc_SynthClockedFSM(gnc nc, fsm_type fsm, const char *cell_name, const char
     case GNC_HL_OPT_ENC_IC_ALL:  encode = FSM_ENCODE_IC_ALL; break;
     case GNC_HL_OPT_ENC_IC_PART: encode = FSM_ENCODE_IC_PART; break;
     case GNC_HL_OPT_ENC_SIMPLE:  encode = FSM_ENCODE_SIMPLE; break;
+    case GNC_HL_OPT_ENC_SEARCH:  encode = FSM_ENCODE_SEARCH; break;
+    case GNC_HL_OPT_ENC_ANNEAL:  encode = FSM_ENCODE_ANNEAL; break;
     default:                     encode = FSM_ENCODE_SIMPLE; break;
   }
     
@@ -1025,7 +1027,16 @@ int gnc_SynthClockedFSM(gnc nc, fsm_type fsm, const char *cell_name, const char
     }
   }
 
-  if ( fsm_BuildClockedMachine(fsm, encode) == 0 )
+  if ( encode == FSM_ENCODE_SEARCH )
+  {
+    if ( fsm_BuildClockedMachineBySearch(fsm, 
+          nc->syparam.enc_search_cnt, nc->syparam.enc_search_ms) == 0 )
+    {
+      gnc_Error(nc, "gnc_SynthClockedFSM: Can not create control function.");
+      return fsm_PopLogFn(fsm), -1;
+    }
+  }
+  else if ( fsm_BuildClockedMachine(fsm, encode) == 0 )
   {
     gnc_Error(nc, "gnc_SynthClockedFSM: Can not create control function.");
     return fsm_PopLogFn(fsm), -1;
@@ -31,5 +31,7 @@ int syparam_Init(syparam_struct *syparam)
 {
   syparam->gate_expansion = SYPARAM_GATE_EXPANSION_BALANCED;
   syparam->delay_safety = GNC_DEFAULT_DELAY_SAFETY;
+  syparam->enc_search_cnt = GNC_DEFAULT_ENC_SEARCH_CNT;
+  syparam->enc_search_ms = 0L;
   return 1;
 }
@@ -31,6 +31,7 @@
 #define SYPARAM_GATE_EXPANSION_AREA_OPTIMIZED   1
 
 #define GNC_DEFAULT_DELAY_SAFETY 1.10
+#define GNC_DEFAULT_ENC_SEARCH_CNT 64
 
 
 
@@ -46,6 +47,13 @@ struct _syparam_struct
     file: sydelay.c
   */
   double delay_safety;
+  /*
+    file: syfsm.c, GNC_HL_OPT_ENC_SEARCH
+    enc_search_cnt: number of evaluated state encodings
+    enc_search_ms: time limit in milliseconds, 0: no limit
+  */
+  int enc_search_cnt;
+  long enc_search_ms;
 };
 typedef struct _syparam_struct syparam_struct;
 
@@ -48,6 +48,7 @@
 #include <stdarg.h>
 #include <assert.h>
 #include "b_bcp.h"
+#include "b_th.h"
 
 /* #define BCM_LOG */
 
@@ -1452,14 +1453,729 @@ static int b_bcp_recursion(b_bcp_type bc, bcm_type m, bcs_type x)
 }
 
 
+/*--- packed rows ----------------------------------------------------------*/
+/*
+  Each row (clause) of the matrix is stored as two bitplanes:
+  'pos' contains all columns with BCN_VAL_ONE, 'neg' all columns with
+  BCN_VAL_ZERO. The current (partial) selection is also stored as two
+  bitsets 'one' and 'zero'. A row is satisfied, if
+    (pos & one) | (neg & zero) 
+  is not empty. Reductions are done with unit propagation (a row with
+  only one free literal forces this literal) and with the pure literal
+  rule (a column which does not appear with a free positive literal in
+  any unsatisfied row can be set to zero). Decisions are undone with
+  a trail of assigned columns and satisfied rows.
+  
+  If more than one thread is requested, the first levels of the 
+  search tree are expanded into a list of decision prefixes, which 
+  are solved by the worker threads. The best solution is shared.
+  Solutions with the same cost are ordered by their position in the
+  search tree (the tasks are numbered in depth first order), so the
+  threads always return the same solution as the serial search: The
+  first solution with minimal cost.
+*/
+
+typedef unsigned long bcx_word;
+#define BCX_BITS ((int)(sizeof(bcx_word)*8))
+#define BCX_WORDS(n) (((n)+BCX_BITS-1)/BCX_BITS)
+#define BCX_BIT(pos) (((bcx_word)1)<<((pos)%BCX_BITS))
+#define BCX_IS(set,pos) (((set)[(pos)/BCX_BITS] & BCX_BIT(pos)) != 0)
+#define BCX_SET(set,pos) ((set)[(pos)/BCX_BITS] |= BCX_BIT(pos))
+#define BCX_CLR(set,pos) ((set)[(pos)/BCX_BITS] &= ~BCX_BIT(pos))
+
+#if defined(__GNUC__)
+#define bcx_popcount(w) (__builtin_popcountl(w))
+#define bcx_lowest(w) (__builtin_ctzl(w))
+#else
+static int bcx_popcount(bcx_word w)
+{
+  int cnt = 0;
+  while( w != 0 )
+  {
+    w &= w-1;
+    cnt++;
+  }
+  return cnt;
+}
+static int bcx_lowest(bcx_word w)
+{
+  int pos = 0;
+  while( (w & 1) == 0 )
+  {
+    w >>= 1;
+    pos++;
+  }
+  return pos;
+}
+#endif
+
+/* maximum depth of the decision prefixes for the worker threads */
+#define BCX_TASK_DEPTH_MAX 12
+
+struct _bcx_struct
+{
+  int width;          /* number of columns */
+  int height;         /* number of rows */
+  int words;          /* words per row (columns) */
+  int row_words;      /* words for the set of rows */
+  bcx_word *pos;      /* height*words */
+  bcx_word *neg;      /* height*words */
+  
+  int is_greedy;
+  
+  /* best result, shared between the threads */
+  int best_cost;
+  int is_found;
+  long best_key;      /* bcx_GetKey() of the best result */
+  long key_mul;       /* greater than the order of all solutions */
+  bcx_word *best;     /* words */
+  
+  /* decision prefixes for the worker threads */
+  int task_depth;
+  int *task_ptr;      /* decision: column*2 + (val == BCN_VAL_ONE) */
+  int task_cnt;       /* number of tasks */
+  int task_max;
+};
+typedef struct _bcx_struct *bcx_type;
+
+struct _bcxs_struct
+{
+  bcx_type x;
+  bcx_word *one;      /* words */
+  bcx_word *zero;     /* words */
+  bcx_word *sat;      /* row_words */
+  bcx_word *occ;      /* words, temp. */
+  int cost;           /* number of bits in 'one' */
+  int order;          /* position of the current subtree in the search order */
+  
+  int *trail_col;     /* width */
+  int trail_col_cnt;
+  int *trail_row;     /* height */
+  int trail_row_cnt;
+  
+  int *decision;      /* width, decisions of the current path */
+  int decision_cnt;
+  
+  int *row_cnt;       /* height, lower bound */
+  int *row_order;     /* height, lower bound */
+  int *bucket;        /* width+2, lower bound */
+  double *weight;     /* width, branch column */
+};
+typedef struct _bcxs_struct *bcxs_type;
+
+static bcx_type bcx_Open(bcm_type m)
+{
+  bcx_type x;
+  bcn_type row, n;
+  int y;
+  
+  x = (bcx_type)malloc(sizeof(struct _bcx_struct));
+  if ( x == NULL )
+    return NULL;
+  x->width = m->width;
+  x->height = bcn_dl_get_cnt(m->ul, 1);
+  x->words = BCX_WORDS(x->width);
+  if ( x->words == 0 )
+    x->words = 1;
+  x->row_words = BCX_WORDS(x->height);
+  if ( x->row_words == 0 )
+    x->row_words = 1;
+  x->is_greedy = 0;
+  x->best_cost = x->width+1;
+  x->is_found = 0;
+  x->key_mul = 1;
+  x->best_key = (long)x->best_cost;
+  x->task_depth = 0;
+  x->task_ptr = NULL;
+  x->task_cnt = 0;
+  x->task_max = 0;
+  x->pos = (bcx_word *)calloc((size_t)x->height*x->words+1, sizeof(bcx_word));
+  x->neg = (bcx_word *)calloc((size_t)x->height*x->words+1, sizeof(bcx_word));
+  x->best = (bcx_word *)calloc(x->words, sizeof(bcx_word));
+  if ( x->pos == NULL || x->neg == NULL || x->best == NULL )
+  {
+    if ( x->pos != NULL ) free(x->pos);
+    if ( x->neg != NULL ) free(x->neg);
+    if ( x->best != NULL ) free(x->best);
+    free(x);
+    return NULL;
+  }
+  
+  /* copy the linked matrix, DC values are ignored */
+  y = 0;
+  row = N(m->ul, 1);
+  while( row != NULL )
+  {
+    n = N(row, 0);
+    while( n != NULL )
+    {
+      if ( n->val == BCN_VAL_ONE )
+        BCX_SET(x->pos+y*x->words, XY(n, 0));
+      else if ( n->val == BCN_VAL_ZERO )
+        BCX_SET(x->neg+y*x->words, XY(n, 0));
+      n = N(n, 0);
+    }
+    y++;
+    row = N(row, 1);
+  }
+  return x;
+}
+
+static void bcx_Close(bcx_type x)
+{
+  if ( x->task_ptr != NULL )
+    free(x->task_ptr);
+  free(x->pos);
+  free(x->neg);
+  free(x->best);
+  free(x);
+}
+
+static bcxs_type bcxs_Open(bcx_type x)
+{
+  bcxs_type s;
+  s = (bcxs_type)malloc(sizeof(struct _bcxs_struct));
+  if ( s == NULL )
+    return NULL;
+  s->x = x;
+  s->cost = 0;
+  s->order = 0;
+  s->trail_col_cnt = 0;
+  s->trail_row_cnt = 0;
+  s->decision_cnt = 0;
+  s->one = (bcx_word *)calloc(x->words, sizeof(bcx_word));
+  s->zero = (bcx_word *)calloc(x->words, sizeof(bcx_word));
+  s->occ = (bcx_word *)calloc(x->words, sizeof(bcx_word));
+  s->sat = (bcx_word *)calloc(x->row_words, sizeof(bcx_word));
+  s->trail_col = (int *)malloc((x->width+1)*sizeof(int));
+  s->decision = (int *)malloc((x->width+1)*sizeof(int));
+  s->trail_row = (int *)malloc((x->height+1)*sizeof(int));
+  s->row_cnt = (int *)malloc((x->height+1)*sizeof(int));
+  s->row_order = (int *)malloc((x->height+1)*sizeof(int));
+  s->bucket = (int *)malloc((x->width+2)*sizeof(int));
+  s->weight = (double *)malloc((x->width+1)*sizeof(double));
+  if ( s->one != NULL && s->zero != NULL && s->occ != NULL && s->sat != NULL
+    && s->trail_col != NULL && s->decision != NULL && s->trail_row != NULL 
+    && s->row_cnt != NULL && s->row_order != NULL && s->bucket != NULL 
+    && s->weight != NULL )
+    return s;
+  if ( s->one != NULL ) free(s->one);
+  if ( s->zero != NULL ) free(s->zero);
+  if ( s->occ != NULL ) free(s->occ);
+  if ( s->sat != NULL ) free(s->sat);
+  if ( s->trail_col != NULL ) free(s->trail_col);
+  if ( s->decision != NULL ) free(s->decision);
+  if ( s->trail_row != NULL ) free(s->trail_row);
+  if ( s->row_cnt != NULL ) free(s->row_cnt);
+  if ( s->row_order != NULL ) free(s->row_order);
+  if ( s->bucket != NULL ) free(s->bucket);
+  if ( s->weight != NULL ) free(s->weight);
+  free(s);
+  return NULL;
+}
+
+static void bcxs_Close(bcxs_type s)
+{
+  free(s->one);
+  free(s->zero);
+  free(s->occ);
+  free(s->sat);
+  free(s->trail_col);
+  free(s->decision);
+  free(s->trail_row);
+  free(s->row_cnt);
+  free(s->row_order);
+  free(s->bucket);
+  free(s->weight);
+  free(s);
+}
+
+static void bcxs_Assign(bcxs_type s, int col, int val)
+{
+  if ( val == BCN_VAL_ONE )
+  {
+    BCX_SET(s->one, col);
+    s->cost++;
+  }
+  else
+  {
+    BCX_SET(s->zero, col);
+  }
+  s->trail_col[s->trail_col_cnt++] = col;
+}
+
+static void bcxs_SetSat(bcxs_type s, int row)
+{
+  BCX_SET(s->sat, row);
+  s->trail_row[s->trail_row_cnt++] = row;
+}
+
+/* undo all assignments after the trail positions */
+static void bcxs_Undo(bcxs_type s, int col_cnt, int row_cnt)
+{
+  int col, row;
+  while( s->trail_col_cnt > col_cnt )
+  {
+    col = s->trail_col[--s->trail_col_cnt];
+    if ( BCX_IS(s->one, col) )
+    {
+      BCX_CLR(s->one, col);
+      s->cost--;
+    }
+    else
+    {
+      BCX_CLR(s->zero, col);
+    }
+  }
+  while( s->trail_row_cnt > row_cnt )
+  {
+    row = s->trail_row[--s->trail_row_cnt];
+    BCX_CLR(s->sat, row);
+  }
+}
+
+/* reset the state to the empty selection */
+static void bcxs_Clear(bcxs_type s)
+{
+  bcxs_Undo(s, 0, 0);
+  s->decision_cnt = 0;
+}
+
+/* 
+  unit propagation and pure literal rule 
+  returns 0, if there is a row, which can not be satisfied
+*/
+static int bcxs_Propagate(bcxs_type s)
+{
+  bcx_type x = s->x;
+  int words = x->words;
+  int r, w;
+  int is_changed;
+  int lit_cnt, lit_col, lit_val;
+  bcx_word *p, *n;
+  bcx_word f, fp, fn, pure;
+  
+  do
+  {
+    is_changed = 0;
+    
+    /* unit propagation */
+    for( r = 0; r < x->height; r++ )
+    {
+      if ( BCX_IS(s->sat, r) )
+        continue;
+      p = x->pos + r*words;
+      n = x->neg + r*words;
+      lit_cnt = 0;
+      lit_col = -1;
+      lit_val = BCN_VAL_NONE;
+      for( w = 0; w < words; w++ )
+      {
+        if ( ((p[w] & s->one[w]) | (n[w] & s->zero[w])) != 0 )
+          break;
+        if ( lit_cnt < 2 )
+        {
+          f = ~(s->one[w] | s->zero[w]);
+          fp = p[w] & f;
+          fn = n[w] & f;
+          if ( fp != 0 )
+          {
+            lit_cnt += bcx_popcount(fp);
+            lit_col = w*BCX_BITS + bcx_lowest(fp);
+            lit_val = BCN_VAL_ONE;
+          }
+          if ( fn != 0 )
+          {
+            lit_cnt += bcx_popcount(fn);
+            lit_col = w*BCX_BITS + bcx_lowest(fn);
+            lit_val = BCN_VAL_ZERO;
+          }
+        }
+      }
+      if ( w < words )
+      {
+        bcxs_SetSat(s, r);   /* already satisfied */
+      }
+      else if ( lit_cnt == 0 )
+      {
+        return 0;            /* conflict */
+      }
+      else if ( lit_cnt == 1 )
+      {
+        bcxs_Assign(s, lit_col, lit_val);
+        bcxs_SetSat(s, r);
+        is_changed = 1;
+      }
+    }
+    
+    if ( is_changed != 0 )
+      continue;
+      
+    /* pure literal rule: free columns, which only occur negative */
+    for( w = 0; w < words; w++ )
+      s->occ[w] = 0;
+    for( r = 0; r < x->height; r++ )
+    {
+      if ( BCX_IS(s->sat, r) )
+        continue;
+      p = x->pos + r*words;
+      for( w = 0; w < words; w++ )
+        s->occ[w] |= p[w];
+    }
+    for( r = 0; r < x->height; r++ )
+    {
+      if ( BCX_IS(s->sat, r) )
+        continue;
+      n = x->neg + r*words;
+      for( w = 0; w < words; w++ )
+      {
+        pure = n[w] & ~s->occ[w] & ~(s->one[w] | s->zero[w]);
+        while( pure != 0 )
+        {
+          bcxs_Assign(s, w*BCX_BITS + bcx_lowest(pure), BCN_VAL_ZERO);
+          pure &= pure-1;
+          is_changed = 1;
+        }
+      }
+    }
+  } while( is_changed != 0 );
+  return 1;
+}
+
+/* returns 1 if all rows are satisfied */
+static int bcxs_IsDone(bcxs_type s)
+{
+  return s->trail_row_cnt >= s->x->height;
+}
+
+/* 
+  lower bound: rows with only free positive literals, 
+  which have no common column, require different columns
+*/
+static int bcxs_GetLowerBound(bcxs_type s)
+{
+  bcx_type x = s->x;
+  int words = x->words;
+  int r, w, i, cnt, order_cnt;
+  int lb;
+  bcx_word *p, *n;
+  bcx_word f;
+  
+  for( i = 0; i <= x->width+1; i++ )
+    s->bucket[i] = 0;
+  
+  order_cnt = 0;
+  for( r = 0; r < x->height; r++ )
+  {
+    s->row_cnt[r] = -1;
+    if ( BCX_IS(s->sat, r) )
+      continue;
+    p = x->pos + r*words;
+    n = x->neg + r*words;
+    cnt = 0;
+    for( w = 0; w < words; w++ )
+    {
+      f = ~(s->one[w] | s->zero[w]);
+      if ( (n[w] & f) != 0 )
+        break;
+      cnt += bcx_popcount(p[w] & f);
+    }
+    if ( w < words )
+      continue;
+    s->row_cnt[r] = cnt;
+    s->bucket[cnt+1]++;
+    order_cnt++;
+  }
+  
+  /* counting sort: shortest rows first */
+  for( i = 1; i <= x->width+1; i++ )
+    s->bucket[i] += s->bucket[i-1];
+  for( r = 0; r < x->height; r++ )
+    if ( s->row_cnt[r] >= 0 )
+      s->row_order[s->bucket[s->row_cnt[r]]++] = r;
+  
+  for( w = 0; w < words; w++ )
+    s->occ[w] = 0;
+  lb = 0;
+  for( i = 0; i < order_cnt; i++ )
+  {
+    p = x->pos + s->row_order[i]*words;
+    for( w = 0; w < words; w++ )
+      if ( (p[w] & ~(s->one[w] | s->zero[w]) & s->occ[w]) != 0 )
+        break;
+    if ( w < words )
+      continue;
+    for( w = 0; w < words; w++ )
+      s->occ[w] |= p[w] & ~(s->one[w] | s->zero[w]);
+    lb++;
+  }
+  
+  return s->cost + lb;
+}
+
+/* column with the highest weight: sum of 1/(free literals) over all rows */
+static int bcxs_ChooseBranchColumn(bcxs_type s)
+{
+  bcx_type x = s->x;
+  int words = x->words;
+  int r, w, col, cnt;
+  int best_col = -1;
+  double best_weight = -1.0;
+  double weight;
+  bcx_word *p, *n;
+  bcx_word f, fp;
+
+  for( col = 0; col < x->width; col++ )
+    s->weight[col] = 0.0;
+  
+  for( r = 0; r < x->height; r++ )
+  {
+    if ( BCX_IS(s->sat, r) )
+      continue;
+    p = x->pos + r*words;
+    n = x->neg + r*words;
+    cnt = 0;
+    for( w = 0; w < words; w++ )
+    {
+      f = ~(s->one[w] | s->zero[w]);
+      cnt += bcx_popcount((p[w] | n[w]) & f);
+    }
+    if ( cnt == 0 )
+      continue;
+    weight = 1.0/(double)cnt;
+    for( w = 0; w < words; w++ )
+    {
+      fp = p[w] & ~(s->one[w] | s->zero[w]);
+      while( fp != 0 )
+      {
+        s->weight[w*BCX_BITS + bcx_lowest(fp)] += weight;
+        fp &= fp-1;
+      }
+      if ( best_col < 0 )
+      {
+        /* fallback: any free column */
+        f = (p[w] | n[w]) & ~(s->one[w] | s->zero[w]);
+        if ( f != 0 )
+          best_col = w*BCX_BITS + bcx_lowest(f);
+      }
+    }
+  }
+  
+  for( col = 0; col < x->width; col++ )
+  {
+    if ( best_weight < s->weight[col] && s->weight[col] > 0.0 )
+    {
+      best_weight = s->weight[col];
+      best_col = col;
+    }
+  }
+  
+  return best_col;
+}
+
+/* solutions are compared by cost first, then by their order */
+#define bcx_GetKey(x, cost, order) ((long)(cost)*(x)->key_mul + (long)(order))
+
+/* best_key is written inside b_th_Lock(), but read without the lock */
+#if defined(__GNUC__)
+#define bcx_GetBestKey(x) __atomic_load_n(&((x)->best_key), __ATOMIC_ACQUIRE)
+#define bcx_SetBestKey(x, key) __atomic_store_n(&((x)->best_key), (key), __ATOMIC_RELEASE)
+#else
+#define bcx_GetBestKey(x) ((x)->best_key)
+#define bcx_SetBestKey(x, key) ((x)->best_key = (key))
+#endif
+
+static int bcx_IsGreedyDone(bcx_type x)
+{
+  int is_found;
+  if ( x->is_greedy == 0 )
+    return 0;
+  b_th_Lock();
+  is_found = x->is_found;
+  b_th_Unlock();
+  return is_found;
+}
+
+static void bcx_CheckBetterResult(bcx_type x, bcxs_type s)
+{
+  long key = bcx_GetKey(x, s->cost, s->order);
+  int w;
+  b_th_Lock();
+  if ( x->best_key > key )
+  {
+    bcx_SetBestKey(x, key);
+    x->best_cost = s->cost;
+    x->is_found = 1;
+    for( w = 0; w < x->words; w++ )
+      x->best[w] = s->one[w];
+  }
+  b_th_Unlock();
+}
+
+static int bcx_AddTask(bcx_type x, bcxs_type s)
+{
+  int *ptr;
+  int i;
+  if ( x->task_cnt >= x->task_max )
+  {
+    ptr = (int *)realloc(x->task_ptr, (x->task_max+64)*x->task_depth*sizeof(int));
+    if ( ptr == NULL )
+      return 0;
+    x->task_ptr = ptr;
+    x->task_max += 64;
+  }
+  for( i = 0; i < x->task_depth; i++ )
+    x->task_ptr[x->task_cnt*x->task_depth+i] = s->decision[i];
+  x->task_cnt++;
+  return 1;
+}
+
+/* 
+  branch and bound 
+  is_collect != 0: stop at x->task_depth and store the decisions as task
+  returns 0 for memory error
+*/
+static int bcxs_Recursion(bcxs_type s, int is_collect)
+{
+  bcx_type x = s->x;
+  int col_cnt = s->trail_col_cnt;
+  int row_cnt = s->trail_row_cnt;
+  int col_mark, row_mark;
+  int col;
+  int val;
+  int i;
+  
+  if ( bcxs_Propagate(s) == 0 )
+    return bcxs_Undo(s, col_cnt, row_cnt), 1;
+  col_mark = s->trail_col_cnt;
+  row_mark = s->trail_row_cnt;
+
+  /* a solution, found while the tasks are collected, is before the next task */
+  if ( is_collect != 0 )
+    s->order = 2*x->task_cnt;
+
+  if ( bcxs_IsDone(s) )
+  {
+    bcx_CheckBetterResult(x, s);
+    return bcxs_Undo(s, col_cnt, row_cnt), 1;
+  }
+  
+  if ( bcx_GetKey(x, bcxs_GetLowerBound(s), s->order) >= bcx_GetBestKey(x) )
+    return bcxs_Undo(s, col_cnt, row_cnt), 1;
+  
+  if ( is_collect != 0 && s->decision_cnt >= x->task_depth )
+  {
+    i = bcx_AddTask(x, s);
+    return bcxs_Undo(s, col_cnt, row_cnt), i;
+  }
+    
+  col = bcxs_ChooseBranchColumn(s);
+  if ( col < 0 )
+    return bcxs_Undo(s, col_cnt, row_cnt), 1;
+  
+  for( i = 0; i < 2; i++ )
+  {
+    val = i == 0 ? BCN_VAL_ONE : BCN_VAL_ZERO;
+    if ( i == 1 && bcx_IsGreedyDone(x) )
+      break;
+    s->decision[s->decision_cnt++] = col*2 + (val == BCN_VAL_ONE ? 1 : 0);
+    bcxs_Assign(s, col, val);
+    if ( bcxs_Recursion(s, is_collect) == 0 )
+      return bcxs_Undo(s, col_cnt, row_cnt), 0;
+    s->decision_cnt--;
+    bcxs_Undo(s, col_mark, row_mark);
+  }
+
+  return bcxs_Undo(s, col_cnt, row_cnt), 1;
+}
+
+struct _bcx_worker_struct
+{
+  bcx_type x;
+  bcxs_type s[B_TH_MAX];
+};
+
+static int bcx_worker(void *data, int th, int pos)
+{
+  struct _bcx_worker_struct *wd = (struct _bcx_worker_struct *)data;
+  bcx_type x = wd->x;
+  bcxs_type s = wd->s[th];
+  int *d = x->task_ptr + pos*x->task_depth;
+  int i;
+  
+  bcxs_Clear(s);
+  s->order = 2*pos+1;
+  for( i = 0; i < x->task_depth; i++ )
+  {
+    if ( bcxs_Propagate(s) == 0 )
+      return 1;
+    s->decision[s->decision_cnt++] = d[i];
+    bcxs_Assign(s, d[i]/2, (d[i]&1) ? BCN_VAL_ONE : BCN_VAL_ZERO);
+  }
+  if ( bcx_IsGreedyDone(x) )
+    return 1;
+  return bcxs_Recursion(s, 0);
+}
+
+static int bcx_Search(bcx_type x, int thread_cnt)
+{
+  struct _bcx_worker_struct wd;
+  int i, result;
+  
+  thread_cnt = b_th_GetCnt(thread_cnt, B_TH_MAX);
+  
+  wd.x = x;
+  wd.s[0] = bcxs_Open(x);
+  if ( wd.s[0] == NULL )
+    return 0;
+  
+  if ( thread_cnt <= 1 || x->is_greedy != 0 )
+  {
+    result = bcxs_Recursion(wd.s[0], 0);
+    bcxs_Close(wd.s[0]);
+    return result;
+  }
+
+  /* about eight tasks per thread */
+  x->task_depth = 3;
+  while( (1<<x->task_depth) < thread_cnt*8 && x->task_depth < BCX_TASK_DEPTH_MAX )
+    x->task_depth++;
+  x->task_cnt = 0;
+  
+  /* order: 2*task_cnt during the collection, 2*pos+1 for task 'pos' */
+  x->key_mul = 2*(1L<<x->task_depth)+2;
+  x->best_key = bcx_GetKey(x, x->best_cost, 0);
+  
+  if ( bcxs_Recursion(wd.s[0], 1) == 0 )
+    return bcxs_Close(wd.s[0]), 0;
+    
+  for( i = 1; i < thread_cnt; i++ )
+  {
+    wd.s[i] = bcxs_Open(x);
+    if ( wd.s[i] == NULL )
+    {
+      while( i > 0 )
+        bcxs_Close(wd.s[--i]);
+      return 0;
+    }
+  }
+  
+  result = b_th_Do(thread_cnt, x->task_cnt, bcx_worker, &wd);
+  
+  for( i = 0; i < thread_cnt; i++ )
+    bcxs_Close(wd.s[i]);
+  return result;
+}
+
 /*--- BCP-API --------------------------------------------------------------*/
 
+/* classic algorithm, works directly on the linked matrix */
 /* result: 0 memory error */
 /* results are stored in 
   bc->is_no_solution != 0   --> no valid solution found
   bc->b                     --> selection if 'bc->is_no_solution == 0'
 */
-int b_bcp_Do(b_bcp_type bc)
+int b_bcp_DoClassic(b_bcp_type bc)
 {
   bcs_type x;
   bcm_type m;
@@ -1514,6 +2230,48 @@ int b_bcp_Do(b_bcp_type bc)
   return bcs_Close(x), bcm_Close(m), 1;
 }
 
+/* packed rows, word parallel reductions */
+/* result: 0 memory error */
+/* results are stored in 
+  bc->is_no_solution != 0   --> no valid solution found
+  bc->b                     --> selection if 'bc->is_no_solution == 0'
+*/
+int b_bcp_Do(b_bcp_type bc)
+{
+  bcx_type x;
+  int i;
+
+#ifdef BCM_LOG
+  bcm_Log(bc->m, 4, "Binate cover problem (%d x %d, packed).", bc->m->width, bc->m->height);
+#endif
+
+  if ( bc->b != NULL )
+    bcs_Close(bc->b);
+  bc->b = bcs_Open(bc->m->width);
+  if ( bc->b == NULL )
+    return 0;
+  bcs_Fill(bc->b, BCN_VAL_ZERO);
+  
+  x = bcx_Open(bc->m);
+  if ( x == NULL )
+    return 0;
+  x->is_greedy = bc->is_greedy;
+  
+  if ( bcx_Search(x, bc->thread_cnt) == 0 )
+    return bcx_Close(x), 0;
+    
+  bc->is_no_solution = x->is_found == 0 ? 1 : 0;
+  for( i = 0; i < bc->b->cnt; i++ )
+    if ( BCX_IS(x->best, i) )
+      bcs_Set(bc->b, i, BCN_VAL_ONE);
+      
+#ifdef BCM_LOG
+  bcm_Log(bc->m, 4, "Binate cover problem finished (cost %d).", x->best_cost);
+#endif
+  
+  bcx_Close(x);
+  return 1;
+}
 
 int b_bcp_Set(b_bcp_type bc, int x, int y, int val)
 {
@@ -1562,6 +2320,7 @@ b_bcp_type b_bcp_Open()
   if ( bc != NULL )
   {
     bc->is_greedy = 0;
+    bc->thread_cnt = 0;
     bc->is_no_solution = 0;
     bc->b = NULL;
     bc->m = bcm_Open(bc);
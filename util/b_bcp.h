@@ -63,6 +63,7 @@ typedef struct _bcm_struct *bcm_type;
 struct _b_bcp_struct
 {
   int is_greedy;
+  int thread_cnt;   /* 0: b_th_GetDefaultCnt() */
   int is_no_solution;
   bcs_type b; /* result */
   bcm_type m; /* matrix */
@@ -75,6 +76,9 @@ struct _b_bcp_struct
 /* returns 0, if a memory error occured */
 int b_bcp_Do(b_bcp_type bc);
 
+/* old algorithm on the linked matrix, same result values as b_bcp_Do */
+int b_bcp_DoClassic(b_bcp_type bc);
+
 /* setup the problem */
 int b_bcp_Set(b_bcp_type bc, int x, int y, int val);
 int b_bcp_SetStrLine(b_bcp_type bc, int y, const char *s);
@@ -0,0 +1,220 @@
+/*
+
+  b_ih.c
+
+  hash index for integer values (e.g. ids of a b_set)
+
+  Copyright (C) 2001 Oliver Kraus (olikraus@yahoo.com)
+
+  This file is part of DGC.
+
+  DGC is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 2 of the License, or
+  (at your option) any later version.
+
+  DGC is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with DGC; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA  
+
+  Open addressing with linear probing.
+
+*/
+
+#include <stdlib.h>
+#include "b_ih.h"
+#include "mwc.h"
+
+#define B_IH_EMPTY (-1)
+#define B_IH_DELETED (-2)
+#define B_IH_SIZE_MIN 16
+
+static int b_ih_dummy_fn(void *data, int el, const void *key)
+{
+  return 1;
+}
+
+static int b_ih_Alloc(b_ih_type b_ih, int size)
+{
+  int i;
+  b_ih->val = (int *)malloc(sizeof(int)*size);
+  if ( b_ih->val == NULL )
+    return 0;
+  b_ih->hash = (unsigned *)malloc(sizeof(unsigned)*size);
+  if ( b_ih->hash == NULL )
+    return free(b_ih->val), b_ih->val = NULL, 0;
+  for( i = 0; i < size; i++ )
+    b_ih->val[i] = B_IH_EMPTY;
+  b_ih->size = size;
+  b_ih->cnt = 0;
+  b_ih->used = 0;
+  return 1;
+}
+
+b_ih_type b_ih_Open()
+{
+  b_ih_type b_ih;
+  b_ih = malloc(sizeof(b_ih_struct));
+  if ( b_ih != NULL )
+  {
+    b_ih->cmp_fn = b_ih_dummy_fn;
+    b_ih->data = NULL;
+    if ( b_ih_Alloc(b_ih, B_IH_SIZE_MIN) != 0 )
+    {
+      return b_ih;
+    }
+    free(b_ih);
+  }
+  return NULL;
+}
+
+void b_ih_Close(b_ih_type b_ih)
+{
+  free(b_ih->val);
+  free(b_ih->hash);
+  free(b_ih);
+}
+
+void b_ih_Clear(b_ih_type b_ih)
+{
+  int i;
+  for( i = 0; i < b_ih->size; i++ )
+    b_ih->val[i] = B_IH_EMPTY;
+  b_ih->cnt = 0;
+  b_ih->used = 0;
+}
+
+void b_ih_SetCmpFn(b_ih_type b_ih, int (*cmp_fn)(void *data, int el, const void *key), void *data)
+{
+  b_ih->cmp_fn = cmp_fn;
+  b_ih->data = data;
+}
+
+static void b_ih_Put(b_ih_type b_ih, int val, unsigned hash)
+{
+  int mask = b_ih->size-1;
+  int pos = (int)(hash & (unsigned)mask);
+  while( b_ih->val[pos] >= 0 )
+    pos = (pos+1) & mask;
+  if ( b_ih->val[pos] == B_IH_EMPTY )
+    b_ih->used++;
+  b_ih->val[pos] = val;
+  b_ih->hash[pos] = hash;
+  b_ih->cnt++;
+}
+
+/* rebuild the table, removes all deleted entries */
+static int b_ih_Resize(b_ih_type b_ih)
+{
+  int *old_val = b_ih->val;
+  unsigned *old_hash = b_ih->hash;
+  int old_size = b_ih->size;
+  int size = B_IH_SIZE_MIN;
+  int i;
+  
+  while( size < (b_ih->cnt+1)*4 )
+    size *= 2;
+  if ( b_ih_Alloc(b_ih, size) == 0 )
+  {
+    b_ih->val = old_val;
+    b_ih->hash = old_hash;
+    return 0;
+  }
+  for( i = 0; i < old_size; i++ )
+    if ( old_val[i] >= 0 )
+      b_ih_Put(b_ih, old_val[i], old_hash[i]);
+  free(old_val);
+  free(old_hash);
+  return 1;
+}
+
+/* 0: error */
+int b_ih_Ins(b_ih_type b_ih, int val, unsigned hash)
+{
+  if ( val < 0 )
+    return 0;
+  if ( (b_ih->used+1)*2 > b_ih->size )
+    if ( b_ih_Resize(b_ih) == 0 )
+      return 0;
+  b_ih_Put(b_ih, val, hash);
+  return 1;
+}
+
+static int b_ih_FindPos(b_ih_type b_ih, const void *key, unsigned hash, int pos)
+{
+  int mask = b_ih->size-1;
+  if ( pos < 0 )
+    pos = (int)(hash & (unsigned)mask);
+  else
+    pos = (pos+1) & mask;
+  while( b_ih->val[pos] != B_IH_EMPTY )
+  {
+    if ( b_ih->val[pos] >= 0 && b_ih->hash[pos] == hash )
+      if ( b_ih->cmp_fn(b_ih->data, b_ih->val[pos], key) == 0 )
+        return pos;
+    pos = (pos+1) & mask;
+  }
+  return -1;
+}
+
+/* returns val or -1, start with *pos_ptr = -1 */
+int b_ih_FindNext(b_ih_type b_ih, const void *key, unsigned hash, int *pos_ptr)
+{
+  int pos = b_ih_FindPos(b_ih, key, hash, *pos_ptr);
+  if ( pos < 0 )
+    return -1;
+  *pos_ptr = pos;
+  return b_ih->val[pos];
+}
+
+/* returns val or -1 */
+int b_ih_Find(b_ih_type b_ih, const void *key, unsigned hash)
+{
+  int pos = -1;
+  return b_ih_FindNext(b_ih, key, hash, &pos);
+}
+
+void b_ih_Del(b_ih_type b_ih, int val, unsigned hash)
+{
+  int mask = b_ih->size-1;
+  int pos = (int)(hash & (unsigned)mask);
+  while( b_ih->val[pos] != B_IH_EMPTY )
+  {
+    if ( b_ih->val[pos] == val )
+    {
+      b_ih->val[pos] = B_IH_DELETED;
+      b_ih->cnt--;
+      return;
+    }
+    pos = (pos+1) & mask;
+  }
+}
+
+size_t b_ih_GetMemUsage(b_ih_type b_ih)
+{
+  return sizeof(b_ih_struct) + (sizeof(int)+sizeof(unsigned))*b_ih->size;
+}
+
+unsigned b_ih_StrHash(const char *s)
+{
+  unsigned h = 2166136261U;
+  while( *s != '\0' )
+  {
+    h ^= (unsigned char)*s++;
+    h *= 16777619U;
+  }
+  return h ^ (h >> 15);
+}
+
+unsigned b_ih_IntHash(int a, int b)
+{
+  unsigned h = (unsigned)a*2654435761U;
+  h ^= (unsigned)b + 0x9e3779b9U + (h << 6) + (h >> 2);
+  h *= 2246822519U;
+  return h ^ (h >> 13);
+}
@@ -0,0 +1,74 @@
+/*
+
+  b_ih.h
+
+  hash index for integer values (e.g. ids of a b_set)
+
+  Copyright (C) 2001 Oliver Kraus (olikraus@yahoo.com)
+
+  This file is part of DGC.
+
+  DGC is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 2 of the License, or
+  (at your option) any later version.
+
+  DGC is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with DGC; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA  
+
+  The index stores non-negative integer values together with the hash
+  value of the key. The key itself is not stored: the compare function
+  is called with the stored value and the key, which is searched for.
+  Several values may have the same key.
+
+*/
+
+#ifndef _B_IH_H
+#define _B_IH_H
+
+#include <stddef.h>
+
+struct _b_ih_struct
+{
+  int *val;             /* -1: empty, -2: deleted */
+  unsigned *hash;
+  int size;             /* power of two */
+  int cnt;              /* number of values */
+  int used;             /* values and deleted entries */
+  int (*cmp_fn)(void *data, int el, const void *key);  /* 0: equal */
+  void *data;
+};
+typedef struct _b_ih_struct b_ih_struct;
+typedef struct _b_ih_struct *b_ih_type;
+
+#define b_ih_GetCnt(ih) ((ih)->cnt)
+
+b_ih_type b_ih_Open();
+void b_ih_Close(b_ih_type b_ih);
+void b_ih_Clear(b_ih_type b_ih);
+void b_ih_SetCmpFn(b_ih_type b_ih, int (*cmp_fn)(void *data, int el, const void *key), void *data);
+
+/* 0: error */
+int b_ih_Ins(b_ih_type b_ih, int val, unsigned hash);
+
+/* returns val or -1, start with *pos_ptr = -1 */
+int b_ih_FindNext(b_ih_type b_ih, const void *key, unsigned hash, int *pos_ptr);
+
+/* returns val or -1 */
+int b_ih_Find(b_ih_type b_ih, const void *key, unsigned hash);
+
+/* 'hash' must be the value, which was used for b_ih_Ins() */
+void b_ih_Del(b_ih_type b_ih, int val, unsigned hash);
+
+size_t b_ih_GetMemUsage(b_ih_type b_ih);
+
+unsigned b_ih_StrHash(const char *s);
+unsigned b_ih_IntHash(int a, int b);
+
+#endif /* _B_IH_H */
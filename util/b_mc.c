@@ -0,0 +1,450 @@
+/*
+
+  b_mc.c
+
+  maximal cliques of an undirected graph
+
+  Copyright (C) 2001 Oliver Kraus (olikraus@yahoo.com)
+
+  This file is part of DGC.
+
+  DGC is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 2 of the License, or
+  (at your option) any later version.
+
+  DGC is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with DGC; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+
+  For the i-th vertex v of the degeneracy ordering, all cliques are
+  reported, which contain v but no vertex before v:
+    P = neighbours of v after v
+    X = neighbours of v before v
+  P has at most 'degeneracy' elements, so the recursion depth is
+  limited by degeneracy+1.
+
+*/
+
+#include <stdlib.h>
+#include <string.h>
+#include "b_mc.h"
+#include "b_th.h"
+#include "mwc.h"
+
+#define B_MC_BITS 32
+
+#define b_mc_row(mc,v) ((mc)->adj+(size_t)(v)*(size_t)(mc)->words)
+#define b_mc_get(s,v) (((s)[(v)/B_MC_BITS] >> ((v)%B_MC_BITS)) & 1U)
+#define b_mc_set(s,v) ((s)[(v)/B_MC_BITS] |= 1U << ((v)%B_MC_BITS))
+#define b_mc_clr(s,v) ((s)[(v)/B_MC_BITS] &= ~(1U << ((v)%B_MC_BITS)))
+
+/* is_stop is set by b_mc_Report() inside b_th_Lock(), but read without the lock */
+#if defined(__GNUC__)
+#define b_mc_is_stop(mc) __atomic_load_n(&((mc)->is_stop), __ATOMIC_ACQUIRE)
+#define b_mc_set_stop(mc) __atomic_store_n(&((mc)->is_stop), 1, __ATOMIC_RELEASE)
+#else
+#define b_mc_is_stop(mc) ((mc)->is_stop)
+#define b_mc_set_stop(mc) ((mc)->is_stop = 1)
+#endif
+
+/* workspace of one thread */
+struct _b_mc_ws_struct
+{
+  unsigned *set;        /* 3 bitsets (P, X, candidates) for each level */
+  int *r;               /* current clique */
+};
+typedef struct _b_mc_ws_struct b_mc_ws_struct;
+
+static int b_mc_popcount(unsigned x)
+{
+#if defined(__GNUC__)
+  return __builtin_popcount(x);
+#else
+  int cnt = 0;
+  while( x != 0 )
+  {
+    x &= x-1;
+    cnt++;
+  }
+  return cnt;
+#endif
+}
+
+static int b_mc_ffs(unsigned x)
+{
+#if defined(__GNUC__)
+  return __builtin_ctz(x);
+#else
+  int i = 0;
+  while( (x & 1U) == 0 )
+  {
+    x >>= 1;
+    i++;
+  }
+  return i;
+#endif
+}
+
+/* next element of 's' after position 'v', -1 if there is none */
+static int b_mc_next(b_mc_type mc, unsigned *s, int v)
+{
+  int w;
+  unsigned x;
+  v++;
+  if ( v >= mc->n )
+    return -1;
+  w = v/B_MC_BITS;
+  x = s[w] & (~0U << (v%B_MC_BITS));
+  for(;;)
+  {
+    if ( x != 0 )
+    {
+      v = w*B_MC_BITS + b_mc_ffs(x);
+      return v < mc->n ? v : -1;
+    }
+    w++;
+    if ( w >= mc->words )
+      return -1;
+    x = s[w];
+  }
+}
+
+static int b_mc_is_empty(b_mc_type mc, unsigned *s)
+{
+  int i;
+  for( i = 0; i < mc->words; i++ )
+    if ( s[i] != 0 )
+      return 0;
+  return 1;
+}
+
+b_mc_type b_mc_Open(int n)
+{
+  b_mc_type mc;
+  mc = (b_mc_type)malloc(sizeof(struct _b_mc_struct));
+  if ( mc != NULL )
+  {
+    mc->n = n;
+    mc->words = (n+B_MC_BITS-1)/B_MC_BITS;
+    if ( mc->words == 0 )
+      mc->words = 1;
+    mc->limit = 0;
+    mc->cnt = 0;
+    mc->degeneracy = 0;
+    mc->is_stop = 0;
+    mc->is_limit = 0;
+    mc->adj = (unsigned *)calloc((size_t)mc->words*(size_t)(n+1), sizeof(unsigned));
+    if ( mc->adj != NULL )
+    {
+      mc->order = (int *)malloc(sizeof(int)*(n+1));
+      if ( mc->order != NULL )
+      {
+        mc->rank = (int *)malloc(sizeof(int)*(n+1));
+        if ( mc->rank != NULL )
+        {
+          return mc;
+        }
+        free(mc->order);
+      }
+      free(mc->adj);
+    }
+    free(mc);
+  }
+  return NULL;
+}
+
+void b_mc_Close(b_mc_type mc)
+{
+  free(mc->rank);
+  free(mc->order);
+  free(mc->adj);
+  free(mc);
+}
+
+void b_mc_SetEdge(b_mc_type mc, int a, int b)
+{
+  if ( a == b )
+    return;
+  b_mc_set(b_mc_row(mc, a), b);
+  b_mc_set(b_mc_row(mc, b), a);
+}
+
+int b_mc_IsEdge(b_mc_type mc, int a, int b)
+{
+  return b_mc_get(b_mc_row(mc, a), b);
+}
+
+/*
+  degeneracy ordering: repeatedly remove a vertex with minimal degree
+*/
+static int b_mc_Order(b_mc_type mc)
+{
+  int *deg;
+  int i, v, u, w, best;
+  unsigned *row;
+
+  deg = (int *)malloc(sizeof(int)*(mc->n+1));
+  if ( deg == NULL )
+    return 0;
+  for( v = 0; v < mc->n; v++ )
+  {
+    row = b_mc_row(mc, v);
+    deg[v] = 0;
+    for( w = 0; w < mc->words; w++ )
+      deg[v] += b_mc_popcount(row[w]);
+    mc->rank[v] = -1;
+  }
+
+  mc->degeneracy = 0;
+  for( i = 0; i < mc->n; i++ )
+  {
+    best = -1;
+    for( v = 0; v < mc->n; v++ )
+      if ( mc->rank[v] < 0 )
+        if ( best < 0 || deg[v] < deg[best] )
+          best = v;
+    if ( mc->degeneracy < deg[best] )
+      mc->degeneracy = deg[best];
+    mc->order[i] = best;
+    mc->rank[best] = i;
+    row = b_mc_row(mc, best);
+    u = -1;
+    while( (u = b_mc_next(mc, row, u)) >= 0 )
+      if ( mc->rank[u] < 0 )
+        deg[u]--;
+  }
+  free(deg);
+  return 1;
+}
+
+static int b_mc_Report(b_mc_type mc, int *r, int r_cnt)
+{
+  int ret = 1;
+  b_th_Lock();
+  if ( mc->is_stop == 0 )
+  {
+    if ( mc->cb(mc->data, r, r_cnt) == 0 )
+    {
+      b_mc_set_stop(mc);
+      ret = 0;
+    }
+    else
+    {
+      mc->cnt++;
+      if ( mc->limit > 0 && mc->cnt >= mc->limit )
+      {
+        mc->is_limit = 1;
+        b_mc_set_stop(mc);
+      }
+    }
+  }
+  b_th_Unlock();
+  return ret;
+}
+
+/*
+  Bron-Kerbosch with pivot. P, X and the candidates of
+  level 'depth' are stored in ws->set.
+*/
+static int b_mc_BK(b_mc_type mc, b_mc_ws_struct *ws, int depth, int r_cnt)
+{
+  int words = mc->words;
+  unsigned *p = ws->set + (size_t)depth*3*words;
+  unsigned *x = p + words;
+  unsigned *c = x + words;
+  unsigned *np = c + words;
+  unsigned *nx = np + words;
+  unsigned *row;
+  int i, u, v, cnt, best, best_cnt;
+
+  if ( b_mc_is_stop(mc) != 0 )
+    return 1;
+
+  if ( b_mc_is_empty(mc, p) != 0 )
+  {
+    if ( b_mc_is_empty(mc, x) != 0 )
+      return b_mc_Report(mc, ws->r, r_cnt);
+    return 1;
+  }
+
+  /* pivot: vertex of P or X with the most neighbours in P */
+  best = -1;
+  best_cnt = -1;
+  for( i = 0; i < words; i++ )
+    c[i] = p[i] | x[i];
+  u = -1;
+  while( (u = b_mc_next(mc, c, u)) >= 0 )
+  {
+    row = b_mc_row(mc, u);
+    cnt = 0;
+    for( i = 0; i < words; i++ )
+      cnt += b_mc_popcount(p[i] & row[i]);
+    if ( cnt > best_cnt )
+    {
+      best_cnt = cnt;
+      best = u;
+    }
+  }
+
+  row = b_mc_row(mc, best);
+  for( i = 0; i < words; i++ )
+    c[i] = p[i] & ~row[i];
+
+  v = -1;
+  while( (v = b_mc_next(mc, c, v)) >= 0 )
+  {
+    row = b_mc_row(mc, v);
+    for( i = 0; i < words; i++ )
+    {
+      np[i] = p[i] & row[i];
+      nx[i] = x[i] & row[i];
+    }
+    ws->r[r_cnt] = v;
+    if ( b_mc_BK(mc, ws, depth+1, r_cnt+1) == 0 )
+      return 0;
+    if ( b_mc_is_stop(mc) != 0 )
+      return 1;
+    b_mc_clr(p, v);
+    b_mc_set(x, v);
+  }
+  return 1;
+}
+
+struct _b_mc_do_struct
+{
+  b_mc_type mc;
+  b_mc_ws_struct *ws;
+};
+
+static int b_mc_do_cb(void *data, int th, int pos)
+{
+  struct _b_mc_do_struct *d = (struct _b_mc_do_struct *)data;
+  b_mc_type mc = d->mc;
+  b_mc_ws_struct *ws = d->ws+th;
+  unsigned *p = ws->set;
+  unsigned *x = p + mc->words;
+  unsigned *row;
+  int v = mc->order[pos];
+  int u;
+
+  if ( b_mc_is_stop(mc) != 0 )
+    return 1;
+
+  memset(p, 0, sizeof(unsigned)*mc->words*2);
+  row = b_mc_row(mc, v);
+  u = -1;
+  while( (u = b_mc_next(mc, row, u)) >= 0 )
+  {
+    if ( mc->rank[u] > pos )
+      b_mc_set(p, u);
+    else
+      b_mc_set(x, u);
+  }
+  ws->r[0] = v;
+  return b_mc_BK(mc, ws, 0, 1);
+}
+
+int b_mc_Do(b_mc_type mc, int thread_cnt, b_mc_cb_type cb, void *data)
+{
+  struct _b_mc_do_struct d;
+  int i, th_cnt, r;
+  size_t set_size;
+
+  mc->cb = cb;
+  mc->data = data;
+  mc->cnt = 0;
+  mc->is_stop = 0;
+  mc->is_limit = 0;
+
+  if ( mc->n == 0 )
+    return 1;
+
+  if ( b_mc_Order(mc) == 0 )
+    return 0;
+
+  th_cnt = b_th_GetCnt(thread_cnt, mc->n);
+  d.mc = mc;
+  d.ws = (b_mc_ws_struct *)malloc(sizeof(b_mc_ws_struct)*th_cnt);
+  if ( d.ws == NULL )
+    return 0;
+
+  /* the last level needs P and X, which are written by the level above */
+  set_size = (size_t)(mc->degeneracy+3)*3*(size_t)mc->words;
+  for( i = 0; i < th_cnt; i++ )
+  {
+    d.ws[i].set = (unsigned *)malloc(sizeof(unsigned)*set_size);
+    d.ws[i].r = (int *)malloc(sizeof(int)*(mc->n+1));
+    if ( d.ws[i].set == NULL || d.ws[i].r == NULL )
+    {
+      free(d.ws[i].set);
+      free(d.ws[i].r);
+      break;
+    }
+  }
+  if ( i < th_cnt )
+  {
+    while( i > 0 )
+    {
+      i--;
+      free(d.ws[i].set);
+      free(d.ws[i].r);
+    }
+    free(d.ws);
+    return 0;
+  }
+
+  r = b_th_Do(th_cnt, mc->n, b_mc_do_cb, &d);
+
+  for( i = 0; i < th_cnt; i++ )
+  {
+    free(d.ws[i].set);
+    free(d.ws[i].r);
+  }
+  free(d.ws);
+
+  if ( r == 0 )
+    return 0;
+  if ( mc->is_limit != 0 )
+    return 2;
+  if ( mc->is_stop != 0 )
+    return 0;
+  return 1;
+}
+
+int b_mc_Extend(b_mc_type mc, int *v, int cnt, int *excl)
+{
+  unsigned *c;
+  unsigned *row;
+  int i, w, u;
+
+  c = (unsigned *)malloc(sizeof(unsigned)*mc->words);
+  if ( c == NULL )
+    return cnt;
+  for( w = 0; w < mc->words; w++ )
+    c[w] = ~0U;
+  for( i = 0; i < cnt; i++ )
+  {
+    row = b_mc_row(mc, v[i]);
+    for( w = 0; w < mc->words; w++ )
+      c[w] &= row[w];
+  }
+  u = -1;
+  while( (u = b_mc_next(mc, c, u)) >= 0 )
+  {
+    if ( excl != NULL && excl[u] != 0 )
+      continue;
+    v[cnt++] = u;
+    row = b_mc_row(mc, u);
+    for( w = 0; w < mc->words; w++ )
+      c[w] &= row[w];
+  }
+  free(c);
+  return cnt;
+}
@@ -0,0 +1,94 @@
+/*
+
+  b_mc.h
+
+  maximal cliques of an undirected graph
+
+  Copyright (C) 2001 Oliver Kraus (olikraus@yahoo.com)
+
+  This file is part of DGC.
+
+  DGC is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 2 of the License, or
+  (at your option) any later version.
+
+  DGC is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with DGC; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+  The adjacency matrix is stored as one bitset for each vertex.
+  The cliques are enumerated with the Bron-Kerbosch algorithm
+  (pivot selection of Tomita et al.), the outer level follows a
+  degeneracy ordering of the vertices (Eppstein et al.).
+
+*/
+
+#ifndef _B_MC_H
+#define _B_MC_H
+
+/*
+  callback for each maximal clique:
+    v:      the vertices of the clique
+    cnt:    number of vertices
+  return 0 to abort the enumeration
+*/
+typedef int (*b_mc_cb_type)(void *data, int *v, int cnt);
+
+struct _b_mc_struct
+{
+  int n;                /* number of vertices */
+  int words;            /* unsigned words of one bitset */
+  unsigned *adj;        /* n bitsets */
+
+  long limit;           /* max. number of cliques, <= 0: no limit */
+  long cnt;             /* number of reported cliques */
+
+  int *order;           /* degeneracy ordering */
+  int *rank;            /* position of a vertex in 'order' */
+  int degeneracy;
+
+  volatile int is_stop;
+  int is_limit;
+
+  b_mc_cb_type cb;
+  void *data;
+};
+typedef struct _b_mc_struct *b_mc_type;
+
+b_mc_type b_mc_Open(int n);
+void b_mc_Close(b_mc_type mc);
+
+void b_mc_SetEdge(b_mc_type mc, int a, int b);
+int b_mc_IsEdge(b_mc_type mc, int a, int b);
+
+#define b_mc_SetLimit(mc,l) ((mc)->limit = (l))
+#define b_mc_GetCnt(mc) ((mc)->cnt)
+
+/*
+  Calls 'cb' for each maximal clique. The callback is called
+  inside b_th_Lock()/b_th_Unlock(), the subtrees of the outer level
+  are distributed among 'thread_cnt' threads (see b_th_Do).
+  The order of the cliques depends on the threads.
+  returns
+    0   memory error or 'cb' returned 0
+    1   ok
+    2   the limit has been reached, not all cliques are reported
+*/
+int b_mc_Do(b_mc_type mc, int thread_cnt, b_mc_cb_type cb, void *data);
+
+/*
+  Extends the clique 'v' (with 'cnt' vertices): vertices are added
+  in ascending order, as long as they are connected to all other
+  vertices of the clique. Vertices with excl[u] != 0 are not added,
+  'excl' can be NULL.
+  'v' must have space for all vertices. Returns the new size.
+*/
+int b_mc_Extend(b_mc_type mc, int *v, int cnt, int *excl);
+
+#endif /* _B_MC_H */
@@ -341,6 +341,28 @@ int b_set_Read(b_set_type bs, FILE *fp, void *(*read_el)(FILE *fp, void *ud), vo
   return 1;
 }
 
+/* copies all elements of src to the same positions of the empty set bs */
+int b_set_Copy(b_set_type bs, b_set_type src, void *(*copy_el)(void *el, void *ud), void *ud)
+{
+  int i;
+  assert(bs->list_cnt == 0);
+  while( bs->list_max < src->list_max )
+    if ( b_set_expand(bs) == 0 )
+      return 0;
+  for( i = 0; i < src->list_max; i++ )
+  {
+    if ( src->list_ptr[i] != NULL )
+    {
+      bs->list_ptr[i] = copy_el(src->list_ptr[i], ud);
+      if ( bs->list_ptr[i] == NULL )
+        return 0;
+      bs->list_cnt++;
+    }
+  }
+  bs->search_pos_start = src->search_pos_start;
+  return 1;
+}
+
 int b_set_ReadMerge(b_set_type bs, FILE *fp, void *(*read_el)(FILE *fp, void *ud), void *ud)
 {
   int i, chk, cnt, pos;
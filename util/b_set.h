@@ -61,6 +61,7 @@ int b_set_InvWhileLoop(b_set_type bs, int *pos);
 int b_set_Write(b_set_type bs, FILE *fp, int (*write_el)(FILE *fp, void *el, void *ud), void *ud);
 int b_set_Read(b_set_type bs, FILE *fp, void *(*read_el)(FILE *fp, void *ud), void *ud);
 int b_set_ReadMerge(b_set_type bs, FILE *fp, void *(*read_el)(FILE *fp, void *ud), void *ud);
+int b_set_Copy(b_set_type bs, b_set_type src, void *(*copy_el)(void *el, void *ud), void *ud);
 
 size_t b_set_GetMemUsage(b_set_type bs);
 size_t b_set_GetAllMemUsage(b_set_type bs, size_t (*fn)(void *));
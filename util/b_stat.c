@@ -0,0 +1,190 @@
+/*
+
+  b_stat.c
+
+  statistics export (JSON lines)
+
+  Copyright (C) 2001 Oliver Kraus (olikraus@yahoo.com)
+
+  This file is part of DGC.
+
+  DGC is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 2 of the License, or
+  (at your option) any later version.
+
+  DGC is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with DGC; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+
+  Each record is written as one line:
+
+  {"seq":3,"phase":"primes","wall_ms":1.25,"cpu_ms":1.20,
+   "tautology":0,"tautology_rec":0,"complement_rec":0,"primes_rec":71,
+   "cache_hit":130,"cache_miss":12,"in":10,"out":27}
+
+  The counters contain the number of events during the phase (including
+  nested phases). When the file is closed, a record with the phase
+  "total" is written.
+
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <pthread.h>
+#include <sys/time.h>
+#include "b_stat.h"
+#include "mwc.h"
+
+int g_b_stat_is_enabled = -1;   /* -1: environment not checked */
+
+static FILE *b_stat_fp = NULL;
+static long b_stat_seq = 0;
+static long b_stat_cnt[B_STAT_CNT_MAX];
+static struct _b_stat_struct b_stat_total;
+static pthread_mutex_t b_stat_mutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_once_t b_stat_once = PTHREAD_ONCE_INIT;
+static int b_stat_is_atexit = 0;
+
+static const char *b_stat_cnt_name[B_STAT_CNT_MAX] =
+{
+  "tautology",
+  "tautology_rec",
+  "complement_rec",
+  "primes_rec",
+  "cache_hit",
+  "cache_miss"
+};
+
+static double b_stat_wall_ms(void)
+{
+  struct timeval tv;
+  gettimeofday(&tv, NULL);
+  return (double)tv.tv_sec*1000.0 + (double)tv.tv_usec/1000.0;
+}
+
+/* processor time of the calling thread or of the whole process */
+static double b_stat_cpu_ms(int is_process)
+{
+  struct timespec ts;
+  if ( clock_gettime(is_process != 0 ? CLOCK_PROCESS_CPUTIME_ID : CLOCK_THREAD_CPUTIME_ID, &ts) != 0 )
+    return 0.0;
+  return (double)ts.tv_sec*1000.0 + (double)ts.tv_nsec/1000000.0;
+}
+
+static void b_stat_Init(b_stat_type s, const char *phase, int is_process)
+{
+  int i;
+  s->phase = phase;
+  s->val_cnt = 0;
+  s->is_process = is_process;
+  s->start_wall = b_stat_wall_ms();
+  s->start_cpu = b_stat_cpu_ms(is_process);
+  for( i = 0; i < B_STAT_CNT_MAX; i++ )
+    s->start_cnt[i] = b_stat_cnt[i];
+}
+
+static void b_stat_Write(b_stat_type s)
+{
+  int i;
+  double wall = b_stat_wall_ms();
+  double cpu = b_stat_cpu_ms(s->is_process);
+  pthread_mutex_lock(&b_stat_mutex);
+  if ( b_stat_fp != NULL )
+  {
+    fprintf(b_stat_fp, "{\"seq\":%ld,\"phase\":\"%s\",\"wall_ms\":%.3f,\"cpu_ms\":%.3f",
+      b_stat_seq++, s->phase, wall-s->start_wall, cpu-s->start_cpu);
+    for( i = 0; i < B_STAT_CNT_MAX; i++ )
+      fprintf(b_stat_fp, ",\"%s\":%ld", b_stat_cnt_name[i], b_stat_cnt[i]-s->start_cnt[i]);
+    for( i = 0; i < s->val_cnt; i++ )
+      fprintf(b_stat_fp, ",\"%s\":%ld", s->key[i], s->val[i]);
+    fprintf(b_stat_fp, "}\n");
+    fflush(b_stat_fp);
+  }
+  pthread_mutex_unlock(&b_stat_mutex);
+}
+
+int b_stat_Open(const char *file_name)
+{
+  if ( file_name == NULL || file_name[0] == '\0' )
+    file_name = getenv(B_STAT_ENV);
+  if ( b_stat_fp != NULL )
+    b_stat_Close();
+  g_b_stat_is_enabled = 0;
+  if ( file_name == NULL || file_name[0] == '\0' )
+    return 1;
+  b_stat_fp = fopen(file_name, "a");
+  if ( b_stat_fp == NULL )
+    return 0;
+  g_b_stat_is_enabled = 1;
+  b_stat_Init(&b_stat_total, "total", 1);
+  if ( b_stat_is_atexit == 0 )
+  {
+    atexit(b_stat_Close);
+    b_stat_is_atexit = 1;
+  }
+  return 1;
+}
+
+void b_stat_Close(void)
+{
+  if ( b_stat_fp == NULL )
+    return;
+  b_stat_Write(&b_stat_total);
+  fclose(b_stat_fp);
+  b_stat_fp = NULL;
+  g_b_stat_is_enabled = 0;
+}
+
+void b_stat_IncCnt(int idx)
+{
+#if defined(__GNUC__)
+  __sync_fetch_and_add(b_stat_cnt+idx, 1);
+#else
+  b_stat_cnt[idx]++;
+#endif
+}
+
+/* called once, if b_stat_Open() has not been called by the application */
+static void b_stat_open_env(void)
+{
+  if ( g_b_stat_is_enabled < 0 )
+    b_stat_Open(NULL);
+}
+
+b_stat_type b_stat_Start(const char *phase)
+{
+  b_stat_type s;
+  pthread_once(&b_stat_once, b_stat_open_env);
+  if ( g_b_stat_is_enabled <= 0 )
+    return NULL;
+  s = (b_stat_type)malloc(sizeof(struct _b_stat_struct));
+  if ( s == NULL )
+    return NULL;
+  b_stat_Init(s, phase, 0);
+  return s;
+}
+
+void b_stat_Add(b_stat_type s, const char *key, long val)
+{
+  if ( s == NULL || s->val_cnt >= B_STAT_VAL_MAX )
+    return;
+  s->key[s->val_cnt] = key;
+  s->val[s->val_cnt] = val;
+  s->val_cnt++;
+}
+
+void b_stat_Finish(b_stat_type s)
+{
+  if ( s == NULL )
+    return;
+  b_stat_Write(s);
+  free(s);
+}
@@ -0,0 +1,85 @@
+/*
+
+  b_stat.h
+
+  statistics export (JSON lines)
+
+  Copyright (C) 2001 Oliver Kraus (olikraus@yahoo.com)
+
+  This file is part of DGC.
+
+  DGC is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 2 of the License, or
+  (at your option) any later version.
+
+  DGC is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with DGC; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+*/
+
+#ifndef _B_STAT_H
+#define _B_STAT_H
+
+/* name of the environment variable with the statistics file */
+#define B_STAT_ENV "DGC_STAT"
+
+/* global event counters */
+#define B_STAT_CNT_TAUTOLOGY 0
+#define B_STAT_CNT_TAUTOLOGY_REC 1
+#define B_STAT_CNT_COMPLEMENT_REC 2
+#define B_STAT_CNT_PRIMES_REC 3
+#define B_STAT_CNT_CACHE_HIT 4
+#define B_STAT_CNT_CACHE_MISS 5
+#define B_STAT_CNT_MAX 6
+
+/* maximum number of values of one record */
+#define B_STAT_VAL_MAX 16
+
+struct _b_stat_struct
+{
+  const char *phase;
+  double start_wall;
+  double start_cpu;
+  int is_process;   /* 0: processor time of the calling thread */
+  long start_cnt[B_STAT_CNT_MAX];
+  int val_cnt;
+  const char *key[B_STAT_VAL_MAX];
+  long val[B_STAT_VAL_MAX];
+};
+typedef struct _b_stat_struct *b_stat_type;
+
+/* > 0 if statistics are written */
+extern int g_b_stat_is_enabled;
+
+/*
+  file_name == NULL: use the environment variable DGC_STAT
+  returns 0 if the file could not be opened
+*/
+int b_stat_Open(const char *file_name);
+void b_stat_Close(void);
+
+void b_stat_IncCnt(int idx);
+#define b_stat_Inc(idx) \
+  do { if ( g_b_stat_is_enabled > 0 ) b_stat_IncCnt(idx); } while(0)
+
+/*
+  One record for each phase. b_stat_Start returns NULL if the statistics
+  are disabled, all other functions accept NULL.
+  The record contains the wall clock time and the processor time of
+  the calling thread for the phase and the changes of the global
+  counters. b_stat_Start() and b_stat_Finish() must be called by the
+  same thread. The "total" record contains the processor time of
+  the process.
+*/
+b_stat_type b_stat_Start(const char *phase);
+void b_stat_Add(b_stat_type s, const char *key, long val);
+void b_stat_Finish(b_stat_type s);
+
+#endif /* _B_STAT_H */
@@ -0,0 +1,186 @@
+/*
+
+  b_th.c
+
+  worker threads for independent loop iterations
+
+  Copyright (C) 2001 Oliver Kraus (olikraus@yahoo.com)
+
+  This file is part of DGC.
+
+  DGC is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 2 of the License, or
+  (at your option) any later version.
+
+  DGC is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with DGC; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+
+  The loop index is distributed dynamically: each worker fetches the
+  next free index, so that unbalanced iterations do not block the
+  other workers. The calling thread works as thread 0.
+
+  The memory checker (mwc) is not thread safe, b_th_Do will only use
+  one thread if mwc is enabled.
+
+*/
+
+#include <stdlib.h>
+#include <pthread.h>
+#include "b_th.h"
+#include "mwc.h"
+
+static int b_th_default_cnt = -1;
+/* > 0: the current thread executes a b_th_Do loop with several threads */
+static B_TH_LOCAL int b_th_depth = 0;
+static pthread_mutex_t b_th_global_mutex = PTHREAD_MUTEX_INITIALIZER;
+
+struct _b_th_loop_struct
+{
+  pthread_mutex_t mutex;
+  b_th_fn_type fn;
+  void *data;
+  int cnt;
+  int next;
+  int is_abort;
+};
+typedef struct _b_th_loop_struct *b_th_loop_type;
+
+struct _b_th_worker_struct
+{
+  b_th_loop_type l;
+  int th;
+  pthread_t thread;
+};
+typedef struct _b_th_worker_struct b_th_worker_struct;
+
+int b_th_GetDefaultCnt(void)
+{
+  const char *s;
+  if ( b_th_default_cnt < 0 )
+  {
+    b_th_default_cnt = 1;
+    s = getenv("DGC_THREADS");
+    if ( s != NULL )
+      b_th_SetDefaultCnt(atoi(s));
+  }
+  return b_th_default_cnt;
+}
+
+void b_th_SetDefaultCnt(int cnt)
+{
+  if ( cnt < 1 )
+    cnt = 1;
+  if ( cnt > B_TH_MAX )
+    cnt = B_TH_MAX;
+  b_th_default_cnt = cnt;
+}
+
+int b_th_GetCnt(int thread_cnt, int cnt)
+{
+#ifdef ___MWC_ENABLE
+  return 1;
+#endif
+  if ( thread_cnt <= 0 )
+    thread_cnt = b_th_depth > 0 ? 1 : b_th_GetDefaultCnt();
+  if ( thread_cnt > B_TH_MAX )
+    thread_cnt = B_TH_MAX;
+  if ( thread_cnt > cnt )
+    thread_cnt = cnt;
+  if ( thread_cnt < 1 )
+    thread_cnt = 1;
+  return thread_cnt;
+}
+
+static void *b_th_worker(void *arg)
+{
+  b_th_worker_struct *w = (b_th_worker_struct *)arg;
+  b_th_loop_type l = w->l;
+  int pos;
+  b_th_depth++;
+  for(;;)
+  {
+    pthread_mutex_lock(&(l->mutex));
+    if ( l->is_abort != 0 || l->next >= l->cnt )
+    {
+      pthread_mutex_unlock(&(l->mutex));
+      break;
+    }
+    pos = l->next++;
+    pthread_mutex_unlock(&(l->mutex));
+
+    if ( l->fn(l->data, w->th, pos) == 0 )
+    {
+      pthread_mutex_lock(&(l->mutex));
+      l->is_abort = 1;
+      pthread_mutex_unlock(&(l->mutex));
+      break;
+    }
+  }
+  b_th_depth--;
+  return NULL;
+}
+
+int b_th_Do(int thread_cnt, int cnt, b_th_fn_type fn, void *data)
+{
+  struct _b_th_loop_struct l;
+  b_th_worker_struct w[B_TH_MAX];
+  int i, started;
+
+  thread_cnt = b_th_GetCnt(thread_cnt, cnt);
+
+  if ( thread_cnt <= 1 )
+  {
+    for( i = 0; i < cnt; i++ )
+      if ( fn(data, 0, i) == 0 )
+        return 0;
+    return 1;
+  }
+
+  if ( pthread_mutex_init(&(l.mutex), NULL) != 0 )
+    return 0;
+  l.fn = fn;
+  l.data = data;
+  l.cnt = cnt;
+  l.next = 0;
+  l.is_abort = 0;
+
+  /* thread 0 is the calling thread */
+  started = 1;
+  for( i = 1; i < thread_cnt; i++ )
+  {
+    w[i].l = &l;
+    w[i].th = i;
+    if ( pthread_create(&(w[i].thread), NULL, b_th_worker, w+i) != 0 )
+      break;
+    started++;
+  }
+
+  w[0].l = &l;
+  w[0].th = 0;
+  b_th_worker(w+0);
+
+  for( i = 1; i < started; i++ )
+    pthread_join(w[i].thread, NULL);
+
+  pthread_mutex_destroy(&(l.mutex));
+
+  return l.is_abort == 0 ? 1 : 0;
+}
+
+void b_th_Lock(void)
+{
+  pthread_mutex_lock(&b_th_global_mutex);
+}
+
+void b_th_Unlock(void)
+{
+  pthread_mutex_unlock(&b_th_global_mutex);
+}
@@ -0,0 +1,68 @@
+/*
+
+  b_th.h
+
+  worker threads for independent loop iterations
+
+  Copyright (C) 2001 Oliver Kraus (olikraus@yahoo.com)
+
+  This file is part of DGC.
+
+  DGC is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 2 of the License, or
+  (at your option) any later version.
+
+  DGC is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with DGC; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+*/
+
+#ifndef _B_TH_H
+#define _B_TH_H
+
+/* upper limit for the number of worker threads */
+#define B_TH_MAX 64
+
+/*
+  callback for b_th_Do:
+    data:   user data
+    th:     number of the worker thread (0..thread_cnt-1),
+            can be used to select a per-thread workspace
+    pos:    loop index
+  return 0 to abort the loop (error)
+*/
+typedef int (*b_th_fn_type)(void *data, int th, int pos);
+
+/* number of threads, which should be used by default */
+/* the value is taken from the environment variable DGC_THREADS, default is 1 */
+int b_th_GetDefaultCnt(void);
+void b_th_SetDefaultCnt(int cnt);
+
+/* returns the number of threads, which will be used by b_th_Do */
+/* thread_cnt <= 0: use b_th_GetDefaultCnt(), but only one thread */
+/* inside the callback of a b_th_Do loop with several threads */
+int b_th_GetCnt(int thread_cnt, int cnt);
+
+/* calls fn(data, th, pos) for all pos = 0..cnt-1 */
+/* returns 0 if one of the callbacks returned 0 */
+int b_th_Do(int thread_cnt, int cnt, b_th_fn_type fn, void *data);
+
+/* storage class for static buffers, which are also used by the worker threads */
+#ifdef __GNUC__
+#define B_TH_LOCAL __thread
+#else
+#define B_TH_LOCAL
+#endif
+
+/* global lock for short critical sections inside the callbacks */
+void b_th_Lock(void);
+void b_th_Unlock(void);
+
+#endif /* _B_TH_H */